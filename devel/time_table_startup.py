@@ -0,0 +1,63 @@
+# Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+# https://github.com/GalSim-developers
+#
+# This file is part of GalSim: The modular galaxy image simulation toolkit.
+# https://github.com/GalSim-developers/GalSim
+#
+# GalSim is free software: redistribution and use in source and binary forms,
+# with or without modification, are permitted provided that the following
+# conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions, and the disclaimer given in the accompanying LICENSE
+#    file.
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions, and the disclaimer given in the documentation
+#    and/or other materials provided with the distribution.
+#
+
+# Time the startup cost of the profiles whose lookup tables are built from integrals
+# (cf. integ::int1d).  Each trial uses slightly different GSParams, so none of the tables
+# come from the in-memory caches, and the on-disk info cache is turned off.
+#
+# Run this before and after a change to the integrator and compare the times.  The
+# maxk, stepk and flux values are printed too, since they should not change.
+
+from __future__ import print_function
+import galsim
+import time
+import sys
+
+ntrials = int(sys.argv[1]) if len(sys.argv) > 1 else 3
+galsim.utilities.set_info_cache_dir(None)
+
+profiles = [
+    ('Sersic n=1.7', lambda gsp: galsim.Sersic(n=1.7, half_light_radius=1.2, gsparams=gsp)),
+    ('Sersic n=4.3', lambda gsp: galsim.Sersic(n=4.3, half_light_radius=1.2, gsparams=gsp)),
+    ('Truncated Sersic', lambda gsp: galsim.Sersic(n=2.5, half_light_radius=1.2, trunc=6.,
+                                                   gsparams=gsp)),
+    ('InclinedSersic', lambda gsp: galsim.InclinedSersic(n=1.5, inclination=0.6*galsim.radians,
+                                                         half_light_radius=1.2, gsparams=gsp)),
+    ('Kolmogorov', lambda gsp: galsim.Kolmogorov(fwhm=0.8, gsparams=gsp)),
+    ('VonKarman', lambda gsp: galsim.VonKarman(lam=700., r0=0.2, L0=25., gsparams=gsp)),
+    ('SecondKick', lambda gsp: galsim.SecondKick(lam=700., r0=0.2, diam=4., obscuration=0.3,
+                                                 gsparams=gsp)),
+]
+
+total = 0.
+for name, make in profiles:
+    times = []
+    for trial in range(ntrials):
+        gsp = galsim.GSParams(folding_threshold=5.e-3 * (1. + 1.e-3*trial))
+        t0 = time.time()
+        obj = make(gsp)
+        maxk = obj.maxk
+        stepk = obj.stepk
+        flux = obj.drawImage(nx=64, ny=64, scale=0.2, method='no_pixel').array.sum()
+        t1 = time.time()
+        times.append(t1-t0)
+    best = min(times)
+    total += best
+    print('%-18s  time = %8.4f s (best of %d)   maxk = %.10g  stepk = %.10g  flux = %.10g'%(
+          name, best, ntrials, maxk, stepk, flux))
+print('Total time = %.4f s'%total)
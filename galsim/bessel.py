@@ -16,6 +16,9 @@
 #    and/or other materials provided with the distribution.
 #
 
+import numpy as np
+
+from . import _galsim
 from ._galsim import j0, j1, jv, kv, yv, iv, j0_root
 
 # Alias the "n" names, which don't get any advantage from being implemented differently,
@@ -24,3 +27,60 @@ from ._galsim import j0, j1, jv, kv, yv, iv, j0_root
 jn = jv
 kn = kv
 yn = yv
+
+def j0_many(x):
+    """Calculate j0 for an array of values.
+
+    This is equivalent to ``np.array([j0(xx) for xx in x])``, but is much faster, since the
+    values are calculated together in C++.  The results agree with the scalar `j0` function
+    to within a few times 1.e-16.
+
+    Parameters:
+        x:      A numpy array (or anything convertible to one) of values.
+
+    Returns:
+        a numpy array of j0(x) with the same shape as x.
+    """
+    x = np.ascontiguousarray(x, dtype=float)
+    result = np.empty_like(x)
+    _galsim.j0Many(x.ctypes.data, result.ctypes.data, x.size)
+    return result
+
+def j1_many(x):
+    """Calculate j1 for an array of values.
+
+    This is equivalent to ``np.array([j1(xx) for xx in x])``, but is much faster, since the
+    values are calculated together in C++.  The results agree with the scalar `j1` function
+    to within a few times 1.e-16.
+
+    Parameters:
+        x:      A numpy array (or anything convertible to one) of values.
+
+    Returns:
+        a numpy array of j1(x) with the same shape as x.
+    """
+    x = np.ascontiguousarray(x, dtype=float)
+    result = np.empty_like(x)
+    _galsim.j1Many(x.ctypes.data, result.ctypes.data, x.size)
+    return result
+
+def kv_many(nu, x):
+    """Calculate kv for a single order nu and an array of values.
+
+    This is equivalent to ``np.array([kv(nu, xx) for xx in x])``, but is faster, since the
+    values are calculated together in C++.  The orders 0 and 1 (and other small integers,
+    which use the recurrence relation) are the most efficient.  The results agree with the
+    scalar `kv` function to a relative accuracy of about 1.e-15.
+
+    Parameters:
+        nu:     The order of the Bessel function.
+        x:      A numpy array (or anything convertible to one) of values, which must all
+                be > 0.
+
+    Returns:
+        a numpy array of kv(nu, x) with the same shape as x.
+    """
+    x = np.ascontiguousarray(x, dtype=float)
+    result = np.empty_like(x)
+    _galsim.kvMany(float(nu), x.ctypes.data, result.ctypes.data, x.size)
+    return result
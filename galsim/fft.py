@@ -21,7 +21,9 @@ import numpy as np
 from . import _galsim
 from .image import Image, ImageD, ImageCD
 from .bounds import BoundsI
-from .errors import GalSimValueError, convert_cpp_errors
+from .errors import GalSimValueError, GalSimIncompatibleValuesError, GalSimBoundsError
+from .errors import convert_cpp_errors
+from .errors import galsim_warn
 
 def fft2(a, shift_in=False, shift_out=False):
     """Compute the 2-dimensional discrete Fourier Transform.
@@ -285,3 +287,159 @@ def irfft2(a, shift_in=False, shift_out=False):
     return xim.array
 
 
+_plan_modes = { 'estimate' : 0, 'measure' : 1, 'patient' : 2 }
+
+def set_plan_mode(mode):
+    """Set how much effort FFTW spends finding the fastest algorithm for each new FFT size.
+
+    GalSim caches the FFTW plans, so this cost is only paid the first time a given size is
+    transformed in a process.  The options are:
+
+        - 'estimate'  Use a heuristic to pick a plan.  This is essentially free. [default]
+        - 'measure'   Time several candidate algorithms and pick the fastest one.  This can
+                      take a second or more for large sizes, but the resulting transforms are
+                      often noticeably faster.
+        - 'patient'   Like 'measure', but try a much wider range of algorithms.
+
+    The 'measure' and 'patient' modes are most useful when combined with `import_wisdom` and
+    `export_wisdom`, so the planning is only done once rather than once per process.
+
+    Parameters:
+        mode:       One of 'estimate', 'measure', or 'patient'.
+    """
+    if mode not in _plan_modes:
+        raise GalSimValueError("Invalid plan mode", mode, tuple(_plan_modes.keys()))
+    _galsim.SetFFTWPlanMode(_plan_modes[mode])
+
+def get_plan_mode():
+    """Return the current FFTW planning mode.  cf. `set_plan_mode`
+    """
+    mode = _galsim.GetFFTWPlanMode()
+    return [ k for k,v in _plan_modes.items() if v == mode ][0]
+
+def clear_plan_cache():
+    """Destroy all the cached FFTW plans.
+
+    The cache keeps the 200 most recently used plans.  Plans made in the 'measure' or
+    'patient' modes are also used for later transforms of the same size in 'estimate' mode.
+    """
+    _galsim.ClearFFTWPlanCache()
+
+def import_wisdom(file_name):
+    """Read FFTW wisdom from a file that was written by `export_wisdom`.
+
+    This lets a new process reuse the plans that were measured by a previous process, so
+    it can use the 'measure' or 'patient' planning modes without paying the planning cost
+    again.
+
+    Parameters:
+        file_name:  The name of the file to read.
+    """
+    with convert_cpp_errors(OSError):
+        _galsim.ImportFFTWWisdom(file_name)
+
+def export_wisdom(file_name):
+    """Write the FFTW wisdom accumulated by this process to a file.
+
+    Parameters:
+        file_name:  The name of the file to write.
+    """
+    with convert_cpp_errors(OSError):
+        _galsim.ExportFFTWWisdom(file_name)
+
+def set_num_threads(nthreads, min_size=None):
+    """Set the number of threads FFTW may use for a single large transform.
+
+    Only transforms with at least min_size x min_size elements are split over multiple
+    threads.  Smaller transforms, which are the usual case when drawing postage stamps, are
+    always done in a single thread, since the threading overhead would outweigh any gain.
+    (If you are drawing many small stamps, it is better to parallelize over stamps instead.)
+
+    This requires that GalSim was built against the fftw3_threads library.  If it was not,
+    a warning is emitted and all transforms remain single-threaded.
+
+    Parameters:
+        nthreads:   The number of threads to use.  Use nthreads <= 0 to use all available
+                    cores.
+        min_size:   The minimum linear size of a transform for it to use multiple threads.
+                    [default: None, which means to leave the current value, initially 512]
+    """
+    if not _galsim.FFTWHasThreads() and nthreads != 1:
+        galsim_warn("GalSim was not built with fftw3_threads.  Using a single thread for FFTs.")
+    if min_size is not None:
+        if min_size < 1:
+            raise GalSimValueError("min_size must be positive", min_size)
+        _galsim.SetFFTWThreadsMinSize(int(min_size))
+    _galsim.SetFFTWNumThreads(int(nthreads))
+
+def get_num_threads():
+    """Return the current number of threads FFTW may use for large transforms.
+    cf. `set_num_threads`
+    """
+    return _galsim.GetFFTWNumThreads()
+
+def draw_many(objects, images, add_to_image=False):
+    """Draw many profiles onto their own images using FFTs.
+
+    This is equivalent to::
+
+        >>> flux = [obj.drawFFT(im, add_to_image) for obj, im in zip(objects, images)]
+
+    but it is much faster when drawing many small stamps.  The stamps are grouped by FFT size,
+    the k-space images are filled in parallel in C++ (if GalSim was built with OpenMP), and
+    each group of stamps of the same size is transformed with a single batched FFT.
+
+    As with `GSObject.drawFFT`, the images must already have defined bounds and a `PixelScale`
+    wcs, and the profiles should already be in image coordinates.  The profiles are drawn
+    centered on (0,0), with no pixel convolution.  Images that are not float32 or float64 are
+    drawn one at a time with `GSObject.drawFFT`.  So are float32 images whose profile has
+    ``gsparams.single_precision_fft=True``, since the batched FFTs are always done in double
+    precision.
+
+    Parameters:
+        objects:        A list of `GSObject` instances to draw.
+        images:         A list of `Image` instances onto which to draw them.
+        add_to_image:   Whether to add flux to the existing images rather than clear out
+                        anything in the images before drawing. [default: False]
+
+    Returns:
+        a numpy array with the total flux drawn onto each image.
+    """
+    objects = list(objects)
+    images = list(images)
+    if len(objects) != len(images):
+        raise GalSimIncompatibleValuesError("objects and images must have the same length",
+                                            objects=objects, images=images)
+    added_flux = np.zeros(len(objects), dtype=float)
+
+    groups = { np.float64 : [], np.float32 : [] }
+    for i, (obj, image) in enumerate(zip(objects, images)):
+        if image.wcs is None or not image.wcs.isPixelScale():
+            raise GalSimValueError("draw_many requires images with a PixelScale wcs", image)
+        if image.dtype == np.float32 and obj.gsparams.single_precision_fft:
+            added_flux[i] = obj.drawFFT(image, add_to_image)
+        elif image.dtype in groups:
+            groups[image.dtype].append(i)
+        else:
+            added_flux[i] = obj.drawFFT(image, add_to_image)
+
+    for dtype, index in groups.items():
+        if len(index) == 0: continue
+        sizes = [ objects[i]._drawFFT_sizes(images[i]) for i in index ]
+        Nk = np.array([ s[0] for s in sizes ], dtype=np.int32)
+        N = np.array([ s[1] for s in sizes ], dtype=np.int32)
+        dk = np.array([ s[2] for s in sizes ], dtype=float)
+        for i, n in zip(index, N.tolist()):
+            # Same check drawFFT_finish makes when it takes the subimage of the real image.
+            breal = BoundsI(-n//2, n//2+1, -n//2, n//2-1)
+            if not breal.includes(images[i].bounds):
+                raise GalSimBoundsError("Attempt to access subImage not (fully) in image",
+                                        images[i].bounds, breal)
+        flux = np.empty(len(index), dtype=float)
+        draw_func = _galsim.drawFFTManyD if dtype == np.float64 else _galsim.drawFFTManyF
+        with convert_cpp_errors():
+            draw_func([ objects[i]._sbp for i in index ], [ images[i]._image for i in index ],
+                      Nk.ctypes.data, N.ctypes.data, dk.ctypes.data, add_to_image,
+                      flux.ctypes.data)
+        added_flux[index] = flux
+    return added_flux
@@ -187,6 +187,9 @@ class GSObject(object):
                       'integration_relerr' : float,
                       'integration_abserr' : float,
                       'shoot_accuracy' : float,
+                      'single_precision_fft' : bool,
+                      'tabulate_xval' : bool,
+                      'interpolate_sersic_n' : bool,
                       'allowed_flux_variation' : float,
                       'range_division_for_extrema' : int,
                       'small_fraction_of_flux' : float
@@ -1848,6 +1851,20 @@ class GSObject(object):
         """
         from .bounds import _BoundsI
         from .image import ImageCD, ImageCF
+        Nk, N, dk = self._drawFFT_sizes(image)
+        bounds = _BoundsI(0,Nk//2,-Nk//2,Nk//2)
+        if image.dtype in (np.complex128, np.float64, np.int32, np.uint32):
+            kimage = ImageCD(bounds=bounds, scale=dk)
+        else:
+            kimage = ImageCF(bounds=bounds, scale=dk)
+        return kimage, N
+
+    def _drawFFT_sizes(self, image):
+        """Return the sizes (Nk, N, dk) that drawFFT will use for drawing onto ``image``.
+
+        Nk is the size of the k-space image to draw, N is the size to wrap it to for the FFT,
+        and dk is the k-space pixel scale.
+        """
         # Start with what this profile thinks a good size would be given the image's pixel scale.
         N = self.getGoodImageSize(image.scale)
 
@@ -1873,13 +1890,7 @@ class GSObject(object):
 
         if Nk > self.gsparams.maximum_fft_size:
             raise GalSimFFTSizeError("drawFFT requires an FFT that is too large.", Nk)
-
-        bounds = _BoundsI(0,Nk//2,-Nk//2,Nk//2)
-        if image.dtype in (np.complex128, np.float64, np.int32, np.uint32):
-            kimage = ImageCD(bounds=bounds, scale=dk)
-        else:
-            kimage = ImageCF(bounds=bounds, scale=dk)
-        return kimage, N
+        return Nk, N, dk
 
     def drawFFT_finish(self, image, kimage, wrap_size, add_to_image):
         """
@@ -1909,7 +1920,10 @@ class GSObject(object):
 
         # Perform the fourier transform.
         breal = _BoundsI(-wrap_size//2, wrap_size//2+1, -wrap_size//2, wrap_size//2-1)
-        real_image = Image(breal, dtype=float)
+        if self.gsparams.single_precision_fft and image.dtype == np.float32:
+            real_image = Image(breal, dtype=np.float32)
+        else:
+            real_image = Image(breal, dtype=float)
         with convert_cpp_errors():
             _galsim.irfft(kimage_wrap._image, real_image._image, True, True)
 
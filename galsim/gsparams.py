@@ -110,6 +110,32 @@ class GSParams(object):
                             radial profile. When such approximations need to be made, it makes
                             sure that the resulting fractional error in the flux will be at
                             most this much. [default: 1.e-5]
+        single_precision_fft: Whether to do the FFT for a float32 image in single precision.
+                            By default, the inverse FFT in `GSObject.drawFFT` is done in double
+                            precision, even when the output image is float32.  Setting this to
+                            True does the whole calculation in single precision, which uses half
+                            the memory bandwidth and is typically faster for large images.
+                            The relative accuracy of the result is then only ~1.e-6, which is
+                            usually fine for float32 images.  (This requires GalSim to have been
+                            built with the fftw3f library; if not, the FFT is still done in double
+                            precision.) [default: False]
+        tabulate_xval:      Whether the `Cubic`, `Quintic` and `Lanczos` interpolants should use
+                            a precomputed lookup table for their real-space kernel rather than
+                            evaluating the analytic formula each time.  The table is built to be
+                            accurate to ``xvalue_accuracy``.  This mostly helps `Lanczos`, whose
+                            kernel needs several trig function calls to evaluate, when drawing
+                            an `InterpolatedImage` in real space. [default: False]
+        interpolate_sersic_n: Whether untruncated `Sersic` profiles should interpolate their
+                            Fourier transform, half-light radius and ``stepk`` from a grid of
+                            precomputed tables spanning the allowed range of n, rather than
+                            doing the Hankel transform and root finding for each new value of
+                            n.  The interpolation is accurate to about ``kvalue_accuracy``.
+                            This makes catalogues with continuous values of n about as fast as
+                            ones with a few fixed values.  The grid for the default parameters
+                            is read from a file in the GalSim share directory; for other
+                            parameters it is built the first time it is needed, which takes a
+                            few seconds, and is saved in the info cache directory if there is
+                            one. [default: False]
 
     After construction, all of the above parameters are available as read-only attributes.
     """
@@ -119,7 +145,8 @@ class GSParams(object):
                  realspace_relerr=1.e-4, realspace_abserr=1.e-6,
                  integration_relerr=1.e-6, integration_abserr=1.e-8,
                  shoot_accuracy=1.e-5, allowed_flux_variation=0.81,
-                 range_division_for_extrema=32, small_fraction_of_flux=1.e-4):
+                 range_division_for_extrema=32, small_fraction_of_flux=1.e-4,
+                 single_precision_fft=False, tabulate_xval=False, interpolate_sersic_n=False):
         self._minimum_fft_size = int(minimum_fft_size)
         self._maximum_fft_size = int(maximum_fft_size)
         self._folding_threshold = float(folding_threshold)
@@ -133,6 +160,9 @@ class GSParams(object):
         self._integration_relerr = float(integration_relerr)
         self._integration_abserr = float(integration_abserr)
         self._shoot_accuracy = float(shoot_accuracy)
+        self._single_precision_fft = bool(single_precision_fft)
+        self._tabulate_xval = bool(tabulate_xval)
+        self._interpolate_sersic_n = bool(interpolate_sersic_n)
 
         if allowed_flux_variation != 0.81:
             from .deprecated import depr
@@ -176,6 +206,12 @@ class GSParams(object):
     def integration_abserr(self): return self._integration_abserr
     @property
     def shoot_accuracy(self): return self._shoot_accuracy
+    @property
+    def single_precision_fft(self): return self._single_precision_fft
+    @property
+    def tabulate_xval(self): return self._tabulate_xval
+    @property
+    def interpolate_sersic_n(self): return self._interpolate_sersic_n
 
     @staticmethod
     def check(gsparams, default=None):
@@ -197,6 +233,8 @@ class GSParams(object):
 
         Uses the minimum value for most parameters. For the following parameters, it uses the
         maximum numerical value: minimum_fft_size, maximum_fft_size, stepk_minimum_hlr.
+        The single_precision_fft, tabulate_xval and interpolate_sersic_n options are only used
+        if all of the inputs have them.
         """
         if len(gsp_list) == 1:
             return gsp_list[0]
@@ -216,22 +254,33 @@ class GSParams(object):
                 min([g.realspace_abserr for g in gsp_list]),
                 min([g.integration_relerr for g in gsp_list]),
                 min([g.integration_abserr for g in gsp_list]),
-                min([g.shoot_accuracy for g in gsp_list]))
+                min([g.shoot_accuracy for g in gsp_list]),
+                single_precision_fft=all([g.single_precision_fft for g in gsp_list]),
+                tabulate_xval=all([g.tabulate_xval for g in gsp_list]),
+                interpolate_sersic_n=all([g.interpolate_sersic_n for g in gsp_list]))
 
-    # Define once the order of args in __init__, since we use it a few times.
+    # Define once the order of args for the C++ GSParams constructor, since we use it a few times.
+    # This is the order of the args in __init__, except that the deprecated parameters are
+    # skipped, so the last three options have to be given to __init__ by keyword.
     def _getinitargs(self):
         return (self.minimum_fft_size, self.maximum_fft_size,
                 self.folding_threshold, self.stepk_minimum_hlr, self.maxk_threshold,
                 self.kvalue_accuracy, self.xvalue_accuracy, self.table_spacing,
                 self.realspace_relerr, self.realspace_abserr,
                 self.integration_relerr, self.integration_abserr,
-                self.shoot_accuracy)
+                self.shoot_accuracy, self.single_precision_fft, self.tabulate_xval,
+                self.interpolate_sersic_n)
+
+    _option_names = ('single_precision_fft', 'tabulate_xval', 'interpolate_sersic_n')
 
     def __getstate__(self): return self._getinitargs()
-    def __setstate__(self, state): self.__init__(*state)
+    def __setstate__(self, state):
+        # Older pickles only have the first 13 values.
+        self.__init__(*state[:13], **dict(zip(self._option_names, state[13:])))
 
     def __repr__(self):
-        return 'galsim.GSParams(%r,%r,%r,%r,%r,%r,%r,%r,%r,%r,%r,%r,%r)'% \
+        return ('galsim.GSParams(%r,%r,%r,%r,%r,%r,%r,%r,%r,%r,%r,%r,%r,'
+                'single_precision_fft=%r, tabulate_xval=%r, interpolate_sersic_n=%r)')% \
                 self._getinitargs()
 
     def __eq__(self, other):
@@ -19,6 +19,7 @@
 import numpy as np
 import math
 
+from . import _galsim
 from .image import Image, ImageD
 from .utilities import doc_inherit
 from .errors import GalSimError, GalSimIncompatibleValuesError
@@ -114,6 +115,11 @@ class BaseNoise(object):
     a way to check if an object is a valid noise object with::
 
         >>> isinstance(noise, galsim.BaseNoise)
+
+    If the ``rng`` uses the 'philox' engine (cf. `BaseDeviate`), `GaussianNoise`, `PoissonNoise`
+    and `CCDNoise` are applied to real-valued images in parallel.  The image is split into tiles,
+    each of which draws from its own substream of the ``rng``, so the result is the same for any
+    number of threads.  Only one value is drawn from ``rng`` itself for each image.
     """
     def __init__(self, rng=None):
         from .random import BaseDeviate
@@ -208,6 +214,10 @@ class BaseNoise(object):
             raise TypeError("Provided image must be a galsim.Image")
         return self._applyTo(image)
 
+    def _use_tiles(self, image):
+        # Whether to apply the noise with the parallel tiled functions.
+        return self.rng.engine == 'philox' and not image.iscomplex and not image.isconst
+
     def _applyTo(self, image):
         raise NotImplementedError("Cannot call applyTo on a pure BaseNoise object")
 
@@ -255,6 +265,9 @@ class GaussianNoise(BaseNoise):
         return self._sigma
 
     def _applyTo(self, image):
+        if self._use_tiles(image):
+            _galsim.AddGaussianNoise(image._image, self.rng._rng, self.sigma)
+            return
         self._gd.clearCache()
         noise_array = np.empty(np.prod(image.array.shape), dtype=float)
         self._gd.generate(noise_array)
@@ -328,6 +341,9 @@ class PoissonNoise(BaseNoise):
         return self._sky_level
 
     def _applyTo(self, image):
+        if self._use_tiles(image):
+            _galsim.AddCCDNoise(image._image, self.rng._rng, self.sky_level, 1., 0.)
+            return
         noise_array = np.empty(np.prod(image.array.shape), dtype=float)
         noise_array.reshape(image.array.shape)[:,:] = image.array
 
@@ -461,6 +477,10 @@ class CCDNoise(BaseNoise):
         return self._read_noise
 
     def _applyTo(self, image):
+        if self._use_tiles(image):
+            _galsim.AddCCDNoise(image._image, self.rng._rng, self.sky_level, self.gain,
+                                self.read_noise)
+            return
         noise_array = np.empty(np.prod(image.array.shape), dtype=float)
         noise_array.reshape(image.array.shape)[:,:] = image.array
 
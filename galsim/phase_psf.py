@@ -23,6 +23,7 @@ from builtins import range
 from heapq import heappush, heappop
 import numpy as np
 
+from . import _galsim
 from .gsobject import GSObject
 from .gsparams import GSParams
 from .angle import radians, degrees, arcsec, Angle, AngleUnit
@@ -780,8 +781,11 @@ class PhaseScreenList(object):
         # dummy rng sentinel attribute so do_pickle() will know to skip the obj == eval(repr(obj))
         # test.
         self.__dict__.pop('rng', None)
+        from .phase_screens import AtmosphericScreen
         self.dynamic = any(l.dynamic for l in self)
         self.reversible = all(l.reversible for l in self)
+        self._use_engine = self.reversible and all(
+            isinstance(l, AtmosphericScreen) or not l.dynamic for l in self)
         self.__dict__.pop('r0_500_effective', None)
 
     def _seek(self, t):
@@ -851,6 +855,24 @@ class PhaseScreenList(object):
             self._update_time_heap = []
             return
 
+        # If all of the time-evolving screens are frozen AtmosphericScreens, then the time steps
+        # are independent of each other, so we can do all the steps for each PSF at once in C++,
+        # in parallel across the time steps.
+        if self._use_engine:
+            t_last = None
+            for _, psfref in self._pending:
+                psf = psfref()
+                if psf is not None:
+                    times = psf._step_times()
+                    psf._integrate(times)
+                    psf._finalize()
+                    t_last = times[-1] if t_last is None else max(t_last, times[-1])
+            self._pending = []
+            self._update_time_heap = []
+            if t_last is not None:
+                self._seek(t_last)
+            return
+
         # If we do have time-evolving screens, then iteratively increment the time while being
         # careful to always stop at multiples of each PSF's time_step attribute to update that PSF.
         # Use a heap (in _pending list) to track the next time to stop at.
@@ -1431,6 +1453,56 @@ class PhaseScreenPSF(GSObject):
         if self._bar:  # pragma: no cover
             self._bar.update()
 
+    def _step_times(self):
+        """The times at which _step would be called while integrating this PSF."""
+        # Accumulate the same way as PhaseScreenList._prepareDraw, so the times match exactly.
+        times = [self.t0]
+        t = self.t0 + self.time_step
+        while t < self.t0 + self.exptime:
+            times.append(t)
+            t += self.time_step
+        return times
+
+    def _integrate(self, times):
+        """Add the instantaneous PSFs at each of the given times to the developing integrated PSF.
+
+        This is equivalent to seeking to each time and calling _step, but all the time steps are
+        done together in C++.  It requires every time-dependent screen to be a frozen
+        AtmosphericScreen.
+        """
+        from .phase_screens import AtmosphericScreen
+        self._screen_list.instantiate(check='FFT')
+        u = self.aper.u_illuminated
+        v = self.aper.v_illuminated
+        index = np.flatnonzero(self.aper.illuminated).astype(np.int32)
+        ny, nx = self.aper.illuminated.shape
+        engine = _galsim.PhaseScreenEngine(u.ctypes.data, v.ctypes.data, index.ctypes.data,
+                                           len(u), nx, ny)
+        # The engine doesn't copy the tables or fixed wavefronts, so keep them alive here.
+        keep = []
+        for layer in self._screen_list:
+            if isinstance(layer, AtmosphericScreen):
+                tab = layer._tab2d
+                keep.append(tab)
+                engine.addTableLayer(tab._tab, tab.x0, tab.y0, tab.xperiod, tab.yperiod,
+                                     layer.vx, layer.vy, layer._altitude)
+            else:
+                wf = np.empty_like(u)
+                wf[:] = layer._wavefront(u, v, None, self.theta)
+                keep.append(wf)
+                engine.addFixedLayer(wf.ctypes.data)
+
+        if self._img is None:
+            self._img = np.zeros(self.aper.illuminated.shape, dtype=np.float64)
+        img = _Image(self._img, _BoundsI(1,nx,1,ny), None)
+        times = np.array(times, dtype=float)
+        tanx = self.theta[0].tan() if self.theta[0].rad != 0. else 0.
+        tany = self.theta[1].tan() if self.theta[1].rad != 0. else 0.
+        engine.integrate(img._image, times.ctypes.data, len(times), self.lam, tanx, tany)
+        if self._bar:  # pragma: no cover
+            for _ in range(len(times)):
+                self._bar.update()
+
     def _finalize(self):
         """Take accumulated integrated PSF image and turn it into a proper GSObject."""
         self._img *= self._flux / self._img.sum(dtype=float)
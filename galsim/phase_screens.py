@@ -21,12 +21,12 @@ import sys
 import numpy as np
 import multiprocessing
 
-from .random import BaseDeviate, GaussianDeviate
+from . import _galsim
+from .random import BaseDeviate
 from .image import Image
 from .angle import radians
 from .table import LookupTable2D, _LookupTable2D
 from . import utilities
-from . import fft
 from . import zernike
 from .utilities import LRU_Cache, lazy_property
 from .errors import (GalSimRangeError, GalSimValueError, GalSimIncompatibleValuesError, galsim_warn,
@@ -534,9 +534,13 @@ class AtmosphericScreen(object):
 
     def _random_screen(self):
         """Generate a random phase screen with power spectrum given by self._psi**2"""
-        gd = GaussianDeviate(self.rng)
-        noise = utilities.rand_arr(self._psi.shape, gd)
-        return fft.ifft2(fft.fft2(noise)*self._psi).real
+        # This is equivalent to
+        #     noise = utilities.rand_arr(self._psi.shape, GaussianDeviate(self.rng))
+        #     return fft.ifft2(fft.fft2(noise)*self._psi).real
+        # but it avoids the temporary arrays.
+        screen = np.empty_like(self._psi)
+        _galsim.MakeRandomPhaseScreen(Image(screen)._image, Image(self._psi)._image, self.rng._rng)
+        return screen
 
     def _setShare(self):
         tab2d = LookupTable2D(self._xs, self._ys, self._screen, edge_mode='wrap')
@@ -583,9 +587,8 @@ class AtmosphericScreen(object):
             final_update_number = int(t // self.time_step)
             n_updates = final_update_number - previous_update_number
             if n_updates > 0:
-                for _ in range(n_updates):
-                    self._screen *= self.alpha
-                    self._screen += np.sqrt(1.-self.alpha**2) * self._random_screen()
+                _galsim.BoilPhaseScreen(Image(self._screen)._image, Image(self._psi)._image,
+                                        self.rng._rng, self.alpha, n_updates)
                 # Make a table, copy the x,y,f arrays to shared memory, make a new table that
                 # points to those locations.
                 self._setShare()
@@ -65,12 +65,46 @@ class BaseDeviate(object):
         >>> ud2 = galsim.UniformDeviate(215324)
         >>> ud2()
         0.58736140513792634
+
+    **Engines**:
+
+    The underlying random number generator (the "engine") may be either of the following.
+    It can only be chosen when constructing a BaseDeviate.  Other deviates get their engine from
+    the BaseDeviate used to seed them, and otherwise use the default.
+
+    * 'mt19937' is the Mersenne Twister.  This is the default, and it gives the same sequences
+      for a given seed as all earlier versions of GalSim.
+    * 'philox' is the Philox4x32-10 counter-based generator.  This is faster for filling large
+      arrays with `UniformDeviate.generate`, `GaussianDeviate.generate` and
+      `GaussianDeviate.generate_from_variance` (and hence for adding noise to large images), and
+      `discard` takes the same time for any n.  Its sequences are different from the
+      'mt19937' ones.
+
+    Parameters:
+        seed:       Something that can seed a `BaseDeviate`: an integer seed, a serialization
+                    string, or another `BaseDeviate`.  Using 0 means to generate a seed from
+                    the system. [default: None]
+        engine:     Which random number engine to use: 'mt19937' or 'philox'.  This is ignored
+                    if seed is another `BaseDeviate` or a serialization string, since then the
+                    engine is the one given by seed. [default: 'mt19937']
     """
-    def __init__(self, seed=None):
+    _engines = ('mt19937', 'philox')
+    _engine = 'mt19937'
+
+    def __init__(self, seed=None, engine='mt19937'):
+        if engine not in BaseDeviate._engines:
+            raise GalSimValueError("Invalid engine", engine, BaseDeviate._engines)
         self._rng_type = _galsim.BaseDeviateImpl
         self._rng_args = ()
+        self._engine = engine
         self.reset(seed)
 
+    @property
+    def engine(self):
+        """The name of the random number engine being used: 'mt19937' or 'philox'.
+        """
+        return self._engine
+
     def seed(self, seed=0):
         """Seed the pseudo-random number generator with a given integer value.
 
@@ -97,18 +131,23 @@ class BaseDeviate(object):
             seed:       Something that can seed a `BaseDeviate`: an integer seed or another
                         `BaseDeviate`.  Using None means to generate a seed from the system.
                         [default: None]
+
+        An integer seed keeps the current engine.
         """
         if isinstance(seed, BaseDeviate):
             self._reset(seed)
         elif isinstance(seed, str):
             with convert_cpp_errors():
                 self._rng = self._rng_type(_galsim.BaseDeviateImpl(seed), *self._rng_args)
+            self._engine = self._rng.getEngine()
         elif seed is None:
             with convert_cpp_errors():
-                self._rng = self._rng_type(_galsim.BaseDeviateImpl(0), *self._rng_args)
+                self._rng = self._rng_type(_galsim.BaseDeviateImpl(0, self._engine),
+                                           *self._rng_args)
         elif isinteger(seed):
             with convert_cpp_errors():
-                self._rng = self._rng_type(_galsim.BaseDeviateImpl(int(seed)), *self._rng_args)
+                self._rng = self._rng_type(_galsim.BaseDeviateImpl(int(seed), self._engine),
+                                           *self._rng_args)
         else:
             raise TypeError("BaseDeviate must be initialized with either an int or another "
                             "BaseDeviate")
@@ -119,6 +158,7 @@ class BaseDeviate(object):
         """
         with convert_cpp_errors():
             self._rng = self._rng_type(rng._rng, *self._rng_args)
+        self._engine = rng._engine
 
     def duplicate(self):
         """Create a duplicate of the current `BaseDeviate` object.
@@ -424,15 +464,37 @@ class PoissonDeviate(BaseDeviate):
         """
         return self._rng.generate1()
 
-    def generate_from_expectation(self, array):
+    def generate_from_expectation(self, array, normal_threshold=None):
         """Generate many Poisson deviate values using the existing array values as the
         expectation value (aka mean) for each.
+
+        With the default 'mt19937' engine and no ``normal_threshold``, the values are the same
+        as setting the mean and drawing a value for each element in turn.
+
+        If ``normal_threshold`` is given, or the engine is 'philox', a sampler designed for
+        arrays with many different expectation values is used instead.  Values below 10 use
+        inversion with a table of cumulative probabilities, values up to ``normal_threshold``
+        use the PTRS transformed rejection method for all of them at once, and values above
+        ``normal_threshold`` use a normal approximation rounded to an integer.  The relative
+        error of the normal approximation in the tails is of order 1/sqrt(mean), so this
+        should only be set as low as your application can tolerate.
+
+        Parameters:
+            array:              The array of expectation values, which are replaced by the
+                                Poisson deviates.
+            normal_threshold:   The expectation value above which to use a normal
+                                approximation.  [default: None, which means 2**30 when the
+                                fast sampler is used]
         """
         if np.any(array < 0):
             raise GalSimValueError("Expectation array may not have values < 0.", array)
         array_1d = np.ascontiguousarray(array.ravel(), dtype=float)
         #assert(array_1d.strides[0] == array_1d.itemsize)
-        self._rng.generate_from_expectation(len(array_1d), array_1d.ctypes.data)
+        if normal_threshold is None:
+            self._rng.generate_from_expectation(len(array_1d), array_1d.ctypes.data)
+        else:
+            self._rng.generate_from_expectation_batch(len(array_1d), array_1d.ctypes.data,
+                                                      float(normal_threshold))
         if array_1d.data != array.data:
             # array_1d is not a view into the original array.  Need to copy back.
             np.copyto(array, array_1d.reshape(array.shape), casting='unsafe')
@@ -18,8 +18,10 @@
 
 import numpy as np
 import math
+import os
 
 from . import _galsim
+from . import meta_data
 from .gsobject import GSObject
 from .gsparams import GSParams
 from .utilities import lazy_property, doc_inherit
@@ -62,6 +64,15 @@ class Sersic(GSObject):
     considering the use of only discrete n values rather than allowing it to vary continuously.  For
     more details, see https://github.com/GalSim-developers/GalSim/issues/566.
 
+    Alternatively, you can set ``interpolate_sersic_n=True`` in the `GSParams`.  Then untruncated
+    Sersic profiles get their Hankel transform tables by interpolating a precomputed grid of tables
+    in n, which is about as fast as reusing a cached value of n.  The grid for the default
+    parameters is read from a file in the GalSim share directory, so it costs almost nothing to
+    start using it.  For other parameters, it is built the first time it is needed, which takes
+    a few seconds.  If the info cache is enabled (see `utilities.set_info_cache_dir`), it is
+    saved there and read back in by later runs.  You can also save it yourself with
+    `write_sersic_grid` and load it in later runs with `load_sersic_grid`.
+
     Note that if you are building many Sersic profiles using truncation, the code will be more
     efficient if the truncation is always the same multiple of ``scale_radius``, since it caches
     many calculations that depend on the ratio ``trunc/scale_radius``.
@@ -429,3 +440,43 @@ class DeVaucouleurs(Sersic):
     def withFlux(self, flux):
         return DeVaucouleurs(scale_radius=self.scale_radius, trunc=self.trunc, flux=flux,
                              gsparams=self.gsparams)
+
+
+def write_sersic_grid(file_name, gsparams=None):
+    """Write the grid of Sersic tables used when ``interpolate_sersic_n`` is set to a file.
+
+    The grid is built first if it hasn't been already.  The file can be read back in with
+    `load_sersic_grid`.  It is a binary file, which is only valid on machines with the same
+    byte order and size of a double.
+
+    Parameters:
+        file_name:  The name of the file to write.
+        gsparams:   The `GSParams` to use for the grid.  (interpolate_sersic_n is taken to be
+                    True regardless of its value here.)  [default: None, which means use the
+                    default GSParams]
+    """
+    gsparams = GSParams.check(gsparams)
+    with convert_cpp_errors():
+        _galsim.WriteSersicGrid(file_name, gsparams._gsp)
+
+def load_sersic_grid(file_name, gsparams=None):
+    """Load a grid of Sersic tables written by `write_sersic_grid`.
+
+    Subsequent `Sersic` profiles with these gsparams (and ``interpolate_sersic_n=True``) will
+    use this grid rather than building a new one.
+
+    Parameters:
+        file_name:  The name of the file to read.
+        gsparams:   The `GSParams` that the grid should be for.  [default: None, which means use
+                    the default GSParams]
+
+    Returns:
+        whether the file had a valid grid for these gsparams.
+    """
+    gsparams = GSParams.check(gsparams)
+    with convert_cpp_errors():
+        return _galsim.LoadSersicGrid(file_name, gsparams._gsp)
+
+# The grid for the default GSParams is shipped in the share directory.  The C++ layer reads it
+# the first time it needs a grid for those GSParams.
+_galsim.SetSersicGridFile(os.path.join(meta_data.share_dir, 'sersic_grid.dat'))
@@ -849,6 +849,71 @@ class LookupTable2D(object):
                 dfdy = dfdy.reshape(x1.shape)
             return dfdx, dfdy
 
+    def _value_gradient_inbounds(self, x, y, grid=False):
+        if grid:
+            f = np.empty((len(x), len(y)), dtype=float)
+            dfdx = np.empty((len(x), len(y)), dtype=float)
+            dfdy = np.empty((len(x), len(y)), dtype=float)
+            self._tab.interpGradGrid(x.ctypes.data, y.ctypes.data, f.ctypes.data,
+                                     dfdx.ctypes.data, dfdy.ctypes.data, len(x), len(y))
+        else:
+            f = np.empty_like(x, dtype=float)
+            dfdx = np.empty_like(x, dtype=float)
+            dfdy = np.empty_like(x, dtype=float)
+            self._tab.interpGradMany(x.ctypes.data, y.ctypes.data, f.ctypes.data,
+                                     dfdx.ctypes.data, dfdy.ctypes.data, len(x))
+        return f, dfdx, dfdy
+
+    def value_and_gradient(self, x, y, grid=False):
+        """Calculate both the interpolated value and the gradient of the function at an
+        arbitrary point or points.
+
+        This gives the same answer as calling the table and its `gradient` method separately,
+        but it is faster, since the interpolation only needs to be set up once for each point.
+
+        Parameters:
+            x:      Either a single x value or an array of x values.
+            y:      Either a single y value or an array of y values.
+            grid:   Optional boolean indicating that output should be 2D arrays corresponding
+                    to the outer product of input values.  If False (default), then the output
+                    arrays will be congruent to x and y.
+
+        Returns:
+            A tuple of (f, dfdx, dfdy) where each is a single value (if x,y were single
+            values) or a numpy array.
+        """
+        x1 = np.array(x, dtype=float, copy=self.edge_mode=='wrap')
+        y1 = np.array(y, dtype=float, copy=self.edge_mode=='wrap')
+        x2 = np.ascontiguousarray(x1.ravel(), dtype=float)
+        y2 = np.ascontiguousarray(y1.ravel(), dtype=float)
+
+        if self.edge_mode == 'wrap':
+            x2, y2 = self._wrap_args(x2, y2)
+            f, dfdx, dfdy = self._value_gradient_inbounds(x2, y2, grid)
+        elif self._inbounds(x2, y2):
+            f, dfdx, dfdy = self._value_gradient_inbounds(x2, y2, grid)
+        elif self.edge_mode == 'raise':
+            pos = find_out_of_bounds_position(x2, y2, self._bounds, grid)
+            raise GalSimBoundsError("Extrapolating beyond input range.",
+                                    pos, self._bounds)
+        else:
+            if self.edge_mode == 'warn':
+                pos = find_out_of_bounds_position(x2, y2, self._bounds, grid)
+                galsim_warn("Extrapolating beyond input range. {!r} not in {!r}".format(
+                            pos, self._bounds))
+            # The constant values need special handling, so just do these separately.
+            f = self._call_constant(x2, y2, grid)
+            dfdx, dfdy = self._gradient_constant(x2, y2, grid)
+
+        if isinstance(x, numbers.Real):
+            return f[0], dfdx[0], dfdy[0]
+        else:
+            if not grid:
+                f = f.reshape(x1.shape)
+                dfdx = dfdx.reshape(x1.shape)
+                dfdy = dfdy.reshape(x1.shape)
+            return f, dfdx, dfdy
+
     def __str__(self):
         return ("galsim.LookupTable2D(x=[%s,...,%s], y=[%s,...,%s], "
                 "f=[[%s,...,%s],...,[%s,...,%s]], interpolant=%r, edge_mode=%r)"%(
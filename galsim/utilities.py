@@ -1864,3 +1864,106 @@ def set_omp_threads(num_threads, logger=None):
             logger.warning("Unable to use multiple threads, since OpenMP is not enabled.")
 
     return num_threads
+
+def set_info_cache_dir(dir):
+    """Set the directory to use for the on-disk cache of profile calculations.
+
+    Some profiles (e.g. Sersic, Spergel, Kolmogorov, VonKarman, SecondKick, Airy, Exponential)
+    need to do some fairly expensive calculations, such as tabulating their Fourier transforms
+    or setting up their photon-shooting samplers, the first time a given set of parameters
+    and GSParams is used.  These are normally kept in memory only for the life of the process.
+
+    If a cache directory is set, each of these calculations is first looked for there, and
+    if it is not found, it is done in full and then written there.  Later processes using the
+    same directory can then skip the calculation.  Several processes may safely use the same
+    directory at once.  The files are only valid on machines with the same architecture.
+
+    The default is the value of the GALSIM_INFO_CACHE_DIR environment variable if it is set,
+    and otherwise no on-disk cache.
+
+    Parameters:
+        dir:    The directory to use.  It is created if it does not exist.  None or ''
+                turns the on-disk cache off.
+    """
+    if dir is None:
+        dir = ''
+    elif dir != '' and not os.path.isdir(dir):
+        os.makedirs(dir)
+    _galsim.SetInfoCacheDir(dir)
+
+def get_info_cache_dir():
+    """Get the directory being used for the on-disk cache of profile calculations.
+
+    See `set_info_cache_dir` for details.
+
+    Returns:
+        the directory name, or None if there is no on-disk cache.
+    """
+    return _galsim.GetInfoCacheDir() or None
+
+def cache_names():
+    """Get the names of the in-memory caches of profile calculations.
+
+    Many of the calculations described in `set_info_cache_dir` are also kept in memory, in
+    caches that remove the least recently used entries once they reach their size limits.
+    The functions `get_cache_stats`, `reset_cache_stats`, `set_cache_size` and `clear_cache`
+    take one of these names.
+
+    Returns:
+        a list of the cache names, e.g. 'Sersic', 'Kolmogorov', 'InterpolatedImage'.
+    """
+    return list(_galsim.GetLRUCacheNames())
+
+def get_cache_stats(name):
+    """Get the statistics of one of the in-memory caches of profile calculations.
+
+    The returned object has the following attributes:
+
+        nhit:           The number of times a calculation was found in the cache.
+        nmiss:          The number of times a calculation was not found, so it was done in full.
+        nevict:         The number of entries removed to stay within the size limits.
+        build_time:     The total time spent doing the calculations that were not found, in
+                        seconds.
+        nentries:       The number of entries currently in the cache.
+        nbytes:         An estimate of the memory used by the current entries, in bytes.
+        max_entries:    The maximum number of entries to keep (0 means no limit).
+        max_bytes:      The maximum memory to use for the entries (0 means no limit).
+
+    Parameters:
+        name:   The name of the cache.  See `cache_names` for the valid names.
+
+    Returns:
+        the statistics of the cache.
+    """
+    return _galsim.GetLRUCacheStats(name)
+
+def reset_cache_stats(name):
+    """Reset the nhit, nmiss, nevict and build_time counts of an in-memory cache to 0.
+
+    Parameters:
+        name:   The name of the cache.  See `cache_names` for the valid names.
+    """
+    _galsim.ResetLRUCacheStats(name)
+
+def set_cache_size(name, max_entries, max_bytes):
+    """Set the size limits of one of the in-memory caches of profile calculations.
+
+    If the cache is currently larger than the new limits, the least recently used entries
+    are removed right away.
+
+    Parameters:
+        name:           The name of the cache.  See `cache_names` for the valid names.
+        max_entries:    The maximum number of entries to keep.  0 means no limit.
+        max_bytes:      The maximum memory to use for the entries, in bytes.  0 means no limit.
+    """
+    _galsim.SetLRUCacheSize(name, max_entries, max_bytes)
+
+def clear_cache(name):
+    """Remove all the entries from one of the in-memory caches of profile calculations.
+
+    The size limits and statistics of the cache are not changed.
+
+    Parameters:
+        name:   The name of the cache.  See `cache_names` for the valid names.
+    """
+    _galsim.ClearLRUCache(name)
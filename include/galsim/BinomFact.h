@@ -18,9 +18,9 @@
  */
 
 // Binomial coefficients and factorials
-// These compute the value the first time for a given i or (i,j), and then store
-// it for future use.  So if you are doing a lot of these, they become effectively
-// constant time functions rather than linear in the value of i.
+// These are looked up in tables that are built the first time they are needed, so if you
+// are doing a lot of these, they are effectively constant time functions rather than linear
+// in the value of i.  The tables are never modified after that, so these are thread-safe.
 
 #ifndef GalSim_BinomFactH
 #define GalSim_BinomFactH
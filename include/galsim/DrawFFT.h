@@ -0,0 +1,65 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#ifndef GalSim_DrawFFT_H
+#define GalSim_DrawFFT_H
+
+#include <vector>
+
+#include "Std.h"
+#include "Image.h"
+#include "SBProfile.h"
+
+namespace galsim {
+
+    /**
+     * @brief Draw many profiles onto their own stamps using FFTs.
+     *
+     * This is equivalent to calling GSObject.drawFFT in Python for each (profile, image) pair,
+     * but it is much faster when drawing many small stamps:
+     *
+     *  - The stamps are grouped by FFT size, and each group is transformed with a single
+     *    batched FFTW plan rather than one transform per stamp.
+     *  - The k-space images are filled in parallel (if OpenMP is available), using the
+     *    per-thread scratch arenas for the temporary k-space images.
+     *  - The wrapping and the extraction of the target bounds are done in the same pass
+     *    as the fill and the copy, so no intermediate Python-level images are needed.
+     *
+     * For stamp k, the profile is drawn in k-space on a grid with Nk[k] x Nk[k] points and
+     * spacing dk[k], which is wrapped onto N[k] x N[k] before the inverse FFT.  These are the
+     * values that GSObject.drawFFT_makeKImage computes.  The profiles must already be in image
+     * coordinates and the images must have a pixel scale of 2pi / (N[k] dk[k]).
+     *
+     * @param[in] profiles      The profiles to draw.
+     * @param[in] images        The target images.
+     * @param[in] Nk            The size of the k-space image to draw for each stamp.
+     * @param[in] N             The size of the FFT to use for each stamp.  Must be even.
+     * @param[in] dk            The k-space pixel scale for each stamp.
+     * @param[in] add_to_image  Whether to add to the existing images rather than replace them.
+     * @param[out] added_flux   The total flux drawn onto each image.
+     */
+    template <typename T>
+    void drawFFTMany(const std::vector<SBProfile>& profiles, std::vector<ImageView<T> >& images,
+                     const std::vector<int>& Nk, const std::vector<int>& N,
+                     const std::vector<double>& dk, bool add_to_image,
+                     std::vector<double>& added_flux);
+
+}
+
+#endif
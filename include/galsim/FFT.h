@@ -60,6 +60,7 @@
 #include <stdexcept>
 #include <deque>
 #include <complex>
+#include <mutex>
 
 #include <fftw3.h>
 
@@ -113,7 +114,7 @@ namespace galsim {
         size_t size_2d(size_t n) { return n*(n/2+1); }
     };
 
-    // Handle the FFTW3 memory allocation, which assured 16-bit alignment for SSE usage.
+    // Handle the FFTW3 memory allocation, which assures 64-byte alignment for SIMD usage.
     // FFTW3 now states that C++ complex<double> will be bit-compatible with
     // the fftw_complex type.  So all interfaces will be through std::complex<double>
     // And the fftw real type is now just double.
@@ -177,6 +178,105 @@ namespace galsim {
 
     //! @endcond
 
+    /**
+     * @brief How much effort FFTW should spend finding a fast plan for each new transform size.
+     *
+     * The plans are cached, so the planning cost is only paid the first time a given size
+     * (and direction and alignment) is used in a process.  ESTIMATE is the default and is
+     * essentially free.  MEASURE and PATIENT can give noticeably faster transforms for
+     * sizes that are used repeatedly, especially when combined with ImportFFTWWisdom.
+     */
+    enum FFTWPlanMode { FFTW_PLAN_ESTIMATE=0, FFTW_PLAN_MEASURE=1, FFTW_PLAN_PATIENT=2 };
+
+    //@{
+    /// Set or get the planning mode used for any plans that are not already cached.
+    void SetFFTWPlanMode(int mode);
+    int GetFFTWPlanMode();
+    //@}
+
+    /// Return whether GalSim was built with the fftw3_threads library.
+    bool FFTWHasThreads();
+
+    //@{
+    /**
+     * @brief Set or get the number of threads FFTW may use for a single large transform.
+     *
+     * Transforms with Nx * Ny >= min_size^2 will use nthreads threads.  Smaller transforms
+     * always run single-threaded, since for them the threading overhead outweighs the gain.
+     * nthreads <= 0 means to use the number of available cores.
+     *
+     * If GalSim was not built with fftw3_threads (cf. FFTWHasThreads), all transforms are
+     * single-threaded and SetFFTWNumThreads has no effect.
+     */
+    void SetFFTWNumThreads(int nthreads);
+    int GetFFTWNumThreads();
+    void SetFFTWThreadsMinSize(int min_size);
+    int GetFFTWThreadsMinSize();
+    //@}
+
+    /**
+     * @brief Destroy all cached FFTW plans.
+     *
+     * The plan caches are LRUCaches named "FFTWPlan" and "FFTWFPlan" (for single precision),
+     * which keep up to 200 plans each by default.  Their limits can be changed with
+     * SetLRUCacheSize.
+     */
+    void ClearFFTWPlanCache();
+
+    /// Return the number of FFTW plans currently cached.
+    int GetFFTWPlanCacheSize();
+
+    //@{
+    /**
+     * @brief Read or write FFTW's accumulated wisdom from/to a file.
+     *
+     * This lets a new process skip the expensive MEASURE or PATIENT planning for any
+     * sizes that a previous process already measured.  Throws an FFTError if the file
+     * cannot be opened or read.
+     */
+    void ImportFFTWWisdom(const std::string& file_name);
+    void ExportFFTWWisdom(const std::string& file_name);
+    //@}
+
+    //@{
+    /**
+     * @brief Execute a 2d FFT of size Ny x Nx using a cached plan.
+     *
+     * The arrays follow the normal FFTW layout conventions.  in and out may be the same
+     * pointer for an in-place transform.  The plan cache is keyed by the transform type,
+     * size, whether it is in place, and the memory alignment of the arrays, so these may
+     * be called with any arrays and from any thread.  If a plan for the same key was
+     * already made with more rigorous planning (e.g. by fftwMeasure), that one is used.
+     */
+    void ExecuteFFT_r2c(int Ny, int Nx, double* in, std::complex<double>* out);
+    void ExecuteFFT_c2r(int Ny, int Nx, std::complex<double>* in, double* out);
+    void ExecuteFFT_c2c(int Ny, int Nx, std::complex<double>* in, std::complex<double>* out,
+                        bool inverse);
+    //@}
+
+    /// Return whether GalSim was built with the single-precision fftw3f library.
+    bool FFTWHasSinglePrecision();
+
+    //@{
+    /**
+     * @brief Single-precision versions of ExecuteFFT_r2c and ExecuteFFT_c2r.
+     *
+     * These use fftw3f if GalSim was built with it (cf. FFTWHasSinglePrecision).
+     * Otherwise, the transform is done in double precision and converted.
+     */
+    void ExecuteFFT_r2c(int Ny, int Nx, float* in, std::complex<float>* out);
+    void ExecuteFFT_c2r(int Ny, int Nx, std::complex<float>* in, float* out);
+    //@}
+
+    /**
+     * @brief Execute howmany Ny x Nx complex-to-real FFTs with a single cached plan.
+     *
+     * The howmany input arrays are stored contiguously, each with Ny * (Nx/2+1) elements.
+     * The output arrays are likewise contiguous, each with Ny * Nx elements, or with the
+     * padded Ny * 2(Nx/2+1) layout if in and out are the same memory.
+     */
+    void ExecuteFFTMany_c2r(int howmany, int Ny, int Nx, std::complex<double>* in, double* out);
+
     class XTable;
 
     /**
@@ -249,6 +349,42 @@ namespace galsim {
         /// interpolate to k=(kx, ky) - WILL wrap k values to fill interpolant kernel
         std::complex<double> interpolate(double kx, double ky, const Interpolant2d& interp) const;
 
+        /**
+         * @brief Interpolate onto a regular grid of points (kx0 + i dkx, ky0 + j dky) using a
+         * separable interpolant.
+         *
+         * The result for each point is the same as interpolate(kx, ky, InterpolantXY(interp)).
+         * The kernel weights and the wrapped table indices are computed once per column and
+         * once per row, and the 2-d sum is done as two 1-d passes, parallelized with OpenMP
+         * when that is available.
+         *
+         * @param[out] ptr      The output array; point (i,j) is written to ptr[i + j*stride].
+         * @param[in] m         The number of columns.
+         * @param[in] n         The number of rows.
+         * @param[in] stride    The stride between rows of the output array.
+         * @param[in] kx0, dkx  The kx values to interpolate to are kx0 + i dkx.
+         * @param[in] ky0, dky  The ky values to interpolate to are ky0 + j dky.
+         * @param[in] interp    The 1-d interpolant to use in each direction.
+         */
+        template <typename T>
+        void interpolateGrid(std::complex<T>* ptr, int m, int n, int stride,
+                             double kx0, double dkx, double ky0, double dky,
+                             const Interpolant& interp) const;
+
+        /**
+         * @brief Interpolate onto a sheared grid of points
+         * (kx0 + i dkx + j dkxy, ky0 + i dkyx + j dky) using a separable interpolant.
+         *
+         * Here the weights cannot be shared between rows, but they are still computed for a
+         * whole row at a time, and the rows are done in parallel.  Points with |kx| or |ky|
+         * greater than kmax are set to zero without doing the interpolation.
+         */
+        template <typename T>
+        void interpolateGrid(std::complex<T>* ptr, int m, int n, int stride,
+                             double kx0, double dkx, double dkxy,
+                             double ky0, double dky, double dkyx,
+                             const Interpolant& interp, double kmax) const;
+
         /// Set the value of a grid point ix,iy (k = (ix*dk, iy*dk)) to a given value.
         void kSet(int ix, int iy, std::complex<double> value);
 
@@ -261,10 +397,7 @@ namespace galsim {
 
         /// Clear any cached values that had been set from previous passes.
         void clearCache() const
-        {
-            _cache.clear();
-            _xwt.clear();
-        }
+        { _cache.clear(); }
 
         /// this += scalar*rhs
         void accumulate(const KTable& rhs, double scalar=1.);
@@ -344,12 +477,31 @@ namespace galsim {
 
         int wrapKValue(double k) const;  // wrap floor(k) to be within [-N/2,N/2-1]
 
+        // Compute the kernel weights for interpolating to k0 + i dk for i = 0..n-1.
+        // Point i uses len[i] taps with table indices idx[i*width + t] and weights
+        // wt[i*width + t].  isx selects the wrapping convention used for the x or y direction.
+        void gridWeights(double k0, double dk, int n, const Interpolant& interp, bool isx,
+                         std::vector<int>& idx, std::vector<double>& wt, std::vector<int>& len,
+                         int& width) const;
+
+        // Fill row[ix + N/2] with kval(ix, iy) for -N/2 <= ix <= N/2.
+        void unfoldRow(int iy, std::complex<double>* row) const;
+
         // Objects used to accelerate interpolation with separable interpolants:
-        mutable std::deque<std::complex<double> > _cache;
-        mutable std::vector<double> _xwt;
-        mutable int _cacheStartY;
-        mutable double _cacheX;
-        mutable const InterpolantXY* _cacheInterp;
+        // the sums over rows for the last kx value.
+        struct InterpCache
+        {
+            InterpCache() : startY(0), x(0.), interp(0) {}
+            void clear() { rows.clear(); xwt.clear(); }
+
+            std::deque<std::complex<double> > rows;
+            std::vector<double> xwt;
+            int startY;
+            double x;
+            const InterpolantXY* interp;
+        };
+        mutable InterpCache _cache;
+        mutable std::mutex _cacheMutex;  // Protects _cache.  Other threads don't wait for it.
 
         friend class XTable;
     };
@@ -416,6 +568,28 @@ namespace galsim {
         /// interpolate to (x,y) - will NOT wrap the x data around +-N/2
         double interpolate(double x, double y, const Interpolant2d& interp) const;
 
+        /**
+         * @brief Interpolate onto a regular grid of points (x0 + i dx, y0 + j dy) using a
+         * separable interpolant.
+         *
+         * The result for each point is the same as interpolate(x, y, InterpolantXY(interp)),
+         * but the kernel weights are computed only once per column and once per row, and the
+         * 2-d sum is done as two 1-d passes.  Both passes are parallelized with OpenMP
+         * when that is available.
+         *
+         * @param[out] ptr      The output array; point (i,j) is written to ptr[i + j*stride].
+         * @param[in] m         The number of columns.
+         * @param[in] n         The number of rows.
+         * @param[in] stride    The stride between rows of the output array.
+         * @param[in] x0, dx    The x values to interpolate to are x0 + i dx.
+         * @param[in] y0, dy    The y values to interpolate to are y0 + j dy.
+         * @param[in] interp    The 1-d interpolant to use in each direction.
+         */
+        template <typename T>
+        void interpolateGrid(T* ptr, int m, int n, int stride,
+                             double x0, double dx, double y0, double dy,
+                             const Interpolant& interp) const;
+
         /// Set the value of a grid point ix,iy ((x,y) = (ix*dk, iy*dk)) to a given value.
         void xSet(int ix, int iy, double value);
 
@@ -424,10 +598,7 @@ namespace galsim {
 
         /// Clear any cached values that had been set from previous passes.
         void clearCache() const
-        {
-            _cache.clear();
-            _xwt.clear();
-        }
+        { _cache.clear(); }
 
         /// this += scalar*rhs
         void accumulate(const XTable& rhs, double scalar=1.);
@@ -489,11 +660,20 @@ namespace galsim {
 #endif
 
         // Objects used to accelerate interpolation with separable interpolants:
-        mutable std::deque<double> _cache;
-        mutable std::vector<double> _xwt;
-        mutable double _cacheX;
-        mutable int _cacheStartY;
-        mutable const InterpolantXY* _cacheInterp;
+        // the sums over rows for the last x value.
+        struct InterpCache
+        {
+            InterpCache() : startY(0), x(0.), interp(0) {}
+            void clear() { rows.clear(); xwt.clear(); }
+
+            std::deque<double> rows;
+            std::vector<double> xwt;
+            int startY;
+            double x;
+            const InterpolantXY* interp;
+        };
+        mutable InterpCache _cache;
+        mutable std::mutex _cacheMutex;  // Protects _cache.  Other threads don't wait for it.
 
         friend class KTable;
     };
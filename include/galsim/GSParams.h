@@ -92,6 +92,18 @@ namespace galsim {
          *                                    sample the radial profile out to some value.  We
          *                                    choose the outer radius such that the integral
          *                                    encloses at least (1-shoot_accuracy) of the flux.
+         *
+         * Finally, there are three switches that trade a little precision for speed:
+         *
+         * @param single_precision_fft  Whether to do the FFTs for single-precision images in
+         *                              single precision too (using fftw3f if available).
+         * @param tabulate_xval         Whether the Cubic, Quintic and Lanczos interpolants
+         *                              should use a lookup table for xval, accurate to
+         *                              xvalue_accuracy, rather than the analytic formula.
+         * @param interpolate_sersic_n  Whether untruncated Sersic profiles should get their
+         *                              Fourier transform, half-light radius and stepk by
+         *                              interpolating a grid of tables in n, rather than doing
+         *                              the calculation for each new value of n.
          */
         GSParams(int _minimum_fft_size,
                  int _maximum_fft_size,
@@ -105,7 +117,10 @@ namespace galsim {
                  double _realspace_abserr,
                  double _integration_relerr,
                  double _integration_abserr,
-                 double _shoot_accuracy);
+                 double _shoot_accuracy,
+                 bool _single_precision_fft,
+                 bool _tabulate_xval,
+                 bool _interpolate_sersic_n);
 
         /**
          * A reasonable set of default values
@@ -126,9 +141,16 @@ namespace galsim {
             integration_relerr(1.e-6),
             integration_abserr(1.e-8),
 
-            shoot_accuracy(1.e-5)
+            shoot_accuracy(1.e-5),
+
+            single_precision_fft(false),
+            tabulate_xval(false),
+            interpolate_sersic_n(false)
             {}
 
+        // These are used for the keys of the caches of precomputed tables, so they ignore
+        // the three switches, which don't change any of those tables.  The Sersic cache,
+        // which does depend on interpolate_sersic_n, has it as a separate part of its key.
         bool operator==(const GSParams& rhs) const;
         bool operator<(const GSParams& rhs) const;
 
@@ -151,6 +173,10 @@ namespace galsim {
 
         double shoot_accuracy;
 
+        bool single_precision_fft;
+        bool tabulate_xval;
+        bool interpolate_sersic_n;
+
     };
 
     std::ostream& operator<<(std::ostream& os, const GSParams& gsp);
@@ -794,18 +794,33 @@ namespace galsim {
 
     /**
      *  @brief Perform a 2D FFT from real space to k-space.
+     *
+     *  The precision of the FFT is set by the output type, which may be either
+     *  std::complex<double> or std::complex<float>.
      */
-    template <typename T>
-    void rfft(const BaseImage<T>& in, ImageView<std::complex<double> > out,
+    template <typename T, typename U>
+    void rfft(const BaseImage<T>& in, ImageView<std::complex<U> > out,
              bool shift_in=true, bool shift_out=true);
 
     /**
      *  @brief Perform a 2D inverse FFT from k-space to real space.
+     *
+     *  The precision of the FFT is set by the output type, which may be either double or float.
      */
-    template <typename T>
-    void irfft(const BaseImage<T>& in, ImageView<double> out,
+    template <typename T, typename U>
+    void irfft(const BaseImage<T>& in, ImageView<U> out,
                bool shift_in=true, bool shift_out=true);
 
+    /**
+     *  @brief Do the first half of irfft: check the bounds and load the (scaled, shifted)
+     *  k-space values into out, ready for an in-place complex-to-real FFT.
+     *
+     *  This lets several transforms of the same size be done together with ExecuteFFTMany_c2r.
+     */
+    template <typename T, typename U>
+    void irfftPrepare(const BaseImage<T>& in, ImageView<U> out,
+                      bool shift_in=true, bool shift_out=true);
+
     /**
      *  @brief Perform a 2D FFT from complex space to k-space or the inverse.
      */
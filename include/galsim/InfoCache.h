@@ -0,0 +1,163 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#ifndef GalSim_InfoCache_H
+#define GalSim_InfoCache_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <sstream>
+
+#include "Std.h"
+#include "GSParams.h"
+
+namespace galsim {
+
+    class TableBuilder;
+
+    namespace sbp {
+        // The version of the on-disk Info cache format.  Increment this whenever any of the
+        // cached Info classes changes what it writes, so that old files are not used.
+        const int info_cache_version = 1;
+    }
+
+    // Helpers to write and read binary values.  These are only meant to be read back on
+    // machines with the same architecture (endianness and sizeof(double)), so the files that
+    // use them should include a check value to detect a mismatch.
+    template <typename T>
+    inline void WriteValue(std::ostream& os, T x)
+    { os.write(reinterpret_cast<const char*>(&x), sizeof(T)); }
+
+    template <typename T>
+    inline bool ReadValue(std::istream& is, T& x)
+    { return bool(is.read(reinterpret_cast<char*>(&x), sizeof(T))); }
+
+    void WriteVector(std::ostream& os, const std::vector<double>& v);
+    bool ReadVector(std::istream& is, std::vector<double>& v);
+
+    void WriteGSParams(std::ostream& os, const GSParams& gsparams);
+    bool ReadGSParams(std::istream& is, GSParams& gsparams);
+
+    // A TableBuilder is written as its args and vals.  The interpolant is not written,
+    // since it is always set by the class that owns the table.  ReadTable only changes the
+    // table (and finalizes it) if the read is successful.  To read several tables before
+    // changing any of them, use ReadTableValues and then SetTableValues.
+    void WriteTable(std::ostream& os, const TableBuilder& table);
+    bool ReadTable(std::istream& is, TableBuilder& table);
+    bool ReadTableValues(std::istream& is, std::vector<double>& args, std::vector<double>& vals);
+    void SetTableValues(TableBuilder& table, const std::vector<double>& args,
+                        const std::vector<double>& vals);
+
+    /**
+     * @brief The key for an entry in the on-disk Info cache.
+     *
+     * This is the name of the cached class, along with the parameters and GSParams that
+     * fully determine its calculated values.
+     */
+    struct InfoCacheKey
+    {
+        InfoCacheKey(const std::string& type_, const GSParams& gsparams_) :
+            type(type_), gsparams(gsparams_) {}
+        InfoCacheKey(const std::string& type_, double p1, const GSParams& gsparams_) :
+            type(type_), params(1,p1), gsparams(gsparams_) {}
+        InfoCacheKey(const std::string& type_, double p1, double p2,
+                     const GSParams& gsparams_) :
+            type(type_), params(1,p1), gsparams(gsparams_)
+        { params.push_back(p2); }
+        InfoCacheKey(const std::string& type_, double p1, double p2, double p3,
+                     const GSParams& gsparams_) :
+            type(type_), params(1,p1), gsparams(gsparams_)
+        { params.push_back(p2); params.push_back(p3); }
+
+        std::string type;
+        std::vector<double> params;
+        GSParams gsparams;
+    };
+
+    /**
+     * @brief Set the directory to use for the on-disk Info cache.
+     *
+     * The profile Info classes (SersicInfo, KolmogorovInfo, etc.) and their photon-shooting
+     * samplers can take a long time to calculate, and the in-memory LRUCache only helps within
+     * a single process.  If a cache directory is set, each of these is first looked for there,
+     * and if it is not found, it is calculated in full and written there for later processes
+     * to use.
+     *
+     * Each entry is a separate file, whose name is made from a hash of its key.  The file
+     * repeats the full key (and the cache version), so entries that don't match exactly are
+     * ignored and overwritten.  Files are written to a temporary name and then renamed, so
+     * several processes may safely share the same directory.  Files are read through a
+     * memory map.
+     *
+     * The default is the value of the GALSIM_INFO_CACHE_DIR environment variable if set,
+     * or no cache otherwise.  An empty string turns the cache off.
+     */
+    void SetInfoCacheDir(const std::string& dir);
+
+    /// @brief Get the directory being used for the on-disk Info cache ("" if none).
+    std::string GetInfoCacheDir();
+
+    /// @brief Whether the on-disk Info cache is turned on.
+    bool InfoCacheEnabled();
+
+    /// @brief Open the cache entry for key, returning a stream positioned at its contents.
+    /// Returns a null pointer if there is no valid entry.
+    shared_ptr<std::istream> OpenCachedInfo(const InfoCacheKey& key);
+
+    /// @brief Write the given contents as the cache entry for key.
+    /// Failures to write are not errors; the entry is just not saved.
+    void SaveCachedInfo(const InfoCacheKey& key, const std::string& contents);
+
+    /**
+     * @brief Read obj from the on-disk Info cache.
+     *
+     * The class T needs a method `bool read(std::istream& is)`, which returns whether it
+     * successfully read all of its calculated values.  If it returns false, obj should be
+     * unchanged.
+     *
+     * Returns whether obj was read from the cache.
+     */
+    template <class T>
+    bool ReadCachedInfo(const InfoCacheKey& key, T& obj)
+    {
+        if (!InfoCacheEnabled()) return false;
+        shared_ptr<std::istream> is = OpenCachedInfo(key);
+        return is && obj.read(*is);
+    }
+
+    /**
+     * @brief Write obj to the on-disk Info cache.
+     *
+     * The class T needs a method `void write(std::ostream& os) const`, which calculates
+     * anything it has not yet calculated and writes it in the format expected by its read
+     * method.
+     */
+    template <class T>
+    void WriteCachedInfo(const InfoCacheKey& key, const T& obj)
+    {
+        if (!InfoCacheEnabled()) return;
+        std::ostringstream os(std::ios::binary);
+        obj.write(os);
+        SaveCachedInfo(key, os.str());
+    }
+
+}
+
+#endif
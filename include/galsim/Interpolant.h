@@ -22,6 +22,10 @@
 
 #include <cmath>
 #include <map>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 
 #include "Std.h"
 #include "Table.h"
@@ -47,6 +51,57 @@ namespace galsim {
         const Interpolant& _interp;  // Interpolant being wrapped
     };
 
+    /**
+     * @brief A fast lookup table for the real-space kernel of an `Interpolant`.
+     *
+     * The kernel is assumed to be symmetric and zero for |x| >= range.  Each cell of width
+     * h = 1/n on [0, range) stores a cubic polynomial that goes through the kernel at 4
+     * equally-spaced points in the cell.  The cell edges fall on the integers, so the table is
+     * exact at the nodes, and it is exact everywhere for a piecewise-cubic kernel like Cubic.
+     *
+     * n starts at the value implied by table_spacing and xvalue_accuracy (as for the other
+     * tables in GalSim).  It is then doubled until the maximum error, checked at 8 points per
+     * cell against the direct calculation, is less than xvalue_accuracy.
+     *
+     * Evaluation is a multiply, a truncation and a 4-term polynomial with no other branches,
+     * so the loop in xvalMany vectorizes well.
+     */
+    class XvalTable
+    {
+    public:
+        XvalTable(const Interpolant& interp, const GSParams& gsparams);
+
+        double operator()(double x) const
+        {
+            x = std::abs(x);
+            if (x >= _range) return 0.;
+            double u = x * _n;
+            // u can round up to _ncell for x just below _range.
+            int i = std::min(int(u), _ncell-1);
+            double t = u - i;
+            const double* c = &_coef[4*i];
+            return c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+        }
+
+        /// Replace each x[i] by the kernel value at x[i].
+        void many(double* x, int N) const;
+
+        /// The number of cells per unit x.
+        int getN() const { return _n; }
+
+        /// The maximum error of the table, as measured when it was built.
+        double getMaxError() const { return _max_err; }
+
+    private:
+        double _range;
+        int _n;
+        int _ncell;
+        std::vector<double> _coef;
+        double _max_err;
+
+        void build(const Interpolant& interp);
+    };
+
     /**
      * @brief Base class representing one-dimensional interpolant functions
      *
@@ -64,10 +119,13 @@ namespace galsim {
          * @param[in] gsparams  GSParams object storing constants that control the accuracy of
          *                      operations, if different from the default.
          */
-        Interpolant(const GSParams& gsparams) : _gsparams(gsparams), _interp(*this) {}
+        Interpolant(const GSParams& gsparams) :
+            _gsparams(gsparams), _interp(*this), _sampler_built(false) {}
 
         /// @brief Copy constructor: does not copy photon sampler, will need to rebuild.
-        Interpolant(const Interpolant& rhs): _gsparams(rhs._gsparams), _interp(rhs._interp) {}
+        Interpolant(const Interpolant& rhs):
+            _gsparams(rhs._gsparams), _interp(rhs._interp), _xvaltab(rhs._xvaltab),
+            _sampler_built(false) {}
 
         /// @brief Destructor
         virtual ~Interpolant() {}
@@ -108,11 +166,20 @@ namespace galsim {
 
         /**
          * @brief Calculate xval for array of input values x
+         *
+         * If the interpolant is using a lookup table for xval (cf. GSParams::tabulate_xval),
+         * this is done in a single tight loop over the table.
+         *
          * @param[in/out]   Each x[i] is replaces by xval[x[i]]
          * @param[in]       How many x values to calculate
          */
         void xvalMany(double* x, int N) const;
 
+        /**
+         * @brief Return whether xval is using a lookup table rather than the direct calculation.
+         */
+        bool isXvalTabulated() const { return bool(_xvaltab); }
+
         /**
          * @brief Value of interpolant in frequency space
          * @param[in] u Frequency for evaluation (cycles per pixel)
@@ -184,13 +251,29 @@ namespace galsim {
         GSParams _gsparams;
         InterpolantFunction _interp;
 
+        // The lookup table for xval, if GSParams::tabulate_xval is set and the subclass
+        // supports it.  Shared among all interpolants with the same parameters.
+        shared_ptr<XvalTable> _xvaltab;
+
         // Class that draws photons from this Interpolant
         mutable shared_ptr<OneDimensionalDeviate> _sampler;
+        mutable std::atomic<bool> _sampler_built;
+        mutable std::mutex _sampler_mutex;  // Protects the lazy construction of _sampler.
+
+        // Make sure the photon sampler has been built.  The same Interpolant may be used
+        // from several threads, so only one of them builds it.
+        void checkSampler() const
+        {
+            if (_sampler_built.load(std::memory_order_acquire)) return;
+            std::lock_guard<std::mutex> lock(_sampler_mutex);
+            if (_sampler_built.load(std::memory_order_relaxed)) return;
+            buildSampler();
+            _sampler_built.store(true, std::memory_order_release);
+        }
 
         // Allocate photon sampler and do all of its pre-calculations
-        virtual void checkSampler() const
+        virtual void buildSampler() const
         {
-            if (_sampler.get()) return;
             // Will assume by default that the Interpolant kernel changes sign at non-zero
             // integers, with one extremum in each integer range.
             int nKnots = int(ceil(xrange()));
@@ -462,6 +545,8 @@ namespace galsim {
         // Store the tables in a map, so repeat constructions are quick.
         static std::map<double,shared_ptr<TableBuilder> > _cache_tab;
         static std::map<double,double> _cache_umax;
+        static std::map<std::pair<double,double>,shared_ptr<XvalTable> > _cache_xvaltab;
+        static std::mutex _cache_mutex;  // Protects the above caches.
     };
 
     /**
@@ -499,7 +584,7 @@ namespace galsim {
     protected:
         // Override default sampler configuration because Quintic filter has sign change in
         // outer interval
-        void checkSampler() const;
+        void buildSampler() const;
 
     private:
         double _range; // Reduce range slightly from n so we're not using zero-valued endpoints.
@@ -512,6 +597,8 @@ namespace galsim {
         // Store the tables in a map, so repeat constructions are quick.
         static std::map<double,shared_ptr<TableBuilder> > _cache_tab;
         static std::map<double,double> _cache_umax;
+        static std::map<std::pair<double,double>,shared_ptr<XvalTable> > _cache_xvaltab;
+        static std::mutex _cache_mutex;  // Protects the above caches.
     };
 
     /**
@@ -572,6 +659,8 @@ namespace galsim {
         static std::map<KeyType,shared_ptr<TableBuilder> > _cache_xtab;
         static std::map<KeyType,shared_ptr<TableBuilder> > _cache_utab;
         static std::map<KeyType,double> _cache_umax;
+        static std::map<std::pair<KeyType,double>,shared_ptr<XvalTable> > _cache_xvaltab;
+        static std::mutex _cache_mutex;  // Protects the above caches.
     };
 
 }
@@ -22,6 +22,10 @@
 
 #include <list>
 #include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <chrono>
 
 namespace galsim {
 
@@ -123,6 +127,73 @@ namespace galsim {
         }
     };
 
+    // Helper to estimate the memory used by a Value, for caches with a byte budget.
+    // The default is just sizeof(Value).  Value types that own large tables should specialize
+    // this (normally by calling a getMemorySize method) before the cache's get() is used.
+    template <typename Value>
+    struct LRUCacheSize
+    {
+        static size_t Get(const Value& value)
+        { return sizeof(Value); }
+    };
+
+    /**
+     * @brief Statistics about the use of an LRUCache.
+     *
+     * The counts are totals since the cache was made or since the last resetStats().
+     */
+    struct LRUCacheStats
+    {
+        long nhit;          ///< Number of calls to get() that found the key in the cache.
+        long nmiss;         ///< Number of calls to get() that needed to build a new value.
+        long nevict;        ///< Number of values removed to stay within the limits.
+        double build_time;  ///< Total time spent building new values, in seconds.
+        long nentries;      ///< Number of values currently in the cache.
+        long nbytes;        ///< Estimated memory used by the values currently in the cache.
+        long max_entries;   ///< The maximum number of values to keep (0 = no limit).
+        long max_bytes;     ///< The maximum memory to use for the values (0 = no limit).
+    };
+
+    /**
+     * @brief The part of the LRUCache interface that does not depend on the Key and Value.
+     *
+     * Caches that are given a name register themselves under that name, so they can be
+     * inspected and resized at run time (e.g. from Python) with the functions below.
+     */
+    class LRUCacheBase
+    {
+    public:
+        virtual ~LRUCacheBase() {}
+
+        virtual LRUCacheStats getStats() const = 0;
+        virtual void resetStats() = 0;
+        virtual void setMaxSize(long max_entries, long max_bytes) = 0;
+        virtual void clear() = 0;
+    };
+
+    //@{
+    /**
+     * @brief Register, inspect and control the named LRUCaches.
+     *
+     * The caches of the profile Info classes are named for the profile: "Airy", "Exponential",
+     * "Kolmogorov", "Moffat", "SecondKick", "Sersic", "Spergel" and "VonKarman".  The tables
+     * of SBInterpolatedImages are cached in "InterpolatedImage", and the FFTW plans in
+     * "FFTWPlan" and "FFTWFPlan".
+     *
+     * SetLRUCacheSize sets the maximum number of entries and the maximum memory in bytes for
+     * the cache, removing the least recently used entries as needed.  A value of 0 for either
+     * means no limit on that.  The functions taking a name raise std::invalid_argument if there
+     * is no cache with that name.
+     */
+    void RegisterLRUCache(const std::string& name, LRUCacheBase* cache);
+    void UnregisterLRUCache(const std::string& name, LRUCacheBase* cache);
+    std::vector<std::string> GetLRUCacheNames();
+    LRUCacheStats GetLRUCacheStats(const std::string& name);
+    void ResetLRUCacheStats(const std::string& name);
+    void SetLRUCacheSize(const std::string& name, long max_entries, long max_bytes);
+    void ClearLRUCache(const std::string& name);
+    //@}
+
     /**
      * @brief Least Recently Used Cache
      *
@@ -144,63 +215,210 @@ namespace galsim {
      * provided Key, and return it if it is in the cache.  Otherwise, it builds a new Value,
      * saves it in the cache, and returns it.
      *
-     * At most nmax items will be saved in the cache.
+     * At most max_entries items will be saved in the cache, and if max_bytes is set, the
+     * least recently used items are also removed while the estimated memory of all the items
+     * (from LRUCacheSize<Value>) is more than max_bytes.  The most recently used item is
+     * always kept, even if it is larger than max_bytes on its own.  Since many of the Values
+     * build more tables the first time they are used, the size of an item is measured again
+     * each time it is returned by get().
+     *
+     * The cache is safe to use from multiple threads.  The list of entries is protected by a
+     * mutex, and each Value is built only once: if several threads ask for the same new Key at
+     * the same time, one of them builds the Value and the others wait for it.  Values for
+     * different Keys may be built concurrently.
      *
      */
     template <typename Key, typename Value>
-    class LRUCache
+    class LRUCache : public LRUCacheBase
     {
     public:
         /**
          * @brief Constructor
          *
-         * @param[in] nmax  How many values to save in the cache.
+         * @param[in] nmax       How many values to save in the cache.  0 means no limit.
+         * @param[in] name       If given, the name under which to register the cache, so it
+         *                       can be found with GetLRUCacheStats, SetLRUCacheSize, etc.
+         * @param[in] max_bytes  The maximum memory to use for the values.  0 means no limit.
          */
-        LRUCache(size_t nmax) : _nmax(nmax) {}
+        LRUCache(size_t nmax, const std::string& name="", size_t max_bytes=0) :
+            _nmax(nmax), _max_bytes(max_bytes), _nbytes(0), _name(name)
+        {
+            resetStats();
+            if (!_name.empty()) RegisterLRUCache(_name, this);
+        }
 
         /**
          * @brief Destructor
          *
          * Delete all items stored in the cache.
          */
-        ~LRUCache() {}
+        ~LRUCache()
+        {
+            if (!_name.empty()) UnregisterLRUCache(_name, this);
+        }
 
         shared_ptr<Value> get(const Key& key)
         {
-            assert(_entries.size() == _cache.size());
-            MapIter iter = _cache.find(key);
-            if (iter != _cache.end()) {
-                // Item is cached.
-                // Move it to the front of the list.
-                if (iter != _cache.begin())
-                    _entries.splice(_entries.begin(), _entries, iter->second);
-                // Return the item's value
+            shared_ptr<Slot> slot;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
                 assert(_entries.size() == _cache.size());
-                return iter->second->second;
-            } else {
-                // Item is not cached.
-                // Make a new one.
-                shared_ptr<Value> value(LRUCacheHelper<Value,Key>::NewValue(key));
-                // Remove items from the cache as necessary.
-                while (_entries.size() >= _nmax) {
-                    _cache.erase(_entries.back().first);
-                    _entries.pop_back();
+                MapIter iter = _cache.find(key);
+                if (iter != _cache.end()) {
+                    // Item is cached (or is being built by another thread).
+                    // Move it to the front of the list.
+                    ++_nhit;
+                    if (iter->second != _entries.begin())
+                        _entries.splice(_entries.begin(), _entries, iter->second);
+                    slot = iter->second->second;
+                } else {
+                    // Item is not cached.
+                    // Remove items from the cache as necessary.
+                    // Any thread still using one of these holds its own reference to the slot,
+                    // so it is safe to drop them here.
+                    ++_nmiss;
+                    while (_nmax > 0 && _entries.size() >= _nmax) removeLast();
+                    // Add an empty slot to the front.  The value is built below, outside of
+                    // the cache lock, so other keys are not blocked while we build it.
+                    slot.reset(new Slot());
+                    _entries.push_front(Entry(key,slot));
+                    _cache[key] = _entries.begin();
                 }
-                // Add the new value to the front.
-                _entries.push_front(Entry(key,value));
-                // Also put it in the cache
-                _cache[key] = _entries.begin();
-                // Return the new value
                 assert(_entries.size() == _cache.size());
-                return value;
             }
+
+            // Build the value if necessary.  Any other threads asking for the same key wait
+            // here until it is finished, so each value is only ever constructed once.
+            // If the construction throws, the slot is left empty and the next caller tries again.
+            shared_ptr<Value> value;
+            {
+                std::lock_guard<std::mutex> lock(slot->mutex);
+                if (!slot->value) {
+                    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+                    slot->value.reset(LRUCacheHelper<Value,Key>::NewValue(key));
+                    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+                    std::lock_guard<std::mutex> lock2(_mutex);
+                    _build_time += dt.count();
+                }
+                value = slot->value;
+            }
+
+            // Update the size of this item, and remove other items if we are now over budget.
+            // The item might have been removed by another thread in the meantime, in which
+            // case there is nothing to do.
+            size_t nbytes = LRUCacheSize<Value>::Get(*value);
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                MapIter iter = _cache.find(key);
+                if (iter != _cache.end() && iter->second->second == slot) {
+                    _nbytes += nbytes;
+                    _nbytes -= slot->nbytes;
+                    slot->nbytes = nbytes;
+                    removeExcess();
+                }
+            }
+            return value;
+        }
+
+        /**
+         * @brief Return the number of items currently in the cache.
+         */
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _entries.size();
+        }
+
+        /**
+         * @brief Remove all items from the cache.
+         *
+         * Values that are still in use elsewhere are not deleted until they are released.
+         */
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _cache.clear();
+            _entries.clear();
+            _nbytes = 0;
+        }
+
+        /**
+         * @brief Set the maximum number of items and the maximum memory (in bytes) to use.
+         *
+         * A value of 0 for either means no limit.  Items are removed right away if needed.
+         */
+        void setMaxSize(long max_entries, long max_bytes)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _nmax = max_entries > 0 ? max_entries : 0;
+            _max_bytes = max_bytes > 0 ? max_bytes : 0;
+            while (_nmax > 0 && _entries.size() > _nmax) removeLast();
+            removeExcess();
+        }
+
+        LRUCacheStats getStats() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            LRUCacheStats stats;
+            stats.nhit = _nhit;
+            stats.nmiss = _nmiss;
+            stats.nevict = _nevict;
+            stats.build_time = _build_time;
+            stats.nentries = _entries.size();
+            stats.nbytes = _nbytes;
+            stats.max_entries = _nmax;
+            stats.max_bytes = _max_bytes;
+            return stats;
+        }
+
+        void resetStats()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _nhit = _nmiss = _nevict = 0;
+            _build_time = 0.;
         }
 
     private:
 
+        // The cache stores a Slot for each key.  The slot is added to the cache right away,
+        // and the value is filled in once it is built.
+        struct Slot
+        {
+            Slot() : nbytes(0) {}
+            std::mutex mutex;
+            shared_ptr<Value> value;
+            size_t nbytes;  // The last measured size of value.  Protected by the cache _mutex.
+        };
+
+        // These must be called with _mutex locked.
+        void removeLast()
+        {
+            _nbytes -= _entries.back().second->nbytes;
+            _cache.erase(_entries.back().first);
+            _entries.pop_back();
+            ++_nevict;
+        }
+
+        void removeExcess()
+        {
+            while (_max_bytes > 0 && _nbytes > _max_bytes && _entries.size() > 1) removeLast();
+        }
+
         size_t _nmax;
+        size_t _max_bytes;
+        size_t _nbytes;
+        std::string _name;
+
+        long _nhit;
+        long _nmiss;
+        long _nevict;
+        double _build_time;
+
+        // Protects _entries, _cache, and all of the above sizes and counts.  It is only held
+        // while updating these, never while a Value is being constructed.
+        mutable std::mutex _mutex;
 
-        typedef std::pair<Key, shared_ptr<Value> > Entry;
+        typedef std::pair<Key, shared_ptr<Slot> > Entry;
         std::list<Entry> _entries;
 
         typedef typename std::list<Entry>::iterator ListIter;
@@ -26,6 +26,7 @@
 #include "Random.h"
 #include "PhotonArray.h"
 #include "ProbabilityTree.h"
+#include "InfoCache.h"
 #include "SBProfile.h"
 #include "Std.h"
 
@@ -168,6 +169,10 @@ namespace galsim {
          */
         std::list<shared_ptr<Interval> > split(double toler);
 
+        /// @brief Write and read the range, flux and linear model of a finished Interval.
+        void write(std::ostream& os) const;
+        bool read(std::istream& is);
+
     private:
 
         const FluxDensity* _fluxDensityPtr;  // Pointer to the parent FluxDensity function.
@@ -240,12 +245,33 @@ namespace galsim {
             const FluxDensity& fluxDensity, std::vector<double>& range, bool isRadial,
             double nominal_flux, const GSParams& gsparams);
 
+        /**
+         * @brief Make an empty OneDimensionalDeviate, which is then set up by read().
+         */
+        OneDimensionalDeviate(
+            const FluxDensity& fluxDensity, bool isRadial, const GSParams& gsparams);
+
+        /**
+         * @brief Write and read the Intervals that were calculated by the main constructor.
+         *
+         * These are used by the on-disk Info cache, so the numerical integrations to set up
+         * the Intervals need not be redone.  The FluxDensity must be the same one that was
+         * used to write.  read returns false if it does not find a valid set of Intervals.
+         * A OneDimensionalDeviate that has been read will draw exactly the same photons as the
+         * one that was written.
+         */
+        void write(std::ostream& os) const;
+        bool read(std::istream& is);
+
         /// @brief Return total flux in positive regions of FluxDensity
         double getPositiveFlux() const {return _positiveFlux;}
 
         /// @brief Return absolute value of total flux in regions of negative FluxDensity
         double getNegativeFlux() const {return _negativeFlux;}
 
+        /// @brief An estimate of the memory used by the deviate, in bytes.
+        size_t getMemorySize() const { return sizeof(*this) + _pt.getMemorySize(); }
+
         /**
          * @brief Draw photons from the distribution.
          *
@@ -267,6 +293,17 @@ namespace galsim {
         GSParams _gsparams;
     };
 
+    /**
+     * @brief Make a OneDimensionalDeviate, reading it from the on-disk Info cache if possible.
+     *
+     * If the Info cache is turned on, and it has an entry for key, the deviate is read from
+     * there.  Otherwise it is made as usual and then written to the cache.  The key needs to
+     * identify everything that determines fluxDensity and range.
+     */
+    shared_ptr<OneDimensionalDeviate> MakeCachedDeviate(
+        const InfoCacheKey& key, const FluxDensity& fluxDensity, std::vector<double>& range,
+        bool isRadial, double nominal_flux, const GSParams& gsparams);
+
 } // namespace galsim
 
 #endif
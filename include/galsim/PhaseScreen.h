@@ -0,0 +1,127 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#ifndef GalSim_PhaseScreen_H
+#define GalSim_PhaseScreen_H
+
+#include <vector>
+
+#include "Std.h"
+#include "Image.h"
+#include "Random.h"
+#include "Table.h"
+
+namespace galsim {
+
+    /**
+     * @brief Make a random phase screen whose power spectrum is psi^2.
+     *
+     * The screen is Re(ifft2(fft2(noise) * psi)), where noise is filled in row order with
+     * unit-variance Gaussian deviates drawn from rng.  This is the same calculation (and the
+     * same use of the random number generator) as AtmosphericScreen._random_screen in Python.
+     *
+     * psi is given in the unshifted (numpy.fft.fftfreq) order.  screen and psi must have the
+     * same shape, and both dimensions must be even.
+     */
+    void MakeRandomPhaseScreen(ImageView<double> screen, const BaseImage<double>& psi,
+                               BaseDeviate rng);
+
+    /**
+     * @brief Apply nstep boiling updates to a phase screen.
+     *
+     * Each update is screen = alpha * screen + sqrt(1-alpha^2) * new_screen, where new_screen
+     * is made by MakeRandomPhaseScreen.
+     */
+    void BoilPhaseScreen(ImageView<double> screen, const BaseImage<double>& psi,
+                         BaseDeviate rng, double alpha, int nstep);
+
+    /**
+     * @brief Multi-layer wavefront and PSF calculation for a fixed set of pupil points.
+     *
+     * The engine is set up with the pupil points at which to evaluate the wavefront, along
+     * with the index of each point in an ny x nx pupil grid.  Then each layer is added in
+     * turn.  A table layer is an atmospheric screen stored in a Table2D that translates with
+     * a wind velocity (vx, vy) and wraps with the given periods.  A fixed layer is a
+     * time-independent wavefront (e.g. optical aberrations) already evaluated at the pupil
+     * points.
+     *
+     * The engine does not copy the tables or arrays it is given, so they must outlive it.
+     *
+     * The wavefront at a given time is the sum of the layers, done in the order they were
+     * added.  Each layer is evaluated in parallel, both across layers and across blocks of
+     * pupil points.  integrate() adds up the instantaneous PSF images for a sequence of
+     * times, in parallel across chunks of time steps.
+     */
+    class PhaseScreenEngine
+    {
+    public:
+        PhaseScreenEngine(const double* u, const double* v, const int* index, int npoints,
+                          int nx, int ny);
+
+        void addTableLayer(const Table2D& table, double x0, double y0,
+                           double xperiod, double yperiod,
+                           double vx, double vy, double altitude);
+
+        void addFixedLayer(const double* wf);
+
+        int getNLayers() const { return int(_layers.size()); }
+        int getNPoints() const { return _npoints; }
+
+        /**
+         * @brief Compute the wavefront at time t for each pupil point.
+         *
+         * tanx, tany are the tangents of the field angle, used to shift each table layer
+         * by altitude * tan(theta).
+         */
+        void wavefront(double* wf, double t, double tanx, double tany) const;
+
+        /**
+         * @brief Add |fft2(exp(2 pi i wf / lam))|^2 to image for each of the given times.
+         *
+         * The pupil grid is zero outside of the pupil points.  The FFT is centered in both
+         * real and Fourier space, as with fft.fft2(..., shift_in=True, shift_out=True) in
+         * Python.  image must be ny x nx.
+         */
+        void integrate(ImageView<double> image, const double* times, int ntimes,
+                       double lam, double tanx, double tany) const;
+
+    private:
+
+        struct Layer
+        {
+            const Table2D* table;   // 0 for a fixed layer
+            const double* fixed;    // The wavefront at each point for a fixed layer
+            double x0, y0, xperiod, yperiod;
+            double vx, vy, altitude;
+        };
+
+        void evaluateLayer(const Layer& layer, int i1, int i2, double* wf,
+                           double t, double tanx, double tany) const;
+
+        const double* _u;
+        const double* _v;
+        const int* _index;
+        int _npoints;
+        int _nx, _ny;
+        std::vector<Layer> _layers;
+    };
+
+}
+
+#endif
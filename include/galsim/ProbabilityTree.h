@@ -55,6 +55,7 @@ namespace galsim {
         typedef typename std::vector<shared_ptr<FluxData> >::iterator VecIter;
         class FluxCompare;
     public:
+        typedef typename std::vector<shared_ptr<FluxData> >::const_iterator const_iterator;
         using std::vector<shared_ptr<FluxData> >::size;
         using std::vector<shared_ptr<FluxData> >::begin;
         using std::vector<shared_ptr<FluxData> >::end;
@@ -96,14 +97,18 @@ namespace galsim {
         /**
          * @brief Construct the tree from current vector elements.
          * @param[in] threshold that have flux <= this value are not included in the tree.
+         * @param[in] sorted   if true, the elements are already in the order that buildTree
+         *                     sorts them into (e.g. they were copied from another tree).
          */
-        void buildTree(double threshold=0.)
+        void buildTree(double threshold=0., bool sorted=false)
         {
             dbg<<"buildTree\n";
             assert(!empty());
             assert(!_root);
             // Sort the list so the largest flux regions are first.
-            std::sort(begin(), end(), FluxCompare());
+            // std::sort is not stable, so don't redo it on a list that is already sorted.
+            // Otherwise elements with equal flux might be permuted.
+            if (!sorted) std::sort(begin(), end(), FluxCompare());
             VecIter start = begin();
             VecIter last =
                 threshold == 0. ? end() :
@@ -138,6 +143,20 @@ namespace galsim {
 #endif
         }
 
+        /**
+         * @brief An estimate of the memory allocated for the tree and its members, in bytes.
+         *
+         * A tree with n members in it has 2n-1 Elements.
+         */
+        size_t getMemorySize() const
+        {
+            const size_t nelem = _shortcut.size();
+            return (size() * sizeof(FluxData) +
+                    this->capacity() * sizeof(shared_ptr<FluxData>) +
+                    (nelem > 0 ? 2*nelem-1 : 0) * sizeof(Element) +
+                    _shortcut.capacity() * sizeof(const Element*));
+        }
+
     private:
 
         /// @brief A private class that wraps the members in their tree information
@@ -222,7 +241,8 @@ namespace galsim {
             ~Element()
             {
                 if (_left) {
-                    assert(_right);
+                    // Not assert, since throwing from a destructor would terminate.
+                    xassert(_right);
                     delete _left;
                     delete _right;
                 }
@@ -32,6 +32,7 @@
  */
 
 #include <sstream>
+#include <stdint.h>
 
 #include "Image.h"
 
@@ -77,6 +78,17 @@ namespace galsim {
      * There is not much you can do with something that is only known to be a BaseDeviate
      * rather than one of the derived classes other than construct it and change the
      * seed, and use it as an argument to pass to other Deviate constructors.
+     *
+     * There are two choices for the underlying random number generator (the "engine"):
+     *
+     * "mt19937" is the Mersenne Twister, which is the default.  Its sequences for a given seed
+     *           are the same as in all previous versions of GalSim.
+     *
+     * "philox"  is the Philox4x32-10 counter-based generator (Salmon et al, 2011).  Each block
+     *           of 4 values is calculated directly from the key (the seed) and a 128 bit
+     *           counter, with no dependence on the previous blocks.  This makes it much faster
+     *           to fill large arrays with generate() and its relatives, and discard() is O(1).
+     *           The sequences are of course different from the mt19937 ones.
      */
     class BaseDeviate
     {
@@ -93,6 +105,14 @@ namespace galsim {
          */
         explicit BaseDeviate(long lseed);
 
+        /**
+         * @brief Construct and seed a new BaseDeviate using the given engine.
+         *
+         * @param[in] lseed   A long-integer seed for the RNG.
+         * @param[in] engine  The name of the engine to use: "mt19937" or "philox".
+         */
+        BaseDeviate(long lseed, const char* engine);
+
         /**
          * @brief Construct a new BaseDeviate, sharing the random number generator with rhs.
          */
@@ -121,6 +141,24 @@ namespace galsim {
         BaseDeviate duplicate()
         { return BaseDeviate(serialize().c_str()); }
 
+        /// @brief Return the name of the engine being used: "mt19937" or "philox".
+        std::string getEngine() const;
+
+        /**
+         * @brief Make a new BaseDeviate for one of a set of independent streams.
+         *
+         * The returned BaseDeviate has its own RNG, using the same engine as this one.  Its
+         * sequence depends only on key and index, not on the current state of this BaseDeviate.
+         * Typically, key is made from two raw() values drawn from this BaseDeviate for the
+         * whole set of streams, and index numbers the pieces of a calculation, which may then be
+         * done in any order (e.g. by different threads) with the same results.
+         *
+         * For philox, the streams all use the 64 bits of key as the key and start at a counter of
+         * (index+1) * 2^64, so they don't overlap.  For mt19937, the full state is seeded from
+         * a hash of key and index.
+         */
+        BaseDeviate substream(uint64_t key, long index) const;
+
         /**
          * @brief Return a string that can act as the repr in python
          */
@@ -204,10 +242,13 @@ namespace galsim {
          * @brief Draw N new random numbers from the distribution and save the values in
          * an array
          *
+         * The default implementation calls generate1() for each value.  Derived classes may
+         * override this to draw the values in blocks.
+         *
          * @param N     The number of values to draw
          * @param data  The array into which to write the values
          */
-        void generate(int N, double* data);
+        virtual void generate(int N, double* data);
 
         /**
          * @brief Draw N new random numbers from the distribution and add them to the values in
@@ -278,6 +319,14 @@ namespace galsim {
          */
         double generate1();
 
+        /**
+         * @brief Fill data with N uniform deviates.
+         *
+         * This draws the values directly from the engine, skipping the virtual generate1()
+         * calls.  The values are the same as N calls to generate1().
+         */
+        void generate(int N, double* data);
+
         /**
          * @brief Clear the internal cache
          */
@@ -347,6 +396,17 @@ namespace galsim {
          */
         double generate1();
 
+        /**
+         * @brief Fill data with N Gaussian deviates.
+         *
+         * With the mt19937 engine, the values are the same as N calls to generate1().
+         * With the philox engine, the values are made in pairs with a vectorizable Box-Muller
+         * loop over a block of uniform deviates.  This first clears the cache, and if N is odd,
+         * the second value of the last pair is not kept.  So the values are the same as
+         * clearCache() followed by N calls to generate1() only when N is even.
+         */
+        void generate(int N, double* data);
+
         /**
          * @brief Get current distribution mean
          *
@@ -575,11 +635,40 @@ namespace galsim {
          * @brief Replace data with Poisson draws using the existing data as the expectation
          * value.
          *
+         * With the mt19937 engine, the values are the same as calling setMean() and
+         * generate1() for each value.  With the philox engine, this is the same as
+         * generateFromExpectationBatch with normal_threshold = 2^30.
+         *
          * @param N     The number of values to draw
          * @param data  The array with the given data to replace with Poisson draws.
          */
         void generateFromExpectation(int N, double* data);
 
+        /**
+         * @brief Replace data with Poisson draws using a sampler designed for many different
+         * expectation values.
+         *
+         * The values are split into three groups by their expectation value, mu:
+         *
+         * mu < 10: Inversion, using a table of the cumulative probabilities.  The table is
+         *          kept while mu stays the same, so runs of equal values (e.g. the sky) are
+         *          very fast.
+         * mu <= normal_threshold: The PTRS transformed rejection method of Hormann (1993),
+         *          which is also what boost uses.  Each round of the rejection is done for all
+         *          the remaining values at once, with the constants for each mu calculated in
+         *          a single loop.
+         * mu > normal_threshold: A normal approximation with mean and variance mu, rounded
+         *          to the nearest non-negative integer.
+         *
+         * Values <= 0 are left as they are.  The current mean of the deviate is not changed.
+         *
+         * @param N                 The number of values to draw
+         * @param data              The array with the given data to replace with Poisson draws.
+         * @param normal_threshold  The expectation value above which to use the normal
+         *                          approximation.
+         */
+        void generateFromExpectationBatch(int N, double* data, double normal_threshold);
+
 
     protected:
         std::string make_repr(bool incl_seed);
@@ -886,6 +975,29 @@ namespace galsim {
         shared_ptr<Chi2DeviateImpl> _devimpl;
     };
 
+    /**
+     * @brief Add Gaussian noise with the given sigma to an image.
+     *
+     * The image is split into square tiles, which are done in parallel.  The tiles draw from
+     * substreams of rng (cf. BaseDeviate::substream) using a single 64-bit key drawn from rng,
+     * so the result doesn't depend on the number of threads.  The values are not the same as
+     * applying a GaussianDeviate with ApplyDeviateToImage.
+     */
+    template <typename T>
+    void AddGaussianNoise(ImageView<T> image, BaseDeviate rng, double sigma);
+
+    /**
+     * @brief Add CCD noise to an image in parallel tiles.
+     *
+     * This is the same calculation as galsim.CCDNoise in Python: Poisson noise on the image
+     * plus sky_level converted to electrons with gain (unless gain <= 0), then Gaussian read
+     * noise.  sky_level is subtracted again at the end.  With gain = 1 and read_noise = 0, this
+     * is galsim.PoissonNoise.  The tiles are done the same way as in AddGaussianNoise.
+     */
+    template <typename T>
+    void AddCCDNoise(ImageView<T> image, BaseDeviate rng, double sky_level, double gain,
+                     double read_noise);
+
 }  // namespace galsim
 
 #endif
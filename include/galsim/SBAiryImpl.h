@@ -54,6 +54,12 @@ namespace galsim {
          */
         virtual double xValue(double r) const = 0;
 
+        /**
+         * @brief Set f[i] = xValue(r[i]) for i in [0,n), using the array version of j1.
+         * r and f may be the same array.
+         */
+        virtual void xValueMany(const double* r, double* f, int n) const = 0;
+
         /**
          * @brief Returns the k-space value of the Airy function.
          * @param[in] ksq_over_pisq should be given in units of lam_over_D
@@ -77,6 +83,9 @@ namespace galsim {
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief An estimate of the memory used by the lookup tables and sampler, in bytes.
+        size_t getMemorySize() const;
+
     protected:
         double _stepk; ///< Sampling in k space necessary to avoid folding
 
@@ -84,6 +93,7 @@ namespace galsim {
 
         ///< Class that can sample radial distribution
         mutable shared_ptr<OneDimensionalDeviate> _sampler;
+        mutable std::mutex _sampler_mutex;  ///< Protects the lazy construction of _sampler.
 
     private:
         AiryInfo(const AiryInfo& rhs); ///< Hides the copy constructor.
@@ -91,6 +101,13 @@ namespace galsim {
 
     };
 
+    // The LRUCache uses this to keep track of the memory used by each AiryInfo.
+    template <>
+    struct LRUCacheSize<AiryInfo>
+    {
+        static size_t Get(const AiryInfo& info) { return info.getMemorySize(); }
+    };
+
     // The definition for obs != 0
     class AiryInfoObs : public AiryInfo
     {
@@ -99,6 +116,7 @@ namespace galsim {
         ~AiryInfoObs() {}
 
         double xValue(double r) const;
+        void xValueMany(const double* r, double* f, int n) const;
         double kValue(double ksq_over_pisq) const;
 
     private:
@@ -129,6 +147,9 @@ namespace galsim {
              */
             double operator()(double radius) const;
 
+            /// @brief Set f[i] = operator()(radius[i]) for i in [0,n).
+            void evalMany(const double* radius, double* f, int n) const;
+
         private:
             double _obscuration; ///< Central obstruction size
             double _obssq; ///< _obscuration*_obscuration
@@ -165,6 +186,7 @@ namespace galsim {
         ~AiryInfoNoObs() {}
 
         double xValue(double r) const;
+        void xValueMany(const double* r, double* f, int n) const;
         double kValue(double ksq_over_pisq) const;
 
     private:
@@ -174,6 +196,7 @@ namespace galsim {
             RadialFunction(const GSParamsPtr& gsparams) : _gsparams(gsparams) {}
 
             double operator()(double radius) const;
+            void evalMany(const double* radius, double* f, int n) const;
 
         private:
             GSParamsPtr _gsparams;
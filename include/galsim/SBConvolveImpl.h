@@ -20,6 +20,7 @@
 #ifndef GalSim_SBConvolveImpl_H
 #define GalSim_SBConvolveImpl_H
 
+#include <atomic>
 #include "SBProfileImpl.h"
 #include "SBConvolve.h"
 
@@ -137,8 +138,10 @@ namespace galsim {
         bool _isStillAxisymmetric; ///< Is output SBProfile shape still circular?
         double _fluxProduct; ///< Flux of the product.
 
-        mutable double _maxk; ///< Minimum maxK() of the convolved SBProfiles.
-        mutable double _stepk; ///< Minimum stepK() of the convolved SBProfiles.
+        // These are calculated when first needed.  Several threads may draw this profile at
+        // once, so each is calculated into a local and then stored in one go.
+        mutable std::atomic<double> _maxk; ///< Minimum maxK() of the convolved SBProfiles.
+        mutable std::atomic<double> _stepk; ///< Minimum stepK() of the convolved SBProfiles.
 
         void doFillKImage(ImageView<std::complex<double> > im,
                           double kx0, double dkx, int izero,
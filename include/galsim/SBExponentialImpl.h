@@ -73,6 +73,9 @@ namespace galsim {
         double maxK() const;
         double stepK() const;
 
+        /// @brief An estimate of the memory used by the lookup tables and sampler, in bytes.
+        size_t getMemorySize() const;
+
     private:
 
         ExponentialInfo(const ExponentialInfo& rhs); ///< Hides the copy constructor.
@@ -88,6 +91,13 @@ namespace galsim {
         double _stepk; ///< Calculated stepK * r0
     };
 
+    // The LRUCache uses this to keep track of the memory used by each ExponentialInfo.
+    template <>
+    struct LRUCacheSize<ExponentialInfo>
+    {
+        static size_t Get(const ExponentialInfo& info) { return info.getMemorySize(); }
+    };
+
     class SBExponential::SBExponentialImpl : public SBProfileImpl
     {
     public:
@@ -29,6 +29,14 @@
 
 namespace galsim {
 
+    namespace sbp {
+
+        // The default maximum memory (in bytes) to use for the "InterpolatedImage" LRUCache
+        // of SBInterpolatedImage tables.
+        const long max_interpolated_image_cache_bytes = 64L << 20;
+
+    }
+
     template <typename T>
     double CalculateSizeContainingFlux(const BaseImage<T>& im, double target_flux);
 
@@ -20,12 +20,74 @@
 #ifndef GalSim_SBInterpolatedImageImpl_H
 #define GalSim_SBInterpolatedImageImpl_H
 
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
 #include "SBProfileImpl.h"
 #include "SBInterpolatedImage.h"
 #include "ProbabilityTree.h"
+#include "LRUCache.h"
 
 namespace galsim {
 
+    /**
+     * @brief The key for the cache of InterpolatedImageTables.
+     *
+     * Keys are ordered by the size and a hash of the values of the XTable, and only if those
+     * match, by the values themselves.  So SBInterpolatedImages made from the same image values
+     * share their tables, regardless of whether they were made from the same Image object.
+     */
+    struct InterpolatedImageKey
+    {
+        InterpolatedImageKey(shared_ptr<XTable> xtab);
+        bool operator<(const InterpolatedImageKey& rhs) const;
+
+        shared_ptr<XTable> xtab;
+        uint64_t hash;
+    };
+
+    /**
+     * @brief The real-space and k-space tables for one padded image.
+     *
+     * These are shared by all the SBInterpolatedImages made from the same image values
+     * through the "InterpolatedImage" LRUCache.  The KTable is only made the first time one
+     * of them needs it.
+     */
+    class InterpolatedImageTables
+    {
+    public:
+        InterpolatedImageTables(const InterpolatedImageKey& key) : _xtab(key.xtab) {}
+
+        shared_ptr<XTable> getXTable() const { return _xtab; }
+
+        shared_ptr<KTable> getKTable()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_ktab) _ktab = _xtab->transform();
+            return _ktab;
+        }
+
+        /// @brief The memory used by the tables, including the KTable whether or not it has
+        /// been made yet.
+        size_t getMemorySize() const
+        {
+            size_t N = _xtab->getN();
+            return N * N * sizeof(double) + N * (N/2+1) * sizeof(std::complex<double>);
+        }
+
+    private:
+        shared_ptr<XTable> _xtab;
+        shared_ptr<KTable> _ktab;
+        std::mutex _mutex;
+    };
+
+    template <>
+    struct LRUCacheSize<InterpolatedImageTables>
+    {
+        static size_t Get(const InterpolatedImageTables& tables)
+        { return tables.getMemorySize(); }
+    };
+
     class SBInterpolatedImage::SBInterpolatedImageImpl : public SBProfile::SBProfileImpl
     {
     public:
@@ -127,13 +189,16 @@ namespace galsim {
 
         InterpolantXY _xInterp; ///< Interpolant used in real space.
         InterpolantXY _kInterp; ///< Interpolant used in k space.
+        shared_ptr<InterpolatedImageTables> _tables; ///< Possibly shared with other profiles.
         shared_ptr<XTable> _xtab; ///< Final real-space image.
-        mutable shared_ptr<KTable> _ktab; ///< Final k-space image.
+        mutable shared_ptr<KTable> _ktab; ///< Final k-space image.  Set by checkK.
+        mutable std::atomic<bool> _ktab_set;
+        mutable std::mutex _ktab_mutex;  ///< Protects the lazy setting of _ktab.
         mutable double _stepk;
         mutable double _maxk;
-        mutable double _flux;
-        mutable double _xcentroid;
-        mutable double _ycentroid;
+        double _flux;
+        double _xcentroid;
+        double _ycentroid;
 
         double _maxk1; ///< maxk based just on the xInterp urange
         double _uscale; ///< conversion from k to u for xInterpolant
@@ -142,7 +207,8 @@ namespace galsim {
         void checkK() const;
 
         /// @brief Set true if the data structures for photon-shooting are valid
-        mutable bool _readyToShoot;
+        mutable std::atomic<bool> _readyToShoot;
+        mutable std::mutex _shoot_mutex;  ///< Protects the lazy setup for photon shooting.
 
         /// @brief Set up photon-shooting quantities, if not ready
         void checkReadyToShoot() const;
@@ -167,6 +233,8 @@ namespace galsim {
 
         std::string serialize() const;
 
+        static LRUCache<InterpolatedImageKey, InterpolatedImageTables> cache;
+
     private:
 
         void doFillXImage(ImageView<double> im,
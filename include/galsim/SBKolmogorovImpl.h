@@ -77,6 +77,13 @@ namespace galsim {
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief An estimate of the memory used by the lookup tables and sampler, in bytes.
+        size_t getMemorySize() const;
+
+        /// @brief Write and read the radial function table, for the on-disk Info cache.
+        void write(std::ostream& os) const;
+        bool read(std::istream& is);
+
     private:
         KolmogorovInfo(const KolmogorovInfo& rhs); ///< Hides the copy constructor.
         void operator=(const KolmogorovInfo& rhs); ///<Hide assignment operator.
@@ -88,6 +95,15 @@ namespace galsim {
 
         ///< Class that can sample radial distribution
         shared_ptr<OneDimensionalDeviate> _sampler;
+
+        void buildRadialFunc(const GSParams& gsparams);
+    };
+
+    // The LRUCache uses this to keep track of the memory used by each KolmogorovInfo.
+    template <>
+    struct LRUCacheSize<KolmogorovInfo>
+    {
+        static size_t Get(const KolmogorovInfo& info) { return info.getMemorySize(); }
     };
 
     class SBKolmogorov::SBKolmogorovImpl : public SBProfileImpl
@@ -29,6 +29,13 @@ namespace galsim {
 
     double MoffatCalculateScaleRadiusFromHLR(double re, double rm, double beta);
 
+    namespace sbp {
+
+        // How many Moffat profiles to save in the cache
+        const int max_moffat_cache = 100;
+
+    }
+
     /**
      * @brief Surface Brightness for the Moffat Profile (an approximate description of ground-based
      * PSFs).
@@ -20,13 +20,99 @@
 #ifndef GalSim_SBMoffatImpl_H
 #define GalSim_SBMoffatImpl_H
 
+#include <atomic>
+#include <iostream>
+
 #include "SBProfileImpl.h"
 #include "SBMoffat.h"
+#include "LRUCache.h"
 #include "Table.h"
 #include "OneDimensionalDeviate.h"
 
 namespace galsim {
 
+    /**
+     * @brief A private class that caches the Fourier transform of a Moffat profile for each
+     * beta and truncation radius.
+     *
+     * This is used for the truncated profiles and for untruncated profiles whose beta doesn't
+     * have a simple analytic transform.  It is shared by all the SBMoffats with the same beta,
+     * trunc/rD and GSParams through the LRUCache in SBMoffatImpl.
+     */
+    class MoffatInfo
+    {
+    public:
+        /**
+         * @brief Constructor
+         *
+         * trunc is the truncation radius in units of rD, or 0 for an untruncated profile.
+         */
+        MoffatInfo(double beta, double trunc, const GSParamsPtr& gsparams);
+
+        /// @brief Destructor
+        ~MoffatInfo() {}
+
+        /**
+         * @brief Returns the value of the fourier transform, normalized to 1 at k=0.
+         *
+         * The input `ksq` should be (k_actual^2 * rD^2).
+         * The returned value should then be multiplied by flux.
+         */
+        double kValue(double ksq) const;
+
+        /// @brief The last k with a kValue > maxk_threshold, in units of 1/rD.
+        /// Only set for truncated profiles.
+        double maxK() const;
+
+        /// @brief An estimate of the memory used by the lookup table, in bytes.
+        size_t getMemorySize() const;
+
+        /**
+         * @brief Write and read the calculated values, for the on-disk Info cache.
+         *
+         * write calculates anything that has not been calculated yet.  read returns false if
+         * is does not have valid values for this beta and trunc.
+         */
+        void write(std::ostream& os) const;
+        bool read(std::istream& is);
+
+    private:
+
+        MoffatInfo(const MoffatInfo& rhs); ///< Hide the copy constructor.
+        void operator=(const MoffatInfo& rhs); ///<Hide assignment operator.
+
+        // Input variables:
+        double _beta;    ///< Moffat beta.
+        double _trunc;   ///< Truncation radius `trunc` in units of rD.
+        GSParamsPtr _gsparams; ///< The GSParams object.
+
+        // Some derived values calculated in the constructor:
+        double _knorm;   ///< Normalization of the analytic transform of an untruncated profile.
+
+        // The lookup table.  For truncated profiles, it is a function of ksq, and is zero past
+        // the end of the table.  For untruncated profiles, it is a function of log(k), and
+        // values of ksq < _ksq_min are calculated directly.
+        mutable TableBuilder _ft;  ///< Lookup table for Fourier transform.
+        mutable double _maxk;    ///< Value of k beyond which aliasing can be neglected.
+        mutable double _ksq_min; ///< Minimum ksq to use lookup table.
+        mutable double _ksq_max; ///< Maximum ksq to use lookup table.
+        mutable std::atomic<bool> _ft_built; ///< Whether the above have been set up.
+        mutable std::mutex _ft_mutex; ///< Protects the lazy construction of the above.
+
+        // Helper functions used internally:
+        void checkFT() const;
+        void buildFT() const;
+        void buildTruncatedFT() const;
+        double analyticKValue(double ksq) const;
+    };
+
+    // The LRUCache uses this to keep track of the memory used by each MoffatInfo.
+    template <>
+    struct LRUCacheSize<MoffatInfo>
+    {
+        static size_t Get(const MoffatInfo& info) { return info.getMemorySize(); }
+    };
+
     class SBMoffat::SBMoffatImpl : public SBProfileImpl
     {
     public:
@@ -119,16 +205,17 @@ namespace galsim {
         double _maxRrD_sq;
         double _maxR_sq;
 
-        mutable TableBuilder _ft;  ///< Lookup table for Fourier transform of Moffat.
-
-        mutable double _stepk;
-        mutable double _maxk; ///< Maximum k with kValue > 1.e-3
+        // These are calculated when first needed.  Several threads may draw this profile at
+        // once, so each is calculated into a local and then stored in one go.
+        mutable std::atomic<double> _stepk;
+        mutable std::atomic<double> _maxk; ///< Maximum k with kValue > 1.e-3
 
         double (*_pow_beta)(double x, double beta);
         double (SBMoffatImpl::*_kV)(double ksq) const;
+        int _kv_nu; ///< _kV is K_nu(k) k^nu for this nu, or 0 if it isn't a Bessel function.
 
-        /// Setup the FT Table.
-        void setupFT() const;
+        /// Points to the info structure for this beta, trunc if the kValues are tabulated.
+        shared_ptr<MoffatInfo> _info;
 
         // These are the (unnormalized) kValue functions for untruncated Moffats
         double kV_15(double ksq) const;
@@ -137,20 +224,13 @@ namespace galsim {
         double kV_3(double ksq) const;
         double kV_35(double ksq) const;
         double kV_4(double ksq) const;
-        double kV_gen(double ksq) const;
 
-        // This does the truncated case.
-        double kV_trunc(double ksq) const;
+        // This does the truncated case and the other values of beta.
+        double kV_info(double ksq) const;
 
-        // pow(x,beta) for special (probably not uncommon) cases.
-        static double pow_1(double x, double );
-        static double pow_15(double x, double );
-        static double pow_2(double x, double );
-        static double pow_25(double x, double );
-        static double pow_3(double x, double );
-        static double pow_35(double x, double );
-        static double pow_4(double x, double );
-        static double pow_gen(double x, double beta);
+        // Set f[i] = _kV(ksq[i]) for a row of pixels.  The ones that need a Bessel function
+        // use the array version of it.  ksq and f must be different arrays.
+        void kVMany(const double* ksq, double* f, int n) const;
 
         void doFillXImage(ImageView<double> im,
                           double x0, double dx, int izero,
@@ -188,6 +268,8 @@ namespace galsim {
         // Copy constructor and op= are undefined.
         SBMoffatImpl(const SBMoffatImpl& rhs);
         void operator=(const SBMoffatImpl& rhs);
+
+        static LRUCache<Tuple<double, double, GSParamsPtr>, MoffatInfo> cache;
     };
 
 }
@@ -55,6 +55,13 @@ namespace galsim {
         double structureFunction(double rho) const;
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief An estimate of the memory used by the lookup tables and sampler, in bytes.
+        size_t getMemorySize() const;
+
+        /// @brief Write and read the lookup tables, for the on-disk Info cache.
+        void write(std::ostream& os) const;
+        bool read(std::istream& is);
+
     private:
         SKInfo(const SKInfo& rhs); ///<Hide the copy constructor
         void operator=(const SKInfo& rhs); ///<Hide the assignment operator
@@ -74,6 +81,13 @@ namespace galsim {
         void _buildKVLUT();
     };
 
+    // The LRUCache uses this to keep track of the memory used by each SKInfo.
+    template <>
+    struct LRUCacheSize<SKInfo>
+    {
+        static size_t Get(const SKInfo& info) { return info.getMemorySize(); }
+    };
+
     //
     //
     //
@@ -31,6 +31,26 @@ namespace galsim {
     double SersicIntegratedFlux(double n, double r);
     double SersicTruncatedScale(double n, double hlr, double trunc);
 
+    /**
+     * @brief Read the grid used for GSParams::interpolate_sersic_n from a file.
+     *
+     * Returns false if the file doesn't have a grid made with these gsparams, in which case
+     * the grid will be built the first time it is needed.
+     */
+    bool LoadSersicGrid(const std::string& file_name, const GSParams& gsparams);
+
+    /// @brief Write the grid used for GSParams::interpolate_sersic_n to a file.
+    void WriteSersicGrid(const std::string& file_name, const GSParams& gsparams);
+
+    /**
+     * @brief Set the file of precomputed grids that is checked before building a new grid.
+     *
+     * GalSim ships the grid for the default GSParams in its share directory, and the Python
+     * layer sets this to that file.  Grids for other GSParams, or a file made on a machine
+     * with a different byte order, are ignored.  An empty string turns this off.
+     */
+    void SetSersicGridFile(const std::string& file_name);
+
     namespace sbp {
 
         // Constrain range of allowed Sersic index n to those for which testing was done
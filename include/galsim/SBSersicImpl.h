@@ -20,6 +20,9 @@
 #ifndef GalSim_SBSersicImpl_H
 #define GalSim_SBSersicImpl_H
 
+#include <atomic>
+#include <iostream>
+
 #include "SBProfileImpl.h"
 #include "SBInclinedSersic.h"
 #include "SBSersic.h"
@@ -29,12 +32,20 @@
 
 namespace galsim {
 
+    class SersicGrid;
+
     /// @brief A private class that caches the needed parameters for each Sersic index `n`.
     class SersicInfo
     {
     public:
-        /// @brief Constructor
-        SersicInfo(double n, double trunc, const GSParamsPtr& gsparams);
+        /**
+         * @brief Constructor
+         *
+         * If use_info_cache is true and the on-disk Info cache is turned on, the calculated
+         * values are read from the cache, or written to it once they have been calculated.
+         */
+        SersicInfo(double n, double trunc, const GSParamsPtr& gsparams,
+                   bool use_info_cache=true);
 
         /// @brief Destructor: deletes photon-shooting classes if necessary
         ~SersicInfo() {}
@@ -85,15 +96,41 @@ namespace galsim {
          */
         void shoot(PhotonArray& photons, UniformDeviate ud) const;
 
+        /// @brief An estimate of the memory used by the lookup tables and sampler, in bytes.
+        size_t getMemorySize() const;
+
+        /**
+         * @brief Write and read the calculated values.
+         *
+         * These are used for SersicGrid files and the on-disk Info cache.  write calculates
+         * anything that has not been calculated yet.  read returns false if is does not
+         * have valid values for this n.
+         */
+        void write(std::ostream& os) const;
+        bool read(std::istream& is);
+
     private:
 
         SersicInfo(const SersicInfo& rhs); ///< Hide the copy constructor.
         void operator=(const SersicInfo& rhs); ///<Hide assignment operator.
 
+        /**
+         * @brief Only set up the input values and the ones derived directly from them.
+         *
+         * The public constructor calculates the rest.  SersicGrid::read uses this directly for
+         * the grid nodes, since their values are about to be read from the file.
+         */
+        SersicInfo(double n, double trunc, const GSParamsPtr& gsparams, bool use_info_cache,
+                   bool grid_node);
+
+        friend class SersicGrid;
+
         // Input variables:
         double _n;       ///< Sersic index.
         double _trunc;   ///< Truncation radius `trunc` in units of r0.
         GSParamsPtr _gsparams; ///< The GSParams object.
+        bool _use_info_cache; ///< Whether to save the Fourier transform in the Info cache.
+        bool _grid_node; ///< Whether this is one of the nodes of a SersicGrid.
 
         // Some derived values calculated in the constructor:
         double _invn;      ///< 1/n
@@ -101,15 +138,13 @@ namespace galsim {
         double _trunc_sq;  ///< trunc^2
         bool _truncated;   ///< True if this Sersic profile is truncated.
         double _gamma2n;   ///< Gamma(2n) = 1/n * int(exp(-r^1/n)*r,r=0..inf)
+        double _stepk;     ///< Sampling in k space necessary to avoid folding.
+        double _re;        ///< The HLR in units of r0.
+        double _b;         ///< b = re^(1/n)
+        double _flux;      ///< Flux relative to the untruncated profile.
 
-        // Parameters calculated when they are first needed, and then stored:
+        // Parameters for the Hankel transform, calculated when they are first needed:
         mutable double _maxk;    ///< Value of k beyond which aliasing can be neglected.
-        mutable double _stepk;   ///< Sampling in k space necessary to avoid folding.
-        mutable double _re;      ///< The HLR in units of r0.
-        mutable double _b;       ///< b = re^(1/n)
-        mutable double _flux;    ///< Flux relative to the untruncated profile.
-
-        // Parameters for the Hankel transform:
         mutable TableBuilder _ft;  ///< Lookup table for Fourier transform.
         mutable double _kderiv2; ///< Quadratic dependence of F near k=0.
         mutable double _kderiv4; ///< Quartic dependence of F near k=0.
@@ -117,17 +152,96 @@ namespace galsim {
         mutable double _ksq_max; ///< Maximum ksq to use lookup table.
         mutable double _highk_a; ///< Coefficient of 1/k^2 in high-k asymptote
         mutable double _highk_b; ///< Coefficient of 1/k^3 in high-k asymptote
+        mutable std::atomic<bool> _ft_built; ///< Whether the above have been set up.
+        mutable std::mutex _ft_mutex; ///< Protects the lazy construction of the above.
+
+        /// If set, the Fourier transform, HLR and stepk are interpolated from this grid.
+        shared_ptr<SersicGrid> _grid;
 
         // Classes used for photon shooting
         mutable shared_ptr<FluxDensity> _radial;
         mutable shared_ptr<OneDimensionalDeviate> _sampler;
+        mutable std::mutex _sampler_mutex;  ///< Protects the lazy construction of _sampler.
 
         // Helper functions used internally:
+        void checkFT() const;
         void buildFT() const;
-        void calculateHLR() const;
+        void calculateHLR();
         double calculateMissingFluxRadius(double missing_flux_frac) const;
     };
 
+    // The LRUCache uses this to keep track of the memory used by each SersicInfo.
+    template <>
+    struct LRUCacheSize<SersicInfo>
+    {
+        static size_t Get(const SersicInfo& info) { return info.getMemorySize(); }
+    };
+
+    /**
+     * @brief A grid of untruncated SersicInfo tables spanning the allowed range of n.
+     *
+     * This is used when GSParams::interpolate_sersic_n is set.  The nodes are evenly spaced in
+     * log(n), with a spacing that makes cubic interpolation between them accurate to about
+     * kvalue_accuracy.  The Fourier transform for any n is interpolated from the four nearest
+     * nodes at the same value of k * hlr.  The half-light radius and the folding radius used
+     * for stepk are interpolated in the same way.
+     *
+     * There is one grid for each GSParams.  It is either read from a file with LoadSersicGrid,
+     * read from the shipped grid file (cf. SetSersicGridFile) or the on-disk Info cache, or
+     * built (in parallel over the nodes) the first time it is needed.
+     */
+    class SersicGrid
+    {
+    public:
+        /// @brief Get the grid for these GSParams, building it if necessary.
+        static shared_ptr<SersicGrid> get(const GSParamsPtr& gsparams);
+
+        /// @brief Read a grid from is and use it for these GSParams.
+        /// Returns false if is doesn't have a valid grid for them.
+        static bool load(std::istream& is, const GSParamsPtr& gsparams);
+
+        /// @brief Write the grid to os.
+        void write(std::ostream& os) const;
+
+        /// @brief Read the grid from is.  Returns false if is doesn't have a valid grid.
+        bool read(std::istream& is);
+
+        /// @brief The Fourier transform at k = exp(logq) / hlr, normalized to 1 at k = 0.
+        double kValue(double n, double logq) const;
+
+        /// @brief The half-light radius in units of r0.
+        double getHLR(double n) const;
+
+        /// @brief The radius enclosing (1-folding_threshold) of the flux in units of r0.
+        double getFoldingRadius(double n) const;
+
+    private:
+
+        SersicGrid(const GSParamsPtr& gsparams);
+
+        void build();
+        int getWeights(double n, double* w) const;
+
+        GSParamsPtr _gsparams;  ///< The GSParams for the nodes (without interpolate_sersic_n).
+        int _nnodes;
+        double _logn0;
+        double _dlogn;
+        std::vector<shared_ptr<SersicInfo> > _nodes;
+        std::vector<double> _logre;  ///< log(hlr/r0) at each node.
+        std::vector<double> _logb;   ///< log(hlr/r0) / n at each node.
+        std::vector<double> _logz;   ///< log(R/r0) / n at each node, for the folding radius R.
+    };
+
+    // Specialize the NewValue function used by LRUCache.  The third item in the key is only
+    // there to keep interpolated and directly calculated SersicInfos apart, since
+    // GSParams::operator< ignores interpolate_sersic_n.
+    template <>
+    struct LRUCacheHelper<SersicInfo, Tuple<double, double, bool, GSParamsPtr> >
+    {
+        static SersicInfo* NewValue(const Tuple<double, double, bool, GSParamsPtr>& key)
+        { return new SersicInfo(key.first, key.second, key.fourth); }
+    };
+
     class SBSersic::SBSersicImpl : public SBProfileImpl
     {
     public:
@@ -263,7 +377,8 @@ namespace galsim {
         SBSersicImpl(const SBSersicImpl& rhs);
         void operator=(const SBSersicImpl& rhs);
 
-        static LRUCache<Tuple<double, double, GSParamsPtr>, SersicInfo> cache;
+        // The key is n, trunc/r0, whether to use the SersicGrid, and the GSParams.
+        static LRUCache<Tuple<double, double, bool, GSParamsPtr>, SersicInfo> cache;
 
         friend class SBInclinedSersic;
         friend class SBInclinedSersic::SBInclinedSersicImpl;
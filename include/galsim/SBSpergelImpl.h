@@ -80,6 +80,17 @@ namespace galsim {
         double calculateIntegratedFlux(double r) const;
         double calculateFluxRadius(double f) const;
 
+        /// @brief An estimate of the memory used by the lookup tables and sampler, in bytes.
+        size_t getMemorySize() const;
+
+        /**
+         * @brief Write and read the calculated values, for the on-disk Info cache.
+         *
+         * read returns false if is does not have valid values for this nu.
+         */
+        void write(std::ostream& os) const;
+        bool read(std::istream& is);
+
     private:
 
         SpergelInfo(const SpergelInfo& rhs); ///< Hide the copy constructor.
@@ -93,15 +104,21 @@ namespace galsim {
         double _gamma_nup1;  ///< Gamma(nu+1)
         double _gamma_nup2;  ///< Gamma(nu+2)
         double _xnorm0   ;   ///< Normalization at r=0 for nu>0
-
-        // Parameters calculated when they are first needed, and then stored:
-        mutable double _maxk;    ///< Value of k beyond which aliasing can be neglected.
-        mutable double _stepk;   ///< Sampling in k space necessary to avoid folding.
-        mutable double _re;      ///< The HLR in units of r0.
+        double _maxk;        ///< Value of k beyond which aliasing can be neglected.
+        double _stepk;       ///< Sampling in k space necessary to avoid folding.
+        double _re;          ///< The HLR in units of r0.
 
         // Classes used for photon shooting
         mutable shared_ptr<FluxDensity> _radial;
         mutable shared_ptr<OneDimensionalDeviate> _sampler;
+        mutable std::mutex _sampler_mutex;  ///< Protects the lazy construction of _sampler.
+    };
+
+    // The LRUCache uses this to keep track of the memory used by each SpergelInfo.
+    template <>
+    struct LRUCacheSize<SpergelInfo>
+    {
+        static size_t Get(const SpergelInfo& info) { return info.getMemorySize(); }
     };
 
     class SBSpergel::SBSpergelImpl : public SBProfileImpl
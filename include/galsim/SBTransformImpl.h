@@ -20,6 +20,8 @@
 #ifndef GalSim_SBTransformImpl_H
 #define GalSim_SBTransformImpl_H
 
+#include <atomic>
+#include <mutex>
 #include "SBProfileImpl.h"
 #include "SBTransform.h"
 
@@ -115,13 +117,19 @@ namespace galsim {
         bool _zeroCen;
         double _major, _minor;
 
-        mutable double _maxk;
-        mutable double _stepk;
+        // These are calculated when first needed.  Several threads may draw this profile at
+        // once, so each is calculated into a local and then stored in one go.
+        mutable std::atomic<double> _maxk;
+        mutable std::atomic<double> _stepk;
+
         mutable double _xmin, _xmax, _ymin, _ymax; ///< Ranges propagated from adaptee
         mutable double _coeff_b, _coeff_c, _coeff_c2; ///< Values used in getYRangeX(x,ymin,ymax);
         mutable std::vector<double> _xsplits, _ysplits; ///< Good split points for the intetegrals
+        mutable std::atomic<bool> _ranges_set; ///< Whether the above have been set up.
+        mutable std::mutex _ranges_mutex; ///< Protects the lazy construction of the above.
 
         void setupRanges() const;
+        void buildRanges() const;
 
         /**
          * @brief Forward coordinate transform with `M` matrix.
@@ -56,6 +56,13 @@ namespace galsim {
         double kValueNoTrunc(double) const;
         double rawXValue(double) const;
 
+        /// @brief An estimate of the memory used by the lookup tables and sampler, in bytes.
+        size_t getMemorySize() const;
+
+        /// @brief Write and read the radial function table, for the on-disk Info cache.
+        void write(std::ostream& os) const;
+        bool read(std::istream& is);
+
     private:
         VonKarmanInfo(const VonKarmanInfo& rhs); ///<Hide the copy constructor
         void operator=(const VonKarmanInfo& rhs); ///<Hide the assignment operator
@@ -72,7 +79,7 @@ namespace galsim {
         bool _doDelta;
         double _hlr; // half-light-radius
 
-        const GSParamsPtr& _gsparams;
+        const GSParamsPtr _gsparams;
 
         TableBuilder _radial;
         shared_ptr<OneDimensionalDeviate> _sampler;
@@ -80,6 +87,13 @@ namespace galsim {
         void _buildRadialFunc();
     };
 
+    // The LRUCache uses this to keep track of the memory used by each VonKarmanInfo.
+    template <>
+    struct LRUCacheSize<VonKarmanInfo>
+    {
+        static size_t Get(const VonKarmanInfo& info) { return info.getMemorySize(); }
+    };
+
     //
     //
     //
@@ -0,0 +1,201 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#ifndef GalSim_ScratchArena_H
+#define GalSim_ScratchArena_H
+
+#include <vector>
+
+#include "Std.h"
+#include "Image.h"
+
+namespace galsim {
+
+    /**
+     * @brief Counters describing how the scratch arenas have been used.
+     *
+     * The values are summed over all threads since the last call to
+     * ScratchArena::resetStats().
+     */
+    struct ScratchArenaStats
+    {
+        long nalloc;        ///< Number of scratch allocations requested.
+        long nbytes;        ///< Total number of bytes requested.
+        long nsys_alloc;    ///< Number of times an arena had to get more memory from the system.
+        long nsys_bytes;    ///< Total number of bytes obtained from the system.
+
+        /// The number of system allocations that were avoided by reusing arena memory.
+        long getAllocsAvoided() const { return nalloc - nsys_alloc; }
+
+        /// The number of bytes that were served from memory the arena already owned.
+        long getBytesAvoided() const
+        { return nbytes > nsys_bytes ? nbytes - nsys_bytes : 0; }
+    };
+
+    /**
+     * @brief A per-thread stack allocator for the temporary buffers used while drawing.
+     *
+     * Many of the fillXImage and fillKImage implementations need some temporary storage
+     * (e.g. the second image in SBAdd, or the single-quadrant image in FillQuadrant).  When
+     * drawing many small stamps, the malloc/free for these temporaries is a noticeable
+     * fraction of the total time.  The arena keeps the memory around between calls, so
+     * after the first few stamps, these allocations are just a pointer bump.
+     *
+     * Allocations must be released in the reverse order they were made.  This is
+     * automatic if you use the ScratchBuffer and ScratchImage classes below, which is
+     * the recommended way to use the arena.
+     *
+     * Each thread has its own arena, so no locking is required.
+     */
+    class ScratchArena
+    {
+    public:
+        /**
+         * @brief Return the arena for the current thread.
+         */
+        static ScratchArena& instance();
+
+        /**
+         * @brief Get nbytes of memory aligned to a 16 byte boundary.
+         */
+        void* allocate(size_t nbytes);
+
+        /**
+         * @brief Release the memory from the most recent allocation that is still active.
+         */
+        void release(void* p);
+
+        /**
+         * @brief Release all memory held by this arena back to the system.
+         *
+         * It is an error to call this while any allocations are still active.
+         */
+        void clear();
+
+        /// The number of bytes currently owned by this arena.
+        size_t getCapacity() const;
+
+        /// The number of bytes currently handed out by this arena.
+        size_t getInUse() const;
+
+        /// The number of allocations that are currently active.
+        int getDepth() const { return int(_marks.size()); }
+
+        //@{
+        /**
+         * @brief Query or reset the usage statistics, summed over all threads.
+         */
+        static ScratchArenaStats getStats();
+        static void resetStats();
+        //@}
+
+        ~ScratchArena();
+
+    private:
+        ScratchArena() {}
+
+        // Consolidate multiple blocks into a single block of the same total size.
+        void consolidate();
+
+        struct Block
+        {
+            char* mem;      // the original allocation
+            char* start;    // the aligned start of usable memory
+            size_t size;    // usable size
+            size_t used;    // how much is currently in use
+        };
+        std::vector<Block> _blocks;
+
+        struct Mark
+        {
+            void* p;        // the pointer that was returned
+            size_t iblock;  // which block it came from
+            size_t used;    // the value of used in that block before the allocation
+        };
+        std::vector<Mark> _marks;
+
+        // Not copyable.
+        ScratchArena(const ScratchArena&);
+        void operator=(const ScratchArena&);
+    };
+
+    /**
+     * @brief A temporary array of n values of type T taken from the current thread's arena.
+     *
+     * The values are not initialized.
+     */
+    template <typename T>
+    class ScratchBuffer
+    {
+    public:
+        ScratchBuffer(size_t n) :
+            _arena(ScratchArena::instance()), _n(n),
+            _data(static_cast<T*>(_arena.allocate(n * sizeof(T)))) {}
+
+        ~ScratchBuffer() { _arena.release(_data); }
+
+        size_t size() const { return _n; }
+        T* begin() { return _data; }
+        T* end() { return _data + _n; }
+        const T* begin() const { return _data; }
+        const T* end() const { return _data + _n; }
+        T& operator[](size_t i) { return _data[i]; }
+        const T& operator[](size_t i) const { return _data[i]; }
+
+    private:
+        ScratchArena& _arena;
+        size_t _n;
+        T* _data;
+
+        ScratchBuffer(const ScratchBuffer&);
+        void operator=(const ScratchBuffer&);
+    };
+
+    /**
+     * @brief A temporary contiguous image whose pixels are taken from the current thread's arena.
+     *
+     * This is a drop-in replacement for ImageAlloc<T> for images that don't outlive the
+     * current scope.  The pixel values are not initialized.  Views of this image must not
+     * be used after it goes out of scope.
+     */
+    template <typename T>
+    class ScratchImage
+    {
+    public:
+        ScratchImage(const Bounds<int>& b) :
+            _buf(size_t(b.getXMax()-b.getXMin()+1) * (b.getYMax()-b.getYMin()+1)),
+            _view(_buf.begin(), shared_ptr<T>(), 1, b.getXMax()-b.getXMin()+1, b) {}
+
+        ScratchImage(int ncol, int nrow) :
+            _buf(size_t(ncol) * nrow),
+            _view(_buf.begin(), shared_ptr<T>(), 1, ncol, Bounds<int>(1,ncol,1,nrow)) {}
+
+        ImageView<T> view() { return _view; }
+        T* getData() { return _view.getData(); }
+        int getStride() const { return _view.getStride(); }
+        int getStep() const { return _view.getStep(); }
+
+    private:
+        ScratchBuffer<T> _buf;
+        ImageView<T> _view;
+    };
+
+}
+
+#endif
@@ -105,6 +105,21 @@ namespace galsim {
 
         void finalize();
 
+        const std::vector<double>& getArgs() const { return _xvec; }
+        const std::vector<double>& getVals() const { return _fvec; }
+
+        /**
+         * @brief An estimate of the memory used by the table, in bytes.
+         *
+         * Once the table is finalized, the interpolation may keep up to one more value per
+         * entry (e.g. the second derivatives for a spline), which is included here.
+         */
+        size_t getMemorySize() const
+        {
+            return (sizeof(*this) + (_xvec.capacity() + _fvec.capacity()) * sizeof(double) +
+                    (_final ? _xvec.size() * sizeof(double) : 0));
+        }
+
     private:
 
         bool _final;
@@ -148,6 +163,14 @@ namespace galsim {
         void gradientGrid(const double* xvec, const double* yvec,
                           double* dfdxvec, double* dfdyvec, int Nx, int Ny) const;
 
+        /// Interpolate and estimate df/dx, df/dy together, which is faster than doing
+        /// interpMany and gradientMany separately.
+        void interpGradMany(const double* xvec, const double* yvec, double* valvec,
+                            double* dfdxvec, double* dfdyvec, int N) const;
+
+        void interpGradGrid(const double* xvec, const double* yvec, double* valvec,
+                            double* dfdxvec, double* dfdyvec, int Nx, int Ny) const;
+
         class Table2DImpl;
     protected:
         const shared_ptr<Table2DImpl> _pimpl;
@@ -0,0 +1,134 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+
+#ifndef GalSim_TableBuilder_H
+#define GalSim_TableBuilder_H
+
+#include <vector>
+#include <exception>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Std.h"
+
+namespace galsim {
+
+    namespace sbp {
+
+        // The maximum number of table nodes that TableNodeEvaluator will evaluate at once.
+        const int max_table_batch = 64;
+
+    }
+
+    /**
+     * @brief Evaluate a function at successive table nodes, several at a time in parallel.
+     *
+     * The lookup tables for profiles like Sersic, Kolmogorov and von Karman are built by
+     * evaluating an expensive function (usually an integral) at one node after another, and
+     * deciding after each one whether the table is finished.  TableNodeEvaluator lets such a
+     * loop keep its structure, while the function is evaluated in parallel for a batch of the
+     * nodes the loop is going to ask for next.
+     *
+     * The nodes are x, x+step, x+step+step, ... or, if geometric is true, x, x*step, ...
+     * These are computed with the same arithmetic as a loop that does x += step (or x *= step)
+     * would use, so they match the loop's values exactly.  If the loop asks for a value that
+     * is not the next node in the current batch, a new batch is started at that value.  Each
+     * batch is twice as long as the previous one (up to sbp::max_table_batch), so a loop that
+     * stops early doesn't waste many evaluations.  Nodes >= xmax are not evaluated in advance.
+     *
+     * The returned values are exactly f(x), regardless of the number of threads.  If f throws
+     * for some node, the exception is only rethrown if the loop actually asks for that node.
+     * f must be safe to call from several threads at once.
+     */
+    template <class F>
+    class TableNodeEvaluator
+    {
+    public:
+        TableNodeEvaluator(const F& f, double step, double xmax, bool geometric=false) :
+            _f(f), _step(step), _xmax(xmax), _geometric(geometric), _next(0)
+        {
+            _nthreads = 1;
+#ifdef _OPENMP
+            // If we are already in a parallel region, there is no point evaluating ahead.
+            if (!omp_in_parallel()) _nthreads = omp_get_max_threads();
+#endif
+            _batch = _nthreads;
+            _max_batch = std::max(_nthreads, sbp::max_table_batch);
+        }
+
+        double operator()(double x)
+        {
+            if (_next == int(_x.size()) || _x[_next] != x) evaluate(x);
+            int i = _next++;
+            if (_error[i]) std::rethrow_exception(_error[i]);
+            return _val[i];
+        }
+
+    private:
+
+        void evaluate(double x)
+        {
+            int n = _batch;
+            if (_nthreads > 1) _batch = std::min(2*_batch, _max_batch);
+            _x.clear();
+            _x.push_back(x);
+            for (int i=1; i<n; ++i) {
+                if (_geometric) x *= _step;
+                else x += _step;
+                if (!(x < _xmax)) break;
+                _x.push_back(x);
+            }
+            n = int(_x.size());
+            _val.resize(n);
+            _error.assign(n, std::exception_ptr());
+            dbg<<"TableNodeEvaluator: evaluate "<<n<<" nodes starting at "<<_x[0]<<std::endl;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(std::min(n, _nthreads)) if (n > 1)
+#endif
+            for (int i=0; i<n; ++i) {
+                try {
+                    _val[i] = _f(_x[i]);
+                } catch (...) {
+                    _error[i] = std::current_exception();
+                }
+            }
+            _next = 0;
+        }
+
+        const F& _f;
+        double _step;
+        double _xmax;
+        bool _geometric;
+        int _nthreads;
+        int _batch;
+        int _max_batch;
+        int _next;
+        std::vector<double> _x;
+        std::vector<double> _val;
+        std::vector<std::exception_ptr> _error;
+    };
+
+}
+
+#endif
@@ -142,10 +142,29 @@
  *
  *     (Which should give 1.75 as the result.)
  *
+ *
+ *
+ * Evaluating Many Points at Once:
+ *
+ *     The GKP algorithm evaluates the function at a whole set of abscissae for each level
+ *     of the rule.  If the function object has a method
+ *
+ *     void evalMany(const double* x, double* f, int n) const
+ *
+ *     then this is called with all the abscissae of each level at once, rather than calling
+ *     operator() for each one.  This is useful when the function can be calculated more
+ *     efficiently for an array of values, e.g. using array versions of Bessel functions or
+ *     by splitting the calculation into simple loops that the compiler can vectorize.
+ *     The results should agree with operator() to rounding error, so the integral agrees
+ *     with the one using operator() to within the integration tolerance.  (It is not
+ *     necessarily the same to the last bit, e.g. when evalMany uses the array versions of
+ *     the Bessel functions.)
+ *
  */
 
 
 #include <functional>
+#include <utility>
 #include <vector>
 #include <queue>
 #include <map>
@@ -158,6 +177,7 @@
 #include <stdexcept>
 
 #include "galsim/Std.h"
+#include "galsim/ScratchArena.h"
 #include "MoreFunctional.h"
 // MJ: I think GKPData10 is more accurate...
 //     But worth doing a more thorough comparison to see.  I just based this assessment on the 
@@ -396,6 +416,41 @@ namespace integ {
     };
 
     namespace {
+        /// Check whether func.evalMany(x, f, n) can be called for a const UF func, with
+        /// const T* x, T* f and int n.  This also finds an evalMany inherited from a base class.
+        template <class UF>
+        struct HasEvalMany
+        {
+            typedef typename UF::result_type T;
+            template <class U> static char test(
+                decltype(std::declval<const U&>().evalMany(
+                        static_cast<const T*>(0), static_cast<T*>(0), 0))*);
+            template <class U> static long test(...);
+            static const bool value = sizeof(test<UF>(0)) == sizeof(char);
+        };
+
+        template <class UF, bool has_eval_many=HasEvalMany<UF>::value>
+        struct EvalManyHelper
+        {
+            typedef typename UF::result_type T;
+            static void call(const UF& func, const T* x, T* f, int n)
+            { for (int i=0; i<n; ++i) f[i] = func(x[i]); }
+        };
+
+        template <class UF>
+        struct EvalManyHelper<UF,true>
+        {
+            typedef typename UF::result_type T;
+            static void call(const UF& func, const T* x, T* f, int n)
+            { func.evalMany(x, f, n); }
+        };
+
+        /// Evaluate f[i] = func(x[i]) for i in [0,n), using func.evalMany if available.
+        template <class UF>
+        inline void evalMany(const UF& func, const typename UF::result_type* x,
+                             typename UF::result_type* f, int n)
+        { EvalManyHelper<UF>::call(func, x, f, n); }
+
         /// Rescale the error if int |f| dx or int |f-mean| dx are too large
         template <class T> 
         inline T rescaleError(
@@ -452,11 +507,6 @@ namespace integ {
             const T half_length =  0.5 * (b - a);
             const T abs_half_length = std::abs(half_length);
             const T center = 0.5 * (b + a);
-            const T f_center = func(center);
-            if (reg.fxmap) (*reg.fxmap)[center] = f_center;
-#ifdef COUNTFEVAL
-            nfeval++;
-#endif
             const int nmax = 2*gkp_x<T>(NGKPLEVELS-1).size()-1;
             std::vector<T> fv1(nmax), fv2(nmax);
 
@@ -467,20 +517,37 @@ namespace integ {
             assert(int(fv1.capacity()) == nmax);
             assert(int(fv2.capacity()) == nmax);
 
+            // The abscissae for each level are evaluated together.  The center is first for
+            // level 0, followed by the pairs (center - abscissa, center + abscissa).
+            const int nlevelmax = 2*gkp_x<T>(NGKPLEVELS-1).size()+1;
+            ScratchBuffer<T> work(2*nlevelmax);
+            T* xv = work.begin();
+            T* fxv = xv + nlevelmax;
+
             assert(gkp_wb<T>(0).size() == gkp_x<T>(0).size()+1);
-            T area1 = gkp_wb<T>(0).back() * f_center;
             int n0 = gkp_x<T>(0).size();
+            xv[0] = center;
             for (int k=0; k<n0; k++) {
                 const T abscissa = half_length * gkp_x<T>(0)[k];
-                const T fval1 = func(center - abscissa);
-                const T fval2 = func(center + abscissa);
+                xv[2*k+1] = center - abscissa;
+                xv[2*k+2] = center + abscissa;
+            }
+            evalMany(func, xv, fxv, 2*n0+1);
+            if (reg.fxmap) {
+                for (int k=0; k<2*n0+1; k++) (*reg.fxmap)[xv[k]] = fxv[k];
+            }
+
+            const T f_center = fxv[0];
+#ifdef COUNTFEVAL
+            nfeval++;
+#endif
+            T area1 = gkp_wb<T>(0).back() * f_center;
+            for (int k=0; k<n0; k++) {
+                const T fval1 = fxv[2*k+1];
+                const T fval2 = fxv[2*k+2];
                 area1 += gkp_wb<T>(0)[k] * (fval1+fval2);
                 fv1.push_back(fval1);
                 fv2.push_back(fval2);
-                if (reg.fxmap) {
-                    (*reg.fxmap)[center-abscissa] = fval1;
-                    (*reg.fxmap)[center+abscissa] = fval2;
-                }
             }
             area1 *= half_length;
 #ifdef COUNTFEVAL
@@ -496,6 +563,17 @@ namespace integ {
                 assert(gkp_wa<T>(level).size() == fv1.size());
                 assert(gkp_wa<T>(level).size() == fv2.size());
                 assert(gkp_wb<T>(level).size() == gkp_x<T>(level).size()+1);
+                int nl = gkp_x<T>(level).size();
+                for (int k=0; k<nl; k++) {
+                    const T abscissa = half_length * gkp_x<T>(level)[k];
+                    xv[2*k] = center - abscissa;
+                    xv[2*k+1] = center + abscissa;
+                }
+                evalMany(func, xv, fxv, 2*nl);
+                if (reg.fxmap) {
+                    for (int k=0; k<2*nl; k++) (*reg.fxmap)[xv[k]] = fxv[k];
+                }
+
                 T area2 = gkp_wb<T>(level).back() * f_center;
                 // int_abs = approximation to integral of abs(f)
                 if (calc_int_abs) int_abs = std::abs(area2);
@@ -505,21 +583,15 @@ namespace integ {
                         int_abs += gkp_wa<T>(level)[k] *
                             (std::abs(fv1[k]) + std::abs(fv2[k]));
                 }
-                int nl = gkp_x<T>(level).size();
                 for (int k=0; k<nl; k++) {
-                    const T abscissa = half_length * gkp_x<T>(level)[k];
-                    const T fval1 = func(center - abscissa);
-                    const T fval2 = func(center + abscissa);
+                    const T fval1 = fxv[2*k];
+                    const T fval2 = fxv[2*k+1];
                     const T fval = fval1 + fval2;
                     area2 += gkp_wb<T>(level)[k] * fval;
                     if (calc_int_abs) 
                         int_abs += gkp_wb<T>(level)[k] * (std::abs(fval1) + std::abs(fval2));
                     fv1.push_back(fval1);
                     fv2.push_back(fval2);
-                    if (reg.fxmap) {
-                        (*reg.fxmap)[center-abscissa] = fval1;
-                        (*reg.fxmap)[center+abscissa] = fval2;
-                    }
                 }
 #ifdef COUNTFEVAL
                 nfeval+=gkp_x<T>(level).size()*2;
@@ -754,6 +826,15 @@ namespace integ {
             typename UF::result_type operator()(
                 typename UF::argument_type x) const 
             { return f(1./x-1.)/(x*x); }
+
+            void evalMany(const typename UF::result_type* x,
+                          typename UF::result_type* fx, int n) const
+            {
+                ScratchBuffer<typename UF::result_type> y(n);
+                for (int i=0; i<n; ++i) y[i] = 1./x[i]-1.;
+                integ::evalMany(f, y.begin(), fx, n);
+                for (int i=0; i<n; ++i) fx[i] /= x[i]*x[i];
+            }
         private:
             const UF& f;
         };
@@ -772,6 +853,15 @@ namespace integ {
             typename UF::result_type operator()(
                 typename UF::argument_type x) const 
             { return f(1./x+1.)/(x*x); }
+
+            void evalMany(const typename UF::result_type* x,
+                          typename UF::result_type* fx, int n) const
+            {
+                ScratchBuffer<typename UF::result_type> y(n);
+                for (int i=0; i<n; ++i) y[i] = 1./x[i]+1.;
+                integ::evalMany(f, y.begin(), fx, n);
+                for (int i=0; i<n; ++i) fx[i] /= x[i]*x[i];
+            }
         private:
             const UF& f;
         };
@@ -781,6 +871,39 @@ namespace integ {
         { return AuxFunc2<UF>(uf); }
     } // anonymous namespace
 
+    namespace {
+        /// Perform a 1-dimensional integral over a region with no split points
+        template <class UF>
+        inline void int1dNoSplit(
+            const UF& func, IntRegion<typename UF::result_type>& reg,
+            const typename UF::result_type& relerr,
+            const typename UF::result_type& abserr)
+        {
+            typedef typename UF::result_type T;
+
+            if (reg.left() <= -MOCK_INF2) {
+                integ_dbg2<<"left = -infinity, right = "<<
+                    reg.right()<<std::endl;
+                assert(reg.right() <= 0.);
+                IntRegion<T> modreg(1./(reg.right()-1.),0.,reg.dbgout);
+                if (reg.fxmap) modreg.useFXMap();
+                intGKP(Aux2<UF>(func),modreg,relerr,abserr);
+                reg.setArea(modreg.getArea(),modreg.getErr());
+            } else if (reg.right() >= MOCK_INF2) {
+                integ_dbg2<<"left = "<<reg.left()<<", right = infinity\n";
+                assert(reg.left() >= 0.);
+                IntRegion<T> modreg(0.,1./(reg.left()+1.),reg.dbgout);
+                if (reg.fxmap) modreg.useFXMap();
+                intGKP(Aux1<UF>(func),modreg,relerr,abserr);
+                reg.setArea(modreg.getArea(),modreg.getErr());
+            } else {
+                integ_dbg2<<"left = "<<reg.left();
+                integ_dbg2<<", right = "<<reg.right()<<std::endl;
+                intGKP(func,reg,relerr,abserr);
+            }
+        }
+    } // anonymous namespace
+
     /// Perform a 1-dimensional integral using an IntRegion
     template <class UF> 
     inline typename UF::result_type int1d(
@@ -800,6 +923,8 @@ namespace integ {
         }
 
         if (reg.getNSplit() > 0) {
+            // The children don't have any split points, and the split at 0 above means that
+            // none of them crosses 0 with an infinite end, so they can be done directly.
             std::vector<IntRegion<T> > children;
             reg.subDivide(children);
             integ_dbg2<<"Subdivided into "<<children.size()<<" children\n";
@@ -810,7 +935,8 @@ namespace integ {
                 integ_dbg2<<"i = "<<i;
                 integ_dbg2<<": bounds = "<<child.left()<<
                     ','<<child.right()<<std::endl;
-                answer += int1d(func,child,relerr,abserr);
+                int1dNoSplit(func,child,relerr,abserr);
+                answer += child.getArea();
                 err += child.getErr();
                 integ_dbg2<<"subint = "<<child.getArea()<<
                     " +- "<<child.getErr()<<std::endl;
@@ -818,26 +944,7 @@ namespace integ {
             reg.setArea(answer,err);
             return answer;
         } else {
-            if (reg.left() <= -MOCK_INF2) {
-                integ_dbg2<<"left = -infinity, right = "<<
-                    reg.right()<<std::endl;
-                assert(reg.right() <= 0.);
-                IntRegion<T> modreg(1./(reg.right()-1.),0.,reg.dbgout);
-                if (reg.fxmap) modreg.useFXMap();
-                intGKP(Aux2<UF>(func),modreg,relerr,abserr);
-                reg.setArea(modreg.getArea(),modreg.getErr());
-            } else if (reg.right() >= MOCK_INF2) {
-                integ_dbg2<<"left = "<<reg.left()<<", right = infinity\n";
-                assert(reg.left() >= 0.);
-                IntRegion<T> modreg(0.,1./(reg.left()+1.),reg.dbgout);
-                if (reg.fxmap) modreg.useFXMap();
-                intGKP(Aux1<UF>(func),modreg,relerr,abserr);
-                reg.setArea(modreg.getArea(),modreg.getErr());
-            } else {
-                integ_dbg2<<"left = "<<reg.left();
-                integ_dbg2<<", right = "<<reg.right()<<std::endl;
-                intGKP(func,reg,relerr,abserr);
-            }
+            int1dNoSplit(func,reg,relerr,abserr);
             integ_dbg2<<"done int1d  answer = "<<reg.getArea();
             integ_dbg2<<" +- "<<reg.getErr()<<std::endl;
             return reg.getArea();
@@ -27,7 +27,7 @@
 namespace galsim {
 namespace math {
 
-    // Functions defined in src/Bessel.cpp
+    // Functions defined in src/math/Bessel.cpp
     double cyl_bessel_j(double nu, double x);
     double cyl_bessel_y(double nu, double x);
     double cyl_bessel_k(double nu, double x);
@@ -37,6 +37,22 @@ namespace math {
     double j0(double x);
     double j1(double x);
 
+    // Array versions of the above, defined in src/math/BesselMany.cpp.
+    // These set f[i] = j0(x[i]), etc., and are faster than calling the scalar versions in a
+    // loop.  x and f may be the same array.
+    //
+    // j0Many and j1Many agree with the scalar versions to within about 1.e-15 (absolute).
+    // kvMany agrees with cyl_bessel_k to about 1.5e-15 (relative) for nu = 0 and 1.  For the
+    // other integer nu <= 20, it uses the upward recurrence from those, and the relative error
+    // grows with nu, to about 7.e-15 at nu = 20.  Other nu just call cyl_bessel_k.
+    // kvMany also differs at the extremes of the range.  Where the scalar version underflows
+    // to 0 (x > ~705), kvMany returns subnormal values.  And for K_0 and K_1 at subnormal x
+    // (e.g. 1.e-310), where the scalar version throws, it returns a finite value for K_0 and
+    // inf for K_1.
+    void j0Many(const double* x, double* f, int n);
+    void j1Many(const double* x, double* f, int n);
+    void kvMany(double nu, const double* x, double* f, int n);
+
 } }
 
 #endif
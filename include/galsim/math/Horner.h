@@ -26,7 +26,8 @@ namespace math {
     // Use Horner's method to evaluate polynomial
     // result[i] = coef[0] + coef[1]*x[i] + coef[2]*x[i]**2 + ...
     // The result array should already be allocated and have the same size as x.
-    void Horner(double* x, const int nx, double* coef, const int nc, double* result);
+    void Horner(const double* x, const int nx, const double* coef, const int nc,
+                double* result);
 
     // 2D version of Horner's method
     // result[i] = coef[0,0] + coef[0,1]*y[i] + coef[0,2]*y[i]**2 + ...
@@ -24,6 +24,30 @@
 namespace galsim {
 namespace math {
 
+    static void _j0Many(size_t ix, size_t iresult, int n)
+    {
+        const double* x = reinterpret_cast<const double*>(ix);
+        double* result = reinterpret_cast<double*>(iresult);
+        ReleaseGIL gil;
+        j0Many(x, result, n);
+    }
+
+    static void _j1Many(size_t ix, size_t iresult, int n)
+    {
+        const double* x = reinterpret_cast<const double*>(ix);
+        double* result = reinterpret_cast<double*>(iresult);
+        ReleaseGIL gil;
+        j1Many(x, result, n);
+    }
+
+    static void _kvMany(double nu, size_t ix, size_t iresult, int n)
+    {
+        const double* x = reinterpret_cast<const double*>(ix);
+        double* result = reinterpret_cast<double*>(iresult);
+        ReleaseGIL gil;
+        kvMany(nu, x, result, n);
+    }
+
     void pyExportBessel(PY_MODULE& _galsim)
     {
         GALSIM_DOT def("j0_root", &getBesselRoot0);
@@ -33,6 +57,9 @@ namespace math {
         GALSIM_DOT def("yv", &cyl_bessel_y);
         GALSIM_DOT def("iv", &cyl_bessel_i);
         GALSIM_DOT def("kv", &cyl_bessel_k);
+        GALSIM_DOT def("j0Many", &_j0Many);
+        GALSIM_DOT def("j1Many", &_j1Many);
+        GALSIM_DOT def("kvMany", &_kvMany);
     }
 
 } // namespace math
@@ -22,14 +22,20 @@
 
 namespace galsim {
 
+    template <typename T>
+    static void CallApplyCD(ImageView<T>& output, const BaseImage<T>& input,
+                            const BaseImage<double>& aL, const BaseImage<double>& aR,
+                            const BaseImage<double>& aB, const BaseImage<double>& aT,
+                            const int dmax, const double gain_ratio)
+    {
+        ReleaseGIL gil;
+        ApplyCD(output, input, aL, aR, aB, aT, dmax, gain_ratio);
+    }
+
     template <typename T>
     static void WrapTemplates(PY_MODULE& _galsim)
     {
-        typedef void (*ApplyCD_func)(ImageView<T>& , const BaseImage<T>& ,
-                                     const BaseImage<double>& , const BaseImage<double>& ,
-                                     const BaseImage<double>& , const BaseImage<double>& ,
-                                     const int , const double );
-        GALSIM_DOT def("_ApplyCD", ApplyCD_func(&ApplyCD));
+        GALSIM_DOT def("_ApplyCD", &CallApplyCD<T>);
     }
 
     void pyExportCDModel(PY_MODULE& _galsim)
@@ -61,18 +61,35 @@ namespace hsm {
         return data;
     }
 
+    template <typename T>
+    static void CallFindAdaptiveMomView(
+        ShapeData& results, const BaseImage<T>& object_image,
+        const BaseImage<int>& object_mask_image, double guess_sig, double precision,
+        Position<double> guess_centroid, bool round_moments, const HSMParams& hsmparams)
+    {
+        ReleaseGIL gil;
+        FindAdaptiveMomView(results, object_image, object_mask_image, guess_sig, precision,
+                            guess_centroid, round_moments, hsmparams);
+    }
+
     template <typename T, typename V>
-    static void WrapTemplates(PY_MODULE& _galsim)
+    static void CallEstimateShearView(
+        ShapeData& results, const BaseImage<T>& gal_image, const BaseImage<V>& PSF_image,
+        const BaseImage<int>& gal_mask_image, float sky_var, const char* shear_est,
+        const char* recompute_flux, double guess_sig_gal, double guess_sig_PSF,
+        double precision, Position<double> guess_centroid, const HSMParams& hsmparams)
     {
-        typedef void (*FAM_func)(ShapeData&, const BaseImage<T>&, const BaseImage<int>&,
-                                 double, double, Position<double>, bool, const HSMParams&);
-        GALSIM_DOT def("_FindAdaptiveMomView", FAM_func(&FindAdaptiveMomView));
+        ReleaseGIL gil;
+        EstimateShearView(results, gal_image, PSF_image, gal_mask_image, sky_var, shear_est,
+                          recompute_flux, guess_sig_gal, guess_sig_PSF, precision,
+                          guess_centroid, hsmparams);
+    }
 
-        typedef void (*ESH_func)(ShapeData&, const BaseImage<T>&, const BaseImage<V>&,
-                                 const BaseImage<int>&, float, const char *,
-                                 const char*, double, double, double, Position<double>,
-                                 const HSMParams&);
-        GALSIM_DOT def("_EstimateShearView", ESH_func(&EstimateShearView));
+    template <typename T, typename V>
+    static void WrapTemplates(PY_MODULE& _galsim)
+    {
+        GALSIM_DOT def("_FindAdaptiveMomView", &CallFindAdaptiveMomView<T>);
+        GALSIM_DOT def("_EstimateShearView", &CallEstimateShearView<T,V>);
     };
 
     void pyExportHSM(PY_MODULE& _galsim)
@@ -28,6 +28,7 @@ namespace math {
         double* x = reinterpret_cast<double*>(ix);
         double* coef = reinterpret_cast<double*>(icoef);
         double* result = reinterpret_cast<double*>(iresult);
+        ReleaseGIL gil;
         Horner(x, nx, coef, nc, result);
     }
 
@@ -39,6 +40,7 @@ namespace math {
         double* coef = reinterpret_cast<double*>(icoef);
         double* result = reinterpret_cast<double*>(iresult);
         double* temp = reinterpret_cast<double*>(itemp);
+        ReleaseGIL gil;
         Horner2D(x, y, nx, coef, ncx, ncy, result, temp);
     }
 
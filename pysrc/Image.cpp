@@ -19,6 +19,7 @@
 
 #include "PyBind11Helper.h"
 #include "Image.h"
+#include "FFT.h"
 
 // Note that docstrings are now added in galsim/image.py
 namespace galsim {
@@ -32,6 +33,39 @@ namespace galsim {
         return new ImageView<T>(data, owner, step, stride, bounds);
     }
 
+    // The FFTs and the wrapping can take a while for large images, so release the GIL for them.
+    template <typename T>
+    static void CallRFFT(const BaseImage<T>& in, ImageView<std::complex<double> > out,
+                         bool shift_in, bool shift_out)
+    {
+        ReleaseGIL gil;
+        rfft(in, out, shift_in, shift_out);
+    }
+
+    template <typename T, typename U>
+    static void CallIRFFT(const BaseImage<T>& in, ImageView<U> out,
+                          bool shift_in, bool shift_out)
+    {
+        ReleaseGIL gil;
+        irfft(in, out, shift_in, shift_out);
+    }
+
+    template <typename T>
+    static void CallCFFT(const BaseImage<T>& in, ImageView<std::complex<double> > out,
+                         bool inverse, bool shift_in, bool shift_out)
+    {
+        ReleaseGIL gil;
+        cfft(in, out, inverse, shift_in, shift_out);
+    }
+
+    template <typename T>
+    static void CallWrapImage(ImageView<T> im, const Bounds<int>& bounds,
+                              bool hermx, bool hermy)
+    {
+        ReleaseGIL gil;
+        wrapImage(im, bounds, hermx, hermy);
+    }
+
     template <typename T>
     static void WrapImage(PY_MODULE& _galsim, const std::string& suffix)
     {
@@ -43,17 +77,11 @@ namespace galsim {
             GALSIM_COMMA ("ImageView" + suffix).c_str() BP_NOINIT)
             .def(PY_INIT((Make_func)&MakeFromArray));
 
-        typedef void (*rfft_func_type)(const BaseImage<T>&, ImageView<std::complex<double> >,
-                                       bool, bool);
-        typedef void (*irfft_func_type)(const BaseImage<T>&, ImageView<double>, bool, bool);
-        typedef void (*cfft_func_type)(const BaseImage<T>&, ImageView<std::complex<double> >,
-                                       bool, bool, bool);
-        GALSIM_DOT def("rfft", rfft_func_type(&rfft));
-        GALSIM_DOT def("irfft", irfft_func_type(&irfft));
-        GALSIM_DOT def("cfft", cfft_func_type(&cfft));
-
-        typedef void (*wrap_func_type)(ImageView<T>, const Bounds<int>&, bool, bool);
-        GALSIM_DOT def("wrapImage", wrap_func_type(&wrapImage));
+        GALSIM_DOT def("rfft", &CallRFFT<T>);
+        GALSIM_DOT def("irfft", &CallIRFFT<T,double>);
+        GALSIM_DOT def("irfft", &CallIRFFT<T,float>);
+        GALSIM_DOT def("cfft", &CallCFFT<T>);
+        GALSIM_DOT def("wrapImage", &CallWrapImage<T>);
 
         typedef void (*invert_func_type)(ImageView<T>);
         GALSIM_DOT def("invertImage", invert_func_type(&invertImage));
@@ -71,6 +99,19 @@ namespace galsim {
         WrapImage<std::complex<float> >(_galsim, "CF");
 
         GALSIM_DOT def("goodFFTSize", &goodFFTSize);
+
+        GALSIM_DOT def("SetFFTWPlanMode", &SetFFTWPlanMode);
+        GALSIM_DOT def("GetFFTWPlanMode", &GetFFTWPlanMode);
+        GALSIM_DOT def("ClearFFTWPlanCache", &ClearFFTWPlanCache);
+        GALSIM_DOT def("GetFFTWPlanCacheSize", &GetFFTWPlanCacheSize);
+        GALSIM_DOT def("ImportFFTWWisdom", &ImportFFTWWisdom);
+        GALSIM_DOT def("ExportFFTWWisdom", &ExportFFTWWisdom);
+        GALSIM_DOT def("FFTWHasThreads", &FFTWHasThreads);
+        GALSIM_DOT def("FFTWHasSinglePrecision", &FFTWHasSinglePrecision);
+        GALSIM_DOT def("SetFFTWNumThreads", &SetFFTWNumThreads);
+        GALSIM_DOT def("GetFFTWNumThreads", &GetFFTWNumThreads);
+        GALSIM_DOT def("SetFFTWThreadsMinSize", &SetFFTWThreadsMinSize);
+        GALSIM_DOT def("GetFFTWThreadsMinSize", &GetFFTWThreadsMinSize);
     }
 
 } // namespace galsim
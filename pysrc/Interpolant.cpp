@@ -26,12 +26,14 @@ namespace galsim {
     static void XvalMany(const Interpolant& interp, size_t ivals, int N)
     {
         double* vals = reinterpret_cast<double*>(ivals);
+        ReleaseGIL gil;
         interp.xvalMany(vals, N);
     }
 
     static void UvalMany(const Interpolant& interp, size_t ivals, int N)
     {
         double* vals = reinterpret_cast<double*>(ivals);
+        ReleaseGIL gil;
         interp.uvalMany(vals, N);
     }
 
@@ -42,6 +44,7 @@ namespace galsim {
             .def("uval", &Interpolant::uval)
             .def("xvalMany", &XvalMany)
             .def("uvalMany", &UvalMany)
+            .def("isXvalTabulated", &Interpolant::isXvalTabulated)
             .def("getPositiveFlux", &Interpolant::getPositiveFlux)
             .def("getNegativeFlux", &Interpolant::getNegativeFlux)
             .def("urange", &Interpolant::urange);
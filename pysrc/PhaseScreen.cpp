@@ -0,0 +1,82 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include "PyBind11Helper.h"
+#include "PhaseScreen.h"
+
+namespace galsim {
+
+    static void CallMakeRandomPhaseScreen(ImageView<double> screen, const BaseImage<double>& psi,
+                                          BaseDeviate rng)
+    {
+        ReleaseGIL gil;
+        MakeRandomPhaseScreen(screen, psi, rng);
+    }
+
+    static void CallBoilPhaseScreen(ImageView<double> screen, const BaseImage<double>& psi,
+                                    BaseDeviate rng, double alpha, int nstep)
+    {
+        ReleaseGIL gil;
+        BoilPhaseScreen(screen, psi, rng, alpha, nstep);
+    }
+
+    static PhaseScreenEngine* MakePhaseScreenEngine(size_t iu, size_t iv, size_t iindex,
+                                                    int npoints, int nx, int ny)
+    {
+        const double* u = reinterpret_cast<const double*>(iu);
+        const double* v = reinterpret_cast<const double*>(iv);
+        const int* index = reinterpret_cast<const int*>(iindex);
+        return new PhaseScreenEngine(u, v, index, npoints, nx, ny);
+    }
+
+    static void AddFixedLayer(PhaseScreenEngine& engine, size_t iwf)
+    {
+        engine.addFixedLayer(reinterpret_cast<const double*>(iwf));
+    }
+
+    static void Wavefront(const PhaseScreenEngine& engine, size_t iwf,
+                          double t, double tanx, double tany)
+    {
+        double* wf = reinterpret_cast<double*>(iwf);
+        ReleaseGIL gil;
+        engine.wavefront(wf, t, tanx, tany);
+    }
+
+    static void Integrate(const PhaseScreenEngine& engine, ImageView<double> image,
+                          size_t itimes, int ntimes, double lam, double tanx, double tany)
+    {
+        const double* times = reinterpret_cast<const double*>(itimes);
+        ReleaseGIL gil;
+        engine.integrate(image, times, ntimes, lam, tanx, tany);
+    }
+
+    void pyExportPhaseScreen(PY_MODULE& _galsim)
+    {
+        py::class_<PhaseScreenEngine>(GALSIM_COMMA "PhaseScreenEngine" BP_NOINIT)
+            .def(PY_INIT(&MakePhaseScreenEngine))
+            .def("addTableLayer", &PhaseScreenEngine::addTableLayer)
+            .def("addFixedLayer", &AddFixedLayer)
+            .def("wavefront", &Wavefront)
+            .def("integrate", &Integrate);
+
+        GALSIM_DOT def("MakeRandomPhaseScreen", &CallMakeRandomPhaseScreen);
+        GALSIM_DOT def("BoilPhaseScreen", &CallBoilPhaseScreen);
+    }
+
+} // namespace galsim
@@ -22,10 +22,23 @@
 
 namespace galsim {
 
+    template <typename T>
+    static double AddTo(const PhotonArray& photons, ImageView<T> target)
+    {
+        ReleaseGIL gil;
+        return photons.addTo(target);
+    }
+
+    static void Convolve(PhotonArray& photons, const PhotonArray& rhs, BaseDeviate ud)
+    {
+        ReleaseGIL gil;
+        photons.convolve(rhs, ud);
+    }
+
     template <typename T, typename W>
     static void WrapTemplates(W& wrapper) {
         wrapper
-            .def("addTo", (double (PhotonArray::*)(ImageView<T>) const) &PhotonArray::addTo)
+            .def("addTo", &AddTo<T>)
             .def("setFrom",
                  (int (PhotonArray::*)(const BaseImage<T>&, double, BaseDeviate))
                  &PhotonArray::setFrom);
@@ -48,7 +61,7 @@ namespace galsim {
         py::class_<PhotonArray> pyPhotonArray(GALSIM_COMMA "PhotonArray" BP_NOINIT);
         pyPhotonArray
             .def(PY_INIT(&construct))
-            .def("convolve", &PhotonArray::convolve);
+            .def("convolve", &Convolve);
         WrapTemplates<double>(pyPhotonArray);
         WrapTemplates<float>(pyPhotonArray);
     }
@@ -82,4 +82,19 @@ namespace py = pybind11;
 
 #endif
 
+// Release the GIL for the lifetime of this object, so other Python threads can run while we
+// do some long calculation in C++.  This works the same way for boost python and pybind11.
+// Only use this in wrapper functions that don't touch any Python objects until it goes out
+// of scope, and where everything the C++ code uses is safe to share between threads.
+class ReleaseGIL
+{
+public:
+    ReleaseGIL() : _state(PyEval_SaveThread()) {}
+    ~ReleaseGIL() { PyEval_RestoreThread(_state); }
+private:
+    ReleaseGIL(const ReleaseGIL&);
+    void operator=(const ReleaseGIL&);
+    PyThreadState* _state;
+};
+
 #endif
@@ -46,16 +46,47 @@ namespace galsim {
         rng.generateFromExpectation(N, data);
     }
 
+    void GenerateFromExpectationBatch(PoissonDeviate& rng, size_t N, size_t idata,
+                                      double normal_threshold)
+    {
+        double* data = reinterpret_cast<double*>(idata);
+        rng.generateFromExpectationBatch(N, data, normal_threshold);
+    }
+
+    template <typename T>
+    static void CallAddGaussianNoise(ImageView<T> image, BaseDeviate rng, double sigma)
+    {
+        ReleaseGIL gil;
+        AddGaussianNoise(image, rng, sigma);
+    }
+
+    template <typename T>
+    static void CallAddCCDNoise(ImageView<T> image, BaseDeviate rng,
+                                double sky_level, double gain, double read_noise)
+    {
+        ReleaseGIL gil;
+        AddCCDNoise(image, rng, sky_level, gain, read_noise);
+    }
+
+    template <typename T>
+    static void WrapNoise(PY_MODULE& _galsim)
+    {
+        GALSIM_DOT def("AddGaussianNoise", &CallAddGaussianNoise<T>);
+        GALSIM_DOT def("AddCCDNoise", &CallAddCCDNoise<T>);
+    }
+
     void pyExportRandom(PY_MODULE& _galsim)
     {
         py::class_<BaseDeviate> (GALSIM_COMMA "BaseDeviateImpl" BP_NOINIT)
             .def(py::init<long>())
+            .def(py::init<long, const char*>())
             .def(py::init<const BaseDeviate&>())
             .def(py::init<const char*>())
             .def("seed", (void (BaseDeviate::*) (long) )&BaseDeviate::seed)
             .def("reset", (void (BaseDeviate::*) (const BaseDeviate&) )&BaseDeviate::reset)
             .def("clearCache", &BaseDeviate::clearCache)
             .def("serialize", &BaseDeviate::serialize)
+            .def("getEngine", &BaseDeviate::getEngine)
             .def("discard", &BaseDeviate::discard)
             .def("raw", &BaseDeviate::raw)
             .def("generate", &Generate)
@@ -81,7 +112,8 @@ namespace galsim {
             GALSIM_COMMA "PoissonDeviateImpl" BP_NOINIT)
             .def(py::init<const BaseDeviate&, double>())
             .def("generate1", &PoissonDeviate::generate1)
-            .def("generate_from_expectation", &GenerateFromExpectation);
+            .def("generate_from_expectation", &GenerateFromExpectation)
+            .def("generate_from_expectation_batch", &GenerateFromExpectationBatch);
 
         py::class_<WeibullDeviate, BP_BASES(BaseDeviate)>(
             GALSIM_COMMA "WeibullDeviateImpl" BP_NOINIT)
@@ -97,6 +129,13 @@ namespace galsim {
             GALSIM_COMMA "Chi2DeviateImpl" BP_NOINIT)
             .def(py::init<const BaseDeviate&, double>())
             .def("generate1", &Chi2Deviate::generate1);
+
+        WrapNoise<uint16_t>(_galsim);
+        WrapNoise<uint32_t>(_galsim);
+        WrapNoise<int16_t>(_galsim);
+        WrapNoise<int32_t>(_galsim);
+        WrapNoise<float>(_galsim);
+        WrapNoise<double>(_galsim);
     }
 
 } // namespace galsim
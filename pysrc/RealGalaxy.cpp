@@ -32,6 +32,7 @@ namespace galsim {
         const double* w = reinterpret_cast<const double*>(w_data);
         const CD* kimgs = reinterpret_cast<const CD*>(kimgs_data);
         const CD* psf = reinterpret_cast<const CD*>(psf_data);
+        ReleaseGIL gil;
         ComputeCRGCoefficients(coef, Sigma, w, kimgs, psf, nsed, nband, nkx, nky);
     };
 
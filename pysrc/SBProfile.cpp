@@ -20,15 +20,84 @@
 #include "PyBind11Helper.h"
 #include "SBProfile.h"
 #include "SBTransform.h"
+#include "ScratchArena.h"
+#include "DrawFFT.h"
+#include "InfoCache.h"
+#include "LRUCache.h"
 
 namespace galsim {
 
+    template <typename T>
+    static void Draw(const SBProfile& prof, ImageView<T> image, double dx)
+    {
+        ReleaseGIL gil;
+        prof.draw(image, dx);
+    }
+
+    template <typename T>
+    static void DrawK(const SBProfile& prof, ImageView<std::complex<T> > image, double dk)
+    {
+        ReleaseGIL gil;
+        prof.drawK(image, dk);
+    }
+
+    static void Shoot(const SBProfile& prof, PhotonArray& photons, BaseDeviate rng)
+    {
+        ReleaseGIL gil;
+        prof.shoot(photons, rng);
+    }
+
     template <typename T, typename W>
     static void WrapTemplates(W& wrapper)
     {
-        wrapper.def("draw", (void (SBProfile::*)(ImageView<T>, double) const)&SBProfile::draw);
-        wrapper.def("drawK", (void (SBProfile::*)(ImageView<std::complex<T> >, double) const)
-                    &SBProfile::drawK);
+        wrapper.def("draw", &Draw<T>);
+        wrapper.def("drawK", &DrawK<T>);
+    }
+
+    template <typename T>
+    static void DrawFFTManyHelper(
+        const std::vector<SBProfile>& profiles, std::vector<ImageView<T> >& images,
+        size_t iNk, size_t iN, size_t idk, bool add_to_image, size_t iflux)
+    {
+        const int n = int(profiles.size());
+        const int* Nk = reinterpret_cast<const int*>(iNk);
+        const int* N = reinterpret_cast<const int*>(iN);
+        const double* dk = reinterpret_cast<const double*>(idk);
+        double* flux = reinterpret_cast<double*>(iflux);
+        std::vector<double> added_flux;
+        ReleaseGIL gil;
+        drawFFTMany(profiles, images, std::vector<int>(Nk, Nk+n), std::vector<int>(N, N+n),
+                    std::vector<double>(dk, dk+n), add_to_image, added_flux);
+        std::copy(added_flux.begin(), added_flux.end(), flux);
+    }
+
+#ifdef USE_BOOST
+    template <typename T>
+    static void DrawFFTMany(const py::object& profs, const py::object& ims,
+                            size_t iNk, size_t iN, size_t idk, bool add_to_image, size_t iflux)
+    {
+        py::stl_input_iterator<SBProfile> piter(profs), pend;
+        std::vector<SBProfile> profiles(piter, pend);
+        py::stl_input_iterator<ImageView<T> > iiter(ims), iend;
+        std::vector<ImageView<T> > images(iiter, iend);
+        DrawFFTManyHelper(profiles, images, iNk, iN, idk, add_to_image, iflux);
+    }
+#else
+    template <typename T>
+    static void DrawFFTMany(const std::vector<SBProfile>& profiles,
+                            std::vector<ImageView<T> > images,
+                            size_t iNk, size_t iN, size_t idk, bool add_to_image, size_t iflux)
+    {
+        DrawFFTManyHelper(profiles, images, iNk, iN, idk, add_to_image, iflux);
+    }
+#endif
+
+    static py::list GetLRUCacheNameList()
+    {
+        std::vector<std::string> names = GetLRUCacheNames();
+        py::list ret;
+        for (size_t i=0; i<names.size(); ++i) ret.append(names[i]);
+        return ret;
     }
 
     void pyExportSBProfile(PY_MODULE& _galsim)
@@ -36,7 +105,7 @@ namespace galsim {
         py::class_<GSParams>(GALSIM_COMMA "GSParams" BP_NOINIT)
             .def(py::init<
                  int, int, double, double, double, double, double, double, double, double,
-                 double, double, double>());
+                 double, double, double, bool, bool, bool>());
 
         py::class_<SBProfile> pySBProfile(GALSIM_COMMA "SBProfile" BP_NOINIT);
         pySBProfile
@@ -49,9 +118,40 @@ namespace galsim {
             .def("getPositiveFlux", &SBProfile::getPositiveFlux)
             .def("getNegativeFlux", &SBProfile::getNegativeFlux)
             .def("maxSB", &SBProfile::maxSB)
-            .def("shoot", &SBProfile::shoot);
+            .def("shoot", &Shoot);
         WrapTemplates<float>(pySBProfile);
         WrapTemplates<double>(pySBProfile);
+
+        py::class_<ScratchArenaStats>(GALSIM_COMMA "ScratchArenaStats" BP_NOINIT)
+            .def_readonly("nalloc", &ScratchArenaStats::nalloc)
+            .def_readonly("nbytes", &ScratchArenaStats::nbytes)
+            .def_readonly("nsys_alloc", &ScratchArenaStats::nsys_alloc)
+            .def_readonly("nsys_bytes", &ScratchArenaStats::nsys_bytes)
+            .def_property_readonly("allocs_avoided", &ScratchArenaStats::getAllocsAvoided)
+            .def_property_readonly("bytes_avoided", &ScratchArenaStats::getBytesAvoided);
+        GALSIM_DOT def("GetScratchArenaStats", &ScratchArena::getStats);
+        GALSIM_DOT def("ResetScratchArenaStats", &ScratchArena::resetStats);
+
+        GALSIM_DOT def("drawFFTManyD", &DrawFFTMany<double>);
+        GALSIM_DOT def("drawFFTManyF", &DrawFFTMany<float>);
+
+        GALSIM_DOT def("SetInfoCacheDir", &SetInfoCacheDir);
+        GALSIM_DOT def("GetInfoCacheDir", &GetInfoCacheDir);
+
+        py::class_<LRUCacheStats>(GALSIM_COMMA "LRUCacheStats" BP_NOINIT)
+            .def_readonly("nhit", &LRUCacheStats::nhit)
+            .def_readonly("nmiss", &LRUCacheStats::nmiss)
+            .def_readonly("nevict", &LRUCacheStats::nevict)
+            .def_readonly("build_time", &LRUCacheStats::build_time)
+            .def_readonly("nentries", &LRUCacheStats::nentries)
+            .def_readonly("nbytes", &LRUCacheStats::nbytes)
+            .def_readonly("max_entries", &LRUCacheStats::max_entries)
+            .def_readonly("max_bytes", &LRUCacheStats::max_bytes);
+        GALSIM_DOT def("GetLRUCacheNames", &GetLRUCacheNameList);
+        GALSIM_DOT def("GetLRUCacheStats", &GetLRUCacheStats);
+        GALSIM_DOT def("ResetLRUCacheStats", &ResetLRUCacheStats);
+        GALSIM_DOT def("SetLRUCacheSize", &SetLRUCacheSize);
+        GALSIM_DOT def("ClearLRUCache", &ClearLRUCache);
     }
 
 } // namespace galsim
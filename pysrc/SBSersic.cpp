@@ -30,6 +30,9 @@ namespace galsim {
         GALSIM_DOT def("SersicTruncatedScale", &SersicTruncatedScale);
         GALSIM_DOT def("SersicIntegratedFlux", &SersicIntegratedFlux);
         GALSIM_DOT def("SersicHLR", &SersicHLR);
+        GALSIM_DOT def("LoadSersicGrid", &LoadSersicGrid);
+        GALSIM_DOT def("WriteSersicGrid", &WriteSersicGrid);
+        GALSIM_DOT def("SetSersicGridFile", &SetSersicGridFile);
     }
 
 } // namespace galsim
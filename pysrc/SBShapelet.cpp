@@ -27,7 +27,10 @@ namespace galsim {
                     const Position<double>& center)
     {
         LVector bvec(order);
-        ShapeletFitImage(sigma, bvec, image, scale, center);
+        {
+            ReleaseGIL gil;
+            ShapeletFitImage(sigma, bvec, image, scale, center);
+        }
 
         double* data = reinterpret_cast<double*>(idata);
         int size = PQIndex::size(order);
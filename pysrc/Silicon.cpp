@@ -23,14 +23,26 @@
 
 namespace galsim {
 
+    template <typename T>
+    static double Accumulate(Silicon& silicon, const PhotonArray& photons, BaseDeviate rng,
+                             ImageView<T> target, Position<int> orig_center, bool resume)
+    {
+        ReleaseGIL gil;
+        return silicon.accumulate(photons, rng, target, orig_center, resume);
+    }
+
+    template <typename T>
+    static void FillWithPixelAreas(Silicon& silicon, ImageView<T> target,
+                                   Position<int> orig_center)
+    {
+        ReleaseGIL gil;
+        silicon.fillWithPixelAreas(target, orig_center);
+    }
+
     template <typename T, typename W>
     static void WrapTemplates(W& wrapper) {
-        typedef double (Silicon::*accumulate_fn)(const PhotonArray&, BaseDeviate,
-                                                 ImageView<T>, Position<int>, bool);
-        typedef void (Silicon::*area_fn)(ImageView<T>, Position<int>);
-
-        wrapper.def("accumulate", (accumulate_fn)&Silicon::accumulate);
-        wrapper.def("fill_with_pixel_areas", (area_fn)&Silicon::fillWithPixelAreas);
+        wrapper.def("accumulate", &Accumulate<T>);
+        wrapper.def("fill_with_pixel_areas", &FillWithPixelAreas<T>);
     }
 
     static Silicon* MakeSilicon(
@@ -50,6 +50,7 @@ namespace galsim {
     {
         const double* args = reinterpret_cast<const double*>(iargs);
         double* vals = reinterpret_cast<double*>(ivals);
+        ReleaseGIL gil;
         table.interpMany(args, vals, N);
     }
 
@@ -98,6 +99,7 @@ namespace galsim {
         const double* x = reinterpret_cast<const double*>(ix);
         const double* y = reinterpret_cast<const double*>(iy);
         double* vals = reinterpret_cast<double*>(ivals);
+        ReleaseGIL gil;
         table2d.interpMany(x, y, vals, N);
     }
 
@@ -106,6 +108,7 @@ namespace galsim {
         const double* x = reinterpret_cast<const double*>(ix);
         const double* y = reinterpret_cast<const double*>(iy);
         double* vals = reinterpret_cast<double*>(ivals);
+        ReleaseGIL gil;
         table2d.interpGrid(x, y, vals, Nx, Ny);
     }
 
@@ -122,6 +125,7 @@ namespace galsim {
         const double* y = reinterpret_cast<const double*>(iy);
         double* dfdx = reinterpret_cast<double*>(idfdx);
         double* dfdy = reinterpret_cast<double*>(idfdy);
+        ReleaseGIL gil;
         table2d.gradientMany(x, y, dfdx, dfdy, N);
     }
 
@@ -132,9 +136,34 @@ namespace galsim {
         const double* y = reinterpret_cast<const double*>(iy);
         double* dfdx = reinterpret_cast<double*>(idfdx);
         double* dfdy = reinterpret_cast<double*>(idfdy);
+        ReleaseGIL gil;
         table2d.gradientGrid(x, y, dfdx, dfdy, Nx, Ny);
     }
 
+    static void InterpGradMany(const Table2D& table2d, size_t ix, size_t iy, size_t ivals,
+                               size_t idfdx, size_t idfdy, int N)
+    {
+        const double* x = reinterpret_cast<const double*>(ix);
+        const double* y = reinterpret_cast<const double*>(iy);
+        double* vals = reinterpret_cast<double*>(ivals);
+        double* dfdx = reinterpret_cast<double*>(idfdx);
+        double* dfdy = reinterpret_cast<double*>(idfdy);
+        ReleaseGIL gil;
+        table2d.interpGradMany(x, y, vals, dfdx, dfdy, N);
+    }
+
+    static void InterpGradGrid(const Table2D& table2d, size_t ix, size_t iy, size_t ivals,
+                               size_t idfdx, size_t idfdy, int Nx, int Ny)
+    {
+        const double* x = reinterpret_cast<const double*>(ix);
+        const double* y = reinterpret_cast<const double*>(iy);
+        double* vals = reinterpret_cast<double*>(ivals);
+        double* dfdx = reinterpret_cast<double*>(idfdx);
+        double* dfdy = reinterpret_cast<double*>(idfdy);
+        ReleaseGIL gil;
+        table2d.interpGradGrid(x, y, vals, dfdx, dfdy, Nx, Ny);
+    }
+
     static void _WrapArrayToPeriod(size_t ix, int n, double x0, double period)
     {
         double* x = reinterpret_cast<double*>(ix);
@@ -159,7 +188,9 @@ namespace galsim {
             .def("interpGrid", &InterpGrid)
             .def("gradient", &Gradient)
             .def("gradientMany", &GradientMany)
-            .def("gradientGrid", &GradientGrid);
+            .def("gradientGrid", &GradientGrid)
+            .def("interpGradMany", &InterpGradMany)
+            .def("interpGradGrid", &InterpGradGrid);
 
         GALSIM_DOT def("WrapArrayToPeriod", &_WrapArrayToPeriod);
     }
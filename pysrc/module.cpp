@@ -52,6 +52,7 @@ namespace galsim {
     void pyExportSilicon(PY_MODULE&);
     void pyExportRealGalaxy(PY_MODULE&);
     void pyExportWCS(PY_MODULE&);
+    void pyExportPhaseScreen(PY_MODULE&);
 
     namespace hsm {
         void pyExportHSM(PY_MODULE&);
@@ -103,6 +104,7 @@ PYBIND11_MODULE(_galsim, _galsim)
     galsim::pyExportSilicon(_galsim);
     galsim::pyExportRealGalaxy(_galsim);
     galsim::pyExportWCS(_galsim);
+    galsim::pyExportPhaseScreen(_galsim);
 
     galsim::hsm::pyExportHSM(_galsim);
     galsim::integ::pyExportInteg(_galsim);
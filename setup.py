@@ -664,10 +664,29 @@ def add_dirs(builder, output=False):
     # Look for fftw3.
     fftw_lib = find_fftw_lib(output=output)
     fftw_libpath, fftw_libname = os.path.split(fftw_lib)
+
+    # If the threaded version of fftw3 is installed alongside it, use that too.
+    global use_fftw_threads
+    fftw_threads_lib = fftw_libname.replace('fftw3', 'fftw3_threads', 1)
+    use_fftw_threads = os.path.isfile(os.path.join(fftw_libpath, fftw_threads_lib))
+    if output:
+        print('Using fftw3_threads' if use_fftw_threads else 'Not using fftw3_threads')
+
+    # Likewise the single-precision version.
+    global use_fftwf
+    fftwf_lib = fftw_libname.replace('fftw3', 'fftw3f', 1)
+    use_fftwf = os.path.isfile(os.path.join(fftw_libpath, fftwf_lib))
+    if output:
+        print('Using fftw3f' if use_fftwf else 'Not using fftw3f')
+
     if hasattr(builder, 'library_dirs'):
         if fftw_libpath != '':
             builder.library_dirs.append(fftw_libpath)
         builder.libraries.append('galsim')  # Make sure galsim comes before fftw3
+        if use_fftw_threads:
+            builder.libraries.append(fftw_threads_lib.split('.')[0][3:])
+        if use_fftwf:
+            builder.libraries.append(fftwf_lib.split('.')[0][3:])
         builder.libraries.append(os.path.split(fftw_lib)[1].split('.')[0][3:])
     fftw_include = os.path.join(os.path.split(fftw_libpath)[0], 'include')
     if os.path.isfile(os.path.join(fftw_include, 'fftw3.h')):
@@ -735,6 +754,8 @@ def parse_njobs(njobs, task=None, command=None, maxn=4):
                 print('Using %d cpus for %s'%(njobs,task))
     return njobs
 
+use_fftw_threads = False  # Set in add_dirs if libfftw3_threads is found.
+use_fftwf = False         # Set in add_dirs if libfftw3f is found.
 do_output = True  # Keep track of whether we used output=True in add_dirs yet.
                   # It seems that different installation methods do things in different order,
                   # but we only want to output on the first pass through add_dirs.
@@ -769,6 +790,12 @@ class my_build_clib(build_clib):
         for (lib_name, build_info) in libraries:
             build_info['cflags'] = build_info.get('cflags',[]) + cflags
             build_info['lflags'] = build_info.get('lflags',[]) + lflags
+            if use_fftw_threads:
+                build_info['macros'] = (build_info.get('macros',[]) +
+                                        [('GALSIM_USE_FFTW_THREADS', None)])
+            if use_fftwf:
+                build_info['macros'] = (build_info.get('macros',[]) +
+                                        [('GALSIM_USE_FFTWF', None)])
 
         # Now run the normal build function.
         build_clib.build_libraries(self, libraries)
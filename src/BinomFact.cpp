@@ -23,81 +23,95 @@
 
 namespace galsim {
 
+    // The tables are built the first time they are needed.  C++11 guarantees that the
+    // initialization of a function-level static is thread-safe, and after that the tables
+    // are never modified, so these functions are safe to call from multiple threads.
+    // Values past the end of the tables are computed from the last tabulated entry.
+
+    // 170! is the largest factorial that fits in a double.
+    static const int nfact = 171;
+    static const int nsqrt = 512;
+    static const int nbinom = 128;
+
+    static std::vector<double> BuildFactTable()
+    {
+        std::vector<double> f(nfact);
+        f[0] = 1.;
+        for(int j=1;j<nfact;j++) f[j] = f[j-1]*(double)j;
+        return f;
+    }
+
+    static std::vector<double> BuildSqrtFactTable()
+    {
+        std::vector<double> f(nsqrt);
+        f[0] = 1.;
+        for(int j=1;j<nsqrt;j++) f[j] = f[j-1]*std::sqrt((double)j);
+        return f;
+    }
+
+    static std::vector<std::vector<double> > BuildBinomTable()
+    {
+        std::vector<std::vector<double> > f(nbinom);
+        f[0] = std::vector<double>(1,1.);
+        for(int i1=1;i1<nbinom;i1++) {
+            f[i1] = std::vector<double>(i1+1,1.);
+            for(int j1=1;j1<i1;j1++) f[i1][j1] = f[i1-1][j1-1] + f[i1-1][j1];
+        }
+        return f;
+    }
+
+    static std::vector<double> BuildSqrtnTable()
+    {
+        std::vector<double> f(nsqrt);
+        for(int j=0;j<nsqrt;j++) f[j] = std::sqrt((double)j);
+        return f;
+    }
+
     double fact(int i)
     {
         assert(i>=0);
-        static std::vector<double> f(10);
-        static bool first=true;
-        if (first) {
-            f[0] = f[1] = 1.;
-            for(int j=2;j<10;j++) f[j] = f[j-1]*(double)j;
-            first = false;
-        }
-        if (i>=(int)f.size()) {
-            for(int j=f.size();j<=i;j++)
-                f.push_back(f[j-1]*(double)j);
-            assert(i==(int)f.size()-1);
-        }
-        assert(i<(int)f.size());
-        return f[i];
+        static const std::vector<double> f = BuildFactTable();
+        if (i < nfact) return f[i];
+        double ret = f[nfact-1];
+        for(int j=nfact;j<=i;j++) ret *= (double)j;
+        return ret;
     }
 
     double sqrtfact(int i)
     {
-        static std::vector<double> f(10);
-        static bool first=true;
-        if (first) {
-            f[0] = f[1] = 1.;
-            for(int j=2;j<10;j++) f[j] = f[j-1]*std::sqrt((double)j);
-            first = false;
-        }
-        if (i>=(int)f.size())
-            for(int j=f.size();j<=i;j++)
-                f.push_back(f[j-1]*std::sqrt((double)j));
-        assert(i<(int)f.size());
-        return f[i];
+        assert(i>=0);
+        static const std::vector<double> f = BuildSqrtFactTable();
+        if (i < nsqrt) return f[i];
+        double ret = f[nsqrt-1];
+        for(int j=nsqrt;j<=i;j++) ret *= std::sqrt((double)j);
+        return ret;
     }
 
     double binom(int i,int j)
     {
-        static std::vector<std::vector<double> > f(10);
-        static bool first=true;
-        if (first) {
-            f[0] = std::vector<double>(1,1.);
-            f[1] = std::vector<double>(2,1.);
-            for(int i1=2;i1<10;i1++) {
-                f[i1] = std::vector<double>(i1+1);
-                f[i1][0] = f[i1][i1] = 1.;
-                for(int j1=1;j1<i1;j1++) f[i1][j1] = f[i1-1][j1-1] + f[i1-1][j1];
-            }
-            first = false;
-        }
+        static const std::vector<std::vector<double> > f = BuildBinomTable();
         if (j<0 || j>i) return 0.;
-        if (i>=(int)f.size()) {
-            for(int i1=f.size();i1<=i;i1++) {
-                f.push_back(std::vector<double>(i1+1,1.));
-                for(int j1=1;j1<i1;j1++) f[i1][j1] = f[i1-1][j1-1] + f[i1-1][j1];
-            }
-            assert(i==(int)f.size()-1);
+        if (i < nbinom) return f[i][j];
+        // Use the smaller of j and i-j, and build up the product from the last table row.
+        if (2*j > i) j = i-j;
+        int i0 = nbinom-1;
+        if (j > i0) {
+            // Too far from the table to bother; just use the product formula.
+            double ret = 1.;
+            for(int k=1;k<=j;k++) ret = ret * (i-j+k) / k;
+            return ret;
         }
-        assert(i<(int)f.size());
-        assert(j<(int)f[i].size());
-        return f[i][j];
+        // binom(i,j) = binom(i0,j) * prod_{k=i0+1}^{i} k/(k-j)
+        double ret = f[i0][j];
+        for(int k=i0+1;k<=i;k++) ret = ret * k / (k-j);
+        return ret;
     }
 
     double sqrtn(int i)
     {
-        static std::vector<double> f(10);
-        static bool first=true;
-        if (first) {
-            for(int j=0;j<10;j++) f[j] = std::sqrt((double)j);
-            first = false;
-        }
-        if (i>=(int)f.size())
-            for(int j=f.size();j<=i;j++)
-                f.push_back(std::sqrt((double)j));
-        assert(i<(int)f.size());
-        return f[i];
+        static const std::vector<double> f = BuildSqrtnTable();
+        if (i < nsqrt) return f[i];
+        return std::sqrt((double)i);
     }
 
 }
@@ -0,0 +1,139 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+
+//#define DEBUGLOGGING
+
+#include <map>
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "DrawFFT.h"
+#include "FFT.h"
+#include "ScratchArena.h"
+
+namespace galsim {
+
+    template <typename T>
+    void drawFFTMany(const std::vector<SBProfile>& profiles, std::vector<ImageView<T> >& images,
+                     const std::vector<int>& Nk, const std::vector<int>& N,
+                     const std::vector<double>& dk, bool add_to_image,
+                     std::vector<double>& added_flux)
+    {
+        const int nstamp = int(profiles.size());
+        dbg<<"Start drawFFTMany: nstamp = "<<nstamp<<std::endl;
+        if (int(images.size()) != nstamp || int(Nk.size()) != nstamp ||
+            int(N.size()) != nstamp || int(dk.size()) != nstamp)
+            throw std::invalid_argument("drawFFTMany requires all inputs to have the same length");
+        added_flux.assign(nstamp, 0.);
+
+        // Group the stamps by FFT size.
+        std::map<int, std::vector<int> > groups;
+        for (int k=0; k<nstamp; ++k) {
+            if (N[k] <= 0 || N[k] % 2 != 0)
+                FormatAndThrow<std::invalid_argument>() << "Invalid FFT size " << N[k];
+            if (Nk[k] < N[k] || Nk[k] % 2 != 0)
+                FormatAndThrow<std::invalid_argument>() << "Invalid k image size " << Nk[k];
+            // The copy out of the real-space array below runs in parallel, so check here
+            // that each target fits in it rather than throwing from inside that loop.
+            const int no2 = N[k]/2;
+            const Bounds<int> breal(-no2, no2+1, -no2, no2-1);
+            if (!breal.includes(images[k].getBounds())) {
+                FormatAndThrow<ImageError>() <<
+                    "Subimage bounds (" << images[k].getBounds() <<
+                    ") are outside original image bounds (" << breal << ")";
+            }
+            groups[N[k]].push_back(k);
+        }
+
+        // Profiles that build tables the first time they are drawn (e.g. Sersic, Moffat,
+        // InterpolatedImage) guard that setup with their own locks, so the fills below can
+        // call drawK from any thread.
+
+        for (std::map<int, std::vector<int> >::iterator it=groups.begin(); it!=groups.end();
+             ++it) {
+            const int n = it->first;
+            const int no2 = n/2;
+            const std::vector<int>& index = it->second;
+            const int howmany = int(index.size());
+            dbg<<"FFT size "<<n<<": "<<howmany<<" stamps\n";
+
+            // Each stamp gets an n x (n+2) real array, which is the in-place layout for FFTW.
+            // The real output is in the same memory as the complex input.
+            const size_t ncplx = size_t(n) * (no2+1);
+            FFTW_Array<std::complex<double> > batch(howmany * ncplx);
+            double* xdata = reinterpret_cast<double*>(batch.get());
+            const Bounds<int> bwrap(0, no2, -no2, no2-1);
+            const Bounds<int> breal(-no2, no2+1, -no2, no2-1);
+
+            // Draw, wrap, and load each k image into its slot of the batch.
+            std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (int i=0; i<howmany; ++i) {
+                try {
+                    const int k = index[i];
+                    const int nko2 = Nk[k]/2;
+                    ScratchImage<std::complex<double> > kim(Bounds<int>(0, nko2, -nko2, nko2));
+                    profiles[k].drawK(kim.view(), dk[k]);
+                    wrapImage(kim.view(), bwrap, true, false);
+                    ImageView<double> slot(xdata + i * 2 * ncplx, shared_ptr<double>(),
+                                           1, 2*(no2+1), breal);
+                    irfftPrepare(kim.view().subImage(bwrap), slot, true, true);
+                } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    { if (!error) error = std::current_exception(); }
+                }
+            }
+            if (error) std::rethrow_exception(error);
+
+            ExecuteFFTMany_c2r(howmany, n, n, batch.get(), xdata);
+
+            // Copy (or add) the relevant portion of each real image to the target.
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int i=0; i<howmany; ++i) {
+                const int k = index[i];
+                ImageView<double> slot(xdata + i * 2 * ncplx, shared_ptr<double>(),
+                                       1, 2*(no2+1), breal);
+                ImageView<double> temp = slot.subImage(images[k].getBounds());
+                if (add_to_image) images[k] += temp;
+                else images[k].copyFrom(temp);
+                added_flux[k] = temp.sumElements();
+            }
+        }
+    }
+
+    template void drawFFTMany(
+        const std::vector<SBProfile>& profiles, std::vector<ImageView<double> >& images,
+        const std::vector<int>& Nk, const std::vector<int>& N, const std::vector<double>& dk,
+        bool add_to_image, std::vector<double>& added_flux);
+    template void drawFFTMany(
+        const std::vector<SBProfile>& profiles, std::vector<ImageView<float> >& images,
+        const std::vector<int>& Nk, const std::vector<int>& N, const std::vector<double>& dk,
+        bool add_to_image, std::vector<double>& added_flux);
+
+}
@@ -23,8 +23,16 @@
 
 #include <limits>
 #include <vector>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <atomic>
+#include <thread>
+#include <cstdio>
 #include "FFT.h"
 #include "Std.h"
+#include "ScratchArena.h"
+#include "LRUCache.h"
 
 #ifdef __SSE2__
 #include "xmmintrin.h"
@@ -37,9 +45,10 @@ namespace galsim {
     {
         if (_n != n) {
             _n = n;
-            // cf. BaseImage::allocateMem, which uses the same code.
-            char* mem = new char[_n * sizeof(T) + sizeof(char*) + 15];
-            _p = reinterpret_cast<T*>( (uintptr_t)(mem + sizeof(char*) + 15) & ~(size_t) 0x0F );
+            // cf. BaseImage::allocateMem, which uses the same code, but with 16 byte alignment.
+            // Here we align to 64 bytes, so all FFTW_Arrays use the same cached FFTW plans.
+            char* mem = new char[_n * sizeof(T) + sizeof(char*) + 63];
+            _p = reinterpret_cast<T*>( (uintptr_t)(mem + sizeof(char*) + 63) & ~(size_t) 0x3F );
             ((char**)_p)[-1] = mem;
         }
     }
@@ -52,6 +61,470 @@ namespace galsim {
         }
     }
 
+    //
+    // The FFTW plan cache
+    //
+
+    // Everything in FFTW except fftw_execute (and the new-array execute functions) is
+    // not thread safe.  So all planning, plan destruction and wisdom access happens while
+    // holding this lock.  Looking up plans in the cache does not need it.
+    static std::mutex fftw_planner_mutex;
+
+    // Destroying a plan needs the planner lock, but plans can be released where it would be
+    // bad to wait for it, e.g. when the cache drops an old entry while another thread is in
+    // the middle of a long MEASURE plan.  So released plans are queued here, and destroyed
+    // the next time the planner lock is held.
+    static std::mutex fftw_released_mutex;
+    static std::vector<fftw_plan> fftw_released_plans;
+#ifdef GALSIM_USE_FFTWF
+    static std::vector<fftwf_plan> fftwf_released_plans;
+#endif
+
+    // Must be called with fftw_planner_mutex locked.
+    static void DestroyReleasedFFTWPlans()
+    {
+        std::vector<fftw_plan> plans;
+#ifdef GALSIM_USE_FFTWF
+        std::vector<fftwf_plan> plans_f;
+#endif
+        {
+            std::lock_guard<std::mutex> lock(fftw_released_mutex);
+            plans.swap(fftw_released_plans);
+#ifdef GALSIM_USE_FFTWF
+            plans_f.swap(fftwf_released_plans);
+#endif
+        }
+        for (size_t i=0; i<plans.size(); ++i) fftw_destroy_plan(plans[i]);
+#ifdef GALSIM_USE_FFTWF
+        for (size_t i=0; i<plans_f.size(); ++i) fftwf_destroy_plan(plans_f[i]);
+#endif
+    }
+
+    struct FFTWPlanDeleter
+    {
+        void operator()(fftw_plan plan) const
+        {
+            std::lock_guard<std::mutex> lock(fftw_released_mutex);
+            fftw_released_plans.push_back(plan);
+        }
+    };
+    typedef shared_ptr<fftw_plan_s> FFTWPlanPtr;
+
+    enum FFTWPlanKind { FFTW_KIND_R2C, FFTW_KIND_C2R, FFTW_KIND_C2C_FORWARD,
+                        FFTW_KIND_C2C_BACKWARD };
+
+    // FFTW requires that the arrays passed to the new-array execute functions have the same
+    // alignment as the ones used for planning.  We don't know what SIMD alignment FFTW was
+    // built with, so we key on the address mod 64, which covers all of them.
+    static const uintptr_t fftw_align = 64;
+    static inline int AlignmentOf(const void* p)
+    { return int(reinterpret_cast<uintptr_t>(p) % fftw_align); }
+
+    // The key for a cached plan is everything about the transform except the planning
+    // flags.  Each entry keeps the most rigorous plan made for it so far, so e.g. the plan
+    // made by fftwMeasure is also used by later transforms that only ask for an estimate.
+    struct FFTWPlanKey
+    {
+        int kind;
+        int Ny;
+        int Nx;
+        bool inplace;
+        int align_in;
+        int align_out;
+        int nthreads;
+        int howmany;
+
+        bool operator<(const FFTWPlanKey& rhs) const
+        {
+            return std::tie(kind, Ny, Nx, inplace, align_in, align_out, nthreads, howmany) <
+                std::tie(rhs.kind, rhs.Ny, rhs.Nx, rhs.inplace, rhs.align_in, rhs.align_out,
+                         rhs.nthreads, rhs.howmany);
+        }
+    };
+
+    // The maximum number of plans to keep in each of the double and float caches.
+    static const int max_fftw_plans = 200;
+
+    // The settings that determine the key for new plans.  These are read on every transform,
+    // so they are atomics rather than being guarded by the planner lock.
+    static std::atomic<unsigned> fftw_plan_flags(FFTW_ESTIMATE);
+    static std::atomic<int> fftw_nthreads(1);
+    static std::atomic<int> fftw_threads_min_size(512);
+
+#ifdef GALSIM_USE_FFTW_THREADS
+    static bool fftw_threads_initialized = false;
+#endif
+
+    // A temporary array with a given offset from a 64 byte boundary to use for planning.
+    // MEASURE and PATIENT planning overwrite the arrays, so we never plan with the real data.
+    class FFTWPlanningArray
+    {
+    public:
+        FFTWPlanningArray(size_t nbytes, int align) : _mem(new char[nbytes + 2*fftw_align])
+        {
+            uintptr_t base = (reinterpret_cast<uintptr_t>(_mem) + fftw_align - 1) &
+                ~(fftw_align - 1);
+            _p = reinterpret_cast<char*>(base + align);
+        }
+        ~FFTWPlanningArray() { delete [] _mem; }
+        double* real() { return reinterpret_cast<double*>(_p); }
+        fftw_complex* cplx() { return reinterpret_cast<fftw_complex*>(_p); }
+#ifdef GALSIM_USE_FFTWF
+        float* realf() { return reinterpret_cast<float*>(_p); }
+        fftwf_complex* cplxf() { return reinterpret_cast<fftwf_complex*>(_p); }
+#endif
+    private:
+        char* _mem;
+        char* _p;
+    };
+
+    static FFTWPlanPtr MakeFFTWPlan(const FFTWPlanKey& key, unsigned flags)
+    {
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex);
+        DestroyReleasedFFTWPlans();
+
+        dbg<<"Make new FFTW plan: kind = "<<key.kind<<", size = "<<key.Ny<<" x "<<key.Nx<<
+            ", inplace = "<<key.inplace<<", flags = "<<flags<<
+            ", howmany = "<<key.howmany<<std::endl;
+        const size_t nreal = size_t(key.Ny) * key.Nx;
+        const size_t ncplx_half = size_t(key.Ny) * (key.Nx/2+1);
+#ifdef GALSIM_USE_FFTW_THREADS
+        if (!fftw_threads_initialized) {
+            if (!fftw_init_threads()) throw FFTError("fftw_init_threads failed");
+            fftw_threads_initialized = true;
+        }
+        fftw_plan_with_nthreads(key.nthreads);
+#endif
+        fftw_plan plan = 0;
+        switch (key.kind) {
+          case FFTW_KIND_R2C:
+          case FFTW_KIND_C2R: {
+               // In-place real transforms use the padded layout with Nx/2+1 complex per row.
+               // With howmany > 1, the arrays are stored one after the other.
+               int n[2] = { key.Ny, key.Nx };
+               int cembed[2] = { key.Ny, key.Nx/2+1 };
+               int rembed[2] = { key.Ny, key.inplace ? 2*(key.Nx/2+1) : key.Nx };
+               int cdist = int(ncplx_half);
+               int rdist = key.inplace ? 2*cdist : int(nreal);
+               size_t nbytes_c = key.howmany * ncplx_half * sizeof(fftw_complex);
+               size_t nbytes_r = key.inplace ? nbytes_c : key.howmany * nreal * sizeof(double);
+               FFTWPlanningArray a_r(nbytes_r, key.kind == FFTW_KIND_R2C ? key.align_in :
+                                     key.align_out);
+               shared_ptr<FFTWPlanningArray> a_c;
+               if (!key.inplace)
+                   a_c.reset(new FFTWPlanningArray(
+                           nbytes_c, key.kind == FFTW_KIND_R2C ? key.align_out : key.align_in));
+               fftw_complex* c = key.inplace ? a_r.cplx() : a_c->cplx();
+               if (key.kind == FFTW_KIND_R2C)
+                   plan = fftw_plan_many_dft_r2c(2, n, key.howmany, a_r.real(), rembed, 1, rdist,
+                                                 c, cembed, 1, cdist, flags);
+               else
+                   plan = fftw_plan_many_dft_c2r(2, n, key.howmany, c, cembed, 1, cdist,
+                                                 a_r.real(), rembed, 1, rdist, flags);
+               break;
+          }
+          case FFTW_KIND_C2C_FORWARD:
+          case FFTW_KIND_C2C_BACKWARD: {
+               int sign = key.kind == FFTW_KIND_C2C_FORWARD ? FFTW_FORWARD : FFTW_BACKWARD;
+               size_t nbytes = nreal * sizeof(fftw_complex);
+               FFTWPlanningArray a_in(nbytes, key.align_in);
+               if (key.inplace) {
+                   plan = fftw_plan_dft_2d(key.Ny, key.Nx, a_in.cplx(), a_in.cplx(), sign,
+                                           flags);
+               } else {
+                   FFTWPlanningArray a_out(nbytes, key.align_out);
+                   plan = fftw_plan_dft_2d(key.Ny, key.Nx, a_in.cplx(), a_out.cplx(), sign,
+                                           flags);
+               }
+               break;
+          }
+          default:
+               throw FFTError("Invalid FFTW plan kind");
+        }
+        if (plan==NULL) throw FFTInvalid("fftw_plan cannot be created");
+        return FFTWPlanPtr(plan, FFTWPlanDeleter());
+    }
+
+#ifdef GALSIM_USE_FFTWF
+    // The single-precision plans have their own cache, using the same keys.  Only the
+    // real-to-complex and complex-to-real kinds are used in single precision.
+    struct FFTWFPlanDeleter
+    {
+        void operator()(fftwf_plan plan) const
+        {
+            std::lock_guard<std::mutex> lock(fftw_released_mutex);
+            fftwf_released_plans.push_back(plan);
+        }
+    };
+    typedef shared_ptr<fftwf_plan_s> FFTWFPlanPtr;
+
+    static FFTWFPlanPtr MakeFFTWFPlan(const FFTWPlanKey& key, unsigned flags)
+    {
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex);
+        DestroyReleasedFFTWPlans();
+
+        dbg<<"Make new FFTWF plan: kind = "<<key.kind<<", size = "<<key.Ny<<" x "<<key.Nx<<
+            ", inplace = "<<key.inplace<<", flags = "<<flags<<std::endl;
+        int n[2] = { key.Ny, key.Nx };
+        int cembed[2] = { key.Ny, key.Nx/2+1 };
+        int rembed[2] = { key.Ny, key.inplace ? 2*(key.Nx/2+1) : key.Nx };
+        int cdist = key.Ny * (key.Nx/2+1);
+        int rdist = key.inplace ? 2*cdist : key.Ny * key.Nx;
+        size_t nbytes_c = size_t(key.howmany) * cdist * sizeof(fftwf_complex);
+        size_t nbytes_r = key.inplace ? nbytes_c : size_t(key.howmany) * rdist * sizeof(float);
+        FFTWPlanningArray a_r(nbytes_r, key.kind == FFTW_KIND_R2C ? key.align_in :
+                              key.align_out);
+        shared_ptr<FFTWPlanningArray> a_c;
+        if (!key.inplace)
+            a_c.reset(new FFTWPlanningArray(
+                    nbytes_c, key.kind == FFTW_KIND_R2C ? key.align_out : key.align_in));
+        fftwf_complex* c = key.inplace ? a_r.cplxf() : a_c->cplxf();
+
+        fftwf_plan plan = 0;
+        if (key.kind == FFTW_KIND_R2C)
+            plan = fftwf_plan_many_dft_r2c(2, n, key.howmany, a_r.realf(), rembed, 1, rdist,
+                                           c, cembed, 1, cdist, flags);
+        else if (key.kind == FFTW_KIND_C2R)
+            plan = fftwf_plan_many_dft_c2r(2, n, key.howmany, c, cembed, 1, cdist,
+                                           a_r.realf(), rembed, 1, rdist, flags);
+        else
+            throw FFTError("Invalid FFTWF plan kind");
+        if (plan==NULL) throw FFTInvalid("fftwf_plan cannot be created");
+        return FFTWFPlanPtr(plan, FFTWFPlanDeleter());
+    }
+#endif
+
+    // ESTIMATE < MEASURE < PATIENT
+    static int FFTWPlanRigor(unsigned flags)
+    { return flags == FFTW_PATIENT ? 2 : flags == FFTW_MEASURE ? 1 : 0; }
+
+    // The value stored in the plan caches for each key.  The plan is made the first time it
+    // is needed, and made again if a later caller asks for more rigorous planning.  This
+    // happens outside of the cache's lock, so transforms that find their plan in the cache
+    // don't wait for other threads' planning.  Only callers with the same key wait here.
+    template <typename PlanPtr, PlanPtr (*MakePlan)(const FFTWPlanKey&, unsigned)>
+    class FFTWPlanEntry
+    {
+    public:
+        FFTWPlanEntry(const FFTWPlanKey& key) : _key(key), _rigor(-1) {}
+
+        PlanPtr getPlan(unsigned flags)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            int rigor = FFTWPlanRigor(flags);
+            if (rigor > _rigor) {
+                _plan = MakePlan(_key, flags);
+                _rigor = rigor;
+            }
+            return _plan;
+        }
+
+    private:
+        FFTWPlanKey _key;
+        std::mutex _mutex;
+        PlanPtr _plan;
+        int _rigor;
+    };
+
+    static LRUCache<FFTWPlanKey, FFTWPlanEntry<FFTWPlanPtr, MakeFFTWPlan> > fftw_plan_cache(
+        max_fftw_plans, "FFTWPlan");
+
+    static FFTWPlanPtr GetFFTWPlan(const FFTWPlanKey& key, unsigned flags)
+    { return fftw_plan_cache.get(key)->getPlan(flags); }
+
+#ifdef GALSIM_USE_FFTWF
+    static LRUCache<FFTWPlanKey, FFTWPlanEntry<FFTWFPlanPtr, MakeFFTWFPlan> > fftwf_plan_cache(
+        max_fftw_plans, "FFTWFPlan");
+
+    static FFTWFPlanPtr GetFFTWFPlan(const FFTWPlanKey& key, unsigned flags)
+    { return fftwf_plan_cache.get(key)->getPlan(flags); }
+#endif
+
+    static FFTWPlanKey MakeFFTWPlanKey(int kind, int Ny, int Nx, const void* in, const void* out,
+                                       int howmany=1)
+    {
+        FFTWPlanKey key;
+        key.kind = kind;
+        key.Ny = Ny;
+        key.Nx = Nx;
+        key.inplace = (in == out);
+        key.align_in = AlignmentOf(in);
+        key.align_out = AlignmentOf(out);
+        key.howmany = howmany;
+        // Only use multiple threads for large transforms.  For small ones, the overhead of
+        // starting the threads is larger than the gain.  For batches, FFTW can split the
+        // work over the batch, so it is the total size that matters.
+        int min_size = fftw_threads_min_size.load();
+        key.nthreads = (double(Ny) * Nx * howmany >= double(min_size) * min_size) ?
+            fftw_nthreads.load() : 1;
+        return key;
+    }
+
+    static unsigned GetFFTWPlanFlags()
+    { return fftw_plan_flags.load(); }
+
+    void ExecuteFFT_r2c(int Ny, int Nx, double* in, std::complex<double>* out)
+    {
+        FFTWPlanPtr plan = GetFFTWPlan(MakeFFTWPlanKey(FFTW_KIND_R2C, Ny, Nx, in, out),
+                                       GetFFTWPlanFlags());
+        fftw_execute_dft_r2c(plan.get(), in, reinterpret_cast<fftw_complex*>(out));
+    }
+
+    void ExecuteFFT_c2r(int Ny, int Nx, std::complex<double>* in, double* out)
+    {
+        FFTWPlanPtr plan = GetFFTWPlan(MakeFFTWPlanKey(FFTW_KIND_C2R, Ny, Nx, in, out),
+                                       GetFFTWPlanFlags());
+        fftw_execute_dft_c2r(plan.get(), reinterpret_cast<fftw_complex*>(in), out);
+    }
+
+    bool FFTWHasSinglePrecision()
+    {
+#ifdef GALSIM_USE_FFTWF
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void ExecuteFFT_r2c(int Ny, int Nx, float* in, std::complex<float>* out)
+    {
+#ifdef GALSIM_USE_FFTWF
+        FFTWPlanKey key = MakeFFTWPlanKey(FFTW_KIND_R2C, Ny, Nx, in, out);
+        // We don't link fftw3f_threads, so the single-precision plans are always single-threaded.
+        key.nthreads = 1;
+        FFTWFPlanPtr plan = GetFFTWFPlan(key, GetFFTWPlanFlags());
+        fftwf_execute_dft_r2c(plan.get(), in, reinterpret_cast<fftwf_complex*>(out));
+#else
+        // Without fftw3f, do the transform in double precision.
+        const int Nxo2p1 = Nx/2+1;
+        const int rstride = (static_cast<void*>(in) == static_cast<void*>(out)) ? 2*Nxo2p1 : Nx;
+        FFTW_Array<std::complex<double> > kd(size_t(Ny) * Nxo2p1);
+        double* xd = reinterpret_cast<double*>(kd.get());
+        for (int j=0; j<Ny; ++j)
+            std::copy(in + j*rstride, in + j*rstride + Nx, xd + j*2*Nxo2p1);
+        ExecuteFFT_r2c(Ny, Nx, xd, kd.get());
+        std::copy(kd.get(), kd.get() + size_t(Ny) * Nxo2p1, out);
+#endif
+    }
+
+    void ExecuteFFT_c2r(int Ny, int Nx, std::complex<float>* in, float* out)
+    {
+#ifdef GALSIM_USE_FFTWF
+        FFTWPlanKey key = MakeFFTWPlanKey(FFTW_KIND_C2R, Ny, Nx, in, out);
+        key.nthreads = 1;
+        FFTWFPlanPtr plan = GetFFTWFPlan(key, GetFFTWPlanFlags());
+        fftwf_execute_dft_c2r(plan.get(), reinterpret_cast<fftwf_complex*>(in), out);
+#else
+        const int Nxo2p1 = Nx/2+1;
+        const int rstride = (static_cast<void*>(in) == static_cast<void*>(out)) ? 2*Nxo2p1 : Nx;
+        FFTW_Array<std::complex<double> > kd(size_t(Ny) * Nxo2p1);
+        double* xd = reinterpret_cast<double*>(kd.get());
+        std::copy(in, in + size_t(Ny) * Nxo2p1, kd.get());
+        ExecuteFFT_c2r(Ny, Nx, kd.get(), xd);
+        for (int j=0; j<Ny; ++j)
+            std::copy(xd + j*2*Nxo2p1, xd + j*2*Nxo2p1 + Nx, out + j*rstride);
+#endif
+    }
+
+    void ExecuteFFTMany_c2r(int howmany, int Ny, int Nx, std::complex<double>* in, double* out)
+    {
+        FFTWPlanPtr plan = GetFFTWPlan(MakeFFTWPlanKey(FFTW_KIND_C2R, Ny, Nx, in, out, howmany),
+                                       GetFFTWPlanFlags());
+        fftw_execute_dft_c2r(plan.get(), reinterpret_cast<fftw_complex*>(in), out);
+    }
+
+    void ExecuteFFT_c2c(int Ny, int Nx, std::complex<double>* in, std::complex<double>* out,
+                        bool inverse)
+    {
+        int kind = inverse ? FFTW_KIND_C2C_BACKWARD : FFTW_KIND_C2C_FORWARD;
+        FFTWPlanPtr plan = GetFFTWPlan(MakeFFTWPlanKey(kind, Ny, Nx, in, out),
+                                       GetFFTWPlanFlags());
+        fftw_execute_dft(plan.get(), reinterpret_cast<fftw_complex*>(in),
+                         reinterpret_cast<fftw_complex*>(out));
+    }
+
+    void SetFFTWPlanMode(int mode)
+    {
+        switch (mode) {
+          case FFTW_PLAN_ESTIMATE: fftw_plan_flags = FFTW_ESTIMATE; break;
+          case FFTW_PLAN_MEASURE: fftw_plan_flags = FFTW_MEASURE; break;
+          case FFTW_PLAN_PATIENT: fftw_plan_flags = FFTW_PATIENT; break;
+          default: FormatAndThrow<FFTError>() << "Invalid FFTW plan mode " << mode;
+        }
+    }
+
+    int GetFFTWPlanMode()
+    {
+        unsigned flags = GetFFTWPlanFlags();
+        return (flags == FFTW_PATIENT ? FFTW_PLAN_PATIENT :
+                flags == FFTW_MEASURE ? FFTW_PLAN_MEASURE : FFTW_PLAN_ESTIMATE);
+    }
+
+    bool FFTWHasThreads()
+    {
+#ifdef GALSIM_USE_FFTW_THREADS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void SetFFTWNumThreads(int nthreads)
+    {
+        if (nthreads <= 0) nthreads = std::max(int(std::thread::hardware_concurrency()), 1);
+        if (!FFTWHasThreads()) nthreads = 1;
+        fftw_nthreads = nthreads;
+    }
+
+    int GetFFTWNumThreads()
+    { return fftw_nthreads.load(); }
+
+    void SetFFTWThreadsMinSize(int min_size)
+    { fftw_threads_min_size = min_size; }
+
+    int GetFFTWThreadsMinSize()
+    { return fftw_threads_min_size.load(); }
+
+    void ClearFFTWPlanCache()
+    {
+        // Any plans currently being executed in other threads are kept alive by their own
+        // shared_ptr, and are destroyed later, once they are released.
+        fftw_plan_cache.clear();
+#ifdef GALSIM_USE_FFTWF
+        fftwf_plan_cache.clear();
+#endif
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex);
+        DestroyReleasedFFTWPlans();
+    }
+
+    int GetFFTWPlanCacheSize()
+    {
+#ifdef GALSIM_USE_FFTWF
+        return int(fftw_plan_cache.size() + fftwf_plan_cache.size());
+#else
+        return int(fftw_plan_cache.size());
+#endif
+    }
+
+    void ImportFFTWWisdom(const std::string& file_name)
+    {
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex);
+        FILE* fp = fopen(file_name.c_str(), "r");
+        if (!fp) FormatAndThrow<FFTError>() << "Unable to open FFTW wisdom file " << file_name;
+        int ok = fftw_import_wisdom_from_file(fp);
+        fclose(fp);
+        if (!ok) FormatAndThrow<FFTError>() << "Unable to read FFTW wisdom from " << file_name;
+    }
+
+    void ExportFFTWWisdom(const std::string& file_name)
+    {
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex);
+        FILE* fp = fopen(file_name.c_str(), "w");
+        if (!fp) FormatAndThrow<FFTError>() << "Unable to open FFTW wisdom file " << file_name;
+        fftw_export_wisdom_to_file(fp);
+        fclose(fp);
+    }
+
     KTable::KTable(int N, double dk, std::complex<double> value) : _dk(dk), _invdk(1./dk)
     {
         if (N<=0) throw FFTError("KTable size <=0");
@@ -357,22 +830,27 @@ namespace galsim {
             // We have the opportunity to speed up the calculation by
             // re-using the sums over rows.  So we will keep a
             // cache of them.
-            if (kx != _cacheX || ixy != _cacheInterp) {
-                clearCache();
-                _cacheX = kx;
-                _cacheInterp = ixy;
-            } else if (iyMax==iyMin+1 && !_cache.empty()) {
+            // The cache is only useful to one caller stepping through nearby points, so if
+            // another thread is using it, just use a new one rather than waiting.
+            std::unique_lock<std::mutex> lock(_cacheMutex, std::try_to_lock);
+            InterpCache local_cache;
+            InterpCache& c = lock.owns_lock() ? _cache : local_cache;
+            if (kx != c.x || ixy != c.interp) {
+                c.clear();
+                c.x = kx;
+                c.interp = ixy;
+            } else if (iyMax==iyMin+1 && !c.rows.empty()) {
                 // Special case for interpolation on a single iy value:
                 // See if we already have this row in cache:
-                int index = iyMin - _cacheStartY;
+                int index = iyMin - c.startY;
                 if (index < 0) index += _N;
-                if (index < int(_cache.size()))
+                if (index < int(c.rows.size()))
                     // We have it!
-                    return _cache[index];
+                    return c.rows[index];
                 else
                     // Desired row not in cache - kill cache, continue as normal.
                     // (But don't clear xwt, since that's still good.)
-                    _cache.clear();
+                    c.rows.clear();
             }
 
             const bool simple_xval = ixy->xrange() <= _Nd;
@@ -382,8 +860,8 @@ namespace galsim {
             if (nx<=0) nx += _N;
             xdbg<<"nx = "<<nx<<std::endl;
             // This is also cached if possible.  It gets cleared when kx != cacheX above.
-            if (_xwt.empty()) {
-                _xwt.resize(nx);
+            if (c.xwt.empty()) {
+                c.xwt.resize(nx);
                 int ix = ixMin;
                 if (simple_xval) {
                     // Then simple xval is fine (and faster)
@@ -393,30 +871,30 @@ namespace galsim {
                     for (int i=0; i<nx; ++i, ++ix, ++arg) {
                         xdbg<<"Call xval for arg = "<<arg<<std::endl;
                         if (arg > _halfNd) arg -= _Nd;
-                        _xwt[i] = ixy->xval1d(arg);
-                        xdbg<<"xwt["<<i<<"] = "<<_xwt[i]<<std::endl;
+                        c.xwt[i] = ixy->xval1d(arg);
+                        xdbg<<"xwt["<<i<<"] = "<<c.xwt[i]<<std::endl;
                     }
                 } else {
                     // Then might need to wrap to do the sum that's in xvalWrapped...
                     for (int i=0; i<nx; ++i, ++ix) {
                         xdbg<<"Call xvalWrapped1d for ix-kx = "<<ix<<" - "<<kx<<" = "<<
                             ix-kx<<std::endl;
-                        _xwt[i] = ixy->xvalWrapped1d(ix-kx, _N);
-                        xdbg<<"xwt["<<i<<"] = "<<_xwt[i]<<std::endl;
+                        c.xwt[i] = ixy->xvalWrapped1d(ix-kx, _N);
+                        xdbg<<"xwt["<<i<<"] = "<<c.xwt[i]<<std::endl;
                     }
                 }
             } else {
-                assert(int(_xwt.size()) == nx);
+                assert(int(c.xwt.size()) == nx);
             }
 
             // cache always holds sequential y values (with wrap).  Throw away
             // elements until we get to the one we need first
-            std::deque<std::complex<double> >::iterator nextSaved = _cache.begin();
-            while (nextSaved != _cache.end() && _cacheStartY != iyMin) {
-                _cache.pop_front();
-                ++_cacheStartY;
-                if (_cacheStartY >= _No2) _cacheStartY -= _N;
-                nextSaved = _cache.begin();
+            std::deque<std::complex<double> >::iterator nextSaved = c.rows.begin();
+            while (nextSaved != c.rows.end() && c.startY != iyMin) {
+                c.rows.pop_front();
+                ++c.startY;
+                if (c.startY >= _No2) c.startY -= _N;
+                nextSaved = c.rows.begin();
             }
 
             // Accumulate sum of
@@ -437,7 +915,7 @@ namespace galsim {
                 if (iy >= _No2) iy -= _N;   // wrap iy if needed
                 xdbg<<"ny = "<<ny<<", iy = "<<iy<<std::endl;
                 std::complex<double> sumy = 0.;
-                if (nextSaved != _cache.end()) {
+                if (nextSaved != c.rows.end()) {
                     // This row is cached
                     sumy = *nextSaved;
                     ++nextSaved;
@@ -448,13 +926,13 @@ namespace galsim {
                     // Simple loop preserved for comparison.
                     for (int i=0; i<nx; ++i, ++ix) {
                         if (ix > N/2) ix -= N; //check for wrap
-                        sumy += _xwt[i]*kval(ix,iy);
+                        sumy += c.xwt[i]*kval(ix,iy);
                     }
 #else
 
                     // Faster way using ptrs, which doesn't need to do index(ix,iy) every time.
                     int count = nx;
-                    const double* xwt_it = &_xwt[0];
+                    const double* xwt_it = &c.xwt[0];
                     // First do any initial negative ix values:
                     if (ix < 0) {
                         xdbg<<"Some initial negative ix: ix = "<<ix<<std::endl;
@@ -488,12 +966,12 @@ namespace galsim {
                             //xwt_it += count;
                         }
                     }
-                    //xassert(xwt_it == &_xwt[0] + _xwt.size());
+                    //xassert(xwt_it == &c.xwt[0] + c.xwt.size());
 #endif
                     // Add to back of cache
-                    if (_cache.empty()) _cacheStartY = iy;
-                    _cache.push_back(sumy);
-                    nextSaved = _cache.end();
+                    if (c.rows.empty()) c.startY = iy;
+                    c.rows.push_back(sumy);
+                    nextSaved = c.rows.end();
                 }
                 if (simple_xval) {
                     if (arg > _halfNd) arg -= _Nd;
@@ -526,6 +1004,214 @@ namespace galsim {
         return sum;
     }
 
+    void KTable::gridWeights(double k0, double dk, int n, const Interpolant& interp, bool isx,
+                             std::vector<int>& idx, std::vector<double>& wt,
+                             std::vector<int>& len, int& width) const
+    {
+        // The footprints, weights and wrapping here all follow what interpolate does for
+        // a separable interpolant, so the results are the same.
+        const double xrange = interp.xrange();
+        const bool exact = interp.isExactAtNodes();
+        const bool simple_xval = xrange <= _Nd;
+        std::vector<int> start(n);
+        len.resize(n);
+        width = 0;
+        for (int i=0; i<n; ++i) {
+            double k = (k0 + i*dk) * _invdk;
+            if (exact && std::abs(k - std::floor(k+0.01)) <
+                10.*std::numeric_limits<double>::epsilon()) {
+                start[i] = wrapKValue(k+0.01);
+                len[i] = 1;
+            } else if (xrange >= _No2) {
+                start[i] = -_No2;
+                len[i] = _N;
+            } else {
+                start[i] = wrapKValue(k-xrange+0.99);
+                len[i] = -wrapKValue(-k-xrange-0.01) - start[i];
+                if (len[i] <= 0) len[i] += _N;
+            }
+            width = std::max(width, len[i]);
+        }
+
+        idx.resize(n*width);
+        wt.resize(n*width);
+        for (int i=0; i<n; ++i) {
+            double k = (k0 + i*dk) * _invdk;
+            int* ip = &idx[i*width];
+            double* wp = &wt[i*width];
+            int ik = start[i];
+            double arg = ik-k;
+            if (simple_xval && (isx ? std::abs(arg) >= _halfNd : std::abs(arg) > _halfNd))
+                arg -= _Nd*std::floor(arg*_invNd+0.5);
+            for (int t=0; t<len[i]; ++t, ++ik, ++arg) {
+                if (simple_xval) {
+                    // Just store the argument here.  They are all evaluated at the end.
+                    if (arg > _halfNd) arg -= _Nd;
+                    wp[t] = arg;
+                } else {
+                    wp[t] = interp.xvalWrapped(arg, _N);
+                }
+                int iw = ik;
+                if (isx ? iw > _No2 : iw >= _No2) iw -= _N;
+                ip[t] = iw;
+            }
+        }
+        if (simple_xval && !wt.empty()) interp.xvalMany(&wt[0], wt.size());
+    }
+
+    void KTable::unfoldRow(int iy, std::complex<double>* row) const
+    {
+        const std::complex<double>* pos = _array.get() + index2(0, iy < 0 ? iy+_N : iy);
+        const std::complex<double>* neg = _array.get() + index2(0, -iy < 0 ? -iy+_N : -iy);
+        row += _No2;
+        for (int ix=0; ix<=_No2; ++ix) row[ix] = pos[ix];
+        for (int ix=1; ix<=_No2; ++ix) row[-ix] = std::conj(neg[ix]);
+    }
+
+    template <typename T>
+    void KTable::interpolateGrid(std::complex<T>* ptr, int m, int n, int stride,
+                                 double kx0, double dkx, double ky0, double dky,
+                                 const Interpolant& interp) const
+    {
+        dbg<<"KTable interpolateGrid: m,n = "<<m<<','<<n<<std::endl;
+        check_array();
+        std::vector<int> xidx, xlen, yidx, ylen;
+        std::vector<double> xwt, ywt;
+        int xwidth, ywidth;
+        gridWeights(kx0, dkx, m, interp, true, xidx, xwt, xlen, xwidth);
+        gridWeights(ky0, dky, n, interp, false, yidx, ywt, ylen, ywidth);
+
+        // Find which rows of the table contribute to any output row.
+        std::vector<int> rowIndex(_N, -1);
+        std::vector<int> rows;
+        for (int j=0; j<n; ++j) {
+            for (int t=0; t<ylen[j]; ++t) {
+                int iy = yidx[j*ywidth+t];
+                if (rowIndex[iy+_No2] < 0) {
+                    rowIndex[iy+_No2] = rows.size();
+                    rows.push_back(iy);
+                }
+            }
+        }
+        const int nrows = rows.size();
+        xdbg<<"Using "<<nrows<<" rows of the table\n";
+
+        // First pass: interpolate each of the rows we need in the kx direction.
+        // Each row is unfolded to the full range of ix first, so the conjugations for ix < 0
+        // are only done once per row rather than once per tap.
+        std::vector<std::complex<double> > tmp(size_t(nrows)*m);
+#ifdef _OPENMP
+#pragma omp parallel for if (size_t(m)*nrows*xwidth > 100000)
+#endif
+        for (int r=0; r<nrows; ++r) {
+            ScratchBuffer<std::complex<double> > full(_N+1);
+            unfoldRow(rows[r], full.begin());
+            const std::complex<double>* row = full.begin() + _No2;
+            std::complex<double>* out = &tmp[size_t(r)*m];
+            for (int i=0; i<m; ++i) {
+                const int* ip = &xidx[i*xwidth];
+                const double* wp = &xwt[i*xwidth];
+                std::complex<double> sum = 0.;
+                for (int t=0; t<xlen[i]; ++t) sum += wp[t] * row[ip[t]];
+                out[i] = sum;
+            }
+        }
+
+        // Second pass: combine the rows for each output row.
+#ifdef _OPENMP
+#pragma omp parallel for if (size_t(m)*n*ywidth > 100000)
+#endif
+        for (int j=0; j<n; ++j) {
+            ScratchBuffer<std::complex<double> > sum(m);
+            std::fill(sum.begin(), sum.end(), std::complex<double>(0.));
+            const int* ip = &yidx[j*ywidth];
+            const double* wp = &ywt[j*ywidth];
+            for (int t=0; t<ylen[j]; ++t) {
+                const std::complex<double>* row = &tmp[size_t(rowIndex[ip[t]+_No2])*m];
+                for (int i=0; i<m; ++i) sum[i] += wp[t] * row[i];
+            }
+            std::complex<T>* out = ptr + size_t(j)*stride;
+            for (int i=0; i<m; ++i) out[i] = std::complex<T>(sum[i]);
+        }
+    }
+
+    template <typename T>
+    void KTable::interpolateGrid(std::complex<T>* ptr, int m, int n, int stride,
+                                 double kx0, double dkx, double dkxy,
+                                 double ky0, double dky, double dkyx,
+                                 const Interpolant& interp, double kmax) const
+    {
+        dbg<<"KTable sheared interpolateGrid: m,n = "<<m<<','<<n<<std::endl;
+        check_array();
+
+        // Unfold all the rows that any of the points might use, so the inner loop below is
+        // a simple dot product without any conjugations or index wrapping.
+        const double xrange = interp.xrange();
+        double kyMin = std::min(std::min(ky0, ky0 + (m-1)*dkyx),
+                                std::min(ky0 + (n-1)*dky, ky0 + (m-1)*dkyx + (n-1)*dky));
+        double kyMax = std::max(std::max(ky0, ky0 + (m-1)*dkyx),
+                                std::max(ky0 + (n-1)*dky, ky0 + (m-1)*dkyx + (n-1)*dky));
+        kyMin = std::max(kyMin, -kmax);
+        kyMax = std::min(kyMax, kmax);
+        int iy1 = int(std::floor(kyMin*_invdk - xrange)) - 1;
+        int iy2 = int(std::ceil(kyMax*_invdk + xrange)) + 1;
+        if (iy2 - iy1 + 1 >= _N || xrange >= _No2) {
+            iy1 = -_No2;
+            iy2 = _No2-1;
+        }
+        std::vector<int> rowIndex(_N, -1);
+        std::vector<int> rows;
+        for (int iy=iy1; iy<=iy2; ++iy) {
+            int iw = ((iy + _No2) % _N + _N) % _N;
+            if (rowIndex[iw] < 0) {
+                rowIndex[iw] = rows.size();
+                rows.push_back(iw - _No2);
+            }
+        }
+        const int nrows = rows.size();
+        const int fullN = _N+1;
+        xdbg<<"Unfolding "<<nrows<<" rows of the table\n";
+        std::vector<std::complex<double> > full(size_t(nrows)*fullN);
+        for (int r=0; r<nrows; ++r) unfoldRow(rows[r], &full[size_t(r)*fullN]);
+
+#ifdef _OPENMP
+#pragma omp parallel for if (size_t(m)*n > 10000)
+#endif
+        for (int j=0; j<n; ++j) {
+            // Along row j, both kx and ky are linear in i, so we can still get the weights
+            // for the whole row at once.
+            std::vector<int> xidx, xlen, yidx, ylen;
+            std::vector<double> xwt, ywt;
+            int xwidth, ywidth;
+            double kxj = kx0 + j*dkxy;
+            double kyj = ky0 + j*dky;
+            gridWeights(kxj, dkx, m, interp, true, xidx, xwt, xlen, xwidth);
+            gridWeights(kyj, dkyx, m, interp, false, yidx, ywt, ylen, ywidth);
+
+            std::complex<T>* out = ptr + size_t(j)*stride;
+            for (int i=0; i<m; ++i) {
+                if (std::abs(kxj + i*dkx) > kmax || std::abs(kyj + i*dkyx) > kmax) {
+                    out[i] = T(0);
+                    continue;
+                }
+                const int* ixp = &xidx[i*xwidth];
+                const double* wxp = &xwt[i*xwidth];
+                const int* iyp = &yidx[i*ywidth];
+                const double* wyp = &ywt[i*ywidth];
+                std::complex<double> sum = 0.;
+                for (int s=0; s<ylen[i]; ++s) {
+                    xassert(rowIndex[iyp[s]+_No2] >= 0);
+                    const std::complex<double>* row =
+                        &full[size_t(rowIndex[iyp[s]+_No2])*fullN + _No2];
+                    std::complex<double> sumy = 0.;
+                    for (int t=0; t<xlen[i]; ++t) sumy += wxp[t] * row[ixp[t]];
+                    sum += sumy * wyp[s];
+                }
+                out[i] = std::complex<T>(sum);
+            }
+        }
+    }
+
     // Fill table from a function:
     void KTable::fill(KTable::function1 func)
     {
@@ -856,61 +1542,66 @@ namespace galsim {
             // We have the opportunity to speed up the calculation by
             // re-using the sums over rows.  So we will keep a
             // cache of them.
-            if (x != _cacheX || ixy != _cacheInterp) {
-                clearCache();
-                _cacheX = x;
-                _cacheInterp = ixy;
-            } else if (iyMax==iyMin && !_cache.empty()) {
+            // The cache is only useful to one caller stepping through nearby points, so if
+            // another thread is using it, just use a new one rather than waiting.
+            std::unique_lock<std::mutex> lock(_cacheMutex, std::try_to_lock);
+            InterpCache local_cache;
+            InterpCache& c = lock.owns_lock() ? _cache : local_cache;
+            if (x != c.x || ixy != c.interp) {
+                c.clear();
+                c.x = x;
+                c.interp = ixy;
+            } else if (iyMax==iyMin && !c.rows.empty()) {
                 // Special case for interpolation on a single iy value:
                 // See if we already have this row in cache:
-                int index = iyMin - _cacheStartY;
+                int index = iyMin - c.startY;
                 if (index < 0) index += _N;
-                if (index < int(_cache.size()))
+                if (index < int(c.rows.size()))
                     // We have it!
-                    return _cache[index];
+                    return c.rows[index];
                 else
                     // Desired row not in cache - kill cache, continue as normal.
                     // (But don't clear xwt, since that's still good.)
-                    _cache.clear();
+                    c.rows.clear();
             }
 
             // Build x factors for interpolant
             int nx = ixMax - ixMin + 1;
             // This is also cached if possible.  It gets cleared when x != cacheX above.
-            if (_xwt.empty()) {
-                _xwt.resize(nx);
+            if (c.xwt.empty()) {
+                c.xwt.resize(nx);
                 for (int i=0; i<nx; ++i)
-                    _xwt[i] = ixy->xval1d(i+ixMin-x);
+                    c.xwt[i] = ixy->xval1d(i+ixMin-x);
             } else {
-                assert(int(_xwt.size()) == nx);
+                assert(int(c.xwt.size()) == nx);
             }
 
             // cache always holds sequential y values (no wrap).  Throw away
             // elements until we get to the one we need first
-            std::deque<double>::iterator nextSaved = _cache.begin();
-            while (nextSaved != _cache.end() && _cacheStartY != iyMin) {
-                _cache.pop_front();
-                ++_cacheStartY;
-                nextSaved = _cache.begin();
+            std::deque<double>::iterator nextSaved = c.rows.begin();
+            while (nextSaved != c.rows.end() && c.startY != iyMin) {
+                c.rows.pop_front();
+                ++c.startY;
+                nextSaved = c.rows.begin();
             }
 
             for (int iy=iyMin; iy<=iyMax; ++iy) {
                 double sumy = 0.;
-                if (nextSaved != _cache.end()) {
+                if (nextSaved != c.rows.end()) {
                     // This row is cached
                     sumy = *nextSaved;
                     ++nextSaved;
                 } else {
                     // Need to compute a new row's sum
                     const double* dptr = _array.get() + index(ixMin, iy);
-                    std::vector<double>::const_iterator xwt_it = _xwt.begin();
+                    std::vector<double>::const_iterator xwt_it = c.xwt.begin();
                     int count = nx;
                     for(; count; --count) sumy += (*xwt_it++) * (*dptr++);
-                    xassert(xwt_it == _xwt.end());
+                    xassert(xwt_it == c.xwt.end());
                     // Add to back of cache
-                    if (_cache.empty()) _cacheStartY = iy;
-                    _cache.push_back(sumy);
-                    nextSaved = _cache.end();
+                    if (c.rows.empty()) c.startY = iy;
+                    c.rows.push_back(sumy);
+                    nextSaved = c.rows.end();
                 }
                 sum += sumy * ixy->xval1d(iy-y);
             }
@@ -925,6 +1616,110 @@ namespace galsim {
         return sum;
     }
 
+    // The 1-d kernel weights for interpolating to a regular sequence of points
+    // u_i = u0 + i du (in units of the table spacing).  For point i, the weights are
+    // wt[i*width + k] for table indices start[i] + k, k = 0..len[i]-1.
+    struct GridWeights
+    {
+        std::vector<int> start;
+        std::vector<int> len;
+        std::vector<double> wt;
+        int width;
+
+        // Build the weights for an XTable with indices in [-No2, No2).  The footprint of each
+        // point is the same as the one XTable::interpolate uses.
+        GridWeights(double u0, double du, int n, int No2, const Interpolant& interp) :
+            start(n), len(n), width(0)
+        {
+            const double xrange = interp.xrange();
+            const bool exact = interp.isExactAtNodes();
+            std::vector<int> iMax(n);
+            for (int i=0; i<n; ++i) {
+                double u = u0 + i*du;
+                int i1, i2;
+                if (exact && std::abs(u - std::floor(u+0.01)) <
+                    10.*std::numeric_limits<double>::epsilon()) {
+                    i1 = i2 = int(std::floor(u+0.01));
+                } else {
+                    i1 = int(std::ceil(u-xrange));
+                    i2 = int(std::floor(u+xrange));
+                }
+                i1 = std::max(i1, -No2);
+                i2 = std::min(i2, No2-1);
+                start[i] = i1;
+                len[i] = std::max(i2-i1+1, 0);
+                width = std::max(width, len[i]);
+            }
+            // Fill in the kernel arguments, and then evaluate them all at once.
+            wt.resize(n*width);
+            for (int i=0; i<n; ++i) {
+                double u = u0 + i*du;
+                double* w = &wt[i*width];
+                for (int k=0; k<len[i]; ++k) w[k] = start[i]+k-u;
+            }
+            if (!wt.empty()) interp.xvalMany(&wt[0], wt.size());
+        }
+    };
+
+    template <typename T>
+    void XTable::interpolateGrid(T* ptr, int m, int n, int stride,
+                                 double x0, double dx, double y0, double dy,
+                                 const Interpolant& interp) const
+    {
+        dbg<<"XTable interpolateGrid: m,n = "<<m<<','<<n<<std::endl;
+        GridWeights wx(x0*_invdx, dx*_invdx, m, _No2, interp);
+        GridWeights wy(y0*_invdx, dy*_invdx, n, _No2, interp);
+
+        // Find which rows of the table contribute to any output row.
+        std::vector<int> rowIndex(_N, -1);
+        std::vector<int> rows;
+        for (int j=0; j<n; ++j) {
+            for (int k=0; k<wy.len[j]; ++k) {
+                int iy = wy.start[j] + k + _No2;
+                if (rowIndex[iy] < 0) {
+                    rowIndex[iy] = rows.size();
+                    rows.push_back(iy);
+                }
+            }
+        }
+        const int nrows = rows.size();
+        xdbg<<"Using "<<nrows<<" rows of the table\n";
+
+        // First pass: interpolate each of the rows we need in the x direction.
+        // tmp[r*m + i] is the value of table row rows[r] at x_i.
+        std::vector<double> tmp(size_t(nrows)*m);
+#ifdef _OPENMP
+#pragma omp parallel for if (size_t(m)*nrows*wx.width > 100000)
+#endif
+        for (int r=0; r<nrows; ++r) {
+            const double* row = _array.get() + rows[r]*_N + _No2;
+            double* out = &tmp[size_t(r)*m];
+            for (int i=0; i<m; ++i) {
+                const double* w = &wx.wt[i*wx.width];
+                const double* d = row + wx.start[i];
+                double sum = 0.;
+                for (int k=0; k<wx.len[i]; ++k) sum += w[k] * d[k];
+                out[i] = sum;
+            }
+        }
+
+        // Second pass: combine the rows for each output row.
+#ifdef _OPENMP
+#pragma omp parallel for if (size_t(m)*n*wy.width > 100000)
+#endif
+        for (int j=0; j<n; ++j) {
+            ScratchBuffer<double> sum(m);
+            std::fill(sum.begin(), sum.end(), 0.);
+            const double* w = &wy.wt[j*wy.width];
+            for (int k=0; k<wy.len[j]; ++k) {
+                const double* t = &tmp[size_t(rowIndex[wy.start[j]+k+_No2])*m];
+                for (int i=0; i<m; ++i) sum[i] += w[k] * t[i];
+            }
+            T* out = ptr + size_t(j)*stride;
+            for (int i=0; i<m; ++i) out[i] = T(sum[i]);
+        }
+    }
+
     // Fill table from a function:
     void XTable::fill(XTable::function1 func)
     {
@@ -1017,14 +1812,10 @@ namespace galsim {
 
         XTable xt( _N, 2.*M_PI*_invNd*_invdk );
 
-        // Note: The fftw_execute function is the only thread-safe FFTW routine.
-        // So if we decide to go with some kind of multi-threading (rather than multi-process
-        // parallelism) all of the plan creation and destruction calls in this file
-        // will need to be placed in critical blocks or the equivalent (mutex locks, etc.).
-        fftw_plan plan = fftw_plan_dft_c2r_2d(
-            _N, _N, t_array.get_fftw(), xt._array.get_fftw(), FFTW_MEASURE);
-        if (plan==NULL) throw FFTInvalid();
-        fftw_destroy_plan(plan);
+        // This leaves a MEASURE plan in the cache, which transform() will then use, since
+        // the cache ignores the planning flags and FFTW_Arrays are all 64 byte aligned.
+        GetFFTWPlan(MakeFFTWPlanKey(FFTW_KIND_C2R, _N, _N, t_array.get(), xt._array.get()),
+                    FFTW_MEASURE);
     }
 
     // Fourier transform from (complex) k to x:
@@ -1057,16 +1848,9 @@ namespace galsim {
         }
         xdbg<<"After fill t_array, t_array[0] = "<<t_array[0]<<std::endl;
 
-        fftw_plan plan = fftw_plan_dft_c2r_2d(
-            _N, _N, t_array.get_fftw(), xt._array.get_fftw(), FFTW_ESTIMATE);
-        xdbg<<"After make plan"<<std::endl;
-        if (plan==NULL) throw FFTInvalid();
-
         // Run the transform:
-        fftw_execute(plan);
+        ExecuteFFT_c2r(_N, _N, t_array.get(), xt._array.get());
         xdbg<<"After exec plan"<<std::endl;
-        fftw_destroy_plan(plan);
-        xdbg<<"After destroy plan"<<std::endl;
 
         xt._dx = 2.*M_PI*_invNd*_invdk;
         dbg<<"dx = "<<xt._dx<<std::endl;
@@ -1090,11 +1874,10 @@ namespace galsim {
 
         KTable kt( _N, 2.*M_PI*_invNd*_invdx );
 
-        fftw_plan plan = fftw_plan_dft_r2c_2d(
-            _N,_N, t_array.get_fftw(), kt._array.get_fftw(), FFTW_MEASURE);
-        if (plan==NULL) throw FFTInvalid();
-
-        fftw_destroy_plan(plan);
+        // This leaves a MEASURE plan in the cache, which transform() will then use, since
+        // the cache ignores the planning flags and FFTW_Arrays are all 64 byte aligned.
+        GetFFTWPlan(MakeFFTWPlanKey(FFTW_KIND_R2C, _N, _N, t_array.get(), kt._array.get()),
+                    FFTW_MEASURE);
     }
 
     // Fourier transform from x back to (complex) k:
@@ -1105,11 +1888,7 @@ namespace galsim {
         // Make a new copy of data array since measurement will overwrite:
         FFTW_Array<double> t_array = _array;
 
-        fftw_plan plan = fftw_plan_dft_r2c_2d(
-            _N,_N, t_array.get_fftw(), kt._array.get_fftw(), FFTW_ESTIMATE);
-        if (plan==NULL) throw FFTInvalid();
-        fftw_execute(plan);
-        fftw_destroy_plan(plan);
+        ExecuteFFT_r2c(_N, _N, t_array.get(), kt._array.get());
 
         // Now scale the k spectrum and flip signs for x=0 in middle.
         double fac = _dx * _dx;
@@ -1132,6 +1911,28 @@ namespace galsim {
         return kt;
     }
 
+    template void XTable::interpolateGrid(
+        double* ptr, int m, int n, int stride,
+        double x0, double dx, double y0, double dy, const Interpolant& interp) const;
+    template void XTable::interpolateGrid(
+        float* ptr, int m, int n, int stride,
+        double x0, double dx, double y0, double dy, const Interpolant& interp) const;
+
+    template void KTable::interpolateGrid(
+        std::complex<double>* ptr, int m, int n, int stride,
+        double kx0, double dkx, double ky0, double dky, const Interpolant& interp) const;
+    template void KTable::interpolateGrid(
+        std::complex<float>* ptr, int m, int n, int stride,
+        double kx0, double dkx, double ky0, double dky, const Interpolant& interp) const;
+    template void KTable::interpolateGrid(
+        std::complex<double>* ptr, int m, int n, int stride,
+        double kx0, double dkx, double dkxy, double ky0, double dky, double dkyx,
+        const Interpolant& interp, double kmax) const;
+    template void KTable::interpolateGrid(
+        std::complex<float>* ptr, int m, int n, int stride,
+        double kx0, double dkx, double dkxy, double ky0, double dky, double dkyx,
+        const Interpolant& interp, double kmax) const;
+
     template class FFTW_Array<double>;
     template class FFTW_Array<std::complex<double> >;
 
@@ -33,7 +33,10 @@ namespace galsim {
                        double _realspace_abserr,
                        double _integration_relerr,
                        double _integration_abserr,
-                       double _shoot_accuracy):
+                       double _shoot_accuracy,
+                       bool _single_precision_fft,
+                       bool _tabulate_xval,
+                       bool _interpolate_sersic_n):
         minimum_fft_size(_minimum_fft_size),
         maximum_fft_size(_maximum_fft_size),
         folding_threshold(_folding_threshold),
@@ -46,7 +49,10 @@ namespace galsim {
         realspace_abserr(_realspace_abserr),
         integration_relerr(_integration_relerr),
         integration_abserr(_integration_abserr),
-        shoot_accuracy(_shoot_accuracy)
+        shoot_accuracy(_shoot_accuracy),
+        single_precision_fft(_single_precision_fft),
+        tabulate_xval(_tabulate_xval),
+        interpolate_sersic_n(_interpolate_sersic_n)
     {}
 
     bool GSParams::operator==(const GSParams& rhs) const
@@ -70,6 +76,7 @@ namespace galsim {
         else if (integration_abserr != rhs.integration_abserr) return false;
 
         else if (shoot_accuracy != rhs.shoot_accuracy) return false;
+
         else return true;
     }
 
@@ -114,7 +121,10 @@ namespace galsim {
             << gsp.table_spacing << ", "
             << gsp.realspace_relerr << "," << gsp.realspace_abserr << ",  "
             << gsp.integration_relerr << "," << gsp.integration_abserr << ",  "
-            << gsp.shoot_accuracy;
+            << gsp.shoot_accuracy << ",  "
+            << (gsp.single_precision_fft ? "True" : "False") << ", "
+            << (gsp.tabulate_xval ? "True" : "False") << ", "
+            << (gsp.interpolate_sersic_n ? "True" : "False");
         return os;
     }
 
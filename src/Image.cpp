@@ -23,11 +23,11 @@
 #include <numeric>
 #include <cstring>
 
-#include "fftw3.h"
 #include "fmath/fmath.hpp"  // Use their compiler checks for the right SSE include.
 
 #include "Image.h"
 #include "ImageArith.h"
+#include "FFT.h"
 
 namespace galsim {
 
@@ -666,8 +666,8 @@ void wrapImage(ImageView<T> im, const Bounds<int>& b, bool hermx, bool hermy)
 }
 
 
-template <typename T>
-void rfft(const BaseImage<T>& in, ImageView<std::complex<double> > out,
+template <typename T, typename U>
+void rfft(const BaseImage<T>& in, ImageView<std::complex<U> > out,
           bool shift_in, bool shift_out)
 {
     dbg<<"Start rfft\n";
@@ -697,7 +697,7 @@ void rfft(const BaseImage<T>& in, ImageView<std::complex<double> > out,
     // However, note that the complex array has two extra elements in the primary direction
     // (x in our case) to allow for the extra column.
     // cf. http://www.fftw.org/doc/Real_002ddata-DFT-Array-Format.html
-    double* xptr = reinterpret_cast<double*>(out.getData());
+    U* xptr = reinterpret_cast<U*>(out.getData());
     const T* ptr = in.getData();
     const int skip = in.getNSkip();
 
@@ -727,18 +727,15 @@ void rfft(const BaseImage<T>& in, ImageView<std::complex<double> > out,
         }
     }
 
-    fftw_complex* kdata = reinterpret_cast<fftw_complex*>(out.getData());
-    double* xdata = reinterpret_cast<double*>(out.getData());
+    std::complex<U>* kdata = out.getData();
+    U* xdata = reinterpret_cast<U*>(out.getData());
 
-    fftw_plan plan = fftw_plan_dft_r2c_2d(Ny, Nx, xdata, kdata, FFTW_ESTIMATE);
-    if (plan==NULL) throw std::runtime_error("fftw_plan cannot be created");
-    fftw_execute(plan);
-    fftw_destroy_plan(plan);
+    ExecuteFFT_r2c(Ny, Nx, xdata, kdata);
 
     // The resulting image will still have a checkerboard pattern of +-1 on it, which
     // we want to remove.
     if (shift_in) {
-        std::complex<double>* kptr = out.getData();
+        std::complex<U>* kptr = out.getData();
         double fac = 1.;
         const bool extra_flip = (Nxo2 % 2 == 1);
         for (int j=Ny; j; --j, fac=(extra_flip?-fac:fac))
@@ -747,10 +744,10 @@ void rfft(const BaseImage<T>& in, ImageView<std::complex<double> > out,
     }
 }
 
-template <typename T>
-void irfft(const BaseImage<T>& in, ImageView<double> out, bool shift_in, bool shift_out)
+template <typename T, typename U>
+void irfftPrepare(const BaseImage<T>& in, ImageView<U> out, bool shift_in, bool shift_out)
 {
-    dbg<<"Start irfft\n";
+    dbg<<"Start irfftPrepare\n";
     dbg<<"self bounds = "<<in.getBounds()<<std::endl;
 
     if (!in.getData() or !in.getBounds().isDefined())
@@ -782,7 +779,7 @@ void irfft(const BaseImage<T>& in, ImageView<double> out, bool shift_in, bool sh
     // cf. http://www.fftw.org/doc/Real_002ddata-DFT-Array-Format.html
     // The bounds we care about are (-Nxo2, Nxo2-1, -Nyo2, Nyo2-1).
 
-    std::complex<double>* kptr = reinterpret_cast<std::complex<double>*>(out.getData());
+    std::complex<U>* kptr = reinterpret_cast<std::complex<U>*>(out.getData());
 
     // FFTW wants the locations of the + and - ky values swapped relative to how
     // we store it in an image.
@@ -834,14 +831,20 @@ void irfft(const BaseImage<T>& in, ImageView<double> out, bool shift_in, bool sh
                     *kptr++ = fac * *ptr;
         }
     }
+}
 
-    double* xdata = out.getData();
-    fftw_complex* kdata = reinterpret_cast<fftw_complex*>(xdata);
+template <typename T, typename U>
+void irfft(const BaseImage<T>& in, ImageView<U> out, bool shift_in, bool shift_out)
+{
+    dbg<<"Start irfft\n";
+    irfftPrepare(in, out, shift_in, shift_out);
 
-    fftw_plan plan = fftw_plan_dft_c2r_2d(Ny, Nx, kdata, xdata, FFTW_ESTIMATE);
-    if (plan==NULL) throw std::runtime_error("fftw_plan cannot be created");
-    fftw_execute(plan);
-    fftw_destroy_plan(plan);
+    const int Nx = in.getBounds().getXMax() << 1;
+    const int Ny = (in.getBounds().getYMax()+1) << 1;
+    U* xdata = out.getData();
+    std::complex<U>* kdata = reinterpret_cast<std::complex<U>*>(xdata);
+
+    ExecuteFFT_c2r(Ny, Nx, kdata, xdata);
 }
 
 template <typename T>
@@ -909,13 +912,8 @@ void cfft(const BaseImage<T>& in, ImageView<std::complex<double> > out,
         }
     }
 
-    fftw_complex* kdata = reinterpret_cast<fftw_complex*>(out.getData());
-
-    fftw_plan plan = fftw_plan_dft_2d(Ny, Nx, kdata, kdata, inverse ? FFTW_BACKWARD : FFTW_FORWARD,
-                                      FFTW_ESTIMATE);
-    if (plan==NULL) throw std::runtime_error("fftw_plan cannot be created");
-    fftw_execute(plan);
-    fftw_destroy_plan(plan);
+    std::complex<double>* kdata = out.getData();
+    ExecuteFFT_c2c(Ny, Nx, kdata, kdata, inverse);
 
     if (shift_in) {
         kptr = out.getData();
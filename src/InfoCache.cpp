@@ -0,0 +1,356 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+//#define DEBUGLOGGING
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <process.h>
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "InfoCache.h"
+#include "Table.h"
+
+namespace galsim {
+
+    void WriteVector(std::ostream& os, const std::vector<double>& v)
+    {
+        WriteValue(os, int(v.size()));
+        if (!v.empty()) os.write(reinterpret_cast<const char*>(&v[0]), v.size()*sizeof(double));
+    }
+
+    bool ReadVector(std::istream& is, std::vector<double>& v)
+    {
+        int n;
+        if (!ReadValue(is, n) || n < 0 || n > 100000000) return false;
+        v.resize(n);
+        if (n == 0) return true;
+        return bool(is.read(reinterpret_cast<char*>(&v[0]), n*sizeof(double)));
+    }
+
+    // The switches are not written, since they don't change any of the cached values.
+    void WriteGSParams(std::ostream& os, const GSParams& gsp)
+    {
+        WriteValue(os, gsp.minimum_fft_size);
+        WriteValue(os, gsp.maximum_fft_size);
+        WriteValue(os, gsp.folding_threshold);
+        WriteValue(os, gsp.stepk_minimum_hlr);
+        WriteValue(os, gsp.maxk_threshold);
+        WriteValue(os, gsp.kvalue_accuracy);
+        WriteValue(os, gsp.xvalue_accuracy);
+        WriteValue(os, gsp.table_spacing);
+        WriteValue(os, gsp.realspace_relerr);
+        WriteValue(os, gsp.realspace_abserr);
+        WriteValue(os, gsp.integration_relerr);
+        WriteValue(os, gsp.integration_abserr);
+        WriteValue(os, gsp.shoot_accuracy);
+    }
+
+    bool ReadGSParams(std::istream& is, GSParams& gsp)
+    {
+        return (ReadValue(is, gsp.minimum_fft_size) &&
+                ReadValue(is, gsp.maximum_fft_size) &&
+                ReadValue(is, gsp.folding_threshold) &&
+                ReadValue(is, gsp.stepk_minimum_hlr) &&
+                ReadValue(is, gsp.maxk_threshold) &&
+                ReadValue(is, gsp.kvalue_accuracy) &&
+                ReadValue(is, gsp.xvalue_accuracy) &&
+                ReadValue(is, gsp.table_spacing) &&
+                ReadValue(is, gsp.realspace_relerr) &&
+                ReadValue(is, gsp.realspace_abserr) &&
+                ReadValue(is, gsp.integration_relerr) &&
+                ReadValue(is, gsp.integration_abserr) &&
+                ReadValue(is, gsp.shoot_accuracy));
+    }
+
+    void WriteTable(std::ostream& os, const TableBuilder& table)
+    {
+        WriteVector(os, table.getArgs());
+        WriteVector(os, table.getVals());
+    }
+
+    bool ReadTableValues(std::istream& is, std::vector<double>& args, std::vector<double>& vals)
+    {
+        return (ReadVector(is, args) && ReadVector(is, vals) &&
+                args.size() == vals.size() && args.size() >= 2);
+    }
+
+    void SetTableValues(TableBuilder& table, const std::vector<double>& args,
+                        const std::vector<double>& vals)
+    {
+        for (size_t i=0; i<args.size(); ++i) table.addEntry(args[i], vals[i]);
+        table.finalize();
+    }
+
+    bool ReadTable(std::istream& is, TableBuilder& table)
+    {
+        std::vector<double> args, vals;
+        if (!ReadTableValues(is, args, vals)) return false;
+        SetTableValues(table, args, vals);
+        return true;
+    }
+
+    //
+    // The cache directory
+    //
+
+    static std::mutex info_cache_mutex;
+    static bool info_cache_dir_set = false;
+    static std::string info_cache_dir;
+    // Checking whether the cache is on happens for every new Info, so keep a flag that
+    // doesn't need the lock.
+    static std::atomic<bool> info_cache_enabled(false);
+
+    static void CheckInfoCacheDir()
+    {
+        // Must be called with info_cache_mutex locked.
+        if (!info_cache_dir_set) {
+            const char* env = std::getenv("GALSIM_INFO_CACHE_DIR");
+            info_cache_dir = env ? env : "";
+            info_cache_enabled = !info_cache_dir.empty();
+            info_cache_dir_set = true;
+        }
+    }
+
+    void SetInfoCacheDir(const std::string& dir)
+    {
+        std::lock_guard<std::mutex> lock(info_cache_mutex);
+        info_cache_dir = dir;
+        info_cache_enabled = !info_cache_dir.empty();
+        info_cache_dir_set = true;
+    }
+
+    std::string GetInfoCacheDir()
+    {
+        std::lock_guard<std::mutex> lock(info_cache_mutex);
+        CheckInfoCacheDir();
+        return info_cache_dir;
+    }
+
+    static void InitInfoCacheDir()
+    {
+        std::lock_guard<std::mutex> lock(info_cache_mutex);
+        CheckInfoCacheDir();
+    }
+
+    bool InfoCacheEnabled()
+    {
+        static std::once_flag once;
+        std::call_once(once, InitInfoCacheDir);
+        return info_cache_enabled;
+    }
+
+    //
+    // The file format is:
+    //
+    //     magic string
+    //     the cache version and a check value of 1.0 (to catch a different architecture)
+    //     the key: type, params, gsparams
+    //     the length of the contents
+    //     the contents
+    //
+    // Everything before the contents is compared byte for byte with what we expect for the
+    // key, so any difference in the key or the format makes the entry invalid.
+    //
+
+    static const char info_cache_magic[] = "GalSim InfoCache";
+
+    static std::string InfoCacheHeader(const InfoCacheKey& key)
+    {
+        std::ostringstream os(std::ios::binary);
+        os.write(info_cache_magic, sizeof(info_cache_magic));
+        WriteValue(os, sbp::info_cache_version);
+        WriteValue(os, 1.0);
+        WriteValue(os, int(key.type.size()));
+        os.write(key.type.data(), key.type.size());
+        WriteVector(os, key.params);
+        WriteGSParams(os, key.gsparams);
+        return os.str();
+    }
+
+    // The file name is the type followed by a 64 bit FNV-1a hash of the header.
+    static std::string InfoCacheFileName(const std::string& dir, const InfoCacheKey& key,
+                                         const std::string& header)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i=0; i<header.size(); ++i) {
+            hash ^= uint64_t(static_cast<unsigned char>(header[i]));
+            hash *= 1099511628211ULL;
+        }
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+        return dir + "/" + key.type + "_" + hex + ".dat";
+    }
+
+    // A read-only streambuf over a memory-mapped file.
+    class MappedFileBuf : public std::streambuf
+    {
+    public:
+        MappedFileBuf(const std::string& file_name) : _data(0), _size(0)
+        {
+#ifdef _WIN32
+            std::ifstream fin(file_name.c_str(), std::ios::binary);
+            if (!fin) return;
+            std::ostringstream os(std::ios::binary);
+            os << fin.rdbuf();
+            _copy = os.str();
+            if (_copy.empty()) return;
+            _data = &_copy[0];
+            _size = _copy.size();
+#else
+            int fd = ::open(file_name.c_str(), O_RDONLY);
+            if (fd < 0) return;
+            struct stat st;
+            if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* p = ::mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (p != MAP_FAILED) {
+                    _data = static_cast<char*>(p);
+                    _size = st.st_size;
+                }
+            }
+            // The mapping stays valid after the file is closed.
+            ::close(fd);
+#endif
+            setg(_data, _data, _data + _size);
+        }
+
+        ~MappedFileBuf()
+        {
+#ifndef _WIN32
+            if (_data) ::munmap(_data, _size);
+#endif
+        }
+
+        const char* data() const { return _data; }
+        size_t size() const { return _size; }
+
+        // Restrict the readable range to [start, end).
+        void setRange(size_t start, size_t end)
+        { setg(_data + start, _data + start, _data + end); }
+
+    private:
+        MappedFileBuf(const MappedFileBuf&);
+        void operator=(const MappedFileBuf&);
+
+        char* _data;
+        size_t _size;
+#ifdef _WIN32
+        std::string _copy;
+#endif
+    };
+
+    class MappedFileStream : public std::istream
+    {
+    public:
+        MappedFileStream(const std::string& file_name) :
+            std::istream(0), _buf(file_name)
+        { rdbuf(&_buf); }
+
+        MappedFileBuf& buf() { return _buf; }
+
+    private:
+        MappedFileBuf _buf;
+    };
+
+    shared_ptr<std::istream> OpenCachedInfo(const InfoCacheKey& key)
+    {
+        std::string dir = GetInfoCacheDir();
+        if (dir.empty()) return shared_ptr<std::istream>();
+
+        std::string header = InfoCacheHeader(key);
+        std::string file_name = InfoCacheFileName(dir, key, header);
+        dbg<<"OpenCachedInfo: "<<file_name<<std::endl;
+
+        shared_ptr<MappedFileStream> is(new MappedFileStream(file_name));
+        MappedFileBuf& buf = is->buf();
+        const size_t nheader = header.size();
+        uint64_t ncontents;
+        if (buf.size() < nheader + sizeof(ncontents) ||
+            std::memcmp(buf.data(), header.data(), nheader) != 0) {
+            dbg<<"No valid cache entry"<<std::endl;
+            return shared_ptr<std::istream>();
+        }
+        std::memcpy(&ncontents, buf.data() + nheader, sizeof(ncontents));
+        const size_t start = nheader + sizeof(ncontents);
+        if (ncontents != buf.size() - start) {
+            dbg<<"Cache entry has the wrong length"<<std::endl;
+            return shared_ptr<std::istream>();
+        }
+        buf.setRange(start, buf.size());
+        return is;
+    }
+
+    void SaveCachedInfo(const InfoCacheKey& key, const std::string& contents)
+    {
+        std::string dir = GetInfoCacheDir();
+        if (dir.empty()) return;
+
+        std::string header = InfoCacheHeader(key);
+        std::string file_name = InfoCacheFileName(dir, key, header);
+        dbg<<"SaveCachedInfo: "<<file_name<<std::endl;
+
+        // Write to a name unique to this process and call, and then rename it, so readers
+        // never see a partially written file.
+        static std::atomic<int> count(0);
+        std::ostringstream tmp_name;
+#ifdef _WIN32
+        tmp_name << file_name << ".tmp." << _getpid() << "." << count++;
+        _mkdir(dir.c_str());
+#else
+        tmp_name << file_name << ".tmp." << ::getpid() << "." << count++;
+        ::mkdir(dir.c_str(), 0777);
+#endif
+        {
+            std::ofstream fout(tmp_name.str().c_str(), std::ios::binary);
+            if (!fout) {
+                dbg<<"Unable to open "<<tmp_name.str()<<std::endl;
+                return;
+            }
+            uint64_t ncontents = contents.size();
+            fout.write(header.data(), header.size());
+            WriteValue(fout, ncontents);
+            fout.write(contents.data(), contents.size());
+            fout.close();
+            if (!fout) {
+                dbg<<"Error writing "<<tmp_name.str()<<std::endl;
+                std::remove(tmp_name.str().c_str());
+                return;
+            }
+        }
+#ifdef _WIN32
+        // Windows won't rename onto an existing file.
+        std::remove(file_name.c_str());
+#endif
+        if (std::rename(tmp_name.str().c_str(), file_name.c_str()) != 0)
+            std::remove(tmp_name.str().c_str());
+    }
+
+}
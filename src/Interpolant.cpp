@@ -90,6 +90,87 @@ namespace galsim {
 
     double InterpolantFunction::operator()(double x) const  { return _interp.xval(x); }
 
+    //
+    // XvalTable
+    //
+
+    XvalTable::XvalTable(const Interpolant& interp, const GSParams& gsparams) :
+        _range(interp.xrange())
+    {
+        // Cubic interpolation in each cell has errors ~h^4, so start with the same step size
+        // that the other tables use for this accuracy.  Make sure the cell edges hit the
+        // integers exactly.
+        const double h = gsparams.table_spacing * std::pow(gsparams.xvalue_accuracy/10., 0.25);
+        _n = std::max(int(std::ceil(1./h)), 1);
+        const int max_n = 1<<14;
+        for (;;) {
+            build(interp);
+            dbg<<"XvalTable with n = "<<_n<<" has max error "<<_max_err<<std::endl;
+            if (_max_err < gsparams.xvalue_accuracy || _n >= max_n) break;
+            _n *= 2;
+        }
+    }
+
+    void XvalTable::build(const Interpolant& interp)
+    {
+        _ncell = int(std::ceil(_range * _n));
+        const double h = 1./_n;
+        _coef.resize(4*_ncell);
+        for (int i=0; i<_ncell; ++i) {
+            // The cubic through f(x0 + k h/3) for k = 0,1,2,3, as a polynomial in t = (x-x0)/h.
+            double x0 = i*h;
+            double f0 = interp.xval(x0);
+            double f1 = interp.xval(x0 + h/3.);
+            double f2 = interp.xval(x0 + 2.*h/3.);
+            double f3 = interp.xval(x0 + h);
+            double* c = &_coef[4*i];
+            c[0] = f0;
+            c[1] = 0.5 * (-11.*f0 + 18.*f1 - 9.*f2 + 2.*f3);
+            c[2] = 4.5 * (2.*f0 - 5.*f1 + 4.*f2 - f3);
+            c[3] = 4.5 * (-f0 + 3.*f1 - 3.*f2 + f3);
+        }
+
+        // Check the error at points that are not nodes of any of the cubics.
+        _max_err = 0.;
+        for (int i=0; i<_ncell; ++i) {
+            for (int k=1; k<16; k+=2) {
+                double x = (i + k/16.) * h;
+                if (x >= _range) break;
+                double err = std::abs((*this)(x) - interp.xval(x));
+                if (err > _max_err) _max_err = err;
+            }
+        }
+    }
+
+    void XvalTable::many(double* x, int N) const
+    {
+        const double* coef = &_coef[0];
+        for (int i=0; i<N; ++i) {
+            double ax = std::abs(x[i]);
+            // Clamp to the last cell and zero it afterwards, so there is no branch here.
+            double inrange = ax < _range ? 1. : 0.;
+            double u = std::min(ax, _range) * _n;
+            int j = std::min(int(u), _ncell-1);
+            double t = u - j;
+            const double* c = coef + 4*j;
+            x[i] = inrange * (c[0] + t*(c[1] + t*(c[2] + t*c[3])));
+        }
+    }
+
+    // Get an XvalTable for this interpolant from the given cache, building it if necessary.
+    // The caller must hold the lock that protects the cache.
+    template <typename Key>
+    static shared_ptr<XvalTable> GetXvalTable(
+        std::map<Key,shared_ptr<XvalTable> >& cache, const Key& key,
+        const Interpolant& interp, const GSParams& gsparams)
+    {
+        typename std::map<Key,shared_ptr<XvalTable> >::iterator it = cache.find(key);
+        if (it != cache.end()) return it->second;
+        shared_ptr<XvalTable> tab(new XvalTable(interp, gsparams));
+        cache[key] = tab;
+        return tab;
+    }
+
     double InterpolantXY::getPositiveFlux() const
     {
         return _i1d.getPositiveFlux()*_i1d.getPositiveFlux()
@@ -137,7 +218,8 @@ namespace galsim {
     {
         // x is both input and output here.
         // x_i <- xval(x_i)
-        for (; N; --N, ++x) *x = xval(*x);
+        if (_xvaltab) _xvaltab->many(x, N);
+        else for (; N; --N, ++x) *x = xval(*x);
     }
 
     void Interpolant::uvalMany(double* u, int N) const
@@ -292,6 +374,7 @@ namespace galsim {
 
     double Cubic::xval(double x) const
     {
+        if (_xvaltab) return (*_xvaltab)(x);
         x = std::abs(x);
         if (x < 1.) return 1. + x*x*(1.5*x-2.5);
         else if (x < 2.) return -0.5*(x-1.)*(x-2.)*(x-2.);
@@ -333,6 +416,10 @@ namespace galsim {
         dbg<<"Start Cubic\n";
         _range = 2.;
 
+        // The cached tables are shared by all threads, so hold the lock while we look them
+        // up or build them.
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+
 #ifdef USE_TABLES
         double tol = gsparams.kvalue_accuracy;
         // Strangely, not all compilers correctly setup an empty map when it is a
@@ -376,10 +463,17 @@ namespace galsim {
         // umax = (3sqrt(3)/8 tol)^1/3 / pi
         _uMax = std::pow((3.*sqrt(3.)/8.)/gsparams.kvalue_accuracy, 1./3.) / M_PI;
 #endif
+
+        if (gsparams.tabulate_xval) {
+            std::pair<double,double> key(gsparams.xvalue_accuracy, gsparams.table_spacing);
+            _xvaltab = GetXvalTable(_cache_xvaltab, key, *this, gsparams);
+        }
     }
 
     std::map<double,shared_ptr<TableBuilder> > Cubic::_cache_tab;
     std::map<double,double> Cubic::_cache_umax;
+    std::map<std::pair<double,double>,shared_ptr<XvalTable> > Cubic::_cache_xvaltab;
+    std::mutex Cubic::_cache_mutex;
 
     std::string Cubic::makeStr() const
     {
@@ -397,6 +491,7 @@ namespace galsim {
 
     double Quintic::xval(double x) const
     {
+        if (_xvaltab) return (*_xvaltab)(x);
         x = std::abs(x);
 #ifdef ALT_QUINTIC
         // Gary claims in http://arxiv.org/abs/1401.2636 that his quintic function (below) has the
@@ -483,6 +578,10 @@ namespace galsim {
         dbg<<"Start Quintic\n";
         _range = 3.;
 
+        // The cached tables are shared by all threads, so hold the lock while we look them
+        // up or build them.
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+
 #ifdef USE_TABLES
         double tol = gsparams.kvalue_accuracy;
         // Strangely, not all compilers correctly setup an empty map when it is a
@@ -535,13 +634,17 @@ namespace galsim {
         // umax = (25sqrt(5)/108 tol)^1/3 / pi
         _uMax = std::pow((25.*sqrt(5.)/108.)/gsparams.kvalue_accuracy, 1./3.) / M_PI;
 #endif
+
+        if (gsparams.tabulate_xval) {
+            std::pair<double,double> key(gsparams.xvalue_accuracy, gsparams.table_spacing);
+            _xvaltab = GetXvalTable(_cache_xvaltab, key, *this, gsparams);
+        }
     }
 
     // Override default sampler configuration because Quintic filter has sign change in
     // outer interval
-    void Quintic::checkSampler() const
+    void Quintic::buildSampler() const
     {
-        if (_sampler.get()) return;
         std::vector<double> ranges(8);
         ranges[0] = -3.;
         ranges[1] = -(1./11.)*(25.+sqrt(31.));  // This is the extra zero-crossing
@@ -554,6 +657,8 @@ namespace galsim {
 
     std::map<double,shared_ptr<TableBuilder> > Quintic::_cache_tab;
     std::map<double,double> Quintic::_cache_umax;
+    std::map<std::pair<double,double>,shared_ptr<XvalTable> > Quintic::_cache_xvaltab;
+    std::mutex Quintic::_cache_mutex;
 
     std::string Quintic::makeStr() const
     {
@@ -847,6 +952,10 @@ namespace galsim {
                  - 2.*_K[5]*(1.-std::cos(10.*M_PI*x))) << std::endl;
         }
 
+        // The cached tables are shared by all threads, so hold the lock while we look them
+        // up or build them.
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+
         // Strangely, not all compilers correctly setup an empty map when it is a
         // static variable, so you can get seg faults using it.
         // Doing an explicit clear fixes the problem.
@@ -901,14 +1010,25 @@ namespace galsim {
             _cache_utab[key] = _utab;
             _cache_umax[key] = _uMax;
         }
+
+        if (gsparams.tabulate_xval) {
+            // The xval table depends on xvalue_accuracy, not kvalue_accuracy.
+            KeyType xkey(n,std::pair<bool,double>(_conserve_dc,gsparams.xvalue_accuracy));
+            std::pair<KeyType,double> key2(xkey, gsparams.table_spacing);
+            _xvaltab = GetXvalTable(_cache_xvaltab, key2, *this, gsparams);
+        }
     }
 
     std::map<Lanczos::KeyType,shared_ptr<TableBuilder> > Lanczos::_cache_xtab;
     std::map<Lanczos::KeyType,shared_ptr<TableBuilder> > Lanczos::_cache_utab;
     std::map<Lanczos::KeyType,double> Lanczos::_cache_umax;
+    std::map<std::pair<Lanczos::KeyType,double>,shared_ptr<XvalTable> >
+        Lanczos::_cache_xvaltab;
+    std::mutex Lanczos::_cache_mutex;
 
     double Lanczos::xval(double x) const
     {
+        if (_xvaltab) return (*_xvaltab)(x);
         x = std::abs(x);
         if (x >= _nd) return 0.;
         else {
@@ -0,0 +1,110 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+//#define DEBUGLOGGING
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include "Std.h"
+#include "LRUCache.h"
+
+namespace galsim {
+
+    // The registry is made on first use, since the caches that register themselves are
+    // static objects in several different files.  Being made by the first cache's constructor,
+    // it is also destroyed after all of the caches.
+    struct LRUCacheRegistry
+    {
+        std::mutex mutex;
+        std::map<std::string, LRUCacheBase*> caches;
+    };
+
+    static LRUCacheRegistry& GetLRUCacheRegistry()
+    {
+        static LRUCacheRegistry registry;
+        return registry;
+    }
+
+    void RegisterLRUCache(const std::string& name, LRUCacheBase* cache)
+    {
+        LRUCacheRegistry& registry = GetLRUCacheRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.caches[name] = cache;
+    }
+
+    void UnregisterLRUCache(const std::string& name, LRUCacheBase* cache)
+    {
+        LRUCacheRegistry& registry = GetLRUCacheRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::map<std::string, LRUCacheBase*>::iterator it = registry.caches.find(name);
+        if (it != registry.caches.end() && it->second == cache) registry.caches.erase(it);
+    }
+
+    std::vector<std::string> GetLRUCacheNames()
+    {
+        LRUCacheRegistry& registry = GetLRUCacheRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::vector<std::string> names;
+        std::map<std::string, LRUCacheBase*>::const_iterator it = registry.caches.begin();
+        for (; it != registry.caches.end(); ++it) names.push_back(it->first);
+        return names;
+    }
+
+    // Must be called with the registry mutex locked, so the cache can't go away while it
+    // is being used.
+    static LRUCacheBase& FindLRUCache(LRUCacheRegistry& registry, const std::string& name)
+    {
+        std::map<std::string, LRUCacheBase*>::iterator it = registry.caches.find(name);
+        if (it == registry.caches.end())
+            FormatAndThrow<std::invalid_argument>() << "No LRUCache named "<<name;
+        return *it->second;
+    }
+
+    LRUCacheStats GetLRUCacheStats(const std::string& name)
+    {
+        LRUCacheRegistry& registry = GetLRUCacheRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        return FindLRUCache(registry, name).getStats();
+    }
+
+    void ResetLRUCacheStats(const std::string& name)
+    {
+        LRUCacheRegistry& registry = GetLRUCacheRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        FindLRUCache(registry, name).resetStats();
+    }
+
+    void SetLRUCacheSize(const std::string& name, long max_entries, long max_bytes)
+    {
+        LRUCacheRegistry& registry = GetLRUCacheRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        dbg<<"SetLRUCacheSize: "<<name<<"  "<<max_entries<<"  "<<max_bytes<<std::endl;
+        FindLRUCache(registry, name).setMaxSize(max_entries, max_bytes);
+    }
+
+    void ClearLRUCache(const std::string& name)
+    {
+        LRUCacheRegistry& registry = GetLRUCacheRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        FindLRUCache(registry, name).clear();
+    }
+
+}
@@ -419,6 +419,93 @@ namespace galsim {
         _pt.buildTree(thresh);
     }
 
+    void Interval::write(std::ostream& os) const
+    {
+        checkFlux();
+        WriteValue(os, _xLower);
+        WriteValue(os, _xUpper);
+        WriteValue(os, _flux);
+        WriteValue(os, _a);
+        WriteValue(os, _b);
+        WriteValue(os, _c);
+        WriteValue(os, _d);
+    }
+
+    bool Interval::read(std::istream& is)
+    {
+        double xLower, xUpper, flux, a, b, c, d;
+        if (!(ReadValue(is, xLower) && ReadValue(is, xUpper) && ReadValue(is, flux) &&
+              ReadValue(is, a) && ReadValue(is, b) && ReadValue(is, c) && ReadValue(is, d)))
+            return false;
+        _xLower = xLower;
+        _xUpper = xUpper;
+        _xRange = _xUpper - _xLower;
+        _flux = flux;
+        _fluxIsReady = true;
+        _a = a;
+        _b = b;
+        _c = c;
+        _d = d;
+        return true;
+    }
+
+    OneDimensionalDeviate::OneDimensionalDeviate(const FluxDensity& fluxDensity,
+                                                 bool isRadial, const GSParams& gsparams) :
+        _fluxDensity(fluxDensity),
+        _positiveFlux(0.),
+        _negativeFlux(0.),
+        _isRadial(isRadial),
+        _gsparams(gsparams)
+    {}
+
+    void OneDimensionalDeviate::write(std::ostream& os) const
+    {
+        // The tree keeps the Intervals in its sorted order, so this is the order buildTree
+        // wants when reading them back.
+        WriteValue(os, _positiveFlux);
+        WriteValue(os, _negativeFlux);
+        WriteValue(os, int(_pt.size()));
+        for (ProbabilityTree<Interval>::const_iterator it=_pt.begin(); it!=_pt.end(); ++it)
+            (*it)->write(os);
+    }
+
+    bool OneDimensionalDeviate::read(std::istream& is)
+    {
+        assert(_pt.empty());
+        double positiveFlux, negativeFlux;
+        int n;
+        if (!(ReadValue(is, positiveFlux) && ReadValue(is, negativeFlux) &&
+              ReadValue(is, n) && n > 0 && n <= 100000000))
+            return false;
+        std::vector<shared_ptr<Interval> > intervals(n);
+        for (int i=0; i<n; ++i) {
+            intervals[i].reset(new Interval(_fluxDensity, 0., 0., _isRadial, _gsparams));
+            if (!intervals[i]->read(is)) return false;
+        }
+        _positiveFlux = positiveFlux;
+        _negativeFlux = negativeFlux;
+        _pt.insert(_pt.end(), intervals.begin(), intervals.end());
+        // Same threshold as the main constructor uses.
+        double thresh = std::numeric_limits<double>::epsilon() * (_positiveFlux + _negativeFlux);
+        _pt.buildTree(thresh, true);
+        return true;
+    }
+
+    shared_ptr<OneDimensionalDeviate> MakeCachedDeviate(
+        const InfoCacheKey& key, const FluxDensity& fluxDensity, std::vector<double>& range,
+        bool isRadial, double nominal_flux, const GSParams& gsparams)
+    {
+        shared_ptr<OneDimensionalDeviate> odd;
+        if (InfoCacheEnabled()) {
+            odd.reset(new OneDimensionalDeviate(fluxDensity, isRadial, gsparams));
+            if (ReadCachedInfo(key, *odd)) return odd;
+        }
+        odd.reset(new OneDimensionalDeviate(fluxDensity, range, isRadial, nominal_flux,
+                                            gsparams));
+        WriteCachedInfo(key, *odd);
+        return odd;
+    }
+
     void OneDimensionalDeviate::shoot(PhotonArray& photons, UniformDeviate ud, bool xandy) const
     {
         const int N = photons.size();
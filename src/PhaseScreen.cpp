@@ -0,0 +1,315 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+//#define DEBUGLOGGING
+
+#include <cmath>
+#include <exception>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "PhaseScreen.h"
+#include "ScratchArena.h"
+
+namespace galsim {
+
+    // The number of pupil points to do at a time when evaluating a layer.  Each (layer, block)
+    // pair is a separate task for the parallel loop in wavefront().
+    static const int block_size = 4096;
+
+    // The number of time steps that integrate() adds up in each of its partial sums.
+    static const int time_chunk_size = 4;
+
+    static void CheckEvenShape(const BaseImage<double>& screen, const BaseImage<double>& psi)
+    {
+        if (!screen.getBounds().isSameShapeAs(psi.getBounds()))
+            throw ImageError("Phase screen and psi must have the same shape");
+        if (screen.getNCol() % 2 != 0 || screen.getNRow() % 2 != 0)
+            throw ImageError("Phase screen must have even dimensions");
+    }
+
+    // Make the random screen in new_screen, which has bounds (-nx/2, nx/2-1, -ny/2, ny/2-1).
+    static void RandomScreen(ImageView<double> new_screen, const BaseImage<double>& psi,
+                             BaseDeviate rng)
+    {
+        const int nx = new_screen.getNCol();
+        const int ny = new_screen.getNRow();
+        const int nxo2 = nx/2;
+        const int nyo2 = ny/2;
+        dbg<<"RandomScreen: "<<nx<<" x "<<ny<<std::endl;
+
+        GaussianDeviate gd(rng, 0., 1.);
+        gd.generate(nx*ny, new_screen.getData());
+
+        ImageAlloc<std::complex<double> > rk(Bounds<int>(0, nxo2, -nyo2, nyo2-1));
+        rfft(new_screen, rk.view(), false, false);
+
+        // rfft only gives kx >= 0.  Fill in the rest from the Hermitian symmetry and
+        // multiply by psi.  This is the same as fft.fft2 + multiply in Python.
+        ImageAlloc<std::complex<double> > k(new_screen.getBounds());
+        const std::complex<double>* rkdata = rk.getData();
+        const int rkstride = rk.getStride();
+        std::complex<double>* kptr = k.getData();
+        const double* psirow = psi.getData();
+        const int psistep = psi.getStep();
+        for (int j=0; j<ny; ++j, psirow+=psi.getStride()) {
+            const std::complex<double>* row = rkdata + j*rkstride;
+            const std::complex<double>* conjrow = rkdata + ((ny-j)%ny)*rkstride;
+            const double* psiptr = psirow;
+            for (int i=0; i<nxo2; ++i, psiptr+=psistep)
+                *kptr++ = row[i] * *psiptr;
+            for (int i=nxo2; i<nx; ++i, psiptr+=psistep)
+                *kptr++ = std::conj(conjrow[nx-i]) * *psiptr;
+        }
+
+        ImageAlloc<std::complex<double> > x(new_screen.getBounds());
+        cfft(k, x.view(), true, false, false);
+
+        const std::complex<double>* xptr = x.getData();
+        double* ptr = new_screen.getData();
+        for (int i=nx*ny; i; --i) *ptr++ = std::real(*xptr++);
+    }
+
+    void MakeRandomPhaseScreen(ImageView<double> screen, const BaseImage<double>& psi,
+                               BaseDeviate rng)
+    {
+        CheckEvenShape(screen, psi);
+        const int nxo2 = screen.getNCol()/2;
+        const int nyo2 = screen.getNRow()/2;
+        ImageAlloc<double> new_screen(Bounds<int>(-nxo2, nxo2-1, -nyo2, nyo2-1));
+        RandomScreen(new_screen.view(), psi, rng);
+        screen.copyFrom(new_screen);
+    }
+
+    void BoilPhaseScreen(ImageView<double> screen, const BaseImage<double>& psi,
+                         BaseDeviate rng, double alpha, int nstep)
+    {
+        CheckEvenShape(screen, psi);
+        const int nx = screen.getNCol();
+        const int ny = screen.getNRow();
+        const int step = screen.getStep();
+        const int skip = screen.getNSkip();
+        const double beta = std::sqrt(1.-alpha*alpha);
+        ImageAlloc<double> new_screen(Bounds<int>(-nx/2, nx/2-1, -ny/2, ny/2-1));
+        for (int n=0; n<nstep; ++n) {
+            RandomScreen(new_screen.view(), psi, rng);
+            double* ptr = screen.getData();
+            const double* newptr = new_screen.getData();
+            for (int j=ny; j; --j, ptr+=skip) {
+                for (int i=nx; i; --i, ptr+=step) {
+                    *ptr *= alpha;
+                    *ptr += beta * *newptr++;
+                }
+            }
+        }
+    }
+
+    PhaseScreenEngine::PhaseScreenEngine(const double* u, const double* v, const int* index,
+                                         int npoints, int nx, int ny) :
+        _u(u), _v(v), _index(index), _npoints(npoints), _nx(nx), _ny(ny)
+    {
+        if (nx <= 0 || ny <= 0 || nx % 2 != 0 || ny % 2 != 0)
+            FormatAndThrow<std::invalid_argument>() <<
+                "Invalid pupil grid size "<<nx<<" x "<<ny;
+        for (int i=0; i<npoints; ++i) {
+            if (index[i] < 0 || index[i] >= nx*ny)
+                FormatAndThrow<std::invalid_argument>() <<
+                    "Pupil point index "<<index[i]<<" is outside the pupil grid";
+        }
+    }
+
+    void PhaseScreenEngine::addTableLayer(const Table2D& table, double x0, double y0,
+                                          double xperiod, double yperiod,
+                                          double vx, double vy, double altitude)
+    {
+        Layer layer;
+        layer.table = &table;
+        layer.fixed = 0;
+        layer.x0 = x0;
+        layer.y0 = y0;
+        layer.xperiod = xperiod;
+        layer.yperiod = yperiod;
+        layer.vx = vx;
+        layer.vy = vy;
+        layer.altitude = altitude;
+        _layers.push_back(layer);
+    }
+
+    void PhaseScreenEngine::addFixedLayer(const double* wf)
+    {
+        Layer layer = Layer();
+        layer.fixed = wf;
+        _layers.push_back(layer);
+    }
+
+    void PhaseScreenEngine::evaluateLayer(const Layer& layer, int i1, int i2, double* wf,
+                                          double t, double tanx, double tany) const
+    {
+        const int n = i2 - i1;
+        if (!layer.table) {
+            std::copy(layer.fixed + i1, layer.fixed + i2, wf);
+            return;
+        }
+        // Same order of operations as AtmosphericScreen._wavefront, so the results match.
+        const double xshift = t * layer.vx;
+        const double yshift = t * layer.vy;
+        ScratchBuffer<double> x(n);
+        ScratchBuffer<double> y(n);
+        for (int i=0; i<n; ++i) {
+            x[i] = _u[i1+i] - xshift;
+            y[i] = _v[i1+i] - yshift;
+        }
+        if (tanx != 0.) {
+            const double dx = layer.altitude * tanx;
+            for (int i=0; i<n; ++i) x[i] += dx;
+        }
+        if (tany != 0.) {
+            const double dy = layer.altitude * tany;
+            for (int i=0; i<n; ++i) y[i] += dy;
+        }
+        WrapArrayToPeriod(x.begin(), n, layer.x0, layer.xperiod);
+        WrapArrayToPeriod(y.begin(), n, layer.y0, layer.yperiod);
+        layer.table->interpMany(x.begin(), y.begin(), wf, n);
+    }
+
+    void PhaseScreenEngine::wavefront(double* wf, double t, double tanx, double tany) const
+    {
+        const int nlayers = int(_layers.size());
+        if (nlayers == 0) {
+            std::fill(wf, wf + _npoints, 0.);
+            return;
+        }
+        const int nblock = (_npoints + block_size - 1) / block_size;
+
+        // The first layer goes directly into wf.  The rest get their own buffers, which are
+        // added to wf in order afterwards, so the sum doesn't depend on the number of threads.
+        std::vector<double> buffer(size_t(nlayers-1) * _npoints);
+
+        std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (size_t(nlayers)*_npoints > 10000)
+#endif
+        for (int k=0; k<nlayers*nblock; ++k) {
+            try {
+                const int l = k / nblock;
+                const int i1 = (k % nblock) * block_size;
+                const int i2 = std::min(i1 + block_size, _npoints);
+                double* out = (l == 0) ? wf : &buffer[size_t(l-1) * _npoints];
+                evaluateLayer(_layers[l], i1, i2, out + i1, t, tanx, tany);
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                { if (!error) error = std::current_exception(); }
+            }
+        }
+        if (error) std::rethrow_exception(error);
+
+        for (int l=1; l<nlayers; ++l) {
+            const double* layer_wf = &buffer[size_t(l-1) * _npoints];
+            for (int i=0; i<_npoints; ++i) wf[i] += layer_wf[i];
+        }
+    }
+
+    void PhaseScreenEngine::integrate(ImageView<double> image, const double* times, int ntimes,
+                                      double lam, double tanx, double tany) const
+    {
+        dbg<<"Start PhaseScreenEngine::integrate: ntimes = "<<ntimes<<std::endl;
+        if (image.getNCol() != _nx || image.getNRow() != _ny)
+            FormatAndThrow<ImageError>() <<
+                "Image must be "<<_nx<<" x "<<_ny<<" to match the pupil grid";
+        // With no pupil points, the PSF is zero, so there is nothing to add.
+        if (ntimes <= 0 || _npoints == 0) return;
+
+        const double k = 2.*M_PI / lam;
+        const Bounds<int> b(-_nx/2, _nx/2-1, -_ny/2, _ny/2-1);
+
+        // The time steps are added up in chunks of time_chunk_size steps, and then the chunks
+        // are added to the image in order.  The chunks don't depend on the number of threads,
+        // so neither does the result.  When there is only one chunk, the single thread uses
+        // the parallelism in wavefront() instead.
+        const int nchunk = (ntimes + time_chunk_size - 1) / time_chunk_size;
+        int nthreads = 1;
+#ifdef _OPENMP
+        nthreads = std::min(omp_get_max_threads(), nchunk);
+#endif
+        // Only a few chunks per thread are kept at a time, to limit the memory used.
+        const int nsums = std::min(nchunk, 4*nthreads);
+        std::vector<shared_ptr<ImageAlloc<double> > > sums(nsums);
+
+        for (int c1=0; c1<nchunk; c1+=nsums) {
+            const int c2 = std::min(c1 + nsums, nchunk);
+            std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads)
+#endif
+            {
+                shared_ptr<ImageAlloc<std::complex<double> > > pupil, psf;
+                std::vector<double> wf;
+                try {
+                    pupil.reset(new ImageAlloc<std::complex<double> >(b, 0.));
+                    psf.reset(new ImageAlloc<std::complex<double> >(b));
+                    wf.resize(_npoints);
+                } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    { if (!error) error = std::current_exception(); }
+                }
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+                for (int c=c1; c<c2; ++c) {
+                    if (!psf) continue;
+                    try {
+                        shared_ptr<ImageAlloc<double> >& sum = sums[c-c1];
+                        if (sum) sum->setZero();
+                        else sum.reset(new ImageAlloc<double>(b, 0.));
+                        const int it2 = std::min((c+1) * time_chunk_size, ntimes);
+                        for (int it=c*time_chunk_size; it<it2; ++it) {
+                            wavefront(&wf[0], times[it], tanx, tany);
+                            std::complex<double>* pupildata = pupil->getData();
+                            for (int i=0; i<_npoints; ++i)
+                                pupildata[_index[i]] = std::polar(1., k * wf[i]);
+                            cfft(*pupil, psf->view(), false, true, true);
+
+                            const std::complex<double>* psfptr = psf->getData();
+                            double* sumptr = sum->getData();
+                            for (int i=_nx*_ny; i; --i) *sumptr++ += std::norm(*psfptr++);
+                        }
+                    } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                        { if (!error) error = std::current_exception(); }
+                    }
+                }
+            }
+            if (error) std::rethrow_exception(error);
+
+            for (int c=c1; c<c2; ++c) image += *sums[c-c1];
+        }
+    }
+
+}
@@ -23,7 +23,16 @@
 #include <vector>
 #include <sstream>
 #include <unistd.h>
+#include <stdint.h>
+#include <algorithm>
+#include <exception>
+#include <type_traits>
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "Random.h"
+#include "ScratchArena.h"
 
 #include "galsim/IgnoreWarnings.h"
 
@@ -42,6 +51,7 @@
 #include "galsim/boost1_48_0/random/weibull_distribution.hpp"
 #include "galsim/boost1_48_0/random/gamma_distribution.hpp"
 #include "galsim/boost1_48_0/random/chi_squared_distribution.hpp"
+#include "galsim/boost1_48_0/random/uniform_01.hpp"
 #else
 #include "boost/random/mersenne_twister.hpp"
 #include "boost/random/normal_distribution.hpp"
@@ -51,16 +61,280 @@
 #include "boost/random/weibull_distribution.hpp"
 #include "boost/random/gamma_distribution.hpp"
 #include "boost/random/chi_squared_distribution.hpp"
+#include "boost/random/uniform_01.hpp"
 #endif
 
 namespace galsim {
 
+    // The Philox4x32-10 counter-based generator of Salmon, Moraes, Dror & Shaw (2011),
+    // "Parallel random numbers: as easy as 1, 2, 3".  Each 128 bit counter value is put through
+    // 10 rounds of a simple bijection keyed by the 64 bit key, giving 4 32-bit values.
+    class Philox4x32
+    {
+    public:
+        typedef uint32_t result_type;
+
+        Philox4x32() { seed(0); }
+
+        // Start at counter = 0 with the given key.
+        void seed(uint32_t k0, uint32_t k1=0)
+        {
+            _key[0] = k0;
+            _key[1] = k1;
+            _ctr[0] = _ctr[1] = _ctr[2] = _ctr[3] = 0;
+            Block(_ctr, _key, _buf);
+            _index = 0;
+        }
+
+        // Start at counter = hi * 2^64 with key (k0, k1).
+        void seedStream(uint32_t k0, uint32_t k1, uint64_t hi)
+        {
+            seed(k0, k1);
+            _ctr[2] = uint32_t(hi);
+            _ctr[3] = uint32_t(hi >> 32);
+            Block(_ctr, _key, _buf);
+        }
+
+        result_type operator()()
+        {
+            if (_index == 4) {
+                increment(1);
+                Block(_ctr, _key, _buf);
+                _index = 0;
+            }
+            return _buf[_index++];
+        }
+
+        void discard(unsigned long long n)
+        {
+            if (n == 0) return;
+            unsigned long long p = _index + n;
+            if (p >= 4) {
+                increment(p / 4);
+                Block(_ctr, _key, _buf);
+            }
+            _index = p % 4;
+        }
+
+        // Fill out with n values in [0,1), each made from one 32 bit value the same way
+        // as boost::uniform_01 does it.  So these are the same values as n separate draws.
+        void fillUniform(double* out, int n)
+        {
+            const double factor = 1. / 4294967296.;
+            int i=0;
+            for (; i<n && _index<4; ++i) out[i] = _buf[_index++] * factor;
+            const int nblock = (n-i) / 4;
+            if (nblock > 0) {
+                BlockMany(_ctr, _key, nblock, out + i);
+                // Leave the state at the end of the last block.
+                increment(nblock);
+                Block(_ctr, _key, _buf);
+                _index = 4;
+                i += 4*nblock;
+            }
+            for (; i<n; ++i) out[i] = (*this)() * factor;
+        }
+
+        void write(std::ostream& os) const
+        {
+            os << "philox4x32 " << _key[0] << ' ' << _key[1];
+            for (int k=0; k<4; ++k) os << ' ' << _ctr[k];
+            os << ' ' << _index;
+        }
+
+        void read(std::istream& is)
+        {
+            std::string name;
+            is >> name >> _key[0] >> _key[1] >> _ctr[0] >> _ctr[1] >> _ctr[2] >> _ctr[3]
+                >> _index;
+            if (!is || name != "philox4x32" || _index > 4)
+                throw std::runtime_error("Invalid serialization string for philox4x32");
+            Block(_ctr, _key, _buf);
+        }
+
+        static void Block(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4])
+        {
+            uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+            uint32_t k0 = key[0], k1 = key[1];
+            for (int r=0; r<10; ++r) {
+                const uint64_t p0 = uint64_t(M0) * c0;
+                const uint64_t p1 = uint64_t(M1) * c2;
+                const uint32_t n0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+                const uint32_t n2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+                c0 = n0;
+                c1 = uint32_t(p1);
+                c2 = n2;
+                c3 = uint32_t(p0);
+                k0 += W0;
+                k1 += W1;
+            }
+            out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+        }
+
+        // Write the values for the nblock counters following ctr into out as uniform
+        // deviates.  The blocks don't depend on each other, so this does several at a time
+        // with the 4 counter words in separate arrays, which lets the compiler vectorize
+        // the rounds.
+        static void BlockMany(const uint32_t ctr[4], const uint32_t key[2], int nblock,
+                              double* out)
+        {
+            const int G = 8;
+            const double factor = 1. / 4294967296.;
+            const uint64_t lo = (uint64_t(ctr[1]) << 32) | ctr[0];
+            const uint64_t hi = (uint64_t(ctr[3]) << 32) | ctr[2];
+            for (int b0=0; b0<nblock; b0+=G) {
+                uint32_t c0[G], c1[G], c2[G], c3[G];
+                for (int j=0; j<G; ++j) {
+                    const uint64_t lo_b = lo + uint64_t(b0 + j) + 1;
+                    const uint64_t hi_b = hi + (lo_b <= lo ? 1 : 0);
+                    c0[j] = uint32_t(lo_b);
+                    c1[j] = uint32_t(lo_b >> 32);
+                    c2[j] = uint32_t(hi_b);
+                    c3[j] = uint32_t(hi_b >> 32);
+                }
+                uint32_t k0 = key[0], k1 = key[1];
+                for (int r=0; r<10; ++r) {
+                    for (int j=0; j<G; ++j) {
+                        const uint64_t p0 = uint64_t(M0) * c0[j];
+                        const uint64_t p1 = uint64_t(M1) * c2[j];
+                        c0[j] = uint32_t(p1 >> 32) ^ c1[j] ^ k0;
+                        c1[j] = uint32_t(p1);
+                        c2[j] = uint32_t(p0 >> 32) ^ c3[j] ^ k1;
+                        c3[j] = uint32_t(p0);
+                    }
+                    k0 += W0;
+                    k1 += W1;
+                }
+                const int g = std::min(G, nblock-b0);
+                double* o = out + 4*b0;
+                for (int j=0; j<g; ++j) {
+                    o[4*j] = c0[j] * factor;
+                    o[4*j+1] = c1[j] * factor;
+                    o[4*j+2] = c2[j] * factor;
+                    o[4*j+3] = c3[j] * factor;
+                }
+            }
+        }
+
+    private:
+        static const uint32_t M0 = 0xD2511F53;
+        static const uint32_t M1 = 0xCD9E8D57;
+        static const uint32_t W0 = 0x9E3779B9;
+        static const uint32_t W1 = 0xBB67AE85;
+
+        void increment(unsigned long long n)
+        {
+            uint64_t lo = (uint64_t(_ctr[1]) << 32) | _ctr[0];
+            uint64_t hi = (uint64_t(_ctr[3]) << 32) | _ctr[2];
+            const uint64_t new_lo = lo + n;
+            if (new_lo < lo) ++hi;
+            _ctr[0] = uint32_t(new_lo);
+            _ctr[1] = uint32_t(new_lo >> 32);
+            _ctr[2] = uint32_t(hi);
+            _ctr[3] = uint32_t(hi >> 32);
+        }
+
+        uint32_t _key[2];
+        uint32_t _ctr[4];    // The counter for the values in _buf
+        uint32_t _buf[4];
+        unsigned int _index; // The next value in _buf to use.  4 means _buf is used up.
+    };
+
+    // The engine used by all the deviates.  This is either an mt19937 or a Philox4x32, and it
+    // meets the requirements of a Boost.Random engine, so it can be used with any of the
+    // boost distributions.  The mt19937 values are exactly the ones boost::mt19937 produces.
+    class RandomEngine
+    {
+    public:
+        typedef boost::mt19937::result_type result_type;
+
+        RandomEngine(bool philox) : _philox(philox ? new Philox4x32 : 0) {}
+
+        static result_type min() { return 0; }
+        static result_type max() { return 0xffffffff; }
+
+        result_type operator()()
+        { return _philox ? (*_philox)() : _mt(); }
+
+        void seed(result_type s)
+        {
+            if (_philox) _philox->seed(s);
+            else _mt.seed(s);
+        }
+
+        void discard(unsigned long long n)
+        {
+            if (_philox) _philox->discard(n);
+            else _mt.discard(n);
+        }
+
+        // Seed for substream index of the set of streams given by key.
+        void seedSubstream(uint64_t key, uint64_t index)
+        {
+            if (_philox) {
+                _philox->seedStream(uint32_t(key), uint32_t(key >> 32), index + 1);
+            } else {
+                // Fill the whole mt19937 state with splitmix64 values starting from a mix of
+                // key and index, so different streams are very unlikely to share any state.
+                uint64_t x = key ^ ((index + 1) * 0xD1B54A32D192ED03ULL);
+                std::ostringstream oss;
+                for (int j=0; j<624; ++j) {
+                    x += 0x9E3779B97F4A7C15ULL;
+                    uint64_t z = x;
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                    z ^= z >> 31;
+                    oss << uint32_t(z >> 32) << ' ';
+                }
+                std::istringstream iss(oss.str());
+                iss >> _mt;
+            }
+        }
+
+        void fillUniform(double* out, int n)
+        {
+            if (_philox) {
+                _philox->fillUniform(out, n);
+            } else {
+                boost::uniform_01<double> u;
+                for (int i=0; i<n; ++i) out[i] = u(_mt);
+            }
+        }
+
+        bool isPhilox() const { return bool(_philox); }
+
+        void write(std::ostream& os) const
+        {
+            if (_philox) _philox->write(os);
+            else os << _mt;
+        }
+
+        void read(std::istream& is)
+        {
+            if (_philox) _philox->read(is);
+            else is >> _mt;
+        }
+
+    private:
+        boost::mt19937 _mt;
+        shared_ptr<Philox4x32> _philox;
+    };
+
+    static bool IsPhilox(const char* engine)
+    {
+        std::string name(engine);
+        if (name == "philox") return true;
+        else if (name == "mt19937") return false;
+        else
+            FormatAndThrow<std::invalid_argument>() <<
+                "Unknown random number engine "<<name<<".  Must be mt19937 or philox.";
+        return false;
+    }
+
     struct BaseDeviate::BaseDeviateImpl
     {
-        // Note that this class could be templated with the type of Boost.Random generator that
-        // you want to use instead of mt19937
-        typedef boost::mt19937 rng_type;
-        BaseDeviateImpl() : _rng(new rng_type) {}
+        typedef RandomEngine rng_type;
+        BaseDeviateImpl(bool philox=false) : _rng(new rng_type(philox)) {}
         shared_ptr<rng_type> _rng;
     };
 
@@ -68,6 +342,10 @@ namespace galsim {
         _impl(new BaseDeviateImpl())
     { seed(lseed); }
 
+    BaseDeviate::BaseDeviate(long lseed, const char* engine) :
+        _impl(new BaseDeviateImpl(IsPhilox(engine)))
+    { seed(lseed); }
+
     BaseDeviate::BaseDeviate(const BaseDeviate& rhs) :
         _impl(rhs._impl)
     {}
@@ -79,18 +357,31 @@ namespace galsim {
             seed(0);
         } else {
             std::string str(str_c);
+            if (str.compare(0, 10, "philox4x32") == 0)
+                _impl.reset(new BaseDeviateImpl(true));
             std::istringstream iss(str);
-            iss >> *_impl->_rng;
+            _impl->_rng->read(iss);
         }
     }
 
+    std::string BaseDeviate::getEngine() const
+    { return _impl->_rng->isPhilox() ? "philox" : "mt19937"; }
+
+    BaseDeviate BaseDeviate::substream(uint64_t key, long index) const
+    {
+        BaseDeviate dev(*this);
+        dev._impl.reset(new BaseDeviateImpl(_impl->_rng->isPhilox()));
+        dev._impl->_rng->seedSubstream(key, uint64_t(index));
+        return dev;
+    }
+
     std::string BaseDeviate::serialize()
     {
         // When serializing, we need to make sure there is no cache being stored
         // by the derived class.
         clearCache();
         std::ostringstream oss;
-        oss << *_impl->_rng;
+        _impl->_rng->write(oss);
         return oss.str();
     }
 
@@ -157,7 +448,7 @@ namespace galsim {
     }
 
     void BaseDeviate::reset(long lseed)
-    { _impl.reset(new BaseDeviateImpl()); seed(lseed); }
+    { _impl.reset(new BaseDeviateImpl(_impl->_rng->isPhilox())); seed(lseed); }
 
     void BaseDeviate::reset(const BaseDeviate& dev)
     { _impl = dev._impl; clearCache(); }
@@ -175,7 +466,16 @@ namespace galsim {
 
     void BaseDeviate::addGenerate(int N, double* data)
     {
-        for (int i=0; i<N; ++i) data[i] += (*this)();
+        if (N <= 0) return;
+        // Draw the values in chunks with generate, so derived classes that draw in blocks
+        // are fast here too.
+        const int chunk = std::min(N, 4096);
+        ScratchBuffer<double> buf(chunk);
+        for (int i=0; i<N; i+=chunk) {
+            const int n = std::min(chunk, N-i);
+            generate(n, buf.begin());
+            for (int k=0; k<n; ++k) data[i+k] += buf[k];
+        }
     }
 
     // Next two functions shamelessly stolen from
@@ -244,6 +544,9 @@ namespace galsim {
     double UniformDeviate::generate1()
     { return _devimpl->_urd(*this->_impl->_rng); }
 
+    void UniformDeviate::generate(int N, double* data)
+    { _impl->_rng->fillUniform(data, N); }
+
     std::string UniformDeviate::make_repr(bool incl_seed)
     {
         std::ostringstream oss(" ");
@@ -292,6 +595,45 @@ namespace galsim {
     double GaussianDeviate::generate1()
     { return _devimpl->_normal(*this->_impl->_rng); }
 
+    // Fill data with N normal deviates using Box-Muller on blocks of uniform deviates.
+    // This uses the same formulae as boost::normal_distribution, so the pairs of values
+    // are the same as it would produce.
+    static void BoxMuller(RandomEngine& rng, int N, double* data, double mean, double sigma)
+    {
+        const int npair = (N+1)/2;
+        const int chunk = std::min(npair, 2048);
+        const double pi = 3.14159265358979323846;
+        ScratchBuffer<double> u(2*chunk);
+        for (int i=0; i<npair; i+=chunk) {
+            const int n = std::min(chunk, npair-i);
+            rng.fillUniform(u.begin(), 2*n);
+            double* out = data + 2*i;
+            const int nfull = (2*(i+n) <= N) ? n : n-1;
+            for (int k=0; k<nfull; ++k) {
+                const double rho = std::sqrt(-2. * std::log(1.-u[2*k+1]));
+                const double theta = 2.*pi*u[2*k];
+                out[2*k] = rho * std::cos(theta) * sigma + mean;
+                out[2*k+1] = rho * std::sin(theta) * sigma + mean;
+            }
+            if (nfull < n) {
+                // The last pair when N is odd.
+                const double rho = std::sqrt(-2. * std::log(1.-u[2*nfull+1]));
+                out[2*nfull] = rho * std::cos(2.*pi*u[2*nfull]) * sigma + mean;
+            }
+        }
+    }
+
+    void GaussianDeviate::generate(int N, double* data)
+    {
+        RandomEngine& rng = *_impl->_rng;
+        if (rng.isPhilox()) {
+            clearCache();
+            BoxMuller(rng, N, data, getMean(), getSigma());
+        } else {
+            for (int i=0; i<N; ++i) data[i] = _devimpl->_normal(rng);
+        }
+    }
+
     std::string GaussianDeviate::make_repr(bool incl_seed)
     {
         std::ostringstream oss(" ");
@@ -306,9 +648,20 @@ namespace galsim {
     {
         setMean(0.);
         setSigma(1.);
-        for (int i=0; i<N; ++i) {
-            double sigma = std::sqrt(data[i]);
-            data[i] = (*this)() * sigma;
+        RandomEngine& rng = *_impl->_rng;
+        if (rng.isPhilox()) {
+            const int chunk = std::min(N, 4096);
+            ScratchBuffer<double> buf(chunk);
+            for (int i=0; i<N; i+=chunk) {
+                const int n = std::min(chunk, N-i);
+                BoxMuller(rng, n, buf.begin(), 0., 1.);
+                for (int k=0; k<n; ++k) data[i+k] = buf[k] * std::sqrt(data[i+k]);
+            }
+        } else {
+            for (int i=0; i<N; ++i) {
+                double sigma = std::sqrt(data[i]);
+                data[i] = _devimpl->_normal(rng) * sigma;
+            }
         }
     }
 
@@ -454,13 +807,191 @@ namespace galsim {
         return oss.str();
     }
 
+    // Below this mean, the batch sampler uses inversion.  (This is also where boost switches
+    // from inversion to PTRS.)
+    static const double poisson_inversion_max = 10.;
+
+    // The mean above which generateFromExpectation switches to the normal distribution.
+    // cf. PoissonDeviateImpl::setMean
+    static const double poisson_normal_threshold = 1<<30;
+
+    // The cumulative Poisson probabilities for the last mean used, extended as needed.
+    class PoissonInversionTable
+    {
+    public:
+        PoissonInversionTable() : _mean(-1.) {}
+
+        double draw(double mean, double u)
+        {
+            if (mean != _mean) {
+                _mean = mean;
+                _p = std::exp(-mean);
+                _cdf.clear();
+                _cdf.push_back(_p);
+            }
+            // For mean < 10, P(k > 100) is far below the resolution of u.
+            const int kmax = 100;
+            int k = 0;
+            while (u > _cdf[k] && k < kmax) {
+                ++k;
+                if (k == int(_cdf.size())) {
+                    _p *= _mean / k;
+                    _cdf.push_back(_cdf.back() + _p);
+                }
+            }
+            return k;
+        }
+
+    private:
+        double _mean;
+        double _p;      // The probability for the last value in _cdf
+        std::vector<double> _cdf;
+    };
+
+    // The log of k! for k < 10, as used by boost::poisson_distribution.
+    static double LogFactorial(int k)
+    {
+        static const double table[10] = {
+            0.0, 0.0, 0.69314718055994529, 1.7917594692280550, 3.1780538303479458,
+            4.7874917427820458, 6.5792512120101012, 8.5251613610654147, 10.604602902745251,
+            12.801827480081469
+        };
+        return table[k];
+    }
+
+    // One try of the PTRS method for the given mean with uniform deviates v and w.
+    // This is the same as the loop body in boost::poisson_distribution::generate, except that
+    // the second uniform deviate is always supplied.  Returns whether k was accepted.
+    static bool PTRSTry(double mean, double log_mean, double smu, double a, double b,
+                        double inv_alpha, double v_r, double v, double w, double& k)
+    {
+        double u;
+        if (v <= 0.86 * v_r) {
+            u = v / v_r - 0.43;
+            k = std::floor((2*a/(0.5-std::abs(u)) + b)*u + mean + 0.445);
+            return true;
+        }
+        if (v >= v_r) {
+            u = w - 0.5;
+        } else {
+            u = v/v_r - 0.93;
+            u = ((u < 0)? -0.5 : 0.5) - u;
+            v = w * v_r;
+        }
+        const double us = 0.5 - std::abs(u);
+        if (us < 0.013 && v > us) return false;
+
+        k = std::floor((2*a/us + b)*u + mean + 0.445);
+        v = v*inv_alpha/(a/(us*us) + b);
+
+        const double log_sqrt_2pi = 0.91893853320467267;
+        if (k >= 10) {
+            return (std::log(v*smu) <= (k + 0.5)*std::log(mean/k) - mean - log_sqrt_2pi + k
+                    - (1/12. - (1/360. - 1/(1260.*k*k))/(k*k))/k);
+        } else if (k >= 0) {
+            return (std::log(v) <= k*log_mean - mean - LogFactorial(int(k)));
+        } else {
+            return false;
+        }
+    }
+
+    void PoissonDeviate::generateFromExpectationBatch(int N, double* data,
+                                                      double normal_threshold)
+    {
+        if (N <= 0) return;
+        RandomEngine& rng = *_impl->_rng;
+        PoissonInversionTable table;
+
+        // Work in chunks, so the scratch arrays stay small.
+        const int chunk = std::min(N, 4096);
+        ScratchBuffer<int> small(chunk);
+        ScratchBuffer<int> mid(chunk);
+        ScratchBuffer<int> large(chunk);
+        ScratchBuffer<double> u(2*chunk);
+        // The PTRS constants for the values in mid.
+        ScratchBuffer<double> log_mean(chunk);
+        ScratchBuffer<double> smu(chunk);
+        ScratchBuffer<double> a(chunk);
+        ScratchBuffer<double> b(chunk);
+        ScratchBuffer<double> inv_alpha(chunk);
+        ScratchBuffer<double> v_r(chunk);
+
+        for (int i1=0; i1<N; i1+=chunk) {
+            const int i2 = std::min(N, i1+chunk);
+            int nsmall=0, nmid=0, nlarge=0;
+            for (int i=i1; i<i2; ++i) {
+                const double mean = data[i];
+                if (!(mean > 0.)) continue;
+                if (mean > normal_threshold) large[nlarge++] = i;
+                else if (mean < poisson_inversion_max) small[nsmall++] = i;
+                else mid[nmid++] = i;
+            }
+
+            if (nsmall > 0) {
+                rng.fillUniform(u.begin(), nsmall);
+                for (int j=0; j<nsmall; ++j) {
+                    double& x = data[small[j]];
+                    x = table.draw(x, u[j]);
+                }
+            }
+
+            if (nmid > 0) {
+                for (int j=0; j<nmid; ++j) {
+                    const double mean = data[mid[j]];
+                    log_mean[j] = std::log(mean);
+                    smu[j] = std::sqrt(mean);
+                    b[j] = 0.931 + 2.53 * smu[j];
+                    a[j] = -0.059 + 0.02483 * b[j];
+                    inv_alpha[j] = 1.1239 + 1.1328 / (b[j] - 3.4);
+                    v_r[j] = 0.9277 - 3.6224 / (b[j] - 2);
+                }
+                // Each round tries every value not yet accepted, and moves the rejected ones
+                // to the front of the list for the next round.
+                int n = nmid;
+                while (n > 0) {
+                    rng.fillUniform(u.begin(), 2*n);
+                    int nrej = 0;
+                    for (int j=0; j<n; ++j) {
+                        double k;
+                        if (PTRSTry(data[mid[j]], log_mean[j], smu[j], a[j], b[j],
+                                    inv_alpha[j], v_r[j], u[2*j], u[2*j+1], k)) {
+                            data[mid[j]] = k;
+                        } else {
+                            mid[nrej] = mid[j];
+                            log_mean[nrej] = log_mean[j];
+                            smu[nrej] = smu[j];
+                            a[nrej] = a[j];
+                            b[nrej] = b[j];
+                            inv_alpha[nrej] = inv_alpha[j];
+                            v_r[nrej] = v_r[j];
+                            ++nrej;
+                        }
+                    }
+                    n = nrej;
+                }
+            }
+
+            if (nlarge > 0) {
+                BoxMuller(rng, nlarge, u.begin(), 0., 1.);
+                for (int j=0; j<nlarge; ++j) {
+                    double& x = data[large[j]];
+                    x = std::max(std::floor(x + std::sqrt(x) * u[j] + 0.5), 0.);
+                }
+            }
+        }
+    }
+
     void PoissonDeviate::generateFromExpectation(int N, double* data)
     {
+        if (_impl->_rng->isPhilox()) {
+            generateFromExpectationBatch(N, data, poisson_normal_threshold);
+            return;
+        }
         for (int i=0; i<N; ++i) {
             double mean = data[i];
             if (mean > 0.) {
                 setMean(mean);
-                data[i] = (*this)();
+                data[i] = _devimpl->getValue(*_impl->_rng);
             }
         }
     }
@@ -597,4 +1128,157 @@ namespace galsim {
         oss << "n="<<getN()<<")";
         return oss.str();
     }
+
+    //
+    // Parallel noise
+    //
+
+    // The size of the tiles used for the parallel noise functions.  This sets which pixels
+    // use which substream, so changing it changes the noise values.
+    static const int noise_tile_size = 256;
+
+    // Call op(tile_rng, ptr, ncol, nrow, step, stride) for each tile of image, where ptr points
+    // to the first pixel of the tile and tile_rng is the tile's own substream of rng.
+    // The tiles are done in parallel.
+    template <typename T, typename Op>
+    static void ApplyInTiles(ImageView<T> image, BaseDeviate& rng, const Op& op)
+    {
+        const int ncol = image.getNCol();
+        const int nrow = image.getNRow();
+        if (ncol <= 0 || nrow <= 0 || !image.getData()) return;
+        const int ntx = (ncol + noise_tile_size - 1) / noise_tile_size;
+        const int nty = (nrow + noise_tile_size - 1) / noise_tile_size;
+        const int ntile = ntx * nty;
+        const int step = image.getStep();
+        const int stride = image.getStride();
+        T* data = image.getData();
+
+        // These are the only values drawn from rng itself.  raw() gives 32 bits, so use two of
+        // them for the key.
+        const uint64_t key_hi = uint32_t(rng.raw());
+        const uint64_t key = (key_hi << 32) | uint32_t(rng.raw());
+
+        std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (ntile > 1)
+#endif
+        for (int k=0; k<ntile; ++k) {
+            try {
+                const int tx = k % ntx;
+                const int ty = k / ntx;
+                const int i1 = tx * noise_tile_size;
+                const int j1 = ty * noise_tile_size;
+                const int n = std::min(noise_tile_size, ncol - i1);
+                const int m = std::min(noise_tile_size, nrow - j1);
+                BaseDeviate tile_rng = rng.substream(key, k);
+                op(tile_rng, data + j1*stride + i1*step, n, m, step, stride);
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                { if (!error) error = std::current_exception(); }
+            }
+        }
+        if (error) std::rethrow_exception(error);
+    }
+
+    // Convert a noise value to the pixel type.  Integer types go through int64_t, since
+    // converting a negative double directly to an unsigned type is undefined.
+    template <typename T>
+    static inline T NoiseToPixel(double x)
+    { return std::is_integral<T>::value ? T(int64_t(x)) : T(x); }
+
+    template <typename T>
+    struct GaussianNoiseOp
+    {
+        GaussianNoiseOp(double sigma) : _sigma(sigma) {}
+
+        void operator()(BaseDeviate& rng, T* ptr, int ncol, int nrow, int step, int stride) const
+        {
+            GaussianDeviate gd(rng, 0., _sigma);
+            ScratchBuffer<double> buf(ncol);
+            for (int j=0; j<nrow; ++j, ptr+=stride) {
+                gd.generate(ncol, buf.begin());
+                T* p = ptr;
+                for (int i=0; i<ncol; ++i, p+=step) *p += NoiseToPixel<T>(buf[i]);
+            }
+        }
+
+        double _sigma;
+    };
+
+    template <typename T>
+    void AddGaussianNoise(ImageView<T> image, BaseDeviate rng, double sigma)
+    { ApplyInTiles(image, rng, GaussianNoiseOp<T>(sigma)); }
+
+    template <typename T>
+    struct CCDNoiseOp
+    {
+        CCDNoiseOp(double sky_level, double gain, double read_noise) :
+            _sky_level(sky_level), _gain(gain), _read_noise(read_noise)
+        {
+            // cf. CCDNoise._applyTo in Python.  For integer images, convert to an integer with
+            // the sky still added, then subtract the integer part of the sky.
+            _frac_sky = sky_level - double(NoiseToPixel<T>(sky_level));
+            _int_sky = sky_level - _frac_sky;
+            _read_sigma = gain > 0. ? read_noise / gain : read_noise;
+        }
+
+        void operator()(BaseDeviate& rng, T* ptr, int ncol, int nrow, int step, int stride) const
+        {
+            PoissonDeviate pd(rng, 1.);
+            GaussianDeviate gd(rng, 0., _read_sigma);
+            ScratchBuffer<double> buf(ncol);
+            for (int j=0; j<nrow; ++j, ptr+=stride) {
+                T* p = ptr;
+                for (int i=0; i<ncol; ++i, p+=step) buf[i] = double(*p) + _sky_level;
+                if (_gain > 0.) {
+                    for (int i=0; i<ncol; ++i) buf[i] = std::max(buf[i] * _gain, 0.);
+                    pd.generateFromExpectation(ncol, buf.begin());
+                    for (int i=0; i<ncol; ++i) buf[i] /= _gain;
+                }
+                if (_read_noise > 0.) gd.addGenerate(ncol, buf.begin());
+                p = ptr;
+                if (std::is_integral<T>::value) {
+                    // _int_sky is a whole number, so this is exact.
+                    for (int i=0; i<ncol; ++i, p+=step)
+                        *p = NoiseToPixel<T>(std::trunc(buf[i] - _frac_sky) - _int_sky);
+                } else {
+                    for (int i=0; i<ncol; ++i, p+=step) *p = T(T(buf[i] - _frac_sky) - _int_sky);
+                }
+            }
+        }
+
+        double _sky_level;
+        double _gain;
+        double _read_noise;
+        double _frac_sky;
+        double _int_sky;
+        double _read_sigma;
+    };
+
+    template <typename T>
+    void AddCCDNoise(ImageView<T> image, BaseDeviate rng, double sky_level, double gain,
+                     double read_noise)
+    { ApplyInTiles(image, rng, CCDNoiseOp<T>(sky_level, gain, read_noise)); }
+
+    template void AddGaussianNoise(ImageView<double> image, BaseDeviate rng, double sigma);
+    template void AddGaussianNoise(ImageView<float> image, BaseDeviate rng, double sigma);
+    template void AddGaussianNoise(ImageView<int32_t> image, BaseDeviate rng, double sigma);
+    template void AddGaussianNoise(ImageView<int16_t> image, BaseDeviate rng, double sigma);
+    template void AddGaussianNoise(ImageView<uint32_t> image, BaseDeviate rng, double sigma);
+    template void AddGaussianNoise(ImageView<uint16_t> image, BaseDeviate rng, double sigma);
+
+    template void AddCCDNoise(ImageView<double> image, BaseDeviate rng,
+                              double sky_level, double gain, double read_noise);
+    template void AddCCDNoise(ImageView<float> image, BaseDeviate rng,
+                              double sky_level, double gain, double read_noise);
+    template void AddCCDNoise(ImageView<int32_t> image, BaseDeviate rng,
+                              double sky_level, double gain, double read_noise);
+    template void AddCCDNoise(ImageView<int16_t> image, BaseDeviate rng,
+                              double sky_level, double gain, double read_noise);
+    template void AddCCDNoise(ImageView<uint32_t> image, BaseDeviate rng,
+                              double sky_level, double gain, double read_noise);
+    template void AddCCDNoise(ImageView<uint16_t> image, BaseDeviate rng,
+                              double sky_level, double gain, double read_noise);
 }
@@ -21,6 +21,7 @@
 
 #include "SBAdd.h"
 #include "SBAddImpl.h"
+#include "ScratchArena.h"
 
 namespace galsim {
 
@@ -136,10 +137,10 @@ namespace galsim {
         assert(pptr != _plist.end());
         GetImpl(*pptr)->fillXImage(im,x0,dx,izero,y0,dy,jzero);
         if (++pptr != _plist.end()) {
-            ImageAlloc<T> im2(im.getBounds());
+            ScratchImage<T> im2(im.getBounds());
             for (; pptr != _plist.end(); ++pptr) {
                 GetImpl(*pptr)->fillXImage(im2.view(),x0,dx,izero,y0,dy,jzero);
-                im += im2;
+                im += im2.view();
             }
         }
     }
@@ -156,10 +157,10 @@ namespace galsim {
         assert(pptr != _plist.end());
         GetImpl(*pptr)->fillXImage(im,x0,dx,dxy,y0,dy,dyx);
         if (++pptr != _plist.end()) {
-            ImageAlloc<T> im2(im.getBounds());
+            ScratchImage<T> im2(im.getBounds());
             for (; pptr != _plist.end(); ++pptr) {
                 GetImpl(*pptr)->fillXImage(im2.view(),x0,dx,dxy,y0,dy,dyx);
-                im += im2;
+                im += im2.view();
             }
         }
     }
@@ -176,10 +177,10 @@ namespace galsim {
         assert(pptr != _plist.end());
         GetImpl(*pptr)->fillKImage(im,kx0,dkx,izero,ky0,dky,jzero);
         if (++pptr != _plist.end()) {
-            ImageAlloc<std::complex<T> > im2(im.getBounds());
+            ScratchImage<std::complex<T> > im2(im.getBounds());
             for (; pptr != _plist.end(); ++pptr) {
                 GetImpl(*pptr)->fillKImage(im2.view(),kx0,dkx,izero,ky0,dky,jzero);
-                im += im2;
+                im += im2.view();
             }
         }
     }
@@ -196,10 +197,10 @@ namespace galsim {
         assert(pptr != _plist.end());
         GetImpl(*pptr)->fillKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx);
         if (++pptr != _plist.end()) {
-            ImageAlloc<std::complex<T> > im2(im.getBounds());
+            ScratchImage<std::complex<T> > im2(im.getBounds());
             for (; pptr != _plist.end(); ++pptr) {
                 GetImpl(*pptr)->fillKImage(im2.view(),kx0,dkx,dkxy,ky0,dky,dkyx);
-                im += im2;
+                im += im2.view();
             }
         }
     }
@@ -24,7 +24,9 @@
 
 #include "SBAiry.h"
 #include "SBAiryImpl.h"
+#include "InfoCache.h"
 #include "math/Bessel.h"
+#include "ScratchArena.h"
 
 namespace galsim {
 
@@ -89,7 +91,8 @@ namespace galsim {
         xdbg<<"SBAiryImpl constructor: gsparams = "<<gsparams<<std::endl;
     }
 
-    LRUCache<Tuple<double, GSParamsPtr>, AiryInfo> SBAiry::SBAiryImpl::cache(sbp::max_airy_cache);
+    LRUCache<Tuple<double, GSParamsPtr>, AiryInfo> SBAiry::SBAiryImpl::cache(
+        sbp::max_airy_cache, "Airy");
 
     // This is a scale-free version of the Airy radial function.
     // Input radius is in units of lambda/D.  Output normalized
@@ -116,6 +119,25 @@ namespace galsim {
         return xval;
     }
 
+    void AiryInfoObs::RadialFunction::evalMany(const double* radius, double* f, int n) const
+    {
+        // The same calculation as operator(), but with the array version of j1.
+        const double thresh = sqrt(8.*_gsparams->xvalue_accuracy);
+        ScratchBuffer<double> nu(n);
+        ScratchBuffer<double> j1obs(n);
+        for (int i=0; i<n; ++i) {
+            nu[i] = radius[i]*M_PI;
+            j1obs[i] = _obscuration*nu[i];
+        }
+        math::j1Many(nu.begin(), f, n);
+        math::j1Many(j1obs.begin(), j1obs.begin(), n);
+        for (int i=0; i<n; ++i) {
+            double xval = (nu[i] < thresh) ? 0.5 * (1.-_obssq) :
+                (f[i] - _obscuration * j1obs[i]) / nu[i];
+            f[i] = xval * xval * _norm;
+        }
+    }
+
     double SBAiry::SBAiryImpl::xValue(const Position<double>& p) const
     {
         double r = sqrt(p.x*p.x+p.y*p.y) * _D;
@@ -125,6 +147,9 @@ namespace galsim {
     double AiryInfoObs::xValue(double r) const
     { return _radial(r); }
 
+    void AiryInfoObs::xValueMany(const double* r, double* f, int n) const
+    { _radial.evalMany(r, f, n); }
+
     std::complex<double> SBAiry::SBAiryImpl::kValue(const Position<double>& k) const
     {
         double ksq_over_pisq = (k.x*k.x+k.y*k.y) * _inv_Dsq_pisq;
@@ -156,11 +181,13 @@ namespace galsim {
             y0 *= _D;
             dy *= _D;
 
+            ScratchBuffer<double> val(m);
             for (int j=0; j<n; ++j,y0+=dy,ptr+=skip) {
                 double x = x0;
                 double ysq = y0*y0;
-                for (int i=0;i<m;++i,x+=dx)
-                    *ptr++ = _xnorm * _info->xValue(sqrt(x*x + ysq));
+                for (int i=0;i<m;++i,x+=dx) val[i] = sqrt(x*x + ysq);
+                _info->xValueMany(val.begin(), val.begin(), m);
+                for (int i=0;i<m;++i) *ptr++ = _xnorm * val[i];
             }
         }
     }
@@ -186,11 +213,13 @@ namespace galsim {
         dy *= _D;
         dyx *= _D;
 
+        ScratchBuffer<double> val(m);
         for (int j=0; j<n; ++j,x0+=dxy,y0+=dy,ptr+=skip) {
             double x = x0;
             double y = y0;
-            for (int i=0; i<m; ++i,x+=dx,y+=dyx)
-                *ptr++ = _xnorm * _info->xValue(sqrt(x*x + y*y));
+            for (int i=0; i<m; ++i,x+=dx,y+=dyx) val[i] = sqrt(x*x + y*y);
+            _info->xValueMany(val.begin(), val.begin(), m);
+            for (int i=0; i<m; ++i) *ptr++ = _xnorm * val[i];
         }
     }
 
@@ -378,8 +407,17 @@ namespace galsim {
         _sampler->shoot(photons, ud);
     }
 
+    size_t AiryInfo::getMemorySize() const
+    {
+        size_t nbytes = sizeof(*this);
+        std::lock_guard<std::mutex> lock(_sampler_mutex);
+        if (_sampler) nbytes += _sampler->getMemorySize();
+        return nbytes;
+    }
+
     void AiryInfoObs::checkSampler() const
     {
+        std::lock_guard<std::mutex> lock(this->_sampler_mutex);
         if (this->_sampler.get()) return;
         dbg<<"Airy sampler\n";
         dbg<<"obsc = "<<_obscuration<<std::endl;
@@ -394,13 +432,18 @@ namespace galsim {
         // NB: don't need floor, since rhs is positive, so floor is superfluous.
         ranges.reserve(int((rmax-rmin+2)/0.5+0.5));
         for(double r=rmin; r<=rmax; r+=0.5) ranges.push_back(r);
-        this->_sampler.reset(new OneDimensionalDeviate(_radial, ranges, true, 1.0, *_gsparams));
+        this->_sampler = MakeCachedDeviate(
+            InfoCacheKey("AirySampler", _obscuration, *_gsparams),
+            _radial, ranges, true, 1.0, *_gsparams);
     }
 
     // Now the specializations for when obs = 0
     double AiryInfoNoObs::xValue(double r) const
     { return _radial(r); }
 
+    void AiryInfoNoObs::xValueMany(const double* r, double* f, int n) const
+    { _radial.evalMany(r, f, n); }
+
     double AiryInfoNoObs::kValue(double ksq_over_pisq) const
     {
         if (ksq_over_pisq >= 4.) return 0.;
@@ -437,6 +480,19 @@ namespace galsim {
         return xval;
     }
 
+    void AiryInfoNoObs::RadialFunction::evalMany(const double* radius, double* f, int n) const
+    {
+        // The same calculation as operator(), but with the array version of j1.
+        const double thresh = sqrt(8.*_gsparams->xvalue_accuracy);
+        ScratchBuffer<double> nu(n);
+        for (int i=0; i<n; ++i) nu[i] = radius[i]*M_PI;
+        math::j1Many(nu.begin(), f, n);
+        for (int i=0; i<n; ++i) {
+            double xval = (nu[i] < thresh) ? 0.5 : f[i] / nu[i];
+            f[i] = xval * xval * M_PI;
+        }
+    }
+
     // Constructor to initialize Airy constants and k lookup table
     AiryInfoNoObs::AiryInfoNoObs(const GSParamsPtr& gsparams) :
         _radial(gsparams), _gsparams(gsparams)
@@ -454,6 +510,7 @@ namespace galsim {
 
     void AiryInfoNoObs::checkSampler() const
     {
+        std::lock_guard<std::mutex> lock(this->_sampler_mutex);
         if (this->_sampler.get()) return;
         dbg<<"AiryNoObs sampler\n";
         std::vector<double> ranges(1,0.);
@@ -464,6 +521,7 @@ namespace galsim {
         // NB: don't need floor, since rhs is positive, so floor is superfluous.
         ranges.reserve(int((rmax-rmin+2)/0.5+0.5));
         for(double r=rmin; r<=rmax; r+=0.5) ranges.push_back(r);
-        this->_sampler.reset(new OneDimensionalDeviate(_radial, ranges, true, 1.0, *_gsparams));
+        this->_sampler = MakeCachedDeviate(InfoCacheKey("AirySampler", 0., *_gsparams),
+                                           _radial, ranges, true, 1.0, *_gsparams);
     }
 }
@@ -21,6 +21,7 @@
 
 #include "SBBox.h"
 #include "SBBoxImpl.h"
+#include "ScratchArena.h"
 #include "math/Sinc.h"
 #include "math/Angle.h"
 #include "math/Bessel.h"
@@ -183,14 +184,14 @@ namespace galsim {
 
             // The Box profile in Fourier space is separable:
             //    val(x,y) = _flux * sinc(x * _width/2pi) * sinc(y * _height/2pi)
-            std::vector<double> sinc_kx(m);
-            std::vector<double> sinc_ky(n);
-            typedef std::vector<double>::iterator It;
+            ScratchBuffer<double> sinc_kx(m);
+            ScratchBuffer<double> sinc_ky(n);
+            typedef double* It;
             It kxit = sinc_kx.begin();
             for (int i=0; i<m; ++i,kx0+=dkx) *kxit++ = math::sinc(kx0);
 
             if ((kx0 == ky0) && (dkx == dky) && (m==n)) {
-                sinc_ky = sinc_kx;
+                std::copy(sinc_kx.begin(), sinc_kx.end(), sinc_ky.begin());
             } else {
                 It kyit = sinc_ky.begin();
                 for (int j=0; j<n; ++j,ky0+=dky) *kyit++ = math::sinc(ky0);
@@ -22,6 +22,7 @@
 #include "SBConvolve.h"
 #include "SBConvolveImpl.h"
 #include "SBTransform.h"
+#include "ScratchArena.h"
 
 namespace galsim {
 
@@ -135,29 +136,33 @@ namespace galsim {
 
     double SBConvolve::SBConvolveImpl::maxK() const
     {
-        if (_maxk == 0.) {
+        double maxk = _maxk.load(std::memory_order_acquire);
+        if (maxk == 0.) {
             for(ConstIter it=_plist.begin(); it!=_plist.end(); ++it) {
                 double it_maxk = it->maxK();
                 dbg<<"SBConvolve component has maxK = "<<it_maxk<<std::endl;
-                if (_maxk <= 0. || it_maxk < _maxk) _maxk = it_maxk;
+                if (maxk <= 0. || it_maxk < maxk) maxk = it_maxk;
             }
-            dbg<<"Net maxK = "<<_maxk<<std::endl;
+            dbg<<"Net maxK = "<<maxk<<std::endl;
+            _maxk.store(maxk, std::memory_order_release);
         }
-        return _maxk;
+        return maxk;
     }
 
     double SBConvolve::SBConvolveImpl::stepK() const
     {
-        if (_stepk == 0.) {
+        double stepk = _stepk.load(std::memory_order_acquire);
+        if (stepk == 0.) {
             for(ConstIter it=_plist.begin(); it!=_plist.end(); ++it) {
                 double it_stepk = it->stepK();
                 dbg<<"SBConvolve component has stepK = "<<it_stepk<<std::endl;
-                _stepk += 1./(it_stepk*it_stepk);  // Accumulate Sum 1/stepk^2
+                stepk += 1./(it_stepk*it_stepk);  // Accumulate Sum 1/stepk^2
             }
-            _stepk = 1./sqrt(_stepk);  // Convert to (Sum 1/stepk^2)^(-1/2)
-            dbg<<"Net stepK = "<<_stepk<<std::endl;
+            stepk = 1./sqrt(stepk);  // Convert to (Sum 1/stepk^2)^(-1/2)
+            dbg<<"Net stepK = "<<stepk<<std::endl;
+            _stepk.store(stepk, std::memory_order_release);
         }
-        return _stepk;
+        return stepk;
     }
 
     double SBConvolve::SBConvolveImpl::xValue(const Position<double>& pos) const
@@ -204,10 +209,10 @@ namespace galsim {
         assert(pptr != _plist.end());
         GetImpl(*pptr)->fillKImage(im,kx0,dkx,izero,ky0,dky,jzero);
         if (++pptr != _plist.end()) {
-            ImageAlloc<std::complex<T> > im2(im.getBounds());
+            ScratchImage<std::complex<T> > im2(im.getBounds());
             for (; pptr != _plist.end(); ++pptr) {
                 GetImpl(*pptr)->fillKImage(im2.view(),kx0,dkx,izero,ky0,dky,jzero);
-                im *= im2;
+                im *= im2.view();
             }
         }
     }
@@ -224,10 +229,10 @@ namespace galsim {
         assert(pptr != _plist.end());
         GetImpl(*pptr)->fillKImage(im,kx0,dkx,dkxy,ky0,dky,dkyx);
         if (++pptr != _plist.end()) {
-            ImageAlloc<std::complex<T> > im2(im.getBounds());
+            ScratchImage<std::complex<T> > im2(im.getBounds());
             for (; pptr != _plist.end(); ++pptr) {
                 GetImpl(*pptr)->fillKImage(im2.view(),kx0,dkx,dkxy,ky0,dky,dkyx);
-                im *= im2;
+                im *= im2.view();
             }
         }
     }
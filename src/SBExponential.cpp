@@ -21,6 +21,7 @@
 
 #include "SBExponential.h"
 #include "SBExponentialImpl.h"
+#include "InfoCache.h"
 #include "math/Angle.h"
 #include "fmath/fmath.hpp"
 
@@ -68,7 +69,7 @@ namespace galsim {
     }
 
     LRUCache<GSParamsPtr, ExponentialInfo> SBExponential::SBExponentialImpl::cache(
-        sbp::max_exponential_cache);
+        sbp::max_exponential_cache, "Exponential");
 
     SBExponential::SBExponentialImpl::SBExponentialImpl(
         double r0, double flux, const GSParams& gsparams) :
@@ -528,7 +529,8 @@ namespace galsim {
         dbg<<"Made radial"<<std::endl;
         std::vector<double> range(2,0.);
         range[1] = -std::log(gsparams->shoot_accuracy);
-        _sampler.reset(new OneDimensionalDeviate(*_radial, range, true, 2.*M_PI, *gsparams));
+        _sampler = MakeCachedDeviate(InfoCacheKey("ExponentialSampler", *gsparams),
+                                     *_radial, range, true, 2.*M_PI, *gsparams);
         dbg<<"Made sampler"<<std::endl;
 #endif
 
@@ -569,6 +571,11 @@ namespace galsim {
         dbg<<"ExponentialInfo Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
+    size_t ExponentialInfo::getMemorySize() const
+    {
+        return sizeof(*this) + (_sampler ? _sampler->getMemorySize() : 0);
+    }
+
     void SBExponential::SBExponentialImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
         const int N = photons.size();
@@ -21,6 +21,7 @@
 
 #include "SBGaussian.h"
 #include "SBGaussianImpl.h"
+#include "ScratchArena.h"
 #include "math/Angle.h"
 #include "fmath/fmath.hpp"
 
@@ -150,14 +151,14 @@ namespace galsim {
             // The Gaussian profile is separable:
             //    im(x,y) = _norm * exp(-0.5 * (x*x + y*y)
             //            = _norm * exp(-0.5 * x*x) * exp(-0.5 * y*y)
-            std::vector<double> gauss_x(m);
-            std::vector<double> gauss_y(n);
-            typedef std::vector<double>::iterator It;
+            ScratchBuffer<double> gauss_x(m);
+            ScratchBuffer<double> gauss_y(n);
+            typedef double* It;
             It xit = gauss_x.begin();
             for (int i=0; i<m; ++i,x0+=dx) *xit++ = fmath::expd(-0.5 * x0*x0);
 
             if ((x0 == y0) && (dx == dy) && (m==n)) {
-                gauss_y = gauss_x;
+                std::copy(gauss_x.begin(), gauss_x.end(), gauss_y.begin());
             } else {
                 It yit = gauss_y.begin();
                 for (int j=0; j<n; ++j,y0+=dy) *yit++ = fmath::expd(-0.5 * y0*y0);
@@ -226,15 +227,15 @@ namespace galsim {
             // The Gaussian profile is separable:
             //    im(kx,ky) = _flux * exp(-0.5 * (kx*kx + ky*ky)
             //              = _flux * exp(-0.5 * kx*kx) * exp(-0.5 * ky*ky)
-            std::vector<double> gauss_kx(m);
-            std::vector<double> gauss_ky(n);
-            typedef std::vector<double>::iterator It;
+            ScratchBuffer<double> gauss_kx(m);
+            ScratchBuffer<double> gauss_ky(n);
+            typedef double* It;
             It kxit = gauss_kx.begin();
 
             for (int i=0; i<m; ++i,kx0+=dkx) *kxit++ = fmath::expd(-0.5 * kx0*kx0);
 
             if ((kx0 == ky0) && (dkx == dky) && (m==n)) {
-                gauss_ky = gauss_kx;
+                std::copy(gauss_kx.begin(), gauss_kx.end(), gauss_ky.begin());
             } else {
                 It kyit = gauss_ky.begin();
                 for (int j=0; j<n; ++j,ky0+=dky) *kyit++ = fmath::expd(-0.5 * ky0*ky0);
@@ -116,8 +116,9 @@ namespace galsim {
         _ksq_max(integ::MOCK_INF), // Start with infinite _ksq_max so we can use kValueHelper to
                                   // get a better value
         // Start with untruncated SersicInfo regardless of value of trunc
-        _info(SBSersic::SBSersicImpl::cache.get(MakeTuple(_n, _trunc/_r0,
-                                                          GSParamsPtr(this->gsparams))))
+        _info(SBSersic::SBSersicImpl::cache.get(
+                MakeTuple(_n, _trunc/_r0, _trunc == 0. && this->gsparams.interpolate_sersic_n,
+                          GSParamsPtr(this->gsparams))))
     {
         dbg<<"Start SBInclinedSersic constructor:\n";
         dbg<<"n = "<<_n<<std::endl;
@@ -20,12 +20,52 @@
 //#define DEBUGLOGGING
 
 #include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdint.h>
 #include "SBInterpolatedImage.h"
 #include "SBInterpolatedImageImpl.h"
+#include "ScratchArena.h"
 
 
 namespace galsim {
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // The cache of InterpolatedImageTables
+
+    // FNV-1a, but taking 8-byte words rather than single bytes at a time.  This is only used
+    // to find candidate matches, which are then compared in full, so it doesn't need to be
+    // a particularly good hash.
+    static uint64_t HashValues(const double* data, size_t n)
+    {
+        const uint64_t* p = reinterpret_cast<const uint64_t*>(data);
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i=0; i<n; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    InterpolatedImageKey::InterpolatedImageKey(shared_ptr<XTable> xtab_) :
+        xtab(xtab_), hash(HashValues(xtab->getArray(), size_t(xtab->getN()) * xtab->getN()))
+    {}
+
+    bool InterpolatedImageKey::operator<(const InterpolatedImageKey& rhs) const
+    {
+        if (xtab->getN() != rhs.xtab->getN()) return xtab->getN() < rhs.xtab->getN();
+        if (xtab->getDx() != rhs.xtab->getDx()) return xtab->getDx() < rhs.xtab->getDx();
+        if (hash != rhs.hash) return hash < rhs.hash;
+        // Only compare the values in full when the hashes match, which means it is almost
+        // certainly the same image.
+        const size_t n = size_t(xtab->getN()) * xtab->getN();
+        return std::memcmp(xtab->getArray(), rhs.xtab->getArray(), n * sizeof(double)) < 0;
+    }
+
+    LRUCache<InterpolatedImageKey, InterpolatedImageTables>
+        SBInterpolatedImage::SBInterpolatedImageImpl::cache(
+            0, "InterpolatedImage", sbp::max_interpolated_image_cache_bytes);
+
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // SBInterpolatedImage methods
 
@@ -87,8 +127,6 @@ namespace galsim {
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // SBInterpolatedImageImpl methods
 
-#define INVALID -1.e300  // dummy value to indicate that flux or centroid not calculated yet.
-
     template <typename T>
     SBInterpolatedImage::SBInterpolatedImageImpl::SBInterpolatedImageImpl(
         const BaseImage<T>& image,
@@ -97,9 +135,9 @@ namespace galsim {
         double stepk, double maxk, const GSParams& gsparams) :
         SBProfileImpl(gsparams), _image_bounds(image.getBounds()),
         _init_bounds(init_bounds), _nonzero_bounds(nonzero_bounds),
-        _xInterp(xInterp), _kInterp(kInterp),
+        _xInterp(xInterp), _kInterp(kInterp), _ktab_set(false),
         _stepk(stepk), _maxk(maxk),
-        _flux(INVALID), _xcentroid(INVALID), _ycentroid(INVALID),
+        _flux(0.), _xcentroid(0.), _ycentroid(0.),
         _readyToShoot(false)
     {
         dbg<<"image bounds = "<<image.getBounds()<<std::endl;
@@ -119,6 +157,10 @@ namespace galsim {
                                     1, _Nk, _image_bounds);
         xtab_view.copyFrom(image);
 
+        // Use the cached tables for these values if we have them.
+        _tables = cache.get(InterpolatedImageKey(_xtab));
+        _xtab = _tables->getXTable();
+
         dbg<<"N = "<<_Nk<<", xrange = "<<_xInterp.xrange()<<std::endl;
         dbg<<"xtab size = "<<_xtab->getN()<<", scale = "<<_xtab->getDx()<<std::endl;
 
@@ -160,6 +202,28 @@ namespace galsim {
             _maxk = _maxk1;
             dbg<<"maxk = "<<_maxk<<std::endl;
         }
+
+        // This profile may be drawn from several threads at once, so calculate the flux and
+        // centroid now rather than when they are first needed.
+        ConstImageView<double> nonzero = getNonZeroImage();
+        int xStart = -((nonzero.getXMax()-nonzero.getXMin()+1)/2);
+        int y = -((nonzero.getYMax()-nonzero.getYMin()+1)/2);
+        double sumx = 0.;
+        double sumy = 0.;
+        for (int iy = nonzero.getYMin(); iy <= nonzero.getYMax(); ++iy, ++y) {
+            int x = xStart;
+            for (int ix = nonzero.getXMin(); ix <= nonzero.getXMax(); ++ix, ++x) {
+                double value = nonzero(ix,iy);
+                _flux += value;
+                sumx += value*x;
+                sumy += value*y;
+            }
+        }
+        if (_flux != 0.) {
+            _xcentroid = sumx/_flux;
+            _ycentroid = sumy/_flux;
+        }
+        dbg<<"flux = "<<_flux<<", centroid = "<<_xcentroid<<','<<_ycentroid<<std::endl;
     }
 
 
@@ -207,9 +271,14 @@ namespace galsim {
 
     void SBInterpolatedImage::SBInterpolatedImageImpl::checkK() const
     {
-        // Conduct FFT
-        if (_ktab.get()) return;
-        _ktab = _xtab->transform();
+        // Conduct FFT, or get the KTable from another profile that shares our tables.
+        // This may be called from several threads at once.  Everything that reads _ktab calls
+        // this first, so the acquire load orders those reads after the store below.
+        if (_ktab_set.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(_ktab_mutex);
+        if (_ktab_set.load(std::memory_order_relaxed)) return;
+        _ktab = _tables->getKTable();
+        _ktab_set.store(true, std::memory_order_release);
         dbg<<"Built ktab\n";
         dbg<<"ktab size = "<<_ktab->getN()<<", scale = "<<_ktab->getDk()<<std::endl;
     }
@@ -223,20 +292,12 @@ namespace galsim {
         dbg<<"SBInterpolatedImage fillXImage\n";
         dbg<<"x = "<<x0<<" + i * "<<dx<<", izero = "<<izero<<std::endl;
         dbg<<"y = "<<y0<<" + j * "<<dy<<", jzero = "<<jzero<<std::endl;
-        const int m = im.getNCol();
-        const int n = im.getNRow();
-        T* ptr = im.getData();
         assert(im.getStep() == 1);
 
-        // The XTable interpolation routine will go faster if we make y iteration the
-        // inner loop.
-        const int stride = im.getStride();
-        const int skip = 1 - n*stride;
-        for (int i=0; i<m; ++i,x0+=dx,ptr+=skip) {
-            double y = y0;
-            for (int j=0; j<n; ++j,y+=dy,ptr+=stride)
-                *ptr = _xtab->interpolate(x0, y, _xInterp);
-        }
+        // On a regular grid, the x weights only depend on the column and the y weights only
+        // on the row, so let the XTable do this as two separable 1-d passes.
+        _xtab->interpolateGrid(im.getData(), im.getNCol(), im.getNRow(), im.getStride(),
+                               x0, dx, y0, dy, _xInterp.get1d());
     }
 
     template <typename T>
@@ -268,20 +329,19 @@ namespace galsim {
         xdbg<<"i1,i2,j1,j2 = "<<i1<<','<<i2<<','<<j1<<','<<j2<<"  kx0,ky0 = "<<kx0<<','<<ky0<<std::endl;
 
         // For the rest of the range, calculate ux, uy values
-        std::vector<double> ux(i2-i1);
-        typedef std::vector<double>::iterator It;
+        ScratchBuffer<double> ux(std::max(i2-i1,0));
+        typedef double* It;
         It uxit = ux.begin();
         double kx = kx0;
         for (int i=i1; i<i2; ++i,kx+=dkx) *uxit++ = kx * _uscale;
 
-        std::vector<double> uy(j2-j1);
+        ScratchBuffer<double> uy(std::max(j2-j1,0));
         It uyit = uy.begin();
         double ky = ky0;
         for (int j=j1; j<j2; ++j,ky+=dky) *uyit++ = ky * _uscale;
 
         im.setZero();
         const int stride = im.getStride();
-        const int skip = 1 - (j2-j1)*stride;
         // Then the uval's are separable.  Go ahead and pre-calculate them.
         // Note: We only have separable interpolant, so this is the only branch ever used.
         uxit = ux.begin();
@@ -289,12 +349,15 @@ namespace galsim {
         uyit = uy.begin();
         for (int j=j1; j<j2; ++j,++uyit) *uyit = _xInterp.get1d().uval(*uyit);
 
-        uxit = ux.begin();
-        for (int i=i1; i<i2; ++i,kx0+=dkx,++uxit,ptr+=skip) {
-            double ky = ky0;
-            uyit = uy.begin();
-            for (int j=j1; j<j2; ++j,ky+=dky,ptr+=stride)
-                *ptr = *uxit * *uyit++ * _ktab->interpolate(kx0, ky, _kInterp);
+        // The KTable interpolation is also separable on a regular grid, so do it all at once
+        // and then apply the uval factors.
+        if (i2 > i1 && j2 > j1)
+            _ktab->interpolateGrid(ptr, i2-i1, j2-j1, stride, kx0, dkx, ky0, dky,
+                                   _kInterp.get1d());
+        uyit = uy.begin();
+        for (int j=j1; j<j2; ++j,++uyit,ptr+=stride) {
+            uxit = ux.begin();
+            for (int i=0; i<i2-i1; ++i) ptr[i] *= *uxit++ * *uyit;
         }
     }
 
@@ -321,18 +384,15 @@ namespace galsim {
         double duxy = dkxy * _uscale;
         double duyx = dkyx * _uscale;
 
-        for (int j=0; j<n; ++j,kx0+=dkxy,ky0+=dky,ux0+=duxy,uy0+=duy,ptr+=skip) {
-            double kx = kx0;
-            double ky = ky0;
+        // Points outside of _maxk1 are set to zero here.
+        _ktab->interpolateGrid(ptr, m, n, im.getStride(), kx0, dkx, dkxy, ky0, dky, dkyx,
+                               _kInterp.get1d(), _maxk1);
+
+        for (int j=0; j<n; ++j,ux0+=duxy,uy0+=duy,ptr+=skip) {
             double ux = ux0;
             double uy = uy0;
-            for (int i=0; i<m; ++i,kx+=dkx,ky+=dkyx,ux+=dux,uy+=duyx) {
-                if (std::abs(kx) > _maxk1 || std::abs(ky) > _maxk1) {
-                    *ptr++ = T(0);
-                } else {
-                    double xKernelTransform = _xInterp.uval(ux, uy);
-                    *ptr++ = xKernelTransform * _ktab->interpolate(kx, ky, _kInterp);
-                }
+            for (int i=0; i<m; ++i,ux+=dux,uy+=duyx,++ptr) {
+                if (*ptr != std::complex<T>(0.)) *ptr *= _xInterp.uval(ux, uy);
             }
         }
     }
@@ -420,44 +480,12 @@ namespace galsim {
 
     Position<double> SBInterpolatedImage::SBInterpolatedImageImpl::centroid() const
     {
-        if (_xcentroid == INVALID) {
-            double flux = getFlux();
-            if (flux == 0.) throw std::runtime_error("Flux == 0.  Centroid is undefined.");
-
-            ConstImageView<double> image = getNonZeroImage();
-            int xStart = -((image.getXMax()-image.getXMin()+1)/2);
-            int y = -((image.getYMax()-image.getYMin()+1)/2);
-            double sumx = 0.;
-            double sumy = 0.;
-            for (int iy = image.getYMin(); iy <= image.getYMax(); ++iy, ++y) {
-                int x = xStart;
-                for (int ix = image.getXMin(); ix <= image.getXMax(); ++ix, ++x) {
-                    double value = image(ix,iy);
-                    sumx += value*x;
-                    sumy += value*y;
-                }
-            }
-            _xcentroid = sumx/flux;
-            _ycentroid = sumy/flux;
-        }
-
+        if (_flux == 0.) throw std::runtime_error("Flux == 0.  Centroid is undefined.");
         return Position<double>(_xcentroid, _ycentroid);
     }
 
     double SBInterpolatedImage::SBInterpolatedImageImpl::getFlux() const
-    {
-        if (_flux == INVALID) {
-            _flux = 0.;
-            ConstImageView<double> image = getNonZeroImage();
-            for (int iy = image.getYMin(); iy <= image.getYMax(); ++iy) {
-                for (int ix = image.getXMin(); ix <= image.getXMax(); ++ix) {
-                    double value = image(ix,iy);
-                    _flux += value;
-                }
-            }
-        }
-        return _flux;
-    }
+    { return _flux; }
 
     template <typename T>
     double CalculateSizeContainingFlux(const BaseImage<T>& im, double target_flux)
@@ -599,7 +627,10 @@ namespace galsim {
 
     void SBInterpolatedImage::SBInterpolatedImageImpl::checkReadyToShoot() const
     {
-        if (_readyToShoot) return;
+        if (_readyToShoot.load(std::memory_order_acquire)) return;
+        // The same profile may be shot from several threads, so only one of them sets up _pt.
+        std::lock_guard<std::mutex> lock(_shoot_mutex);
+        if (_readyToShoot.load(std::memory_order_relaxed)) return;
 
         dbg<<"SBInterpolatedImage not ready to shoot.  Build _pt:\n";
 
@@ -650,7 +681,7 @@ namespace galsim {
         dbg<<"thresh = "<<thresh<<std::endl;
         _pt.buildTree(thresh);
 
-        _readyToShoot = true;
+        _readyToShoot.store(true, std::memory_order_release);
     }
 
     // Photon-shooting
@@ -21,7 +21,9 @@
 
 #include "SBKolmogorov.h"
 #include "SBKolmogorovImpl.h"
+#include "InfoCache.h"
 #include "math/Bessel.h"
+#include "TableBuilder.h"
 #include "fmath/fmath.hpp"
 
 // Uncomment this to do the calculation that solves for the conversion between lam_over_r0
@@ -65,7 +67,7 @@ namespace galsim {
     }
 
     LRUCache<GSParamsPtr, KolmogorovInfo> SBKolmogorov::SBKolmogorovImpl::cache(
-        sbp::max_kolmogorov_cache);
+        sbp::max_kolmogorov_cache, "Kolmogorov");
 
     // The "magic" number 2.992934 below comes from the standard form of the Kolmogorov spectrum
     // from Racine, 1996 PASP, 108, 699 (who in turn is quoting Fried, 1966, JOSA, 56, 1372):
@@ -262,6 +264,13 @@ namespace galsim {
         double operator()(double k) const
         { return k*fmath::expd(-fast_pow(k, 5./3.)) * math::j0(k*_r); }
 
+        void evalMany(const double* k, double* f, int n) const
+        {
+            for (int i=0; i<n; ++i) f[i] = k[i]*_r;
+            math::j0Many(f, f, n);
+            for (int i=0; i<n; ++i) f[i] = k[i]*fmath::expd(-fast_pow(k[i], 5./3.)) * f[i];
+        }
+
     private:
         double _r;
     };
@@ -347,8 +356,55 @@ namespace galsim {
         _maxk = std::pow(-std::log(gsparams->kvalue_accuracy),3./5.);
         dbg<<"maxK = "<<_maxk<<std::endl;
 
-        // Build the table for the radial function.
+        // Build the table for the radial function, or read it from the Info cache.
+        InfoCacheKey key("KolmogorovInfo", *gsparams);
+        if (!ReadCachedInfo(key, *this)) {
+            buildRadialFunc(*gsparams);
+            WriteCachedInfo(key, *this);
+        }
+
+        // Next, set up the sampler for photon shooting
+        std::vector<double> range(2,0.);
+        range[1] = _radial.argMax();
+        _sampler = MakeCachedDeviate(InfoCacheKey("KolmogorovSampler", *gsparams),
+                                     _radial, range, true, 1.0, *gsparams);
+        dbg<<"made sampler\n";
+
+#ifdef SOLVE_FWHM_HLR
+        // Improve upon the conversion between lam_over_r0 and fwhm:
+        KolmTargetValue fwhm_func(0.55090124543985636638457099311149824 / 2., *gsparams);
+        double r1 = 1.4;
+        double r2 = 1.5;
+        Solve<KolmTargetValue> fwhm_solver(fwhm_func,r1,r2);
+        fwhm_solver.setMethod(Brent);
+        double rd = fwhm_solver.root();
+        xdbg<<"Root is "<<rd<<std::endl;
+        // This is in units of 1/k0.  k0 = 2.992934 / lam_over_r0
+        // It's also the half-width hal-max, so * 2 to get fwhm.
+        xdbg<<"fwhm = "<<rd * 2. / 2.992934<<" * lam_over_r0\n";
 
+        // Confirm that flux function gets unit flux when integrated to infinity:
+        KolmEnclosedFlux enc_flux;
+        for(double rmax = 0.; rmax < 20.; rmax += 1.) {
+            dbg<<"Flux enclosed by r="<<rmax<<" = "<<enc_flux(rmax)<<std::endl;
+        }
+
+        // Next find the conversion between lam_over_r0 and hlr:
+        KolmTargetFlux hlr_func(0.5);
+        r1 = 1.6;
+        r2 = 1.7;
+        Solve<KolmTargetFlux> hlr_solver(hlr_func,r1,r2);
+        hlr_solver.setMethod(Brent);
+        rd = hlr_solver.root();
+        xdbg<<"Root is "<<rd<<std::endl;
+        dbg<<"Flux enclosed by r="<<rd<<" = "<<enc_flux(rd)<<std::endl;
+        // This is in units of 1/k0.  k0 = 2.992934 / lam_over_r0
+        xdbg<<"hlr = "<<rd / 2.992934<<" * lam_over_r0\n";
+#endif
+    }
+
+    void KolmogorovInfo::buildRadialFunc(const GSParams& gsparams)
+    {
         // Start with f(0), which is analytic:
         // According to Wolfram Alpha:
         // Integrate[k*exp(-k^5/3),{k,0,infinity}] = 3/5 Gamma(6/5)
@@ -364,20 +420,26 @@ namespace galsim {
         // conservative for Sersic, but I haven't investigated here.)
         // 10 h^4 <= xvalue_accuracy
         // h = (xvalue_accuracy/10)^0.25
-        double dr = gsparams->table_spacing * sqrt(sqrt(gsparams->xvalue_accuracy / 10.));
+        double dr = gsparams.table_spacing * sqrt(sqrt(gsparams.xvalue_accuracy / 10.));
 
         // Along the way accumulate the flux integral to determine the radius
         // that encloses (1-folding_threshold) of the flux.
         double sum = 0.;
         double thresh0 = 0.5 / (2.*M_PI*dr);
-        double thresh1 = (1.-gsparams->folding_threshold) / (2.*M_PI*dr);
-        double thresh2 = (1.-gsparams->shoot_accuracy) / (2.*M_PI*dr);
+        double thresh1 = (1.-gsparams.folding_threshold) / (2.*M_PI*dr);
+        double thresh2 = (1.-gsparams.shoot_accuracy) / (2.*M_PI*dr);
         double R = 0., hlr = 0.;
         // Continue until accumulate 0.999 of the flux
-        KolmXValue xval_func(*gsparams);
+        // The integrals for the next several values of r are done in parallel.
+        // The flux outside r falls off as r^-5/3 (with a coefficient < 1 in these units), so
+        // the loop is done well before r = shoot_accuracy^-3/5.  This only limits how far
+        // ahead the nodes are evaluated, so it doesn't need to be exact.
+        KolmXValue xval_func(gsparams);
+        double rmax = std::pow(gsparams.shoot_accuracy, -0.6);
+        TableNodeEvaluator<KolmXValue> xval_eval(xval_func, dr, rmax);
 
         for (double r = dr; sum < thresh2; r += dr) {
-            val = xval_func(r) / (2.*M_PI);
+            val = xval_eval(r) / (2.*M_PI);
             xdbg<<"f("<<r<<") = "<<val<<std::endl;
             _radial.addEntry(r,val);
 
@@ -393,48 +455,24 @@ namespace galsim {
         dbg<<"R = "<<R<<std::endl;
         dbg<<"hlr = "<<hlr<<std::endl;
         // Make sure it is at least 5 hlr
-        R = std::max(R,gsparams->stepk_minimum_hlr*hlr);
+        R = std::max(R,gsparams.stepk_minimum_hlr*hlr);
         _stepk = M_PI / R;
         dbg<<"stepk = "<<_stepk<<std::endl;
         dbg<<"sum*2*pi*dr = "<<sum*2.*M_PI*dr<<"   (should ~= 0.999)\n";
+    }
 
-        // Next, set up the sampler for photon shooting
-        std::vector<double> range(2,0.);
-        range[1] = _radial.argMax();
-        _sampler.reset(new OneDimensionalDeviate(_radial, range, true, 1.0, *gsparams));
-        dbg<<"made sampler\n";
-
-#ifdef SOLVE_FWHM_HLR
-        // Improve upon the conversion between lam_over_r0 and fwhm:
-        KolmTargetValue fwhm_func(0.55090124543985636638457099311149824 / 2., *gsparams);
-        double r1 = 1.4;
-        double r2 = 1.5;
-        Solve<KolmTargetValue> fwhm_solver(fwhm_func,r1,r2);
-        fwhm_solver.setMethod(Brent);
-        double rd = fwhm_solver.root();
-        xdbg<<"Root is "<<rd<<std::endl;
-        // This is in units of 1/k0.  k0 = 2.992934 / lam_over_r0
-        // It's also the half-width hal-max, so * 2 to get fwhm.
-        xdbg<<"fwhm = "<<rd * 2. / 2.992934<<" * lam_over_r0\n";
-
-        // Confirm that flux function gets unit flux when integrated to infinity:
-        KolmEnclosedFlux enc_flux;
-        for(double rmax = 0.; rmax < 20.; rmax += 1.) {
-            dbg<<"Flux enclosed by r="<<rmax<<" = "<<enc_flux(rmax)<<std::endl;
-        }
+    void KolmogorovInfo::write(std::ostream& os) const
+    {
+        WriteValue(os, _stepk);
+        WriteTable(os, _radial);
+    }
 
-        // Next find the conversion between lam_over_r0 and hlr:
-        KolmTargetFlux hlr_func(0.5);
-        r1 = 1.6;
-        r2 = 1.7;
-        Solve<KolmTargetFlux> hlr_solver(hlr_func,r1,r2);
-        hlr_solver.setMethod(Brent);
-        rd = hlr_solver.root();
-        xdbg<<"Root is "<<rd<<std::endl;
-        dbg<<"Flux enclosed by r="<<rd<<" = "<<enc_flux(rd)<<std::endl;
-        // This is in units of 1/k0.  k0 = 2.992934 / lam_over_r0
-        xdbg<<"hlr = "<<rd / 2.992934<<" * lam_over_r0\n";
-#endif
+    bool KolmogorovInfo::read(std::istream& is)
+    {
+        double stepk;
+        if (!(ReadValue(is, stepk) && ReadTable(is, _radial))) return false;
+        _stepk = stepk;
+        return true;
     }
 
     void KolmogorovInfo::shoot(PhotonArray& photons, UniformDeviate ud) const
@@ -447,6 +485,12 @@ namespace galsim {
         dbg<<"KolmogorovInfo Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
+    size_t KolmogorovInfo::getMemorySize() const
+    {
+        return (sizeof(*this) + _radial.getMemorySize() - sizeof(_radial) +
+                (_sampler ? _sampler->getMemorySize() : 0));
+    }
+
     void SBKolmogorov::SBKolmogorovImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
         const int N = photons.size();
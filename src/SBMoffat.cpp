@@ -30,6 +30,8 @@
 #include "math/Gamma.h"
 #include "math/Angle.h"
 #include "fmath/fmath.hpp"
+#include "InfoCache.h"
+#include "ScratchArena.h"
 
 // Define this variable to find azimuth (and sometimes radius within a unit disc) of 2d photons by
 // drawing a uniform deviate for theta, instead of drawing 2 deviates for a point on the unit
@@ -46,6 +48,31 @@ namespace galsim {
     inline double fast_pow(double x, double y)
     { return fmath::expd(y * std::log(x)); }
 
+    // pow(x,beta) for special (probably not uncommon) cases.
+    static double pow_1(double x, double ) { return x; }
+    static double pow_15(double x, double ) { return x * std::sqrt(x); }
+    static double pow_2(double x, double ) { return x*x; }
+    static double pow_25(double x, double ) { return x*x * std::sqrt(x); }
+    static double pow_3(double x, double ) { return x*x*x; }
+    static double pow_35(double x, double ) { return x*x*x * std::sqrt(x); }
+    static double pow_4(double x, double ) { double xsq=x*x; return xsq*xsq; }
+    static double pow_gen(double x, double beta) { return fast_pow(x,beta); }
+
+    typedef double (*PowFunc)(double x, double beta);
+
+    // Pick the fastest function to use for pow(x,beta).
+    static PowFunc GetPowBeta(double beta, const GSParams& gsparams)
+    {
+        if (std::abs(beta-1) < gsparams.xvalue_accuracy) return &pow_1;
+        else if (std::abs(beta-1.5) < gsparams.xvalue_accuracy) return &pow_15;
+        else if (std::abs(beta-2) < gsparams.xvalue_accuracy) return &pow_2;
+        else if (std::abs(beta-2.5) < gsparams.xvalue_accuracy) return &pow_25;
+        else if (std::abs(beta-3) < gsparams.xvalue_accuracy) return &pow_3;
+        else if (std::abs(beta-3.5) < gsparams.xvalue_accuracy) return &pow_35;
+        else if (std::abs(beta-4) < gsparams.xvalue_accuracy) return &pow_4;
+        else return &pow_gen;
+    }
+
     SBMoffat::SBMoffat(double beta, double scale_radius, double trunc, double flux,
                        const GSParams& gsparams) :
         SBProfile(new SBMoffatImpl(beta, scale_radius, trunc, flux, gsparams)) {}
@@ -95,6 +122,9 @@ namespace galsim {
     }
 
 
+    LRUCache<Tuple<double, double, GSParamsPtr>, MoffatInfo>
+        SBMoffat::SBMoffatImpl::cache(sbp::max_moffat_cache, "Moffat");
+
     class MoffatScaleRadiusFunc
     {
     public:
@@ -178,7 +208,6 @@ namespace galsim {
         _beta(beta), _flux(flux), _rD(scale_radius),
         _rD_sq(_rD * _rD), _inv_rD(1./_rD), _inv_rD_sq(_inv_rD*_inv_rD),
         _trunc(trunc),
-        _ft(Table::spline),
         _stepk(0.), // calculated by stepK() and stored.
         _maxk(0.) // calculated by maxK() and stored.
     {
@@ -217,38 +246,29 @@ namespace galsim {
         dbg << "Moffat rD " << _rD << " fluxFactor " << _fluxFactor
             << " norm " << _norm << " maxR " << _maxR << std::endl;
 
-        if (std::abs(_beta-1) < this->gsparams.xvalue_accuracy)
-            _pow_beta = &SBMoffatImpl::pow_1;
-        else if (std::abs(_beta-1.5) < this->gsparams.xvalue_accuracy)
-            _pow_beta = &SBMoffatImpl::pow_15;
-        else if (std::abs(_beta-2) < this->gsparams.xvalue_accuracy)
-            _pow_beta = &SBMoffatImpl::pow_2;
-        else if (std::abs(_beta-2.5) < this->gsparams.xvalue_accuracy)
-            _pow_beta = &SBMoffatImpl::pow_25;
-        else if (std::abs(_beta-3) < this->gsparams.xvalue_accuracy)
-            _pow_beta = &SBMoffatImpl::pow_3;
-        else if (std::abs(_beta-3.5) < this->gsparams.xvalue_accuracy)
-            _pow_beta = &SBMoffatImpl::pow_35;
-        else if (std::abs(_beta-4) < this->gsparams.xvalue_accuracy)
-            _pow_beta = &SBMoffatImpl::pow_4;
-        else _pow_beta = &SBMoffatImpl::pow_gen;
-
-        if (_trunc > 0.) _kV = &SBMoffatImpl::kV_trunc;
+        _pow_beta = GetPowBeta(_beta, this->gsparams);
+
+        _kv_nu = 0;
+        if (_trunc > 0.) _kV = &SBMoffatImpl::kV_info;
         else if (std::abs(_beta-1.5) < this->gsparams.kvalue_accuracy)
             _kV = &SBMoffatImpl::kV_15;
-        else if (std::abs(_beta-2) < this->gsparams.kvalue_accuracy)
-            _kV = &SBMoffatImpl::kV_2;
-        else if (std::abs(_beta-2.5) < this->gsparams.kvalue_accuracy)
+        else if (std::abs(_beta-2) < this->gsparams.kvalue_accuracy) {
+            _kV = &SBMoffatImpl::kV_2; _kv_nu = 1;
+        } else if (std::abs(_beta-2.5) < this->gsparams.kvalue_accuracy)
             _kV = &SBMoffatImpl::kV_25;
         else if (std::abs(_beta-3) < this->gsparams.kvalue_accuracy) {
-            _kV = &SBMoffatImpl::kV_3; _knorm /= 2.;
+            _kV = &SBMoffatImpl::kV_3; _kv_nu = 2; _knorm /= 2.;
         } else if (std::abs(_beta-3.5) < this->gsparams.kvalue_accuracy) {
             _kV = &SBMoffatImpl::kV_35; _knorm /= 3.;
         } else if (std::abs(_beta-4) < this->gsparams.kvalue_accuracy) {
-            _kV = &SBMoffatImpl::kV_4; _knorm /= 8.;
-        } else {
-            _kV = &SBMoffatImpl::kV_gen;
-            _knorm *= 4. / (math::tgamma(beta-1.) * std::pow(2.,beta));
+            _kV = &SBMoffatImpl::kV_4; _kv_nu = 3; _knorm /= 8.;
+        } else _kV = &SBMoffatImpl::kV_info;
+
+        // The truncated profiles and the ones without a simple analytic transform use a
+        // lookup table, which is shared by all the profiles with the same beta and trunc/rD.
+        if (_kV == &SBMoffatImpl::kV_info) {
+            _info = cache.get(MakeTuple(_beta, _trunc > 0. ? _maxRrD : 0.,
+                                        GSParamsPtr(this->gsparams)));
         }
     }
 
@@ -269,15 +289,6 @@ namespace galsim {
         else return _norm / _pow_beta(1.+rsq, _beta);
     }
 
-    double SBMoffat::SBMoffatImpl::pow_1(double x, double ) { return x; }
-    double SBMoffat::SBMoffatImpl::pow_15(double x, double ) { return x * std::sqrt(x); }
-    double SBMoffat::SBMoffatImpl::pow_2(double x, double ) { return x*x; }
-    double SBMoffat::SBMoffatImpl::pow_25(double x, double ) { return x*x * std::sqrt(x); }
-    double SBMoffat::SBMoffatImpl::pow_3(double x, double ) { return x*x*x; }
-    double SBMoffat::SBMoffatImpl::pow_35(double x, double ) { return x*x*x * std::sqrt(x); }
-    double SBMoffat::SBMoffatImpl::pow_4(double x, double ) { double xsq=x*x; return xsq*xsq; }
-    double SBMoffat::SBMoffatImpl::pow_gen(double x, double beta) { return fast_pow(x,beta); }
-
     std::complex<double> SBMoffat::SBMoffatImpl::kValue(const Position<double>& k) const
     {
         double ksq = (k.x*k.x + k.y*k.y)*_rD_sq;
@@ -329,20 +340,27 @@ namespace galsim {
         }
     }
 
-    double SBMoffat::SBMoffatImpl::kV_gen(double ksq) const
+    double SBMoffat::SBMoffatImpl::kV_info(double ksq) const
     {
-        if (ksq == 0.) return _flux/_knorm;
-        else {
-            double k = sqrt(ksq);
-            return math::cyl_bessel_k(_beta-1,k) * fast_pow(k,_beta-1);
-        }
+        return _info->kValue(ksq);
     }
 
-    double SBMoffat::SBMoffatImpl::kV_trunc(double ksq) const
+    void SBMoffat::SBMoffatImpl::kVMany(const double* ksq, double* f, int n) const
     {
-        setupFT();
-        if (ksq > _ft.argMax()) return 0.;
-        else return _ft(ksq);
+        // kV_2, kV_3 and kV_4 are K_nu(k) k^nu for nu = 1, 2, 3.
+        const int nu = _kv_nu;
+        if (nu == 0) {
+            for (int i=0; i<n; ++i) f[i] = (this->*_kV)(ksq[i]);
+            return;
+        }
+        // kvMany needs k > 0, so use k = 1 for k = 0, and fix those up at the end.
+        ScratchBuffer<double> k(n);
+        for (int i=0; i<n; ++i) k[i] = ksq[i] > 0. ? sqrt(ksq[i]) : 1.;
+        math::kvMany(nu, k.begin(), f, n);
+        for (int i=0; i<n; ++i) {
+            if (ksq[i] > 0.) f[i] *= (nu == 1) ? k[i] : (nu == 2) ? ksq[i] : k[i]*ksq[i];
+            else f[i] = (this->*_kV)(0.);
+        }
     }
 
     template <typename T>
@@ -441,11 +459,14 @@ namespace galsim {
             ky0 *= _rD;
             dky *= _rD;
 
+            ScratchBuffer<double> ksq(m);
+            ScratchBuffer<double> val(m);
             for (int j=0; j<n; ++j,ky0+=dky,ptr+=skip) {
                 double kx = kx0;
                 double kysq = ky0*ky0;
-                for (int i=0;i<m;++i,kx+=dkx)
-                    *ptr++ = _knorm * (this->*_kV)(kx*kx + kysq);
+                for (int i=0;i<m;++i,kx+=dkx) ksq[i] = kx*kx + kysq;
+                kVMany(ksq.begin(), val.begin(), m);
+                for (int i=0;i<m;++i) *ptr++ = _knorm * val[i];
             }
         }
     }
@@ -471,18 +492,22 @@ namespace galsim {
         dky *= _rD;
         dkyx *= _rD;
 
+        ScratchBuffer<double> ksq(m);
+        ScratchBuffer<double> val(m);
         for (int j=0; j<n; ++j,kx0+=dkxy,ky0+=dky,ptr+=skip) {
             double kx = kx0;
             double ky = ky0;
-            for (int i=0; i<m; ++i,kx+=dkx,ky+=dkyx)
-                *ptr++ = _knorm * (this->*_kV)(kx*kx + ky*ky);
+            for (int i=0; i<m; ++i,kx+=dkx,ky+=dkyx) ksq[i] = kx*kx + ky*ky;
+            kVMany(ksq.begin(), val.begin(), m);
+            for (int i=0; i<m; ++i) *ptr++ = _knorm * val[i];
         }
     }
 
     // Set maxK to the value where the FT is down to maxk_threshold
     double SBMoffat::SBMoffatImpl::maxK() const
     {
-        if (_maxk == 0.) {
+        double maxk = _maxk.load(std::memory_order_acquire);
+        if (maxk == 0.) {
             if (_trunc == 0.) {
                 // f(k) = 4 K(beta-1,k) (k/2)^beta / Gamma(beta-1)
                 //
@@ -503,19 +528,20 @@ namespace galsim {
                 // (beta-1/2) log(k) - k = log(temp)
                 // k = (beta-1/2) log(k) - log(temp)
                 temp = std::log(temp);
-                _maxk = -temp;
+                maxk = -temp;
                 dbg<<"temp = "<<temp<<std::endl;
                 for (int i=0;i<5;++i) {
-                    _maxk = (_beta-0.5) * std::log(_maxk) - temp;
-                    dbg<<"_maxk = "<<_maxk<<std::endl;
+                    maxk = (_beta-0.5) * std::log(maxk) - temp;
+                    dbg<<"maxk = "<<maxk<<std::endl;
                 }
             } else {
-                // _maxk is determined during setupFT() as the last k value to have a
-                // kValue > 1.e-3.
-                setupFT();
+                // maxk is determined when the MoffatInfo builds its table as the last k value
+                // to have a kValue > maxk_threshold.
+                maxk = _info->maxK();
             }
+            _maxk.store(maxk, std::memory_order_release);
         }
-        return _maxk*_inv_rD;
+        return maxk*_inv_rD;
     }
 
     // The amount of flux missed in a circle of radius pi/stepk should be at
@@ -525,13 +551,14 @@ namespace galsim {
         dbg<<"Find Moffat stepK\n";
         dbg<<"beta = "<<_beta<<std::endl;
 
-        if (_stepk == 0.) {
+        double stepk = _stepk.load(std::memory_order_acquire);
+        if (stepk == 0.) {
             // The fractional flux out to radius R is (if not truncated)
             // 1 - (1+R^2)^(1-beta)
             // So solve (1+R^2)^(1-beta) = folding_threshold
             if (_beta <= 1.1) {
                 // Then flux never converges (or nearly so), so just use truncation radius
-                _stepk = M_PI / _maxR;
+                stepk = M_PI / _maxR;
             } else {
                 // Ignore the 1 in (1+R^2), so approximately:
                 double R = std::pow(this->gsparams.folding_threshold, 0.5/(1.-_beta)) * _rD;
@@ -543,10 +570,11 @@ namespace galsim {
                 dbg<<"stepk = "<<(M_PI/R)<<std::endl;
                 // Make sure it is at least 5 hlr
                 R = std::max(R,gsparams.stepk_minimum_hlr*getHalfLightRadius());
-                _stepk = M_PI / R;
+                stepk = M_PI / R;
             }
+            _stepk.store(stepk, std::memory_order_release);
         }
-        return _stepk;
+        return stepk;
     }
 
     // Integrand class for the Hankel transform of Moffat
@@ -564,17 +592,112 @@ namespace galsim {
         double (*_pow_beta)(double x, double beta);
     };
 
-    void SBMoffat::SBMoffatImpl::setupFT() const
+    MoffatInfo::MoffatInfo(double beta, double trunc, const GSParamsPtr& gsparams) :
+        _beta(beta), _trunc(trunc), _gsparams(gsparams),
+        _knorm(4. / (math::tgamma(beta-1.) * std::pow(2.,beta))),
+        _ft(Table::spline), _maxk(0.), _ksq_min(0.), _ksq_max(0.), _ft_built(false)
     {
-        assert(_trunc > 0.);
-        if (_ft.finalized()) return;
+        dbg<<"Start MoffatInfo constructor for beta = "<<_beta<<std::endl;
+        dbg<<"trunc = "<<_trunc<<std::endl;
 
-        // Do a Hankel transform and store the results in a lookup table.
+        // Only the truncated table requires any integrals, so that is the only one worth
+        // saving in the on-disk cache.  If it isn't there, checkFT writes it once it is built.
+        if (_trunc > 0.) {
+            ReadCachedInfo(InfoCacheKey("MoffatInfo", _beta, _trunc, *_gsparams), *this);
+        }
+    }
 
-        double prefactor = 2. * (_beta-1.) / (_fluxFactor);
+    double MoffatInfo::kValue(double ksq) const
+    {
+        assert(ksq >= 0.);
+        checkFT();
+
+        if (_trunc > 0.) {
+            if (ksq > _ksq_max) return 0.;
+            else return _ft(ksq);
+        } else {
+            if (ksq < _ksq_min) return analyticKValue(ksq);
+            else if (ksq >= _ksq_max) return 0.;
+            else return _ft(0.5*std::log(ksq)); // Lookup table is logarithmic
+        }
+    }
+
+    double MoffatInfo::maxK() const
+    {
+        checkFT();
+        return _maxk;
+    }
+
+    // f(k) = 4 K(beta-1,k) (k/2)^beta / Gamma(beta-1)
+    double MoffatInfo::analyticKValue(double ksq) const
+    {
+        if (ksq == 0.) return 1.;
+        else {
+            double k = sqrt(ksq);
+            return _knorm * math::cyl_bessel_k(_beta-1,k) * fast_pow(k,_beta-1);
+        }
+    }
+
+    void MoffatInfo::checkFT() const
+    {
+        // This object may be shared between threads through the cache, so make sure only one
+        // of them builds the table, and the others wait until it is finished.
+        if (_ft_built.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(_ft_mutex);
+        if (_ft_built.load(std::memory_order_relaxed)) return;
+        if (_trunc > 0.) {
+            buildTruncatedFT();
+            _ft_built.store(true, std::memory_order_release);
+            WriteCachedInfo(InfoCacheKey("MoffatInfo", _beta, _trunc, *_gsparams), *this);
+        } else {
+            buildFT();
+            _ft_built.store(true, std::memory_order_release);
+        }
+    }
+
+    void MoffatInfo::buildFT() const
+    {
+        // The analytic formula requires a Bessel function, which is slow to calculate for every
+        // pixel, so tabulate it instead.  Near k=0, f(k) has a term proportional to
+        // k^(2beta-2), which is not smooth enough for a spline in k when beta < 2.  As a
+        // function of log(k) it is smooth though, so the table uses that.  Values below kmin,
+        // which only a few pixels near k=0 ever have, are calculated directly.
+        const double kmin = 0.01;
+        _ksq_min = kmin * kmin;
+
+        // As for Sersic, take 10 as a conservative estimate for the fourth derivative.
+        // 10 h^4 <= kvalue_accuracy
+        // h = (kvalue_accuracy/10)^0.25
+        double dlogk = _gsparams->table_spacing * sqrt(sqrt(_gsparams->kvalue_accuracy / 10.));
+        dbg<<"Using dlogk = "<<dlogk<<std::endl;
+
+        // f(k) is monotonically decreasing, so once it is below kvalue_accuracy, we can use
+        // 0 instead.  Start and end a few steps past the range we use, so the end effects of
+        // the spline are not in the range where we use it.
+        _ksq_max = 0.;
+        int n_past_max = 0;
+        for (double logk = std::log(kmin)-4.*dlogk; n_past_max < 4; logk += dlogk) {
+            double k = fmath::expd(logk);
+            double ksq = k*k;
+            double val = analyticKValue(ksq);
+            xdbg<<"logk = "<<logk<<", ft("<<k<<") = "<<val<<std::endl;
+            _ft.addEntry(logk, val);
+            if (_ksq_max > 0.) ++n_past_max;
+            else if (val < _gsparams->kvalue_accuracy || k > 500.) _ksq_max = ksq;
+        }
+        _ft.finalize();
+        dbg<<"ksq_max = "<<_ksq_max<<std::endl;
+    }
+
+    void MoffatInfo::buildTruncatedFT() const
+    {
+        // Do a Hankel transform and store the results in a lookup table.
+        double fluxFactor = 1. - std::pow(1.+_trunc*_trunc, 1.-_beta);
+        double prefactor = 2. * (_beta-1.) / (fluxFactor);
+        PowFunc pow_beta = GetPowBeta(_beta, *_gsparams);
 
         // Along the way, find the last k that has a kValue > 1.e-3
-        double maxk_val = this->gsparams.maxk_threshold;
+        double maxk_val = _gsparams->maxk_threshold;
         dbg<<"Looking for maxk_val = "<<maxk_val<<std::endl;
         // Keep going until at least 5 in a row have kvalues below kvalue_accuracy.
         // (It's oscillatory, so want to make sure not to stop at a zero crossing.)
@@ -585,33 +708,33 @@ namespace galsim {
         // conservative for Sersic, but I haven't investigated here.)
         // 10 h^4 <= kvalue_accuracy
         // h = (kvalue_accuracy/10)^0.25
-        double dk = gsparams.table_spacing * sqrt(sqrt(gsparams.kvalue_accuracy / 10.));
+        double dk = _gsparams->table_spacing * sqrt(sqrt(_gsparams->kvalue_accuracy / 10.));
         dbg<<"dk = "<<dk<<std::endl;
         int n_below_thresh = 0;
         // Don't go past k = 50
         for(double k=0.; k < 50; k += dk) {
 
-            MoffatIntegrand I(_beta, k, _pow_beta);
+            MoffatIntegrand I(_beta, k, pow_beta);
 
 #ifdef DEBUGLOGGING
             std::ostream* integ_dbgout = verbose_level >= 3 ? dbgout : 0;
-            integ::IntRegion<double> reg(0, _maxRrD, integ_dbgout);
+            integ::IntRegion<double> reg(0, _trunc, integ_dbgout);
 #else
-            integ::IntRegion<double> reg(0, _maxRrD);
+            integ::IntRegion<double> reg(0, _trunc);
 #endif
 
             // Add explicit splits at first several roots of J0.
             // This tends to make the integral more accurate.
             for (int s=1; s<=10; ++s) {
                 double root = math::getBesselRoot0(s);
-                if (root > k * _maxRrD) break;
+                if (root > k * _trunc) break;
                 reg.addSplit(root/k);
             }
 
             double val = integ::int1d(
                 I, reg,
-                this->gsparams.integration_relerr,
-                this->gsparams.integration_abserr);
+                _gsparams->integration_relerr,
+                _gsparams->integration_abserr);
             val *= prefactor;
 
             xdbg<<"ft("<<k<<") = "<<val<<std::endl;
@@ -619,14 +742,49 @@ namespace galsim {
 
             if (std::abs(val) > maxk_val) _maxk = k;
 
-            if (std::abs(val) > this->gsparams.kvalue_accuracy) n_below_thresh = 0;
+            if (std::abs(val) > _gsparams->kvalue_accuracy) n_below_thresh = 0;
             else ++n_below_thresh;
             if (n_below_thresh == 5) break;
         }
         _ft.finalize();
+        _ksq_max = _ft.argMax();
         dbg<<"maxk = "<<_maxk<<std::endl;
     }
 
+    size_t MoffatInfo::getMemorySize() const
+    {
+        size_t nbytes = sizeof(*this);
+        if (_ft_built) nbytes += _ft.getMemorySize() - sizeof(_ft);
+        return nbytes;
+    }
+
+    void MoffatInfo::write(std::ostream& os) const
+    {
+        // Make sure everything has been calculated.
+        checkFT();
+        WriteValue(os, _beta);
+        WriteValue(os, _trunc);
+        WriteValue(os, _maxk);
+        WriteValue(os, _ksq_min);
+        WriteValue(os, _ksq_max);
+        WriteTable(os, _ft);
+    }
+
+    bool MoffatInfo::read(std::istream& is)
+    {
+        double beta, trunc, maxk, ksq_min, ksq_max;
+        if (!(ReadValue(is, beta) && beta == _beta &&
+              ReadValue(is, trunc) && trunc == _trunc &&
+              ReadValue(is, maxk) && ReadValue(is, ksq_min) && ReadValue(is, ksq_max) &&
+              ReadTable(is, _ft)))
+            return false;
+        _maxk = maxk;
+        _ksq_min = ksq_min;
+        _ksq_max = ksq_max;
+        _ft_built.store(true, std::memory_order_release);
+        return true;
+    }
+
     void SBMoffat::SBMoffatImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
         const int N = photons.size();
@@ -22,6 +22,7 @@
 #include "SBProfile.h"
 #include "SBTransform.h"
 #include "SBProfileImpl.h"
+#include "ScratchArena.h"
 #include "math/Angle.h"
 
 // There are three levels of verbosity which can be helpful when debugging,
@@ -374,7 +375,7 @@ namespace galsim {
         const int n2 = n - n1 - 1;
 
         // Make a smaller single-quadrant image and fill that the normal way.
-        ImageAlloc<T> q(std::max(m1,m2)+1, std::max(n1,n2)+1);
+        ScratchImage<T> q(std::max(m1,m2)+1, std::max(n1,n2)+1);
         QuadrantHelper<T>::fill(prof, q.view(), m1==0?x0:0., dx, n1==0?y0:0., dy);
 
         // Use those values to fill the original image.
@@ -21,9 +21,11 @@
 
 #include "SBSecondKick.h"
 #include "SBSecondKickImpl.h"
+#include "InfoCache.h"
 #include "SBVonKarmanImpl.h"
 #include "fmath/fmath.hpp"
 #include "Solve.h"
+#include "TableBuilder.h"
 #include "math/Bessel.h"
 #include "math/Gamma.h"
 #include "math/BesselRoots.h"
@@ -121,18 +123,54 @@ namespace galsim {
         _kvLUT(Table::spline)
     {
         // build the radial function
+        InfoCacheKey key("SKInfo", _kcrit, *_gsparams);
+        if (!ReadCachedInfo(key, *this)) {
 #ifdef DEBUGLOGGING
-        std::clock_t t0 = std::clock();
-        _buildKVLUT();
-        std::clock_t t1 = std::clock();
-        _buildRadial();
-        std::clock_t t2 = std::clock();
-        dbg << "buildKV time = " << (double)(t1-t0)/CLOCKS_PER_SEC << '\n';
-        dbg << "buildRad time = " << (double)(t2-t1)/CLOCKS_PER_SEC << '\n';
+            std::clock_t t0 = std::clock();
+            _buildKVLUT();
+            std::clock_t t1 = std::clock();
+            _buildRadial();
+            std::clock_t t2 = std::clock();
+            dbg << "buildKV time = " << (double)(t1-t0)/CLOCKS_PER_SEC << '\n';
+            dbg << "buildRad time = " << (double)(t2-t1)/CLOCKS_PER_SEC << '\n';
 #else
-        _buildKVLUT();
-        _buildRadial();
+            _buildKVLUT();
+            _buildRadial();
 #endif
+            WriteCachedInfo(key, *this);
+        }
+
+        std::vector<double> range(2,0.);
+        range[1] = _radial.argMax();
+        dbg<<"range = "<<range[0]<<"  "<<range[1]<<std::endl;
+        _sampler = MakeCachedDeviate(InfoCacheKey("SKSampler", _kcrit, *_gsparams),
+                                     _radial, range, true, 1.0, *_gsparams);
+        dbg<<"made sampler\n";
+    }
+
+    void SKInfo::write(std::ostream& os) const
+    {
+        WriteValue(os, _maxk);
+        WriteValue(os, _delta);
+        WriteValue(os, _stepk);
+        WriteTable(os, _kvLUT);
+        WriteTable(os, _radial);
+    }
+
+    bool SKInfo::read(std::istream& is)
+    {
+        // Read both tables before changing either, so a failure leaves this unchanged.
+        double maxk, delta, stepk;
+        std::vector<double> kargs, kvals, rargs, rvals;
+        if (!(ReadValue(is, maxk) && ReadValue(is, delta) && ReadValue(is, stepk) &&
+              ReadTableValues(is, kargs, kvals) && ReadTableValues(is, rargs, rvals)))
+            return false;
+        _maxk = maxk;
+        _delta = delta;
+        _stepk = stepk;
+        SetTableValues(_kvLUT, kargs, kvals);
+        SetTableValues(_radial, rargs, rvals);
+        return true;
     }
 
     inline double pow4(double x) { double x2 = x*x; return x2*x2; }
@@ -151,6 +189,17 @@ namespace galsim {
             }
             return ret;
         }
+        void evalMany(const double* k, double* f, int n) const {
+            for (int i=0; i<n; ++i) f[i] = _2pirho*k[i];
+            math::j0Many(f, f, n);
+            for (int i=0; i<n; ++i) f[i] = fast_pow(k[i], -8./3)*(1-f[i]);
+            if (_kc4 > 0.) {
+                for (int i=0; i<n; ++i) {
+                    double k4 = pow4(k[i]);
+                    f[i] *= k4 / (k4 + _kc4);
+                }
+            }
+        }
     private:
         const double _2pirho;   // 2*pi*rho
         const double _kc4;      // kcrit^4
@@ -171,6 +220,15 @@ namespace galsim {
         return result;
     }
 
+    class SKStructureFunction : public std::unary_function<double,double>
+    {
+    public:
+        SKStructureFunction(const SKInfo& ski) : _ski(ski) {}
+        double operator()(double k) const { return _ski.structureFunction(k); }
+    private:
+        const SKInfo& _ski;
+    };
+
     void SKInfo::_buildKVLUT() {
         // Start with 10x the regular Kolmogorov maxk (fairly arbitrarily)
         _maxk = 10*std::pow(-std::log(_gsparams->kvalue_accuracy),3./5.);
@@ -195,10 +253,13 @@ namespace galsim {
         double dk = _gsparams->table_spacing * sqrt(sqrt(_gsparams->kvalue_accuracy / 10.0));
         xdbg<<"Using dk = "<<dk<<'\n';
 
+        // The integrals for the next several values of k are done in parallel.
+        SKStructureFunction sf_func(*this);
+        TableNodeEvaluator<SKStructureFunction> sf_eval(sf_func, dk, 1.);
         double k=0.;
         _kvLUT.addEntry(0, 1.-_delta);
         for (k=dk; k<1.; k+=dk) {
-            double val = structureFunction(k);
+            double val = sf_eval(k);
             xdbg<<"sf("<<k<<") "<<val<<std::endl;
             double kv = fmath::exp(-0.5*val)-_delta;
             dbg<<"kv("<<k<<") "<<kv<<std::endl;
@@ -207,9 +268,10 @@ namespace galsim {
         }
         // Switch to logarithmic spacing.  dk -> dlogk
         double expdlogk = exp(dk);
+        TableNodeEvaluator<SKStructureFunction> sf_log_eval(sf_func, expdlogk, _maxk, true);
         int nsmall=0;
         for (; k<_maxk; k*=expdlogk) {
-            double val = structureFunction(k);
+            double val = sf_log_eval(k);
             xdbg<<"sf("<<k<<") "<<val<<std::endl;
             double kv = fmath::exp(-0.5*val)-_delta;
             dbg<<"kv("<<k<<") "<<kv<<std::endl;
@@ -246,6 +308,11 @@ namespace galsim {
     public:
         SKIXIntegrand(double r, const SKInfo& ski) : _r(r), _ski(ski) {}
         double operator()(double k) const { return _ski.kValue(k)*j0(k*_r)*k; }
+        void evalMany(const double* k, double* f, int n) const {
+            for (int i=0; i<n; ++i) f[i] = k[i]*_r;
+            math::j0Many(f, f, n);
+            for (int i=0; i<n; ++i) f[i] = _ski.kValue(k[i])*f[i]*k[i];
+        }
     private:
         const double _r;
         const SKInfo& _ski;
@@ -280,6 +347,11 @@ namespace galsim {
     public:
         SKIExactXIntegrand(double r, const SKInfo& ski) : _r(r), _ski(ski) {}
         double operator()(double k) const { return _ski.kValueRaw(k)*j0(k*_r)*k; }
+        void evalMany(const double* k, double* f, int n) const {
+            for (int i=0; i<n; ++i) f[i] = k[i]*_r;
+            math::j0Many(f, f, n);
+            for (int i=0; i<n; ++i) f[i] = _ski.kValueRaw(k[i])*f[i]*k[i];
+        }
     private:
         const double _r;
         const SKInfo& _ski;
@@ -304,6 +376,15 @@ namespace galsim {
         return result;
     }
 
+    class SKXValue : public std::unary_function<double,double>
+    {
+    public:
+        SKXValue(const SKInfo& ski) : _ski(ski) {}
+        double operator()(double r) const { return _ski.xValueRaw(r); }
+    private:
+        const SKInfo& _ski;
+    };
+
     void SKInfo::_buildRadial() {
         //set_verbose(2);
         if (_delta > 1.-_gsparams->folding_threshold) {
@@ -313,12 +394,6 @@ namespace galsim {
             _radial.addEntry(2., 0.);
             _radial.finalize();
             _stepk = 1.e10;
-            std::vector<double> range(2,0.);
-            range[1] = _radial.argMax();
-            dbg<<"range = "<<range[0]<<"  "<<range[1]<<std::endl;
-            dbg<<"Make ODD\n";
-            _sampler.reset(new OneDimensionalDeviate(_radial, range, true, 1.0, *_gsparams));
-            dbg<<"Made ODD\n";
             return;
         }
 
@@ -342,9 +417,12 @@ namespace galsim {
         double sum = 0.5*r*val;
 
         // Continue until accumulate 0.999 of the flux
+        // The integrals for the next several values of r are done in parallel.
+        SKXValue xval_func(*this);
+        TableNodeEvaluator<SKXValue> xval_eval(xval_func, dr, 1.);
         int nsmall=0;
         for (; r<1.; r+=dr) {
-            val = xValueRaw(r);
+            val = xval_eval(r);
             xdbg<<"f("<<r<<") = "<<val<<std::endl;
 
             // The result should be positive, but numerical inaccuracies can mean that some
@@ -366,9 +444,10 @@ namespace galsim {
         }
         // Switch to logarithmic binning
         double expdlogr = std::exp(dr);
+        TableNodeEvaluator<SKXValue> xval_log_eval(xval_func, expdlogr, maxR, true);
         nsmall=0;
         for (; r<maxR; r *= expdlogr) {
-            val = xValueRaw(r);
+            val = xval_log_eval(r);
             xdbg<<"f("<<r<<") = "<<val<<std::endl;
 
             // The result should be positive, but numerical inaccuracies can mean that some
@@ -402,11 +481,6 @@ namespace galsim {
         dbg<<"final R = "<<R<<std::endl;
         _stepk = M_PI / R;
         dbg<<"stepk = "<<_stepk<<std::endl;
-
-        std::vector<double> range(2,0.);
-        range[1] = _radial.argMax();
-        _sampler.reset(new OneDimensionalDeviate(_radial, range, true, 1.0, *_gsparams));
-        dbg<<"made sampler\n";
         //set_verbose(1);
     }
 
@@ -416,8 +490,15 @@ namespace galsim {
         _sampler->shoot(photons,ud);
     }
 
+    size_t SKInfo::getMemorySize() const
+    {
+        return (sizeof(*this) + _radial.getMemorySize() - sizeof(_radial) +
+                _kvLUT.getMemorySize() - sizeof(_kvLUT) +
+                (_sampler ? _sampler->getMemorySize() : 0));
+    }
+
     LRUCache<Tuple<double,GSParamsPtr>,SKInfo>
-        SBSecondKick::SBSecondKickImpl::cache(sbp::max_SK_cache);
+        SBSecondKick::SBSecondKickImpl::cache(sbp::max_SK_cache, "SecondKick");
 
     //
     //
@@ -19,9 +19,21 @@
 
 //#define DEBUGLOGGING
 
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <cstring>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "SBSersic.h"
 #include "SBSersicImpl.h"
+#include "InfoCache.h"
 #include "integ/Int.h"
+#include "TableBuilder.h"
 #include "Solve.h"
 #include "math/Bessel.h"
 #include "math/BesselRoots.h"
@@ -87,15 +99,17 @@ namespace galsim {
         return oss.str();
     }
 
-    LRUCache<Tuple<double, double, GSParamsPtr>, SersicInfo>
-        SBSersic::SBSersicImpl::cache(sbp::max_sersic_cache);
+    LRUCache<Tuple<double, double, bool, GSParamsPtr>, SersicInfo>
+        SBSersic::SBSersicImpl::cache(sbp::max_sersic_cache, "Sersic");
 
     SBSersic::SBSersicImpl::SBSersicImpl(double n,  double scale_radius, double flux,
                                          double trunc, const GSParams& gsparams) :
         SBProfileImpl(gsparams),
         _n(n), _flux(flux), _r0(scale_radius), _trunc(trunc),
         _r0_sq(_r0*_r0), _inv_r0(1./_r0), _inv_r0_sq(_inv_r0*_inv_r0), _trunc_sq(trunc*trunc),
-        _info(cache.get(MakeTuple(_n, _trunc/_r0, GSParamsPtr(this->gsparams))))
+        _info(cache.get(MakeTuple(_n, _trunc/_r0,
+                                  _trunc == 0. && this->gsparams.interpolate_sersic_n,
+                                  GSParamsPtr(this->gsparams))))
     {
         dbg<<"Start SBSersic constructor:\n";
         dbg<<"n = "<<_n<<std::endl;
@@ -307,14 +321,15 @@ namespace galsim {
     double SBSersic::SBSersicImpl::maxK() const { return _info->maxK() * _inv_r0; }
     double SBSersic::SBSersicImpl::stepK() const { return _info->stepK() * _inv_r0; }
 
-    SersicInfo::SersicInfo(double n, double trunc, const GSParamsPtr& gsparams) :
-        _n(n), _trunc(trunc), _gsparams(gsparams),
-        _invn(1./_n), _inv2n(0.5*_invn),
+    SersicInfo::SersicInfo(double n, double trunc, const GSParamsPtr& gsparams,
+                           bool use_info_cache, bool grid_node) :
+        _n(n), _trunc(trunc), _gsparams(gsparams), _use_info_cache(use_info_cache),
+        _grid_node(grid_node), _invn(1./_n), _inv2n(0.5*_invn),
         _trunc_sq(_trunc*_trunc), _truncated(_trunc > 0.),
         _gamma2n(math::tgamma(2.*_n)),
-        _maxk(0.), _stepk(0.), _re(0.), _flux(0.),
+        _stepk(0.), _re(0.), _b(0.), _flux(0.), _maxk(0.),
         _ft(Table::spline),
-        _kderiv2(0.), _kderiv4(0.)
+        _kderiv2(0.), _kderiv4(0.), _ft_built(false)
     {
         dbg<<"Start SersicInfo constructor for n = "<<_n<<std::endl;
         dbg<<"trunc = "<<_trunc<<std::endl;
@@ -323,33 +338,54 @@ namespace galsim {
             throw SBError("Requested Sersic index out of range");
     }
 
-    double SersicInfo::stepK() const
+    SersicInfo::SersicInfo(double n, double trunc, const GSParamsPtr& gsparams,
+                           bool use_info_cache) :
+        SersicInfo(n, trunc, gsparams, use_info_cache, false)
     {
-        if (_stepk == 0.) {
-            // How far should the profile extend, if not truncated?
-            // Estimate number of effective radii needed to enclose (1-folding_threshold) of flux
-            double R = calculateMissingFluxRadius(_gsparams->folding_threshold);
-            if (_truncated && _trunc < R)  R = _trunc;
-            // Go to at least 5*re
-            R = std::max(R,_gsparams->stepk_minimum_hlr);
-            dbg<<"R => "<<R<<std::endl;
-            _stepk = M_PI / R;
-            dbg<<"stepk = "<<_stepk<<std::endl;
+        if (!_truncated && _gsparams->interpolate_sersic_n) {
+            _grid = SersicGrid::get(_gsparams);
+            _use_info_cache = false;
+        } else if (_use_info_cache) {
+            // If this isn't in the cache, it is written there by checkFT, once the Fourier
+            // transform has been calculated.
+            ReadCachedInfo(InfoCacheKey("SersicInfo", _n, _trunc, *_gsparams), *this);
         }
-        return _stepk;
+
+        // This object may be shared between threads through the cache, so calculate these
+        // here rather than lazily.  They are cheap compared to the Fourier transform.
+        if (_truncated) {
+            // Calculate the flux of a truncated profile (relative to the integral for
+            // an untruncated profile), integrating from 0. to _trunc.
+            _flux = SersicIntegratedFlux(_n, _trunc);
+            dbg << "Flux fraction = " << _flux << std::endl;
+        } else {
+            _flux = 1.;
+        }
+        if (_re == 0.) calculateHLR();
+
+        // How far should the profile extend, if not truncated?
+        // Estimate number of effective radii needed to enclose (1-folding_threshold) of flux
+        double R = _grid ? _grid->getFoldingRadius(_n) :
+            calculateMissingFluxRadius(_gsparams->folding_threshold);
+        if (_truncated && _trunc < R)  R = _trunc;
+        // Go to at least 5*re
+        R = std::max(R,_gsparams->stepk_minimum_hlr);
+        dbg<<"R => "<<R<<std::endl;
+        _stepk = M_PI / R;
+        dbg<<"stepk = "<<_stepk<<std::endl;
     }
 
+    double SersicInfo::stepK() const
+    { return _stepk; }
+
     double SersicInfo::maxK() const
     {
-        if (_maxk == 0.) buildFT();
+        checkFT();
         return _maxk;
     }
 
     double SersicInfo::getHLR() const
-    {
-        if (_re == 0.) calculateHLR();
-        return _re;
-    }
+    { return _re; }
 
     double SersicIntegratedFlux(double n, double r)
     {
@@ -358,20 +394,7 @@ namespace galsim {
     }
 
     double SersicInfo::getFluxFraction() const
-    {
-        if (_flux == 0.) {
-            // Calculate the flux of a truncated profile (relative to the integral for
-            // an untruncated profile).
-            if (_truncated) {
-                // integrate from 0. to _trunc
-                _flux = SersicIntegratedFlux(_n, _trunc);
-                dbg << "Flux fraction = " << _flux << std::endl;
-            } else {
-                _flux = 1.;
-            }
-        }
-        return _flux;
-    }
+    { return _flux; }
 
     double SersicInfo::getXNorm() const
     { return 1. / (2.*M_PI*_n*_gamma2n * getFluxFraction()); }
@@ -385,7 +408,7 @@ namespace galsim {
     double SersicInfo::kValue(double ksq) const
     {
         assert(ksq >= 0.);
-        if (!_ft.finalized()) buildFT();
+        checkFT();
 
         if (ksq>=_ksq_max)
             return (_highk_a + _highk_b/sqrt(ksq))/ksq; // high-k asymptote
@@ -406,11 +429,97 @@ namespace galsim {
         double operator()(double r) const
         { return r*fmath::expd(-fast_pow(r, _invn)) * math::j0(_k*r); }
 
+        // The integrator calls this with all the abscissae of each GKP level at once.
+        void evalMany(const double* r, double* f, int n) const
+        {
+            for (int i=0; i<n; ++i) f[i] = _k*r[i];
+            math::j0Many(f, f, n);
+            for (int i=0; i<n; ++i) f[i] = r[i]*fmath::expd(-fast_pow(r[i], _invn)) * f[i];
+        }
+
     private:
         double _invn;
         double _k;
     };
 
+    // The Hankel transform at k = exp(logk), normalized to be 1 at k=0.
+    // If grid is given, the value is interpolated from it rather than integrated.
+    // grid_node is true when building the nodes of a SersicGrid, which need extra splits.
+    class SersicHankelTransform : public std::unary_function<double,double>
+    {
+    public:
+        SersicHankelTransform(double invn, double integ_maxr, double hankel_norm,
+                              const GSParams& gsparams,
+                              const SersicGrid* grid, double n, double logre,
+                              bool grid_node) :
+            _invn(invn), _integ_maxr(integ_maxr), _hankel_norm(hankel_norm),
+            _gsparams(gsparams), _grid(grid), _n(n), _logre(logre), _grid_node(grid_node) {}
+
+        double operator()(double logk) const
+        {
+            if (_grid) return _grid->kValue(_n, logk + _logre);
+
+            double k = fmath::expd(logk);
+            SersicHankel I(_invn, k);
+
+#ifdef DEBUGLOGGING
+            std::ostream* integ_dbgout = verbose_level >= 3 ?
+                &Debugger::instance().get_dbgout() : 0;
+            integ::IntRegion<double> reg(0, _integ_maxr, integ_dbgout);
+#else
+            integ::IntRegion<double> reg(0, _integ_maxr);
+#endif
+
+            // Add explicit splits at first several roots of J0.
+            // This tends to make the integral more accurate.
+            for (int s=1; s<=10; ++s) {
+                double root = math::getBesselRoot0(s);
+                if (root > k * _integ_maxr) break;
+                reg.addSplit(root/k);
+            }
+            // The grid nodes go up to large n and start further below kmin than usual.  There
+            // the profile covers many decades in r, and the integral is occasionally quite wrong
+            // unless we also split at r = u^n for u = 1, 2, 4, ... 64, up to the last of those
+            // roots.  Other profiles don't need these, so leave their integrals as they were.
+            if (_grid_node) {
+                const double rmax = std::min(math::getBesselRoot0(10) / k, _integ_maxr);
+                for (double u=1.; u<=64.; u*=2.) {
+                    double r = std::pow(u, 1./_invn);
+                    if (r >= rmax) break;
+                    reg.addSplit(r);
+                }
+            }
+
+            double val = integ::int1d(I, reg,
+                                      _gsparams.integration_relerr,
+                                      _gsparams.integration_abserr*_hankel_norm);
+            return val / _hankel_norm;
+        }
+
+    private:
+        double _invn;
+        double _integ_maxr;
+        double _hankel_norm;
+        const GSParams& _gsparams;
+        const SersicGrid* _grid;
+        double _n;
+        double _logre;
+        bool _grid_node;
+    };
+
+    void SersicInfo::checkFT() const
+    {
+        // This object may be shared between threads through the cache, so make sure only one
+        // of them builds the table, and the others wait until it is finished.
+        if (_ft_built.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(_ft_mutex);
+        if (_ft_built.load(std::memory_order_relaxed)) return;
+        buildFT();
+        _ft_built.store(true, std::memory_order_release);
+        if (_use_info_cache)
+            WriteCachedInfo(InfoCacheKey("SersicInfo", _n, _trunc, *_gsparams), *this);
+    }
+
     void SersicInfo::buildFT() const
     {
         // The small-k expansion of the Hankel transform is (normalized to have flux=1):
@@ -481,31 +590,19 @@ namespace galsim {
         _ksq_max = -1.;
         _maxk = kmin; // Just in case we break on the first iteration.
         bool found_maxk = false;
-        for (double logk = std::log(kmin)-0.001; logk < std::log(500.); logk += dlogk) {
+        // The integrals for the next several values of logk are done in parallel.
+        // The tables for the interpolated grid start a few steps below kmin, so the end
+        // effects of the spline are in the range where we use the quartic approximation
+        // instead.  Otherwise, start just below kmin, as always.
+        SersicHankelTransform ft_func(_invn, integ_maxr, hankel_norm, *_gsparams,
+                                      _grid.get(), _n, _grid ? std::log(getHLR()) : 0.,
+                                      _grid_node);
+        TableNodeEvaluator<SersicHankelTransform> ft_eval(ft_func, dlogk, std::log(500.));
+        double logk0 = std::log(kmin) - ((_grid_node || _grid) ? 4.*dlogk : 0.001);
+        for (double logk = logk0; logk < std::log(500.); logk += dlogk) {
             double k = fmath::expd(logk);
             double ksq = k*k;
-            SersicHankel I(_invn, k);
-
-#ifdef DEBUGLOGGING
-            std::ostream* integ_dbgout = verbose_level >= 3 ?
-                &Debugger::instance().get_dbgout() : 0;
-            integ::IntRegion<double> reg(0, integ_maxr, integ_dbgout);
-#else
-            integ::IntRegion<double> reg(0, integ_maxr);
-#endif
-
-            // Add explicit splits at first several roots of J0.
-            // This tends to make the integral more accurate.
-            for (int s=1; s<=10; ++s) {
-                double root = math::getBesselRoot0(s);
-                if (root > k * integ_maxr) break;
-                reg.addSplit(root/k);
-            }
-
-            double val = integ::int1d(I, reg,
-                                      _gsparams->integration_relerr,
-                                      _gsparams->integration_abserr*hankel_norm);
-            val /= hankel_norm;
+            double val = ft_eval(logk);
             xdbg<<"logk = "<<logk<<", ft("<<exp(logk)<<") = "<<val<<"   "<<val*ksq<<std::endl;
 
             double f0 = val * ksq;
@@ -650,7 +747,6 @@ namespace galsim {
             // So use the HLR _b value instead:
             if (z1 < 0.) {
                 assert(missing_flux_frac < 0.5);
-                getHLR(); // Make sure _b is set.
                 z1 = _b;
             }
 
@@ -700,12 +796,17 @@ namespace galsim {
         return b;
     }
 
-    void SersicInfo::calculateHLR() const
+    void SersicInfo::calculateHLR()
     {
-        _b = CalculateB(_n, _invn, _gamma2n, getFluxFraction());
+        if (_grid) {
+            _re = _grid->getHLR(_n);
+            _b = std::pow(_re,_invn);
+        } else {
+            _b = CalculateB(_n, _invn, _gamma2n, getFluxFraction());
 
-        // re = b^n
-        _re = std::pow(_b,_n);
+            // re = b^n
+            _re = std::pow(_b,_n);
+        }
         dbg<<"re is "<<_re<<std::endl;
     }
 
@@ -808,9 +909,6 @@ namespace galsim {
 
     double SersicInfo::calculateScaleForTruncatedHLR(double re, double trunc) const
     {
-        // We need _b, so call getHLR(), since it may not be calculated yet.
-        // We don't care about the return value, but it also stores the b value in _b.
-        getHLR();
         return re * CalculateTruncatedScale(_n, _invn, _b, trunc/re);
     }
 
@@ -834,16 +932,22 @@ namespace galsim {
     {
         dbg<<"Target flux = 1.0\n";
 
-        if (!_sampler) {
-            // Set up the classes for photon shooting
-            _radial.reset(new SersicRadialFunction(_invn));
-            std::vector<double> range(2,0.);
-            double shoot_maxr = calculateMissingFluxRadius(_gsparams->shoot_accuracy);
-            if (_truncated && _trunc < shoot_maxr) shoot_maxr = _trunc;
-            range[1] = shoot_maxr;
-            double nominal_flux = 2.*M_PI*_n*_gamma2n * _flux;
-            _sampler.reset(new OneDimensionalDeviate(*_radial, range, true, nominal_flux,
-                                                     *_gsparams));
+        {
+            // This object may be shared between threads through the cache, so make sure
+            // only one of them builds the sampler.
+            std::lock_guard<std::mutex> lock(_sampler_mutex);
+            if (!_sampler) {
+                // Set up the classes for photon shooting
+                _radial.reset(new SersicRadialFunction(_invn));
+                std::vector<double> range(2,0.);
+                double shoot_maxr = calculateMissingFluxRadius(_gsparams->shoot_accuracy);
+                if (_truncated && _trunc < shoot_maxr) shoot_maxr = _trunc;
+                range[1] = shoot_maxr;
+                double nominal_flux = 2.*M_PI*_n*_gamma2n * _flux;
+                _sampler = MakeCachedDeviate(
+                    InfoCacheKey("SersicSampler", _n, _trunc, *_gsparams),
+                    *_radial, range, true, nominal_flux, *_gsparams);
+            }
         }
 
         assert(_sampler.get());
@@ -851,6 +955,16 @@ namespace galsim {
         dbg<<"SersicInfo Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
+    size_t SersicInfo::getMemorySize() const
+    {
+        // The grid, if any, is shared by all the SersicInfos, so it isn't counted here.
+        size_t nbytes = sizeof(*this);
+        if (_ft_built) nbytes += _ft.getMemorySize() - sizeof(_ft);
+        std::lock_guard<std::mutex> lock(_sampler_mutex);
+        if (_sampler) nbytes += _sampler->getMemorySize();
+        return nbytes;
+    }
+
     void SBSersic::SBSersicImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
         dbg<<"Sersic shoot: N = "<<photons.size()<<std::endl;
@@ -861,4 +975,285 @@ namespace galsim {
         photons.scaleXY(_r0);
         dbg<<"Sersic Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
+
+    //
+    // The grid of SersicInfo tables for GSParams::interpolate_sersic_n
+    //
+
+    // The grid files are just the raw bytes of each value, so they are only valid on machines
+    // with the same byte order and sizes.  The header has the value 1.0 as a check of this.
+    static const char sersic_grid_magic[] = "GalSim SersicGrid v1";
+
+    void SersicInfo::write(std::ostream& os) const
+    {
+        // Make sure everything has been calculated.
+        checkFT();
+        WriteValue(os, _n);
+        WriteValue(os, _re);
+        WriteValue(os, _b);
+        WriteValue(os, _maxk);
+        WriteValue(os, _kderiv2);
+        WriteValue(os, _kderiv4);
+        WriteValue(os, _ksq_min);
+        WriteValue(os, _ksq_max);
+        WriteValue(os, _highk_a);
+        WriteValue(os, _highk_b);
+        WriteTable(os, _ft);
+    }
+
+    // The grid nodes are at n = exp(logn0 + j*dlogn), which may differ in the last bit or two
+    // on a machine whose libm rounds differently from the one that wrote the file.
+    static bool NearlyEqual(double a, double b)
+    { return std::abs(a-b) <= 4. * std::numeric_limits<double>::epsilon() * std::abs(b); }
+
+    bool SersicInfo::read(std::istream& is)
+    {
+        double n, re, b, maxk, kderiv2, kderiv4, ksq_min, ksq_max, highk_a, highk_b;
+        if (!(ReadValue(is, n) && NearlyEqual(n, _n) &&
+              ReadValue(is, re) && ReadValue(is, b) && ReadValue(is, maxk) &&
+              ReadValue(is, kderiv2) && ReadValue(is, kderiv4) &&
+              ReadValue(is, ksq_min) && ReadValue(is, ksq_max) &&
+              ReadValue(is, highk_a) && ReadValue(is, highk_b) &&
+              ReadTable(is, _ft)))
+            return false;
+        _re = re;
+        _b = b;
+        _maxk = maxk;
+        _kderiv2 = kderiv2;
+        _kderiv4 = kderiv4;
+        _ksq_min = ksq_min;
+        _ksq_max = ksq_max;
+        _highk_a = highk_a;
+        _highk_b = highk_b;
+        _ft_built.store(true, std::memory_order_release);
+        return true;
+    }
+
+    SersicGrid::SersicGrid(const GSParamsPtr& gsparams)
+    {
+        // The nodes themselves are calculated directly.
+        GSParams node_gsparams = *gsparams;
+        node_gsparams.interpolate_sersic_n = false;
+        _gsparams = GSParamsPtr(node_gsparams);
+
+        // The cubic interpolation error goes as h^4.  Empirically, h = 0.1 gives errors of
+        // about 5.e-6 for the default kvalue_accuracy = 1.e-5.
+        double h = 0.1 * _gsparams->table_spacing *
+            sqrt(sqrt(_gsparams->kvalue_accuracy / 1.e-5));
+        _logn0 = std::log(sbp::minimum_sersic_n);
+        double logn1 = std::log(sbp::maximum_sersic_n);
+        _nnodes = std::max(int(std::ceil((logn1 - _logn0) / h)) + 1, 4);
+        _dlogn = (logn1 - _logn0) / (_nnodes - 1);
+        dbg<<"SersicGrid: nnodes = "<<_nnodes<<", dlogn = "<<_dlogn<<std::endl;
+    }
+
+    void SersicGrid::build()
+    {
+        _nodes.resize(_nnodes);
+        _logre.resize(_nnodes);
+        _logb.resize(_nnodes);
+        _logz.resize(_nnodes);
+
+        // Each node is a separate SersicInfo calculation, so do them in parallel.
+        std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int j=0; j<_nnodes; ++j) {
+            try {
+                // Make sure the end points are exactly the allowed limits.
+                double n = (j == 0) ? sbp::minimum_sersic_n :
+                    (j == _nnodes-1) ? sbp::maximum_sersic_n :
+                    std::exp(_logn0 + j*_dlogn);
+                // The grid is saved in the Info cache as a whole, so the nodes don't use it.
+                shared_ptr<SersicInfo> info(new SersicInfo(n, 0., _gsparams, false));
+                info->_grid_node = true;
+                info->checkFT();
+                double re = info->getHLR();
+                double R = info->calculateMissingFluxRadius(_gsparams->folding_threshold);
+                _nodes[j] = info;
+                _logre[j] = std::log(re);
+                _logb[j] = _logre[j] / n;
+                _logz[j] = std::log(R) / n;
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                { if (!error) error = std::current_exception(); }
+            }
+        }
+        if (error) std::rethrow_exception(error);
+    }
+
+    void SersicGrid::write(std::ostream& os) const
+    {
+        os.write(sersic_grid_magic, sizeof(sersic_grid_magic));
+        WriteValue(os, 1.0);
+        WriteGSParams(os, *_gsparams);
+        WriteValue(os, _nnodes);
+        WriteValue(os, _logn0);
+        WriteValue(os, _dlogn);
+        WriteVector(os, _logre);
+        WriteVector(os, _logb);
+        WriteVector(os, _logz);
+        for (int j=0; j<_nnodes; ++j) _nodes[j]->write(os);
+    }
+
+    bool SersicGrid::read(std::istream& is)
+    {
+        char magic[sizeof(sersic_grid_magic)];
+        double one;
+        if (!is.read(magic, sizeof(magic)) ||
+            std::memcmp(magic, sersic_grid_magic, sizeof(magic)) != 0 ||
+            !ReadValue(is, one) || one != 1.0)
+            return false;
+
+        GSParams gsparams;
+        if (!ReadGSParams(is, gsparams)) return false;
+        if (!(gsparams == *_gsparams)) return false;
+
+        int nnodes;
+        double logn0, dlogn;
+        if (!(ReadValue(is, nnodes) && ReadValue(is, logn0) && ReadValue(is, dlogn) &&
+              nnodes == _nnodes && NearlyEqual(logn0, _logn0) && NearlyEqual(dlogn, _dlogn)))
+            return false;
+        if (!(ReadVector(is, _logre) && ReadVector(is, _logb) && ReadVector(is, _logz) &&
+              int(_logre.size()) == _nnodes && int(_logb.size()) == _nnodes &&
+              int(_logz.size()) == _nnodes))
+            return false;
+
+        _nodes.resize(_nnodes);
+        for (int j=0; j<_nnodes; ++j) {
+            double n = (j == 0) ? sbp::minimum_sersic_n :
+                (j == _nnodes-1) ? sbp::maximum_sersic_n :
+                std::exp(_logn0 + j*_dlogn);
+            // The half-light radius comes from the file, so don't solve for it (or for the
+            // folding radius, which is stored in _logz) when making the node.
+            _nodes[j].reset(new SersicInfo(n, 0., _gsparams, false, true));
+            if (!_nodes[j]->read(is)) return false;
+            _nodes[j]->_flux = 1.;
+            double R = std::max(std::exp(_logz[j] * n), _gsparams->stepk_minimum_hlr);
+            _nodes[j]->_stepk = M_PI / R;
+        }
+        return true;
+    }
+
+    // There is one grid per GSParams, which is kept for the life of the program.
+    static std::map<GSParams, shared_ptr<SersicGrid> > sersic_grids;
+    static std::mutex sersic_grid_mutex;
+    static std::string sersic_grid_file;
+
+    shared_ptr<SersicGrid> SersicGrid::get(const GSParamsPtr& gsparams)
+    {
+        // Building the grid takes a while, so other threads wait for it rather than
+        // building their own.
+        std::lock_guard<std::mutex> lock(sersic_grid_mutex);
+        shared_ptr<SersicGrid>& grid = sersic_grids[*gsparams];
+        if (!grid) {
+            // Try the shipped file first.  read checks the header, the byte order and the
+            // GSParams, so a grid that doesn't match is just skipped.
+            shared_ptr<SersicGrid> new_grid(new SersicGrid(gsparams));
+            if (!sersic_grid_file.empty()) {
+                std::ifstream fin(sersic_grid_file.c_str(), std::ios::binary);
+                if (fin && new_grid->read(fin)) {
+                    dbg<<"Read SersicGrid from "<<sersic_grid_file<<std::endl;
+                    grid = new_grid;
+                    return grid;
+                }
+                // A partial read may have filled in some of the nodes, so start over.
+                new_grid.reset(new SersicGrid(gsparams));
+            }
+            InfoCacheKey key("SersicGrid", *gsparams);
+            if (!ReadCachedInfo(key, *new_grid)) {
+                dbg<<"Building SersicGrid for "<<*gsparams<<std::endl;
+                new_grid->build();
+                WriteCachedInfo(key, *new_grid);
+            }
+            grid = new_grid;
+        }
+        return grid;
+    }
+
+    bool SersicGrid::load(std::istream& is, const GSParamsPtr& gsparams)
+    {
+        shared_ptr<SersicGrid> grid(new SersicGrid(gsparams));
+        if (!grid->read(is)) {
+            dbg<<"File does not have a valid SersicGrid for "<<*gsparams<<std::endl;
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(sersic_grid_mutex);
+        sersic_grids[*gsparams] = grid;
+        return true;
+    }
+
+    // Get the index of the first of the four nodes to use for n, and their Lagrange weights.
+    int SersicGrid::getWeights(double n, double* w) const
+    {
+        double u = (std::log(n) - _logn0) / _dlogn;
+        int j = std::max(0, std::min(int(std::floor(u)) - 1, _nnodes - 4));
+        double x = u - j;
+        w[0] = -(x-1.) * (x-2.) * (x-3.) / 6.;
+        w[1] = x * (x-2.) * (x-3.) / 2.;
+        w[2] = -x * (x-1.) * (x-3.) / 2.;
+        w[3] = x * (x-1.) * (x-2.) / 6.;
+        return j;
+    }
+
+    double SersicGrid::kValue(double n, double logq) const
+    {
+        double w[4];
+        int j = getWeights(n, w);
+        double f = 0.;
+        for (int m=0; m<4; ++m) {
+            double logk = logq - _logre[j+m];
+            f += w[m] * _nodes[j+m]->kValue(fmath::expd(2.*logk));
+        }
+        return f;
+    }
+
+    // For the radii, r = b^n, where b is a much smoother function of n than r is.
+    // So we interpolate log(b) rather than log(r).
+    double SersicGrid::getHLR(double n) const
+    {
+        double w[4];
+        int j = getWeights(n, w);
+        double logb = 0.;
+        for (int m=0; m<4; ++m) logb += w[m] * _logb[j+m];
+        return std::exp(n * logb);
+    }
+
+    double SersicGrid::getFoldingRadius(double n) const
+    {
+        double w[4];
+        int j = getWeights(n, w);
+        double logz = 0.;
+        for (int m=0; m<4; ++m) logz += w[m] * _logz[j+m];
+        return std::exp(n * logz);
+    }
+
+    bool LoadSersicGrid(const std::string& file_name, const GSParams& gsparams)
+    {
+        std::ifstream fin(file_name.c_str(), std::ios::binary);
+        if (!fin) throw std::runtime_error("Unable to open Sersic grid file " + file_name);
+        GSParams gsp = gsparams;
+        gsp.interpolate_sersic_n = true;
+        return SersicGrid::load(fin, GSParamsPtr(gsp));
+    }
+
+    void SetSersicGridFile(const std::string& file_name)
+    {
+        std::lock_guard<std::mutex> lock(sersic_grid_mutex);
+        sersic_grid_file = file_name;
+    }
+
+    void WriteSersicGrid(const std::string& file_name, const GSParams& gsparams)
+    {
+        GSParams gsp = gsparams;
+        gsp.interpolate_sersic_n = true;
+        shared_ptr<SersicGrid> grid = SersicGrid::get(GSParamsPtr(gsp));
+        std::ofstream fout(file_name.c_str(), std::ios::binary);
+        if (!fout) throw std::runtime_error("Unable to open Sersic grid file " + file_name);
+        grid->write(fout);
+        if (!fout) throw std::runtime_error("Error writing Sersic grid file " + file_name);
+    }
 }
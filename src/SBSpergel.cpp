@@ -21,6 +21,7 @@
 
 #include "SBSpergel.h"
 #include "SBSpergelImpl.h"
+#include "InfoCache.h"
 #include "Solve.h"
 #include "math/Bessel.h"
 #include "math/Gamma.h"
@@ -77,7 +78,7 @@ namespace galsim {
     }
 
     LRUCache<Tuple<double,GSParamsPtr>,SpergelInfo> SBSpergel::SBSpergelImpl::cache(
-        sbp::max_spergel_cache);
+        sbp::max_spergel_cache, "Spergel");
 
     SBSpergel::SBSpergelImpl::SBSpergelImpl(double nu, double scale_radius,
                                             double flux, const GSParams& gsparams) :
@@ -546,6 +547,22 @@ namespace galsim {
 
         if (_nu < sbp::minimum_spergel_nu || _nu > sbp::maximum_spergel_nu)
             throw SBError("Requested Spergel index out of range");
+
+        // This object may be shared between threads through the cache, so calculate these
+        // here rather than lazily.
+        InfoCacheKey key("SpergelInfo", _nu, *_gsparams);
+        if (!ReadCachedInfo(key, *this)) {
+            // Solving (1+k^2)^(-1-nu) = maxk_threshold for k
+            _maxk = std::sqrt(std::pow(_gsparams->maxk_threshold, -1./(1+_nu))-1.0);
+            _re = calculateFluxRadius(0.5);
+            double R = calculateFluxRadius(1.0 - _gsparams->folding_threshold);
+            // Go to at least 5*re
+            R = std::max(R,_gsparams->stepk_minimum_hlr * _re);
+            dbg<<"R => "<<R<<std::endl;
+            _stepk = M_PI / R;
+            dbg<<"stepk = "<<_stepk<<std::endl;
+            WriteCachedInfo(key, *this);
+        }
     }
 
     class SpergelIntegratedFlux
@@ -624,31 +641,32 @@ namespace galsim {
     }
 
     double SpergelInfo::stepK() const
-    {
-        if (_stepk == 0.) {
-            double R = calculateFluxRadius(1.0 - _gsparams->folding_threshold);
-            // Go to at least 5*re
-            R = std::max(R,_gsparams->stepk_minimum_hlr * getHLR());
-            dbg<<"R => "<<R<<std::endl;
-            _stepk = M_PI / R;
-            dbg<<"stepk = "<<_stepk<<std::endl;
-        }
-        return _stepk;
-    }
+    { return _stepk; }
 
     double SpergelInfo::maxK() const
+    { return _maxk; }
+
+    double SpergelInfo::getHLR() const
+    { return _re; }
+
+    void SpergelInfo::write(std::ostream& os) const
     {
-        if(_maxk == 0.) {
-            // Solving (1+k^2)^(-1-nu) = maxk_threshold for k
-            _maxk = std::sqrt(std::pow(_gsparams->maxk_threshold, -1./(1+_nu))-1.0);
-        }
-        return _maxk;
+        WriteValue(os, _nu);
+        WriteValue(os, _maxk);
+        WriteValue(os, _stepk);
+        WriteValue(os, _re);
     }
 
-    double SpergelInfo::getHLR() const
+    bool SpergelInfo::read(std::istream& is)
     {
-        if (_re == 0.0) _re = calculateFluxRadius(0.5);
-        return _re;
+        double nu, maxk, stepk, re;
+        if (!(ReadValue(is, nu) && nu == _nu &&
+              ReadValue(is, maxk) && ReadValue(is, stepk) && ReadValue(is, re)))
+            return false;
+        _maxk = maxk;
+        _stepk = stepk;
+        _re = re;
+        return true;
     }
 
     double SpergelInfo::getXNorm() const
@@ -697,42 +715,49 @@ namespace galsim {
 
     void SpergelInfo::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
-        if (!_sampler) {
-            // Set up the classes for photon shooting
-            double shoot_rmax = calculateFluxRadius(1. - _gsparams->shoot_accuracy);
-            if (_nu > 0.) {
-                std::vector<double> range(2,0.);
-                range[1] = shoot_rmax;
-                _radial.reset(new SpergelNuPositiveRadialFunction(_nu, _xnorm0));
-                double nominal_flux = 2.*M_PI*std::pow(2.,_nu)*_gamma_nup1;
-                _sampler.reset(new OneDimensionalDeviate(*_radial, range, true, nominal_flux,
-                                                         *_gsparams));
-            } else {
-                // exact s.b. profile diverges at origin, so replace the inner most circle
-                // (defined such that enclosed flux is shoot_acccuracy) with a linear function
-                // that contains the same flux and has the right value at r = rmin.
-                // So need to solve the following for a and b:
-                // int(2 pi r (a + b r) dr, 0..rmin) = shoot_accuracy
-                // a + b rmin = K_nu(rmin) * rmin^nu
-                double flux_target = _gsparams->shoot_accuracy;
-                double shoot_rmin = calculateFluxRadius(flux_target);
-                double knur = math::cyl_bessel_k(_nu, shoot_rmin) * fast_pow(shoot_rmin, _nu);
-                double b = 3./shoot_rmin*(knur - flux_target/(M_PI*shoot_rmin*shoot_rmin));
-                double a = knur - shoot_rmin*b;
-                dbg<<"flux target: "<<flux_target<<std::endl;
-                dbg<<"shoot rmin: "<<shoot_rmin<<std::endl;
-                dbg<<"shoot rmax: "<<shoot_rmax<<std::endl;
-                dbg<<"knur: "<<knur<<std::endl;
-                dbg<<"b: "<<b<<std::endl;
-                dbg<<"a: "<<a<<std::endl;
-                dbg<<"a+b*rmin:"<<a+b*shoot_rmin<<std::endl;
-                std::vector<double> range(3,0.);
-                range[1] = shoot_rmin;
-                range[2] = shoot_rmax;
-                _radial.reset(new SpergelNuNegativeRadialFunction(_nu, shoot_rmin, a, b));
-                double nominal_flux = 2.*M_PI*std::pow(2.,_nu)*_gamma_nup1;
-                _sampler.reset(new OneDimensionalDeviate(*_radial, range, true, nominal_flux,
-                                                         *_gsparams));
+        {
+            // This object may be shared between threads through the cache, so make sure
+            // only one of them builds the sampler.
+            std::lock_guard<std::mutex> lock(_sampler_mutex);
+            if (!_sampler) {
+                // Set up the classes for photon shooting
+                double shoot_rmax = calculateFluxRadius(1. - _gsparams->shoot_accuracy);
+                if (_nu > 0.) {
+                    std::vector<double> range(2,0.);
+                    range[1] = shoot_rmax;
+                    _radial.reset(new SpergelNuPositiveRadialFunction(_nu, _xnorm0));
+                    double nominal_flux = 2.*M_PI*std::pow(2.,_nu)*_gamma_nup1;
+                    _sampler = MakeCachedDeviate(
+                        InfoCacheKey("SpergelSampler", _nu, *_gsparams),
+                        *_radial, range, true, nominal_flux, *_gsparams);
+                } else {
+                    // exact s.b. profile diverges at origin, so replace the inner most circle
+                    // (defined such that enclosed flux is shoot_acccuracy) with a linear function
+                    // that contains the same flux and has the right value at r = rmin.
+                    // So need to solve the following for a and b:
+                    // int(2 pi r (a + b r) dr, 0..rmin) = shoot_accuracy
+                    // a + b rmin = K_nu(rmin) * rmin^nu
+                    double flux_target = _gsparams->shoot_accuracy;
+                    double shoot_rmin = calculateFluxRadius(flux_target);
+                    double knur = math::cyl_bessel_k(_nu, shoot_rmin) * fast_pow(shoot_rmin, _nu);
+                    double b = 3./shoot_rmin*(knur - flux_target/(M_PI*shoot_rmin*shoot_rmin));
+                    double a = knur - shoot_rmin*b;
+                    dbg<<"flux target: "<<flux_target<<std::endl;
+                    dbg<<"shoot rmin: "<<shoot_rmin<<std::endl;
+                    dbg<<"shoot rmax: "<<shoot_rmax<<std::endl;
+                    dbg<<"knur: "<<knur<<std::endl;
+                    dbg<<"b: "<<b<<std::endl;
+                    dbg<<"a: "<<a<<std::endl;
+                    dbg<<"a+b*rmin:"<<a+b*shoot_rmin<<std::endl;
+                    std::vector<double> range(3,0.);
+                    range[1] = shoot_rmin;
+                    range[2] = shoot_rmax;
+                    _radial.reset(new SpergelNuNegativeRadialFunction(_nu, shoot_rmin, a, b));
+                    double nominal_flux = 2.*M_PI*std::pow(2.,_nu)*_gamma_nup1;
+                    _sampler = MakeCachedDeviate(
+                        InfoCacheKey("SpergelSampler", _nu, *_gsparams),
+                        *_radial, range, true, nominal_flux, *_gsparams);
+                }
             }
         }
 
@@ -741,6 +766,14 @@ namespace galsim {
         dbg<<"SpergelInfo Realized flux = "<<photons.getTotalFlux()<<std::endl;
     }
 
+    size_t SpergelInfo::getMemorySize() const
+    {
+        size_t nbytes = sizeof(*this);
+        std::lock_guard<std::mutex> lock(_sampler_mutex);
+        if (_sampler) nbytes += _sampler->getMemorySize();
+        return nbytes;
+    }
+
     void SBSpergel::SBSpergelImpl::shoot(PhotonArray& photons, UniformDeviate ud) const
     {
         dbg<<"Spergel shoot: N = "<<photons.size()<<std::endl;
@@ -80,7 +80,7 @@ namespace galsim {
         const GSParams& gsparams) :
         SBProfileImpl(gsparams),
         _adaptee(adaptee), _mA(mA), _mB(mB), _mC(mC), _mD(mD), _cen(cen), _ampScaling(ampScaling),
-        _maxk(0.), _stepk(0.), _xmin(0.), _xmax(0.), _ymin(0.), _ymax(0.)
+        _maxk(0.), _stepk(0.), _xmin(0.), _xmax(0.), _ymin(0.), _ymax(0.), _ranges_set(false)
     {
         dbg<<"Start TransformImpl\n";
         dbg<<"matrix = "<<_mA<<','<<_mB<<','<<_mC<<','<<_mD<<std::endl;
@@ -185,32 +185,47 @@ namespace galsim {
     {
         // The adaptee's maxk can be slow (e.g. high-n Sersic), so delay this calculation
         // until we actually need it.
-        if (_maxk == 0.) _maxk = _adaptee.maxK() / _minor;
-        return _maxk;
+        double maxk = _maxk.load(std::memory_order_acquire);
+        if (maxk == 0.) {
+            maxk = _adaptee.maxK() / _minor;
+            _maxk.store(maxk, std::memory_order_release);
+        }
+        return maxk;
     }
 
     double SBTransform::SBTransformImpl::stepK() const
     {
-        if (_stepk == 0.) {
-            _stepk = _adaptee.stepK() / _major;
+        double stepk = _stepk.load(std::memory_order_acquire);
+        if (stepk == 0.) {
+            stepk = _adaptee.stepK() / _major;
             // If we have a shift, we need to further modify stepk
             //     stepk = Pi/R
             // R <- R + |shift|
             // stepk <- Pi/(Pi/stepk + |shift|)
             if (_cen.x != 0. || _cen.y != 0.) {
                 double shift = sqrt( _cen.x*_cen.x + _cen.y*_cen.y );
-                dbg<<"stepk from adaptee = "<<_stepk<<std::endl;
-                _stepk = M_PI / (M_PI/_stepk + shift);
-                dbg<<"shift = "<<shift<<", stepk -> "<<_stepk<<std::endl;
+                dbg<<"stepk from adaptee = "<<stepk<<std::endl;
+                stepk = M_PI / (M_PI/stepk + shift);
+                dbg<<"shift = "<<shift<<", stepk -> "<<stepk<<std::endl;
             }
+            _stepk.store(stepk, std::memory_order_release);
         }
-        return _stepk;
+        return stepk;
     }
 
     void SBTransform::SBTransformImpl::setupRanges() const
     {
-        if (_xmin != 0. || _xmax != 0.) return;
+        // The same profile may be integrated in real space from several threads, so make sure
+        // only one of them sets up the ranges, and the others wait until it is finished.
+        if (_ranges_set.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(_ranges_mutex);
+        if (_ranges_set.load(std::memory_order_relaxed)) return;
+        buildRanges();
+        _ranges_set.store(true, std::memory_order_release);
+    }
 
+    void SBTransform::SBTransformImpl::buildRanges() const
+    {
         // Calculate the values for getXRange and getYRange:
         if (_adaptee.isAxisymmetric()) {
             // The original is a circle, so first get its radius.
@@ -21,7 +21,9 @@
 
 #include "SBVonKarman.h"
 #include "SBVonKarmanImpl.h"
+#include "InfoCache.h"
 #include "Solve.h"
+#include "TableBuilder.h"
 #include "math/Bessel.h"
 #include "math/Gamma.h"
 #include "math/BesselRoots.h"
@@ -160,7 +162,17 @@ namespace galsim {
         dbg<<"_delta = "<<_delta<<'\n';
 
         // build the radial function, and along the way, set _stepk, _hlr.
-        _buildRadialFunc();
+        InfoCacheKey key("VonKarmanInfo", _lam, _L0, _doDelta, *_gsparams);
+        if (!ReadCachedInfo(key, *this)) {
+            _buildRadialFunc();
+            WriteCachedInfo(key, *this);
+        }
+
+        std::vector<double> range(2, 0.);
+        range[1] = _radial.argMax();
+        _sampler = MakeCachedDeviate(
+            InfoCacheKey("VonKarmanSampler", _lam, _L0, _doDelta, *_gsparams),
+            _radial, range, true, 1.0, *_gsparams);
     }
 
     double vkStructureFunction(double rho, double L0, double L0_invcuberoot, double L053) {
@@ -206,6 +218,13 @@ namespace galsim {
     public:
         VKXIntegrand(double r, const VonKarmanInfo& vki) : _r(r), _vki(vki) {}
         double operator()(double k) const { return _vki.kValue(k)*j0(k*_r)*k; }
+
+        void evalMany(const double* k, double* f, int n) const
+        {
+            for (int i=0; i<n; ++i) f[i] = k[i]*_r;
+            math::j0Many(f, f, n);
+            for (int i=0; i<n; ++i) f[i] = _vki.kValue(k[i])*f[i]*k[i];
+        }
     private:
         const double _r;  //arcsec
         const VonKarmanInfo& _vki;
@@ -264,6 +283,16 @@ namespace galsim {
         return r < _radial.argMax() ? _radial(r) : 0.;
     }
 
+    // rawXValue at r = exp(logr)
+    class VKLogRXValue : public std::unary_function<double,double>
+    {
+    public:
+        VKLogRXValue(const VonKarmanInfo& vki) : _vki(vki) {}
+        double operator()(double logr) const { return _vki.rawXValue(exp(logr)); }
+    private:
+        const VonKarmanInfo& _vki;
+    };
+
     void VonKarmanInfo::_buildRadialFunc() {
         dbg<<"Start buildRadialFunc:\n";
         dbg<<"lam = "<<_lam<<std::endl;
@@ -312,9 +341,12 @@ namespace galsim {
         double R = 0.;
         _hlr = 0.;
         const double maxR = 60.0; // hard cut at 1 arcminute.
+        // The integrals for the next several values of logr are done in parallel.
+        VKLogRXValue xval_func(*this);
+        TableNodeEvaluator<VKLogRXValue> xval_eval(xval_func, dlogr, log(maxR));
         for(double logr=log(r0); logr<log(maxR) && sum < thresh2; logr+=dlogr) {
             double r = exp(logr);
-            val = rawXValue(r);
+            val = xval_eval(logr);
             dbg<<"f("<<r<<") = "<<val<<std::endl;
             _radial.addEntry(r, val);
 
@@ -341,10 +373,23 @@ namespace galsim {
         dbg<<"sum = "<<sum<<"   (should be > 0.995)\n";
         if (sum < 1-_gsparams->folding_threshold)
             throw SBError("Could not determine appropriate stepk, given folding_threshold");
+    }
 
-        std::vector<double> range(2, 0.);
-        range[1] = _radial.argMax();
-        _sampler.reset(new OneDimensionalDeviate(_radial, range, true, 1.0, *_gsparams));
+    void VonKarmanInfo::write(std::ostream& os) const
+    {
+        WriteValue(os, _stepk);
+        WriteValue(os, _hlr);
+        WriteTable(os, _radial);
+    }
+
+    bool VonKarmanInfo::read(std::istream& is)
+    {
+        double stepk, hlr;
+        if (!(ReadValue(is, stepk) && ReadValue(is, hlr) && ReadTable(is, _radial)))
+            return false;
+        _stepk = stepk;
+        _hlr = hlr;
+        return true;
     }
 
     void VonKarmanInfo::shoot(PhotonArray& photons, UniformDeviate ud) const
@@ -353,8 +398,14 @@ namespace galsim {
         _sampler->shoot(photons,ud);
     }
 
+    size_t VonKarmanInfo::getMemorySize() const
+    {
+        return (sizeof(*this) + _radial.getMemorySize() - sizeof(_radial) +
+                (_sampler ? _sampler->getMemorySize() : 0));
+    }
+
     LRUCache<Tuple<double,double,bool,GSParamsPtr>,VonKarmanInfo>
-        SBVonKarman::SBVonKarmanImpl::cache(sbp::max_vonKarman_cache);
+        SBVonKarman::SBVonKarmanImpl::cache(sbp::max_vonKarman_cache, "VonKarman");
 
     //
     //
@@ -0,0 +1,155 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+//#define DEBUGLOGGING
+
+#include <atomic>
+#include <stdint.h>
+
+#include "ScratchArena.h"
+
+namespace galsim {
+
+    // The smallest block we bother getting from the system.  Most stamps fit in this
+    // with room to spare, so usually there is only ever one system allocation per thread.
+    static const size_t min_block_size = 64 * 1024;
+
+    // The statistics are kept globally rather than per arena so that the values include
+    // the work done in OpenMP threads.  Relaxed atomics are plenty for simple counters.
+    static std::atomic<long> stat_nalloc(0);
+    static std::atomic<long> stat_nbytes(0);
+    static std::atomic<long> stat_nsys_alloc(0);
+    static std::atomic<long> stat_nsys_bytes(0);
+
+    static inline size_t RoundUp16(size_t n) { return (n + 15) & ~size_t(15); }
+
+    ScratchArena& ScratchArena::instance()
+    {
+        static thread_local ScratchArena arena;
+        return arena;
+    }
+
+    ScratchArena::~ScratchArena()
+    {
+        for (size_t k=0; k<_blocks.size(); ++k) delete [] _blocks[k].mem;
+    }
+
+    void* ScratchArena::allocate(size_t nbytes)
+    {
+        nbytes = RoundUp16(nbytes);
+        stat_nalloc.fetch_add(1, std::memory_order_relaxed);
+        stat_nbytes.fetch_add(nbytes, std::memory_order_relaxed);
+
+        if (_blocks.empty() || _blocks.back().used + nbytes > _blocks.back().size) {
+            // Need a new block.  Make it at least as large as everything we already have,
+            // so the number of blocks stays logarithmic in the high-water mark.
+            size_t size = std::max(RoundUp16(nbytes), std::max(min_block_size, getCapacity()));
+            xdbg<<"ScratchArena: new block of "<<size<<" bytes\n";
+            Block block;
+            // Same alignment trick as BaseImage::allocateMem.
+            block.mem = new char[size + 15];
+            block.start = reinterpret_cast<char*>(
+                (uintptr_t)(block.mem + 15) & ~(uintptr_t) 0x0F);
+            block.size = size;
+            block.used = 0;
+            _blocks.push_back(block);
+            stat_nsys_alloc.fetch_add(1, std::memory_order_relaxed);
+            stat_nsys_bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+
+        Block& block = _blocks.back();
+        Mark mark;
+        mark.p = block.start + block.used;
+        mark.iblock = _blocks.size()-1;
+        mark.used = block.used;
+        _marks.push_back(mark);
+        block.used += nbytes;
+        return mark.p;
+    }
+
+    void ScratchArena::release(void* p)
+    {
+        assert(!_marks.empty());
+        assert(_marks.back().p == p);
+        const Mark& mark = _marks.back();
+        _blocks[mark.iblock].used = mark.used;
+        _marks.pop_back();
+
+        // When the arena is empty, merge any blocks that were added while it was growing,
+        // so next time the whole working set fits in one block.
+        if (_marks.empty() && _blocks.size() > 1) consolidate();
+    }
+
+    void ScratchArena::consolidate()
+    {
+        assert(_marks.empty());
+        size_t size = getCapacity();
+        clear();
+        xdbg<<"ScratchArena: consolidate into "<<size<<" bytes\n";
+        Block block;
+        block.mem = new char[size + 15];
+        block.start = reinterpret_cast<char*>((uintptr_t)(block.mem + 15) & ~(uintptr_t) 0x0F);
+        block.size = size;
+        block.used = 0;
+        _blocks.push_back(block);
+        stat_nsys_alloc.fetch_add(1, std::memory_order_relaxed);
+        stat_nsys_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void ScratchArena::clear()
+    {
+        if (!_marks.empty())
+            throw std::runtime_error("Cannot clear a ScratchArena with active allocations");
+        for (size_t k=0; k<_blocks.size(); ++k) delete [] _blocks[k].mem;
+        _blocks.clear();
+    }
+
+    size_t ScratchArena::getCapacity() const
+    {
+        size_t size = 0;
+        for (size_t k=0; k<_blocks.size(); ++k) size += _blocks[k].size;
+        return size;
+    }
+
+    size_t ScratchArena::getInUse() const
+    {
+        size_t used = 0;
+        for (size_t k=0; k<_blocks.size(); ++k) used += _blocks[k].used;
+        return used;
+    }
+
+    ScratchArenaStats ScratchArena::getStats()
+    {
+        ScratchArenaStats stats;
+        stats.nalloc = stat_nalloc.load(std::memory_order_relaxed);
+        stats.nbytes = stat_nbytes.load(std::memory_order_relaxed);
+        stats.nsys_alloc = stat_nsys_alloc.load(std::memory_order_relaxed);
+        stats.nsys_bytes = stat_nsys_bytes.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void ScratchArena::resetStats()
+    {
+        stat_nalloc.store(0, std::memory_order_relaxed);
+        stat_nbytes.store(0, std::memory_order_relaxed);
+        stat_nsys_alloc.store(0, std::memory_order_relaxed);
+        stat_nsys_bytes.store(0, std::memory_order_relaxed);
+    }
+
+}
@@ -23,6 +23,8 @@
 #include <vector>
 #include <iostream>
 #include <deque>
+#include <mutex>
+#include <stdint.h>
 
 #ifdef USE_TMV
 #include "TMV.h"
@@ -45,6 +47,7 @@ namespace galsim {
         ArgVec(const double* args, int n);
 
         int upperIndex(double a) const;
+        int upperIndex(double a, int& hint) const;
         void upperIndexMany(const double* a, int* idx, int N) const;
 
         // A few things to look similar to a vector<dobule>
@@ -62,7 +65,6 @@ namespace galsim {
         double _lower_slop, _upper_slop;
         bool _equalSpaced;
         double _da;
-        mutable int _lastIndex;
     };
 
     ArgVec::ArgVec(const double* vec, int n): _vec(vec), _n(n)
@@ -74,13 +76,36 @@ namespace galsim {
         for (int i=1; i<_n; i++) {
             if (std::abs((_vec[i] - _vec[0])/_da - i) > tolerance) _equalSpaced = false;
         }
-        _lastIndex = 1;
         _lower_slop = (_vec[1]-_vec[0]) * 1.e-6;
         _upper_slop = (_vec[_n-1]-_vec[_n-2]) * 1.e-6;
     }
 
-    // Look up an index.  Use STL binary search.
+    // Each thread keeps its own hints of where its last lookups landed, so lookups are safe
+    // to do from multiple threads at once, and successive nearby lookups are still fast.
+    // The hints are kept in a small table indexed by the address of the ArgVec.  A collision,
+    // or a stale entry from an ArgVec that has since been deleted, just means starting from
+    // a bad hint, which costs a binary search.
+    struct ArgVecHint
+    {
+        const void* vec;
+        int index;
+    };
+    static const int n_hints = 16;
+    static thread_local ArgVecHint arg_hints[n_hints];
+
     int ArgVec::upperIndex(double a) const
+    {
+        ArgVecHint& h = arg_hints[(uintptr_t(this) / sizeof(ArgVec)) % n_hints];
+        if (h.vec != this) {
+            h.vec = this;
+            h.index = 1;
+        }
+        return upperIndex(a, h.index);
+    }
+
+    // Look up an index.  Use STL binary search.
+    // hint is where to start looking, which is updated to the index that is found.
+    int ArgVec::upperIndex(double a, int& hint) const
     {
         // check for slop
         if (a < front()) return 1;
@@ -97,45 +122,43 @@ namespace galsim {
             return i;
         } else {
             xdbg<<"Not equal spaced\n";
-            xdbg<<"lastIndex = "<<_lastIndex<<"  "<<_vec[_lastIndex-1]<<" "<<_vec[_lastIndex]<<std::endl;
-            xassert(_lastIndex >= 1);
-            xassert(_lastIndex < _n);
+            if (hint < 1 || hint >= _n) hint = 1;  // e.g. a hint for a different table.
+            xdbg<<"hint = "<<hint<<"  "<<_vec[hint-1]<<" "<<_vec[hint]<<std::endl;
 
-            if ( a < _vec[_lastIndex-1] ) {
+            if ( a < _vec[hint-1] ) {
                 xdbg<<"Go lower\n";
-                xassert(_lastIndex-2 >= 0);
+                xassert(hint-2 >= 0);
                 // Check to see if the previous one is it.
-                if (a >= _vec[_lastIndex-2]) {
-                    xdbg<<"Previous works: "<<_vec[_lastIndex-2]<<std::endl;
-                    return --_lastIndex;
+                if (a >= _vec[hint-2]) {
+                    xdbg<<"Previous works: "<<_vec[hint-2]<<std::endl;
+                    return --hint;
                 } else {
-                    // Look for the entry from 0.._lastIndex-1:
-                    const double* p = std::upper_bound(begin(), begin()+_lastIndex-1, a);
+                    // Look for the entry from 0..hint-1:
+                    const double* p = std::upper_bound(begin(), begin()+hint-1, a);
                     xassert(p != begin());
-                    xassert(p != begin()+_lastIndex-1);
-                    _lastIndex = p-begin();
-                    xdbg<<"Success: "<<_lastIndex<<"  "<<_vec[_lastIndex]<<std::endl;
-                    return _lastIndex;
+                    xassert(p != begin()+hint-1);
+                    hint = p-begin();
+                    xdbg<<"Success: "<<hint<<"  "<<_vec[hint]<<std::endl;
+                    return hint;
                 }
-            } else if (a > _vec[_lastIndex]) {
-                xassert(_lastIndex+1 < _n);
+            } else if (a > _vec[hint]) {
+                xassert(hint+1 < _n);
                 // Check to see if the next one is it.
-                if (a <= _vec[_lastIndex+1]) {
-                    xdbg<<"Next works: "<<_vec[_lastIndex+1]<<std::endl;
-                    return ++_lastIndex;
+                if (a <= _vec[hint+1]) {
+                    xdbg<<"Next works: "<<_vec[hint+1]<<std::endl;
+                    return ++hint;
                 } else {
-                    // Look for the entry from _lastIndex..end
-                    const double* p = std::lower_bound(begin()+_lastIndex+1, end(), a);
-                    xassert(p != begin()+_lastIndex+1);
+                    // Look for the entry from hint..end
+                    const double* p = std::lower_bound(begin()+hint+1, end(), a);
+                    xassert(p != begin()+hint+1);
                     xassert(p != end());
-                    _lastIndex = p-begin();
-                    xdbg<<"Success: "<<_lastIndex<<"  "<<_vec[_lastIndex]<<std::endl;
-                    return _lastIndex;
+                    hint = p-begin();
+                    xdbg<<"Success: "<<hint<<"  "<<_vec[hint]<<std::endl;
+                    return hint;
                 }
             } else {
-                xdbg<<"lastindex is still good.\n";
-                // Then _lastIndex is correct.
-                return _lastIndex;
+                xdbg<<"hint is still good.\n";
+                return hint;
             }
         }
     }
@@ -181,7 +204,14 @@ namespace galsim {
                         upperBound = lowerBound;
                         lowerBound = _vec[idx-1];
                     } else {
-                        const double* p = std::upper_bound(begin(), begin()+idx-1, a[k]);
+                        // Likewise, gallop backward for input sorted in decreasing order.
+                        int hi = idx-2;
+                        int lo = std::max(hi-2, 0);
+                        for (int step=4; lo > 0 && _vec[lo] > a[k]; step*=2) {
+                            hi = lo;
+                            lo = std::max(hi-step, 0);
+                        }
+                        const double* p = std::upper_bound(begin()+lo+1, begin()+hi+1, a[k]);
                         xassert(p != begin());
                         xassert(p != begin()+idx-1);
                         idx = p-begin();
@@ -200,7 +230,15 @@ namespace galsim {
                         lowerBound = upperBound;
                         upperBound = _vec[idx];
                     } else {
-                        const double* p = std::lower_bound(begin()+idx+1, end(), a[k]);
+                        // The input is often sorted, so gallop forward from the current
+                        // index rather than searching all the way to the end.
+                        int lo = idx+1;
+                        int hi = std::min(lo+2, _n-1);
+                        for (int step=4; hi < _n-1 && _vec[hi] < a[k]; step*=2) {
+                            lo = hi;
+                            hi = std::min(lo+step, _n-1);
+                        }
+                        const double* p = std::lower_bound(begin()+lo+1, begin()+hi+1, a[k]);
                         xassert(p != begin()+idx+1);
                         xassert(p != end());
                         idx = p-begin();
@@ -254,11 +292,32 @@ namespace galsim {
         }
 
         void interpMany(const double* xvec, double* valvec, int N) const override {
-            std::vector<int> indices(N);
-            _args.upperIndexMany(xvec, indices.data(), N);
+            // Work in blocks, so the indices stay in cache.  upperIndexMany doesn't keep any
+            // state between calls, so the blocks are independent, and large arrays can be
+            // split across threads.
+            const int nblocks = (N + block_size - 1) / block_size;
+#ifdef _OPENMP
+#pragma omp parallel for if (N > 100000)
+#endif
+            for (int b=0; b<nblocks; b++) {
+                const int k0 = b * block_size;
+                const int n = std::min<int>(block_size, N-k0);
+                int indices[block_size];
+                _args.upperIndexMany(xvec+k0, indices, n);
+                interpBlock(xvec+k0, indices, valvec+k0, n);
+            }
+        }
 
-            for (int k=0; k<N; k++) {
-                valvec[k] = static_cast<const T*>(this)->interp(xvec[k], indices[k]);
+    private:
+        // An enum rather than a static const int, so std::min doesn't need a definition of it.
+        enum { block_size = 1024 };
+
+        // Kept as a separate loop with no other work in it, so the compiler can inline and
+        // vectorize the interp calls.
+        void interpBlock(const double* xvec, const int* indices, double* valvec, int n) const {
+            const T* self = static_cast<const T*>(this);
+            for (int k=0; k<n; k++) {
+                valvec[k] = self->interp(xvec[k], indices[k]);
             }
         }
     };
@@ -552,6 +611,10 @@ namespace galsim {
                                   double* dfdxvec, double* dfdyvec, int N) const = 0;
         virtual void gradientGrid(const double* xvec, const double* yvec,
                                   double* dfdxvec, double* dfdyvec, int Nx, int Ny) const = 0;
+        virtual void interpGradMany(const double* xvec, const double* yvec, double* valvec,
+                                    double* dfdxvec, double* dfdyvec, int N) const = 0;
+        virtual void interpGradGrid(const double* xvec, const double* yvec, double* valvec,
+                                    double* dfdxvec, double* dfdyvec, int Nx, int Ny) const = 0;
         virtual ~Table2DImpl() {}
     protected:
         const ArgVec _xargs;
@@ -566,6 +629,12 @@ namespace galsim {
     public:
         using Table2D::Table2DImpl::Table2DImpl;
 
+        // Whether T implements grad.  For the ones that don't, grad throws an exception.
+        static const bool has_grad = true;
+        // Whether T::interp uses a cache shared by all threads, so it's not worth splitting
+        // the work across threads.
+        static const bool has_cache = false;
+
         double lookup(double x, double y) const {
             int i = _xargs.upperIndex(x);
             int j = _yargs.upperIndex(y);
@@ -573,31 +642,17 @@ namespace galsim {
         }
 
         void interpMany(const double* xvec, const double* yvec, double* valvec, int N) const {
-            std::vector<int> xindices(N);
-            std::vector<int> yindices(N);
-            _xargs.upperIndexMany(xvec, xindices.data(), N);
-            _yargs.upperIndexMany(yvec, yindices.data(), N);
-
-            for (int k=0; k<N; k++) {
-                valvec[k] = static_cast<const T*>(this)->interp(
-                    xvec[k], yvec[k], xindices[k], yindices[k]
-                );
-            }
+            const T* self = static_cast<const T*>(this);
+            forEachPoint(xvec, yvec, N, [&](int k, int i, int j) {
+                valvec[k] = self->interp(xvec[k], yvec[k], i, j);
+            });
         }
 
         void interpGrid(const double* xvec, const double* yvec, double* valvec, int Nx, int Ny) const {
-            std::vector<int> xindices(Nx);
-            std::vector<int> yindices(Ny);
-            _xargs.upperIndexMany(xvec, xindices.data(), Nx);
-            _yargs.upperIndexMany(yvec, yindices.data(), Ny);
-
-            for (int kx=0, k=0; kx<Nx; kx++) {
-                for (int ky=0; ky<Ny; ky++, k++) {
-                    valvec[k] = static_cast<const T*>(this)->interp(
-                        xvec[kx], yvec[ky], xindices[kx], yindices[ky]
-                    );
-                }
-            }
+            const T* self = static_cast<const T*>(this);
+            forEachRow(xvec, yvec, Nx, Ny, [&](int kx, int i, const int* yindices) {
+                self->interpRow(xvec[kx], i, yvec, yindices, valvec + size_t(kx)*Ny, Ny);
+            });
         }
 
         void gradient(double x, double y, double& dfdx, double& dfdy) const {
@@ -608,40 +663,130 @@ namespace galsim {
 
         void gradientMany(const double* xvec, const double* yvec,
                           double* dfdxvec, double* dfdyvec, int N) const {
-            std::vector<int> xindices(N);
-            std::vector<int> yindices(N);
-            _xargs.upperIndexMany(xvec, xindices.data(), N);
-            _yargs.upperIndexMany(yvec, yindices.data(), N);
+            checkGrad();
+            const T* self = static_cast<const T*>(this);
+            forEachPoint(xvec, yvec, N, [&](int k, int i, int j) {
+                self->grad(xvec[k], yvec[k], i, j, dfdxvec[k], dfdyvec[k]);
+            });
+        }
 
-            for (int k=0; k<N; k++) {
+        void gradientGrid(const double* xvec, const double* yvec,
+                          double* dfdxvec, double* dfdyvec, int Nx, int Ny) const {
+            checkGrad();
+            const T* self = static_cast<const T*>(this);
+            forEachRow(xvec, yvec, Nx, Ny, [&](int kx, int i, const int* yindices) {
+                self->gradRow(xvec[kx], i, yvec, yindices,
+                              dfdxvec + size_t(kx)*Ny, dfdyvec + size_t(kx)*Ny, Ny);
+            });
+        }
+
+        void interpGradMany(const double* xvec, const double* yvec, double* valvec,
+                            double* dfdxvec, double* dfdyvec, int N) const {
+            checkGrad();
+            const T* self = static_cast<const T*>(this);
+            forEachPoint(xvec, yvec, N, [&](int k, int i, int j) {
+                self->interpGrad(xvec[k], yvec[k], i, j, valvec[k], dfdxvec[k], dfdyvec[k]);
+            });
+        }
+
+        void interpGradGrid(const double* xvec, const double* yvec, double* valvec,
+                            double* dfdxvec, double* dfdyvec, int Nx, int Ny) const {
+            checkGrad();
+            const T* self = static_cast<const T*>(this);
+            forEachRow(xvec, yvec, Nx, Ny, [&](int kx, int i, const int* yindices) {
+                const size_t k = size_t(kx)*Ny;
+                self->interpGradRow(xvec[kx], i, yvec, yindices,
+                                    valvec + k, dfdxvec + k, dfdyvec + k, Ny);
+            });
+        }
+
+        // The rest are the default implementations of the calculations for a single point or
+        // a single row of a grid.  T can provide faster versions of these, e.g. ones that
+        // only do the x part of the calculation once per row.
+
+        void interpGrad(double x, double y, int i, int j,
+                        double& val, double& dfdx, double& dfdy) const {
+            val = static_cast<const T*>(this)->interp(x, y, i, j);
+            static_cast<const T*>(this)->grad(x, y, i, j, dfdx, dfdy);
+        }
+
+        void interpRow(double x, int i, const double* yvec, const int* yindices,
+                       double* valvec, int Ny) const {
+            for (int ky=0; ky<Ny; ky++) {
+                valvec[ky] = static_cast<const T*>(this)->interp(x, yvec[ky], i, yindices[ky]);
+            }
+        }
+
+        void gradRow(double x, int i, const double* yvec, const int* yindices,
+                     double* dfdxvec, double* dfdyvec, int Ny) const {
+            for (int ky=0; ky<Ny; ky++) {
                 static_cast<const T*>(this)->grad(
-                    xvec[k], yvec[k], xindices[k], yindices[k], dfdxvec[k], dfdyvec[k]
-                );
+                    x, yvec[ky], i, yindices[ky], dfdxvec[ky], dfdyvec[ky]);
             }
         }
 
-        void gradientGrid(const double* xvec, const double* yvec,
-                          double* dfdxvec, double* dfdyvec, int Nx, int Ny) const {
+        void interpGradRow(double x, int i, const double* yvec, const int* yindices,
+                           double* valvec, double* dfdxvec, double* dfdyvec, int Ny) const {
+            for (int ky=0; ky<Ny; ky++) {
+                static_cast<const T*>(this)->interpGrad(
+                    x, yvec[ky], i, yindices[ky], valvec[ky], dfdxvec[ky], dfdyvec[ky]);
+            }
+        }
+
+    private:
+        // An enum rather than a static const int, so std::min doesn't need a definition of it.
+        enum { block_size = 1024 };
+
+        // For interpolants without a gradient, let grad throw its exception before we start,
+        // since it can't propagate out of an OpenMP region.
+        void checkGrad() const {
+            if (!T::has_grad) {
+                double dfdx, dfdy;
+                static_cast<const T*>(this)->grad(0., 0., 1, 1, dfdx, dfdy);
+            }
+        }
+
+        // Call f(k, i, j) for each point k, where i,j are the upper indices of (x[k], y[k]).
+        // The indices are found a block at a time, so they stay in cache, and the blocks are
+        // split across threads for large N.
+        template <class F>
+        void forEachPoint(const double* xvec, const double* yvec, int N, F f) const {
+            const int nblocks = (N + block_size - 1) / block_size;
+#ifdef _OPENMP
+#pragma omp parallel for if (!T::has_cache && N > 10000)
+#endif
+            for (int b=0; b<nblocks; b++) {
+                const int k0 = b * block_size;
+                const int n = std::min<int>(block_size, N-k0);
+                int xindices[block_size];
+                int yindices[block_size];
+                _xargs.upperIndexMany(xvec+k0, xindices, n);
+                _yargs.upperIndexMany(yvec+k0, yindices, n);
+                for (int k=0; k<n; k++) f(k0+k, xindices[k], yindices[k]);
+            }
+        }
+
+        // Call f(kx, i, yindices) for each row of the grid.  The indices along each axis are
+        // only found once, and the rows are split across threads for large grids.
+        template <class F>
+        void forEachRow(const double* xvec, const double* yvec, int Nx, int Ny, F f) const {
             std::vector<int> xindices(Nx);
             std::vector<int> yindices(Ny);
             _xargs.upperIndexMany(xvec, xindices.data(), Nx);
             _yargs.upperIndexMany(yvec, yindices.data(), Ny);
-
-            for (int kx=0, k=0; kx<Nx; kx++) {
-                for (int ky=0; ky<Ny; ky++, k++) {
-                    static_cast<const T*>(this)->grad(
-                        xvec[kx], yvec[ky], xindices[kx], yindices[ky], dfdxvec[k], dfdyvec[k]
-                    );
-                }
-            }
+            const int* yind = yindices.data();
+#ifdef _OPENMP
+#pragma omp parallel for if (!T::has_cache && size_t(Nx)*Ny > 10000)
+#endif
+            for (int kx=0; kx<Nx; kx++) f(kx, xindices[kx], yind);
         }
-
     };
 
 
     class T2DFloor : public T2DCRTP<T2DFloor> {
     public:
         using T2DCRTP::T2DCRTP;
+        static const bool has_grad = false;
 
         double interp(double x, double y, int i, int j) const {
             // From upperIndex, it is only guaranteed that _xargs[i-1] <= x <= _xargs[i] (and similarly y).
@@ -661,6 +806,7 @@ namespace galsim {
     class T2DCeil : public T2DCRTP<T2DCeil> {
     public:
         using T2DCRTP::T2DCRTP;
+        static const bool has_grad = false;
 
         double interp(double x, double y, int i, int j) const {
             if (x == _xargs[i-1]) i--;
@@ -677,6 +823,7 @@ namespace galsim {
     class T2DNearest : public T2DCRTP<T2DNearest> {
     public:
         using T2DCRTP::T2DCRTP;
+        static const bool has_grad = false;
 
         double interp(double x, double y, int i, int j) const {
             if ((x - _xargs[i-1]) < (_xargs[i] - x)) i--;
@@ -695,8 +842,57 @@ namespace galsim {
         using T2DCRTP::T2DCRTP;
 
         double interp(double x, double y, int i, int j) const {
-            double ax = (_xargs[i] - x) / (_xargs[i] - _xargs[i-1]);
-            double ay = (_yargs[j] - y) / (_yargs[j] - _yargs[j-1]);
+            return linearValue(weight(_xargs, x, i), weight(_yargs, y, j), i, j);
+        }
+
+        void grad(double x, double y, int i, int j, double& dfdx, double& dfdy) const {
+            linearGrad(weight(_xargs, x, i), weight(_yargs, y, j), i, j, dfdx, dfdy);
+        }
+
+        void interpGrad(double x, double y, int i, int j,
+                        double& val, double& dfdx, double& dfdy) const {
+            double ax = weight(_xargs, x, i);
+            double ay = weight(_yargs, y, j);
+            val = linearValue(ax, ay, i, j);
+            linearGrad(ax, ay, i, j, dfdx, dfdy);
+        }
+
+        void interpRow(double x, int i, const double* yvec, const int* yindices,
+                       double* valvec, int Ny) const {
+            const double ax = weight(_xargs, x, i);
+            for (int ky=0; ky<Ny; ky++) {
+                const int j = yindices[ky];
+                valvec[ky] = linearValue(ax, weight(_yargs, yvec[ky], j), i, j);
+            }
+        }
+
+        void gradRow(double x, int i, const double* yvec, const int* yindices,
+                     double* dfdxvec, double* dfdyvec, int Ny) const {
+            const double ax = weight(_xargs, x, i);
+            for (int ky=0; ky<Ny; ky++) {
+                const int j = yindices[ky];
+                linearGrad(ax, weight(_yargs, yvec[ky], j), i, j, dfdxvec[ky], dfdyvec[ky]);
+            }
+        }
+
+        void interpGradRow(double x, int i, const double* yvec, const int* yindices,
+                           double* valvec, double* dfdxvec, double* dfdyvec, int Ny) const {
+            const double ax = weight(_xargs, x, i);
+            for (int ky=0; ky<Ny; ky++) {
+                const int j = yindices[ky];
+                const double ay = weight(_yargs, yvec[ky], j);
+                valvec[ky] = linearValue(ax, ay, i, j);
+                linearGrad(ax, ay, i, j, dfdxvec[ky], dfdyvec[ky]);
+            }
+        }
+
+    private:
+        // The weight of the lower grid point.
+        static double weight(const ArgVec& args, double x, int i) {
+            return (args[i] - x) / (args[i] - args[i-1]);
+        }
+
+        double linearValue(double ax, double ay, int i, int j) const {
             double bx = 1.0 - ax;
             double by = 1.0 - ay;
 
@@ -706,16 +902,14 @@ namespace galsim {
                     + _vals[i*_ny+j] * bx * by);
         }
 
-        void grad(double x, double y, int i, int j, double& dfdx, double& dfdy) const {
+        void linearGrad(double ax, double ay, int i, int j, double& dfdx, double& dfdy) const {
             double dx = _xargs[i] - _xargs[i-1];
             double dy = _yargs[j] - _yargs[j-1];
             double f00 = _vals[(i-1)*_ny+j-1];
             double f01 = _vals[(i-1)*_ny+j];
             double f10 = _vals[i*_ny+j-1];
             double f11 = _vals[i*_ny+j];
-            double ax = (_xargs[i] - x) / (_xargs[i] - _xargs[i-1]);
             double bx = 1.0 - ax;
-            double ay = (_yargs[j] - y) / (_yargs[j] - _yargs[j-1]);
             double by = 1.0 - ay;
             dfdx = ( (f10-f00)*ay + (f11-f01)*by ) / dx;
             dfdy = ( (f01-f00)*ax + (f11-f10)*bx ) / dy;
@@ -730,77 +924,120 @@ namespace galsim {
             T2DCRTP<T2DSpline>(xargs, yargs, vals, Nx, Ny), _dfdx(dfdx), _dfdy(dfdy), _d2fdxdy(d2fdxdy) {}
 
         double interp(double x, double y, int i, int j) const {
-            double dxgrid = _xargs[i] - _xargs[i-1];
-            double dygrid = _yargs[j] - _yargs[j-1];
-            double dx = (x - _xargs[i-1])/dxgrid;
-            double dy = (y - _yargs[j-1])/dygrid;
-
-            // Need to first interpolate the y-values and the y-derivatives in the x direction.
-            double val0 = oneDSpline(dx, _vals[(i-1)*_ny+j-1], _vals[i*_ny+j-1],
-                                     _dfdx[(i-1)*_ny+j-1]*dxgrid, _dfdx[i*_ny+j-1]*dxgrid);
-            double val1 = oneDSpline(dx, _vals[(i-1)*_ny+j], _vals[i*_ny+j],
-                                     _dfdx[(i-1)*_ny+j]*dxgrid, _dfdx[i*_ny+j]*dxgrid);
-            double der0 = oneDSpline(dx, _dfdy[(i-1)*_ny+j-1], _dfdy[i*_ny+j-1],
-                                     _d2fdxdy[(i-1)*_ny+j-1]*dxgrid, _d2fdxdy[i*_ny+j-1]*dxgrid);
-            double der1 = oneDSpline(dx, _dfdy[(i-1)*_ny+j], _dfdy[i*_ny+j],
-                                     _d2fdxdy[(i-1)*_ny+j]*dxgrid, _d2fdxdy[i*_ny+j]*dxgrid);
-
-            return oneDSpline(dy, val0, val1, der0*dygrid, der1*dygrid);
+            double wx[4], wy[4];
+            hermite(_xargs, x, i, wx);
+            hermite(_yargs, y, j, wy);
+            return combine(wx, wy, i, j);
         }
 
         void grad(double x, double y, int i, int j, double& dfdx, double& dfdy) const {
-            double dxgrid = _xargs[i] - _xargs[i-1];
-            double dygrid = _yargs[j] - _yargs[j-1];
-            double dx = (x - _xargs[i-1])/dxgrid;
-            double dy = (y - _yargs[j-1])/dygrid;
+            double wx[4], wy[4], gx[4], gy[4];
+            hermite(_xargs, x, i, wx, gx);
+            hermite(_yargs, y, j, wy, gy);
+            dfdx = combine(gx, wy, i, j);
+            dfdy = combine(wx, gy, i, j);
+        }
 
-            // xgradient;
-            double val0 = oneDGrad(dx, _vals[(i-1)*_ny+j-1], _vals[i*_ny+j-1],
-                                   _dfdx[(i-1)*_ny+j-1]*dxgrid, _dfdx[i*_ny+j-1]*dxgrid);
-            double val1 = oneDGrad(dx, _vals[(i-1)*_ny+j], _vals[i*_ny+j],
-                                   _dfdx[(i-1)*_ny+j]*dxgrid, _dfdx[i*_ny+j]*dxgrid);
-            double der0 = oneDGrad(dx, _dfdy[(i-1)*_ny+j-1], _dfdy[i*_ny+j-1],
-                                   _d2fdxdy[(i-1)*_ny+j-1]*dxgrid, _d2fdxdy[i*_ny+j-1]*dxgrid);
-            double der1 = oneDGrad(dx, _dfdy[(i-1)*_ny+j], _dfdy[i*_ny+j],
-                                   _d2fdxdy[(i-1)*_ny+j]*dxgrid, _d2fdxdy[i*_ny+j]*dxgrid);
-            dfdx = oneDSpline(dy, val0, val1, der0*dygrid, der1*dygrid)/dxgrid;
-
-            // ygradient
-            val0 = oneDGrad(dy, _vals[(i-1)*_ny+j-1], _vals[(i-1)*_ny+j],
-                            _dfdy[(i-1)*_ny+j-1]*dygrid, _dfdy[(i-1)*_ny+j]*dygrid);
-            val1 = oneDGrad(dy, _vals[i*_ny+j-1], _vals[i*_ny+j],
-                            _dfdy[i*_ny+j-1]*dygrid, _dfdy[i*_ny+j]*dygrid);
-            der0 = oneDGrad(dy, _dfdx[(i-1)*_ny+j-1], _dfdx[(i-1)*_ny+j],
-                            _d2fdxdy[(i-1)*_ny+j-1]*dygrid, _d2fdxdy[(i-1)*_ny+j]*dygrid);
-            der1 = oneDGrad(dy, _dfdx[i*_ny+j-1], _dfdx[i*_ny+j],
-                            _d2fdxdy[i*_ny+j-1]*dygrid, _d2fdxdy[i*_ny+j]*dygrid);
-            dfdy = oneDSpline(dx, val0, val1, der0*dxgrid, der1*dxgrid)/dygrid;
+        void interpGrad(double x, double y, int i, int j,
+                        double& val, double& dfdx, double& dfdy) const {
+            double wx[4], wy[4], gx[4], gy[4];
+            hermite(_xargs, x, i, wx, gx);
+            hermite(_yargs, y, j, wy, gy);
+            val = combine(wx, wy, i, j);
+            dfdx = combine(gx, wy, i, j);
+            dfdy = combine(wx, gy, i, j);
         }
+
+        void interpRow(double x, int i, const double* yvec, const int* yindices,
+                       double* valvec, int Ny) const {
+            double wx[4], wy[4];
+            hermite(_xargs, x, i, wx);
+            for (int ky=0; ky<Ny; ky++) {
+                const int j = yindices[ky];
+                hermite(_yargs, yvec[ky], j, wy);
+                valvec[ky] = combine(wx, wy, i, j);
+            }
+        }
+
+        void gradRow(double x, int i, const double* yvec, const int* yindices,
+                     double* dfdxvec, double* dfdyvec, int Ny) const {
+            double wx[4], wy[4], gx[4], gy[4];
+            hermite(_xargs, x, i, wx, gx);
+            for (int ky=0; ky<Ny; ky++) {
+                const int j = yindices[ky];
+                hermite(_yargs, yvec[ky], j, wy, gy);
+                dfdxvec[ky] = combine(gx, wy, i, j);
+                dfdyvec[ky] = combine(wx, gy, i, j);
+            }
+        }
+
+        void interpGradRow(double x, int i, const double* yvec, const int* yindices,
+                           double* valvec, double* dfdxvec, double* dfdyvec, int Ny) const {
+            double wx[4], wy[4], gx[4], gy[4];
+            hermite(_xargs, x, i, wx, gx);
+            for (int ky=0; ky<Ny; ky++) {
+                const int j = yindices[ky];
+                hermite(_yargs, yvec[ky], j, wy, gy);
+                valvec[ky] = combine(wx, wy, i, j);
+                dfdxvec[ky] = combine(gx, wy, i, j);
+                dfdyvec[ky] = combine(wx, gy, i, j);
+            }
+        }
+
     private:
 
-        double oneDSpline(double x, double val0, double val1, double der0, double der1) const {
-            // assuming that x is between 0 and 1, val0 and val1 are the values at
-            // 0 and 1, and der0 and der1 are the derivatives at 0 and 1.
-            // Let f(x) = ax^3 + bx^2 + cx + d
-            //  => f'(x) = 3ax^2 + 2bx + c
-            //  => f(0) = d
-            //     f(1) = a + b + c + d
-            //     f'(0) = c
-            //     f'(1) = 3a + 2b + c
-            //  Solve above for a,b,c,d to obtain below:
-            double a = 2*(val0-val1) + der0 + der1;
-            double b = 3*(val1-val0) - 2*der0 - der1;
-            double c = der0;
-            double d = val0;
-
-            return d + x*(c + x*(b + x*a));
+        // The cubic spline between args[i-1] and args[i] with values f0, f1 and derivatives
+        // f0', f1' at the two ends is
+        //     f(x) = w[0] f0 + w[1] f1 + w[2] f0' + w[3] f1'
+        // with the usual Hermite basis functions of t = (x-args[i-1])/h, h = args[i]-args[i-1]:
+        //     w[0] = 2t^3 - 3t^2 + 1
+        //     w[1] = -2t^3 + 3t^2
+        //     w[2] = (t^3 - 2t^2 + t) h
+        //     w[3] = (t^3 - t^2) h
+        // The 2d spline is the tensor product of this in each direction, so we only need
+        // to calculate these weights once for each x and each y.
+        static void hermite(const ArgVec& args, double x, int i, double* w) {
+            double h = args[i] - args[i-1];
+            double t = (x - args[i-1]) / h;
+            double t2 = t*t;
+            double t3 = t2*t;
+            w[0] = 2*t3 - 3*t2 + 1;
+            w[1] = 3*t2 - 2*t3;
+            w[2] = (t3 - 2*t2 + t) * h;
+            w[3] = (t3 - t2) * h;
         }
 
-        double oneDGrad(double x, double val0, double val1, double der0, double der1) const {
-            double a = 2*(val0-val1) + der0 + der1;
-            double b = 3*(val1-val0) - 2*der0 - der1;
-            double c = der0;
-            return c + x*(2*b + x*3*a);
+        // Also compute the weights g for f'(x), which are the derivatives of the above.
+        static void hermite(const ArgVec& args, double x, int i, double* w, double* g) {
+            double h = args[i] - args[i-1];
+            double t = (x - args[i-1]) / h;
+            double t2 = t*t;
+            double t3 = t2*t;
+            w[0] = 2*t3 - 3*t2 + 1;
+            w[1] = 3*t2 - 2*t3;
+            w[2] = (t3 - 2*t2 + t) * h;
+            w[3] = (t3 - t2) * h;
+            g[0] = 6*(t2 - t) / h;
+            g[1] = -g[0];
+            g[2] = 3*t2 - 4*t + 1;
+            g[3] = 3*t2 - 2*t;
+        }
+
+        // Apply the weights wx in the x direction and wy in the y direction.
+        double combine(const double* wx, const double* wy, int i, int j) const {
+            const int k0 = (i-1)*_ny+j-1;
+            const int k1 = i*_ny+j-1;
+
+            // First interpolate the values and the y-derivatives in the x direction.
+            double val0 = wx[0]*_vals[k0] + wx[1]*_vals[k1] + wx[2]*_dfdx[k0] + wx[3]*_dfdx[k1];
+            double val1 = wx[0]*_vals[k0+1] + wx[1]*_vals[k1+1]
+                + wx[2]*_dfdx[k0+1] + wx[3]*_dfdx[k1+1];
+            double der0 = wx[0]*_dfdy[k0] + wx[1]*_dfdy[k1]
+                + wx[2]*_d2fdxdy[k0] + wx[3]*_d2fdxdy[k1];
+            double der1 = wx[0]*_dfdy[k0+1] + wx[1]*_dfdy[k1+1]
+                + wx[2]*_d2fdxdy[k0+1] + wx[3]*_d2fdxdy[k1+1];
+
+            return wy[0]*val0 + wy[1]*val1 + wy[2]*der0 + wy[3]*der1;
         }
 
         const double* _dfdx;
@@ -815,6 +1052,9 @@ namespace galsim {
                          const Interpolant* gsinterp) :
             T2DCRTP<T2DGSInterpolant>(xargs, yargs, vals, Nx, Ny), _nx(Nx), _gsinterp(*gsinterp) {}
 
+        static const bool has_grad = false;
+        static const bool has_cache = true;
+
         double interp(double x, double y, int i, int j) const {
             double dxgrid = _xargs[i] - _xargs[i-1];
             double dygrid = _yargs[j] - _yargs[j-1];
@@ -851,59 +1091,64 @@ namespace galsim {
                 // We have the opportunity to speed up the calculation by
                 // re-using the sums over rows.  So we will keep a
                 // cache of them.
-                if (y != _cacheY || ixy != _cacheInterp) {
-                    _clearCache();
-                    _cacheY = y;
-                    _cacheInterp = ixy;
-                } else if (ixMax == ixMin && !_cache.empty()) {
+                // The cache is only useful to one caller stepping through nearby points, so if
+                // another thread is using it, just use a new one rather than waiting.
+                std::unique_lock<std::mutex> lock(_cacheMutex, std::try_to_lock);
+                InterpCache local_cache;
+                InterpCache& c = lock.owns_lock() ? _cache : local_cache;
+                if (y != c.y || ixy != c.interp) {
+                    c.clear();
+                    c.y = y;
+                    c.interp = ixy;
+                } else if (ixMax == ixMin && !c.rows.empty()) {
                     // Special case for interpolation on a single ix value:
                     // See if we already have this row in cache:
-                    int index = ixMin - _cacheStartX;
+                    int index = ixMin - c.startX;
                     // if (index < 0) index += _N;  // JM: I don't understand this line...
-                    if (index >= 0 && index < int(_cache.size()))
+                    if (index >= 0 && index < int(c.rows.size()))
                         // We have it!
-                        return _cache[index];
+                        return c.rows[index];
                     else
                         // Desired row not in cache - kill cache, continue as normal.
                         // (But don't clear ywt, since that's still good.)
-                        _cache.clear();
+                        c.rows.clear();
                 }
                 // Build y factors for interpolant
                 int ny = iyMax - iyMin + 1;
                 // This is also cached if possible.  It gets cleared with y!=cacheY above.
-                if (_ywt.empty()) {
-                    _ywt.resize(ny);
+                if (c.ywt.empty()) {
+                    c.ywt.resize(ny);
                     for (int ii=0; ii<ny; ii++) {
-                        _ywt[ii] = ixy->xval1d(j-1+dy-(ii+iyMin));
+                        c.ywt[ii] = ixy->xval1d(j-1+dy-(ii+iyMin));
                     }
                 } else {
-                    assert(int(_ywt.size()) == ny);
+                    assert(int(c.ywt.size()) == ny);
                 }
                 // cache always holds sequential x values (no wrap).  Throw away
                 // elements until we get to the one we need first
-                std::deque<double>::iterator nextSaved = _cache.begin();
-                while (nextSaved != _cache.end() && _cacheStartX != ixMin) {
-                    _cache.pop_front();
-                    ++_cacheStartX;
-                    nextSaved = _cache.begin();
+                std::deque<double>::iterator nextSaved = c.rows.begin();
+                while (nextSaved != c.rows.end() && c.startX != ixMin) {
+                    c.rows.pop_front();
+                    ++c.startX;
+                    nextSaved = c.rows.begin();
                 }
                 for (int ix=ixMin; ix<=ixMax; ix++) {
                     double sumx = 0.0;
-                    if (nextSaved != _cache.end()) {
+                    if (nextSaved != c.rows.end()) {
                         // This row is cached
                         sumx = *nextSaved;
                         ++nextSaved;
                     } else {
                         // Need to compute a new row's sum
                         const double* dptr = &_vals[ix*_ny+iyMin];
-                        std::vector<double>::const_iterator ywt_it = _ywt.begin();
+                        std::vector<double>::const_iterator ywt_it = c.ywt.begin();
                         int count = ny;
                         for(; count; --count) sumx += (*ywt_it++) * (*dptr++);
-                        xassert(ywt_it == _ywt.end());
+                        xassert(ywt_it == c.ywt.end());
                         // Add to back of cache
-                        if (_cache.empty()) _cacheStartX = ix;
-                        _cache.push_back(sumx);
-                        nextSaved = _cache.end();
+                        if (c.rows.empty()) c.startX = ix;
+                        c.rows.push_back(sumx);
+                        nextSaved = c.rows.end();
                     }
                     sum += sumx * ixy->xval1d(i-1+dx-ix);
                 }
@@ -925,16 +1170,20 @@ namespace galsim {
         const int _nx;
         const InterpolantXY _gsinterp;
 
-        void _clearCache() const {
-            _cache.clear();
-            _ywt.clear();
-        }
-
-        mutable std::deque<double> _cache;
-        mutable std::vector<double> _ywt;
-        mutable double _cacheY;
-        mutable int _cacheStartX;
-        mutable const InterpolantXY* _cacheInterp;
+        // The sums over columns for the last y value, to speed up interpolation along x.
+        struct InterpCache
+        {
+            InterpCache() : y(0.), startX(0), interp(0) {}
+            void clear() { rows.clear(); ywt.clear(); }
+
+            std::deque<double> rows;
+            std::vector<double> ywt;
+            double y;
+            int startX;
+            const InterpolantXY* interp;
+        };
+        mutable InterpCache _cache;
+        mutable std::mutex _cacheMutex;  // Protects _cache.  Other threads don't wait for it.
     };
 
 
@@ -1015,6 +1264,16 @@ namespace galsim {
         _pimpl->gradientGrid(xvec, yvec, dfdxvec, dfdyvec, Nx, Ny);
     }
 
+    void Table2D::interpGradMany(const double* xvec, const double* yvec, double* valvec,
+                                 double* dfdxvec, double* dfdyvec, int N) const {
+        _pimpl->interpGradMany(xvec, yvec, valvec, dfdxvec, dfdyvec, N);
+    }
+
+    void Table2D::interpGradGrid(const double* xvec, const double* yvec, double* valvec,
+                                 double* dfdxvec, double* dfdyvec, int Nx, int Ny) const {
+        _pimpl->interpGradGrid(xvec, yvec, valvec, dfdxvec, dfdyvec, Nx, Ny);
+    }
+
     void WrapArrayToPeriod(double* x, int n, double x0, double period)
     {
 #ifdef __SSE2__
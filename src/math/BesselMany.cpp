@@ -0,0 +1,517 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+#include "math/Bessel.h"
+#include "math/Horner.h"
+#include "ScratchArena.h"
+
+// The rational approximations used here are the double precision ones from Boost.Math
+// (boost/math/special_functions/detail/bessel_j0.hpp, etc.), which is distributed under the
+// Boost Software License, Version 1.0 (http://www.boost.org/LICENSE_1_0.txt).
+//
+// The scalar versions evaluate one value at a time with lots of branches.  Here we instead
+// sort the values in each block by which approximation they need, and then evaluate each
+// approximation over all of its values at once.  The polynomials are done with Horner, which
+// uses SSE2 instructions when available.  Values outside the ranges handled here (0, nan, very
+// large x) just use the scalar versions.
+
+namespace galsim {
+namespace math {
+
+    // Do the work in blocks of this many values, so the temporary arrays stay in cache.
+    static const int BLOCK_SIZE = 256;
+
+    // Gather the values with lo < |x| <= hi into w (as |x|) and their indices into idx.
+    // Returns the number of values found.
+    static int Select(const double* x, int n, double lo, double hi, int* idx, double* w)
+    {
+        int m = 0;
+        for (int i=0; i<n; ++i) {
+            double ax = std::abs(x[i]);
+            if (ax > lo && ax <= hi) {
+                idx[m] = i;
+                w[m] = ax;
+                ++m;
+            }
+        }
+        return m;
+    }
+
+    // result[i] = P(x[i]) / Q(x[i]).  temp needs to be the same size as x.
+    static void RationalMany(const double* x, int n, const double* P, int np,
+                             const double* Q, int nq, double* result, double* temp)
+    {
+        Horner(x, n, P, np, result);
+        Horner(x, n, Q, nq, temp);
+        for (int i=0; i<n; ++i) result[i] /= temp[i];
+    }
+
+    // s[i] = sin(x[i]), c[i] = cos(x[i]) for 0 <= x[i] < 2^19 pi.
+    // This is the fdlibm algorithm, but without branches other than the final choice of
+    // quadrant.  The reduction to [-pi/4, pi/4] uses pi/2 split into 33 bit pieces, so
+    // the products with the quadrant number are exact.
+    static void SinCosMany(const double* x, int n, double* s, double* c)
+    {
+        static const double S[] = {
+            -1.66666666666666324348e-01,
+            8.33333333332248946124e-03,
+            -1.98412698298579493134e-04,
+            2.75573137070700676789e-06,
+            -2.50507602534068634195e-08,
+            1.58969099521155010221e-10
+        };
+        static const double C[] = {
+            4.16666666666666019037e-02,
+            -1.38888888888741095749e-03,
+            2.48015872894767294178e-05,
+            -2.75573143513906633035e-07,
+            2.08757232129817482790e-09,
+            -1.13596475577881948265e-11
+        };
+        const double two_over_pi = 6.36619772367581382433e-01;
+        const double pio2_1 = 1.57079632673412561417e+00;
+        const double pio2_2 = 6.07710050630396597660e-11;
+        const double pio2_3 = 2.02226624871116645580e-21;
+        // Adding and subtracting this rounds to the nearest integer.
+        const double magic = 6755399441055744.0;  // 1.5 * 2^52
+
+        ScratchBuffer<double> r(n);
+        ScratchBuffer<double> z(n);
+        ScratchBuffer<double> ps(n);
+        ScratchBuffer<double> pc(n);
+        ScratchBuffer<int> q(n);
+        for (int i=0; i<n; ++i) {
+            double k = (x[i] * two_over_pi + magic) - magic;
+            q[i] = int(k) & 3;
+            r[i] = ((x[i] - k * pio2_1) - k * pio2_2) - k * pio2_3;
+            z[i] = r[i] * r[i];
+        }
+        Horner(z.begin(), n, S, 6, ps.begin());
+        Horner(z.begin(), n, C, 6, pc.begin());
+        for (int i=0; i<n; ++i) {
+            double sr = r[i] + r[i] * z[i] * ps[i];
+            double hz = 0.5 * z[i];
+            double w = 1. - hz;
+            double cr = w + (((1.-w) - hz) + z[i] * z[i] * pc[i]);
+            switch (q[i]) {
+              case 0: s[i] = sr; c[i] = cr; break;
+              case 1: s[i] = cr; c[i] = -sr; break;
+              case 2: s[i] = -sr; c[i] = -cr; break;
+              default: s[i] = -cr; c[i] = sr;
+            }
+        }
+    }
+
+    // The largest |x| to do with SinCosMany.  Larger values use the scalar function.
+    static const double max_sincos_x = 1.e6;
+
+    void j0Many(const double* x, double* f, int n)
+    {
+        static const double P1[] = {
+            -4.1298668500990866786e+11, 2.7282507878605942706e+10, -6.2140700423540120665e+08,
+            6.6302997904833794242e+06, -3.6629814655107086448e+04, 1.0344222815443188943e+02,
+            -1.2117036164593528341e-01
+        };
+        static const double Q1[] = {
+            2.3883787996332290397e+12, 2.6328198300859648632e+10, 1.3985097372263433271e+08,
+            4.5612696224219938200e+05, 9.3614022392337710626e+02, 1.0
+        };
+        static const double P2[] = {
+            -1.8319397969392084011e+03, -1.2254078161378989535e+04, -7.2879702464464618998e+03,
+            1.0341910641583726701e+04, 1.1725046279757103576e+04, 4.4176707025325087628e+03,
+            7.4321196680624245801e+02, 4.8591703355916499363e+01
+        };
+        static const double Q2[] = {
+            -3.5783478026152301072e+05, 2.4599102262586308984e+05, -8.4055062591169562211e+04,
+            1.8680990008359188352e+04, -2.9458766545509337327e+03, 3.3307310774649071172e+02,
+            -2.5258076240801555057e+01, 1.0
+        };
+        static const double PC[] = {
+            2.2779090197304684302e+04, 4.1345386639580765797e+04, 2.1170523380864944322e+04,
+            3.4806486443249270347e+03, 1.5376201909008354296e+02, 8.8961548424210455236e-01
+        };
+        static const double QC[] = {
+            2.2779090197304684318e+04, 4.1370412495510416640e+04, 2.1215350561880115730e+04,
+            3.5028735138235608207e+03, 1.5711159858080893649e+02, 1.0
+        };
+        static const double PS[] = {
+            -8.9226600200800094098e+01, -1.8591953644342993800e+02, -1.1183429920482737611e+02,
+            -2.2300261666214198472e+01, -1.2441026745835638459e+00, -8.8033303048680751817e-03
+        };
+        static const double QS[] = {
+            5.7105024128512061905e+03, 1.1951131543434613647e+04, 7.2642780169211018836e+03,
+            1.4887231232283756582e+03, 9.0593769594993125859e+01, 1.0
+        };
+        // The first two zeros of j0, each split into two parts.
+        const double x1 = 2.4048255576957727686e+00;
+        const double x11 = 6.160e+02;
+        const double x12 = -1.42444230422723137837e-03;
+        const double x2 = 5.5200781102863106496e+00;
+        const double x21 = 1.4130e+03;
+        const double x22 = 5.46860286310649596604e-04;
+        const double one_div_root_pi = 5.64189583547756286948e-01;
+
+        ScratchBuffer<double> xb(BLOCK_SIZE);
+        ScratchBuffer<int> idx(BLOCK_SIZE);
+        ScratchBuffer<double> w(BLOCK_SIZE);
+        ScratchBuffer<double> y(BLOCK_SIZE);
+        ScratchBuffer<double> y2(BLOCK_SIZE);
+        ScratchBuffer<double> r1(BLOCK_SIZE);
+        ScratchBuffer<double> r2(BLOCK_SIZE);
+        ScratchBuffer<double> s(BLOCK_SIZE);
+        ScratchBuffer<double> c(BLOCK_SIZE);
+        for (int i0=0; i0<n; i0+=BLOCK_SIZE) {
+            const int nb = std::min(BLOCK_SIZE, n-i0);
+            // Copy the input values, so x and f may be the same array.
+            std::copy(x+i0, x+i0+nb, xb.begin());
+            double* fb = f + i0;
+
+            // 0 < |x| <= 4
+            int m = Select(xb.begin(), nb, 0., 4., idx.begin(), w.begin());
+            for (int k=0; k<m; ++k) y[k] = w[k] * w[k];
+            RationalMany(y.begin(), m, P1, 7, Q1, 6, r1.begin(), r2.begin());
+            for (int k=0; k<m; ++k)
+                fb[idx[k]] = (w[k] + x1) * ((w[k] - x11/256) - x12) * r1[k];
+
+            // 4 < |x| <= 8
+            m = Select(xb.begin(), nb, 4., 8., idx.begin(), w.begin());
+            for (int k=0; k<m; ++k) y[k] = 1. - w[k] * w[k] / 64.;
+            RationalMany(y.begin(), m, P2, 8, Q2, 8, r1.begin(), r2.begin());
+            for (int k=0; k<m; ++k)
+                fb[idx[k]] = (w[k] + x2) * ((w[k] - x21/256) - x22) * r1[k];
+
+            // 8 < |x| <= max_sincos_x
+            // This is factor * (rc cos(x-pi/4) - y rs sin(x-pi/4)), written in terms of
+            // sin(x) and cos(x).
+            m = Select(xb.begin(), nb, 8., max_sincos_x, idx.begin(), w.begin());
+            for (int k=0; k<m; ++k) {
+                y[k] = 8. / w[k];
+                y2[k] = y[k] * y[k];
+            }
+            RationalMany(y2.begin(), m, PC, 6, QC, 6, r1.begin(), s.begin());
+            RationalMany(y2.begin(), m, PS, 6, QS, 6, r2.begin(), s.begin());
+            SinCosMany(w.begin(), m, s.begin(), c.begin());
+            for (int k=0; k<m; ++k) {
+                double factor = one_div_root_pi / std::sqrt(w[k]);
+                fb[idx[k]] = factor * (r1[k] * (c[k] + s[k]) - y[k] * r2[k] * (s[k] - c[k]));
+            }
+
+            // Anything else (0, very large, inf, nan)
+            for (int i=0; i<nb; ++i) {
+                double ax = std::abs(xb[i]);
+                if (!(ax > 0. && ax <= max_sincos_x)) fb[i] = j0(xb[i]);
+            }
+        }
+    }
+
+    void j1Many(const double* x, double* f, int n)
+    {
+        static const double P1[] = {
+            -1.4258509801366645672e+11, 6.6781041261492395835e+09, -1.1548696764841276794e+08,
+            9.8062904098958257677e+05, -4.4615792982775076130e+03, 1.0650724020080236441e+01,
+            -1.0767857011487300348e-02
+        };
+        static const double Q1[] = {
+            4.1868604460820175290e+12, 4.2091902282580133541e+10, 2.0228375140097033958e+08,
+            5.9117614494174794095e+05, 1.0742272239517380498e+03, 1.0
+        };
+        static const double P2[] = {
+            -1.7527881995806511112e+16, 1.6608531731299018674e+15, -3.6658018905416665164e+13,
+            3.5580665670910619166e+11, -1.8113931269860667829e+09, 5.0793266148011179143e+06,
+            -7.5023342220781607561e+03, 4.6179191852758252278e+00
+        };
+        static const double Q2[] = {
+            1.7253905888447681194e+18, 1.7128800897135812012e+16, 8.4899346165481429307e+13,
+            2.7622777286244082666e+11, 6.4872502899596389593e+08, 1.1267125065029138050e+06,
+            1.3886978985861357615e+03, 1.0
+        };
+        static const double PC[] = {
+            -4.4357578167941278571e+06, -9.9422465050776411957e+06, -6.6033732483649391093e+06,
+            -1.5235293511811373833e+06, -1.0982405543459346727e+05, -1.6116166443246101165e+03
+        };
+        static const double QC[] = {
+            -4.4357578167941278568e+06, -9.9341243899345856590e+06, -6.5853394797230870728e+06,
+            -1.5118095066341608816e+06, -1.0726385991103820119e+05, -1.4550094401904961825e+03,
+            1.0
+        };
+        static const double PS[] = {
+            3.3220913409857223519e+04, 8.5145160675335701966e+04, 6.6178836581270835179e+04,
+            1.8494262873223866797e+04, 1.7063754290207680021e+03, 3.5265133846636032186e+01
+        };
+        static const double QS[] = {
+            7.0871281941028743574e+05, 1.8194580422439972989e+06, 1.4194606696037208929e+06,
+            4.0029443582266975117e+05, 3.7890229745772202641e+04, 8.6383677696049909675e+02,
+            1.0
+        };
+        // The first two zeros of j1, each split into two parts.
+        const double x1 = 3.8317059702075123156e+00;
+        const double x11 = 9.810e+02;
+        const double x12 = -3.2527979248768438556e-04;
+        const double x2 = 7.0155866698156187535e+00;
+        const double x21 = 1.7960e+03;
+        const double x22 = -3.8330184381246462950e-05;
+        const double one_div_root_pi = 5.64189583547756286948e-01;
+
+        ScratchBuffer<double> xb(BLOCK_SIZE);
+        ScratchBuffer<int> idx(BLOCK_SIZE);
+        ScratchBuffer<double> w(BLOCK_SIZE);
+        ScratchBuffer<double> y(BLOCK_SIZE);
+        ScratchBuffer<double> y2(BLOCK_SIZE);
+        ScratchBuffer<double> r1(BLOCK_SIZE);
+        ScratchBuffer<double> r2(BLOCK_SIZE);
+        ScratchBuffer<double> s(BLOCK_SIZE);
+        ScratchBuffer<double> c(BLOCK_SIZE);
+        for (int i0=0; i0<n; i0+=BLOCK_SIZE) {
+            const int nb = std::min(BLOCK_SIZE, n-i0);
+            // Copy the input values, so x and f may be the same array.
+            std::copy(x+i0, x+i0+nb, xb.begin());
+            double* fb = f + i0;
+
+            // j1 is odd, so the calculations below are for |x|, and the sign is put back here.
+            // 0 < |x| <= 4
+            int m = Select(xb.begin(), nb, 0., 4., idx.begin(), w.begin());
+            for (int k=0; k<m; ++k) y[k] = w[k] * w[k];
+            RationalMany(y.begin(), m, P1, 7, Q1, 6, r1.begin(), r2.begin());
+            for (int k=0; k<m; ++k)
+                fb[idx[k]] = w[k] * (w[k] + x1) * ((w[k] - x11/256) - x12) * r1[k];
+
+            // 4 < |x| <= 8
+            m = Select(xb.begin(), nb, 4., 8., idx.begin(), w.begin());
+            for (int k=0; k<m; ++k) y[k] = w[k] * w[k];
+            RationalMany(y.begin(), m, P2, 8, Q2, 8, r1.begin(), r2.begin());
+            for (int k=0; k<m; ++k)
+                fb[idx[k]] = w[k] * (w[k] + x2) * ((w[k] - x21/256) - x22) * r1[k];
+
+            // 8 < |x| <= max_sincos_x
+            // This is factor * (rc cos(x-3pi/4) - y rs sin(x-3pi/4)), written in terms of
+            // sin(x) and cos(x).
+            m = Select(xb.begin(), nb, 8., max_sincos_x, idx.begin(), w.begin());
+            for (int k=0; k<m; ++k) {
+                y[k] = 8. / w[k];
+                y2[k] = y[k] * y[k];
+            }
+            RationalMany(y2.begin(), m, PC, 6, QC, 7, r1.begin(), s.begin());
+            RationalMany(y2.begin(), m, PS, 6, QS, 7, r2.begin(), s.begin());
+            SinCosMany(w.begin(), m, s.begin(), c.begin());
+            for (int k=0; k<m; ++k) {
+                double factor = one_div_root_pi / std::sqrt(w[k]);
+                fb[idx[k]] = factor * (r1[k] * (s[k] - c[k]) + y[k] * r2[k] * (s[k] + c[k]));
+            }
+
+            for (int i=0; i<nb; ++i) {
+                double ax = std::abs(xb[i]);
+                if (!(ax > 0. && ax <= max_sincos_x)) fb[i] = j1(xb[i]);
+                else if (xb[i] < 0.) fb[i] = -fb[i];
+            }
+        }
+    }
+
+    // K0(x) for x > 0
+    static void K0Many(const double* x, double* f, int n)
+    {
+        static const double Y1 = 1.137250900268554688;
+        static const double P1[] = {
+            -1.372509002685546267e-01, 2.574916117833312855e-01, 1.395474602146869316e-02,
+            5.445476986653926759e-04, 7.125159422136622118e-06
+        };
+        static const double Q1[] = {
+            1.000000000000000000e+00, -5.458333438017788530e-02, 1.291052816975251298e-03,
+            -1.367653946978586591e-05
+        };
+        static const double P2[] = {
+            1.159315156584124484e-01, 2.789828789146031732e-01, 2.524892993216121934e-02,
+            8.460350907213637784e-04, 1.491471924309617534e-05, 1.627106892422088488e-07,
+            1.208266102392756055e-09, 6.611686391749704310e-12
+        };
+        static const double P3[] = {
+            2.533141373155002416e-01, 3.628342133984595192e+00, 1.868441889406606057e+01,
+            4.306243981063412784e+01, 4.424116209627428189e+01, 1.562095339356220468e+01,
+            -1.810138978229410898e+00, -1.414237994269995877e+00, -9.369168119754924625e-02
+        };
+        static const double Q3[] = {
+            1.000000000000000000e+00, 1.494194694879908328e+01, 8.265296455388554217e+01,
+            2.162779506621866970e+02, 2.845145155184222157e+02, 1.851714491916334995e+02,
+            5.486540717439723515e+01, 6.118075837628957015e+00, 1.586261269326235053e-01
+        };
+
+        ScratchBuffer<double> xb(BLOCK_SIZE);
+        ScratchBuffer<int> idx(BLOCK_SIZE);
+        ScratchBuffer<double> w(BLOCK_SIZE);
+        ScratchBuffer<double> y(BLOCK_SIZE);
+        ScratchBuffer<double> r1(BLOCK_SIZE);
+        ScratchBuffer<double> r2(BLOCK_SIZE);
+        ScratchBuffer<double> t(BLOCK_SIZE);
+        for (int i0=0; i0<n; i0+=BLOCK_SIZE) {
+            const int nb = std::min(BLOCK_SIZE, n-i0);
+            // Copy the input values, so x and f may be the same array.
+            std::copy(x+i0, x+i0+nb, xb.begin());
+            double* fb = f + i0;
+
+            // 0 < x <= 1
+            int m = Select(xb.begin(), nb, 0., 1., idx.begin(), w.begin());
+            for (int k=0; k<m; ++k) y[k] = w[k] * w[k] / 4.;
+            RationalMany(y.begin(), m, P1, 5, Q1, 4, r1.begin(), t.begin());
+            for (int k=0; k<m; ++k) {
+                r1[k] = (r1[k] + Y1) * y[k] + 1.;
+                y[k] = w[k] * w[k];
+                t[k] = std::log(w[k]);
+            }
+            Horner(y.begin(), m, P2, 8, r2.begin());
+            for (int k=0; k<m; ++k) fb[idx[k]] = r2[k] - t[k] * r1[k];
+
+            // x > 1
+            m = Select(xb.begin(), nb, 1., std::numeric_limits<double>::infinity(),
+                       idx.begin(), w.begin());
+            for (int k=0; k<m; ++k) {
+                y[k] = 1. / w[k];
+                t[k] = std::exp(-w[k] / 2.);
+            }
+            RationalMany(y.begin(), m, P3, 9, Q3, 9, r1.begin(), r2.begin());
+            for (int k=0; k<m; ++k)
+                fb[idx[k]] = ((r1[k] + 1.) * t[k] / std::sqrt(w[k])) * t[k];
+
+            for (int i=0; i<nb; ++i) {
+                if (!(xb[i] > 0.)) fb[i] = cyl_bessel_k(0., xb[i]);
+            }
+        }
+    }
+
+    // K1(x) for x > 0
+    static void K1Many(const double* x, double* f, int n)
+    {
+        static const double Y1 = 8.69547128677368164e-02;
+        static const double P1[] = {
+            -3.62137953440350228e-03, 7.11842087490330300e-03, 1.00302560256614306e-05,
+            1.77231085381040811e-06
+        };
+        static const double Q1[] = {
+            1.00000000000000000e+00, -4.80414794429043831e-02, 9.85972641934416525e-04,
+            -8.91196859397070326e-06
+        };
+        static const double P2[] = {
+            -3.07965757829206184e-01, -7.80929703673074907e-02, -2.70619343754051620e-03,
+            -2.49549522229072008e-05
+        };
+        static const double Q2[] = {
+            1.00000000000000000e+00, -2.36316836412163098e-02, 2.64524577525962719e-04,
+            -1.49749618004162787e-06
+        };
+        static const double Y3 = 1.45034217834472656;
+        static const double P3[] = {
+            -1.97028041029226295e-01, -2.32408961548087617e+00, -7.98269784507699938e+00,
+            -2.39968410774221632e+00, 3.28314043780858713e+01, 5.67713761158496058e+01,
+            3.30907788466509823e+01, 6.62582288933739787e+00, 3.08851840645286691e-01
+        };
+        static const double Q3[] = {
+            1.00000000000000000e+00, 1.41811409298826118e+01, 7.35979466317556420e+01,
+            1.77821793937080859e+02, 2.11014501598705982e+02, 1.19425262951064454e+02,
+            2.88448064302447607e+01, 2.27912927104139732e+00, 2.50358186953478678e-02
+        };
+
+        ScratchBuffer<double> xb(BLOCK_SIZE);
+        ScratchBuffer<int> idx(BLOCK_SIZE);
+        ScratchBuffer<double> w(BLOCK_SIZE);
+        ScratchBuffer<double> y(BLOCK_SIZE);
+        ScratchBuffer<double> r1(BLOCK_SIZE);
+        ScratchBuffer<double> r2(BLOCK_SIZE);
+        ScratchBuffer<double> t(BLOCK_SIZE);
+        ScratchBuffer<double> u(BLOCK_SIZE);
+        for (int i0=0; i0<n; i0+=BLOCK_SIZE) {
+            const int nb = std::min(BLOCK_SIZE, n-i0);
+            // Copy the input values, so x and f may be the same array.
+            std::copy(x+i0, x+i0+nb, xb.begin());
+            double* fb = f + i0;
+
+            // 0 < x <= 1
+            int m = Select(xb.begin(), nb, 0., 1., idx.begin(), w.begin());
+            for (int k=0; k<m; ++k) y[k] = w[k] * w[k] / 4.;
+            RationalMany(y.begin(), m, P1, 4, Q1, 4, r1.begin(), t.begin());
+            for (int k=0; k<m; ++k) {
+                r1[k] = ((r1[k] + Y1) * y[k] * y[k] + y[k] / 2. + 1.) * w[k] / 2.;
+                y[k] = w[k] * w[k];
+                t[k] = std::log(w[k]);
+            }
+            RationalMany(y.begin(), m, P2, 4, Q2, 4, r2.begin(), u.begin());
+            for (int k=0; k<m; ++k) fb[idx[k]] = r2[k] * w[k] + 1. / w[k] + t[k] * r1[k];
+
+            // x > 1
+            m = Select(xb.begin(), nb, 1., std::numeric_limits<double>::infinity(),
+                       idx.begin(), w.begin());
+            for (int k=0; k<m; ++k) {
+                y[k] = 1. / w[k];
+                t[k] = std::exp(-w[k] / 2.);
+            }
+            RationalMany(y.begin(), m, P3, 9, Q3, 9, r1.begin(), r2.begin());
+            for (int k=0; k<m; ++k)
+                fb[idx[k]] = ((r1[k] + Y3) * t[k] / std::sqrt(w[k])) * t[k];
+
+            for (int i=0; i<nb; ++i) {
+                if (!(xb[i] > 0.)) fb[i] = cyl_bessel_k(1., xb[i]);
+            }
+        }
+    }
+
+    void kvMany(double nu, const double* x, double* f, int n)
+    {
+        nu = std::abs(nu);
+        for (int i=0; i<n; ++i) {
+            if (x[i] <= 0)
+                throw std::runtime_error("cyl_bessel_k x must be > 0");
+        }
+
+        if (nu == 0.) {
+            K0Many(x, f, n);
+        } else if (nu == 1.) {
+            K1Many(x, f, n);
+        } else if (nu <= 20. && int(nu) == nu) {
+            // Use the upward recurrence K_{j+1} = K_{j-1} + 2j/x K_j, which is stable.
+            // Any values that overflow or underflow along the way use the scalar function.
+            const int jmax = int(nu);
+            ScratchBuffer<double> xb(BLOCK_SIZE);
+            ScratchBuffer<double> km(BLOCK_SIZE);
+            ScratchBuffer<double> k(BLOCK_SIZE);
+            for (int i0=0; i0<n; i0+=BLOCK_SIZE) {
+                const int nb = std::min(BLOCK_SIZE, n-i0);
+                std::copy(x+i0, x+i0+nb, xb.begin());
+                double* fb = f + i0;
+                K0Many(xb.begin(), km.begin(), nb);
+                K1Many(xb.begin(), k.begin(), nb);
+                for (int j=1; j<jmax; ++j) {
+                    for (int i=0; i<nb; ++i) {
+                        fb[i] = km[i] + 2.*j / xb[i] * k[i];
+                        km[i] = k[i];
+                        k[i] = fb[i];
+                    }
+                }
+                for (int i=0; i<nb; ++i) {
+                    if (!(fb[i] > 0. && fb[i] < std::numeric_limits<double>::max()))
+                        fb[i] = cyl_bessel_k(nu, xb[i]);
+                }
+            }
+        } else {
+            for (int i=0; i<n; ++i) f[i] = cyl_bessel_k(nu, x[i]);
+        }
+    }
+
+}}
@@ -25,7 +25,7 @@
 namespace galsim {
 namespace math {
 
-    void HornerStep(double* x, int n, double c, double* r)
+    void HornerStep(const double* x, int n, double c, double* r)
     {
 #ifdef __SSE2__
         for (; n && (!IsAligned(r) || !IsAligned(x)); --n, ++r, ++x)
@@ -38,7 +38,7 @@ namespace math {
         if (n2) {
             __m128d cx = _mm_set1_pd(c);
             __m128d* rx = reinterpret_cast<__m128d*>(r);
-            __m128d* xx = reinterpret_cast<__m128d*>(x);
+            const __m128d* xx = reinterpret_cast<const __m128d*>(x);
             do {
                 *rx = _mm_add_pd(_mm_mul_pd(*rx, *xx), cx);
                 ++rx;
@@ -56,7 +56,8 @@ namespace math {
 #endif
     }
 
-    void HornerBlock(double* x, int nx, double* coef, double* c, double* result)
+    void HornerBlock(const double* x, int nx, const double* coef, const double* c,
+                     double* result)
     {
         // Repeatedly multiply by x and add next coefficient
         double* r = result;
@@ -67,10 +68,10 @@ namespace math {
         // In the last step, we will have added the constant term, and we're done.
     }
 
-    void Horner(double* x, int nx, double* coef, const int nc, double* result)
+    void Horner(const double* x, int nx, const double* coef, const int nc, double* result)
     {
         // Start at highest power
-        double* c = coef + nc-1;
+        const double* c = coef + nc-1;
         // Ignore any trailing zeros
         while (*c == 0. && c > coef) --c;
 
@@ -27,6 +27,7 @@
 extern void TestImage();
 extern void TestInteg();
 extern void TestVersion();
+extern void TestCache();
 
 int main()
 {
@@ -39,6 +40,8 @@ int main()
         std::cout<<"TestInteg passed all tests.\n";
         TestVersion();
         std::cout<<"TestVersion passed all tests.\n";
+        TestCache();
+        std::cout<<"TestCache passed all tests.\n";
 
     } catch (std::exception& e) {
         std::cerr<<e.what()<<std::endl;
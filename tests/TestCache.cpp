@@ -0,0 +1,342 @@
+/* -*- c++ -*-
+ * Copyright (c) 2012-2019 by the GalSim developers team on GitHub
+ * https://github.com/GalSim-developers
+ *
+ * This file is part of GalSim: The modular galaxy image simulation toolkit.
+ * https://github.com/GalSim-developers/GalSim
+ *
+ * GalSim is free software: redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions, and the disclaimer given in the accompanying LICENSE
+ *    file.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the disclaimer given in the documentation
+ *    and/or other materials provided with the distribution.
+ */
+
+// Tests of the various caches of precomputed tables, including their use from many threads.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "GalSim.h"
+#include "galsim/LRUCache.h"
+#include "galsim/SBSersic.h"
+#include "galsim/SBSpergel.h"
+#include "galsim/SBAiry.h"
+#include "Test.h"
+
+const int test_nthreads = 16;   // Number of threads to use for each test.
+const int test_niter = 200;     // Number of times each thread hits the cache.
+
+// A Value type for the LRUCache tests that counts how many times it has been built.
+static std::atomic<int> ncache_build(0);
+
+class CacheValue
+{
+public:
+    CacheValue(int key) : _key(key)
+    {
+        ++ncache_build;
+        // Take a little while, so other threads are likely to ask for the same key
+        // while we are still building it.
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    int getKey() const { return _key; }
+private:
+    int _key;
+};
+
+// A Value type with a known size, for testing the memory limit of the LRUCache.
+class SizedValue
+{
+public:
+    SizedValue(int key) : _data(1000 * (key+1)) {}
+    size_t getMemorySize() const { return _data.size() * sizeof(double); }
+private:
+    std::vector<double> _data;
+};
+
+namespace galsim {
+    template <>
+    struct LRUCacheSize<SizedValue>
+    {
+        static size_t Get(const SizedValue& value) { return value.getMemorySize(); }
+    };
+}
+
+// Run func(ithread) in test_nthreads threads at once.
+template <typename F>
+void RunThreads(F func)
+{
+    std::vector<std::thread> threads;
+    for (int i=0; i<test_nthreads; ++i) threads.push_back(std::thread(func, i));
+    for (int i=0; i<test_nthreads; ++i) threads[i].join();
+}
+
+void TestLRUCacheThreads()
+{
+    Log("Start TestLRUCacheThreads()");
+
+    // All keys fit in the cache, so each value should be built exactly once, and everyone
+    // should get the same object for a given key.
+    const int nkeys = 10;
+    ncache_build = 0;
+    galsim::LRUCache<int, CacheValue> cache(nkeys);
+    std::vector<std::vector<const CacheValue*> > ptrs(
+        test_nthreads, std::vector<const CacheValue*>(nkeys, 0));
+    std::atomic<int> nbad(0);
+    RunThreads([&](int ithread) {
+        for (int n=0; n<test_niter; ++n) {
+            int key = (n + ithread) % nkeys;
+            std::shared_ptr<CacheValue> value = cache.get(key);
+            if (value->getKey() != key) ++nbad;
+            if (!ptrs[ithread][key]) ptrs[ithread][key] = value.get();
+            else if (ptrs[ithread][key] != value.get()) ++nbad;
+        }
+    });
+    AssertEqual(int(nbad), 0);
+    AssertEqual(int(ncache_build), nkeys);
+    AssertEqual(cache.size(), size_t(nkeys));
+    for (int i=1; i<test_nthreads; ++i)
+        for (int key=0; key<nkeys; ++key)
+            AssertEqual(ptrs[i][key], ptrs[0][key]);
+
+    // Now use a cache that is much smaller than the number of keys, so items are evicted
+    // while other threads are still using them.
+    galsim::LRUCache<int, CacheValue> small_cache(3);
+    RunThreads([&](int ithread) {
+        for (int n=0; n<test_niter/4; ++n) {
+            int key = (7*n + ithread) % 20;
+            std::shared_ptr<CacheValue> value = small_cache.get(key);
+            if (value->getKey() != key) ++nbad;
+        }
+    });
+    AssertEqual(int(nbad), 0);
+    AssertTrue(small_cache.size() <= 3);
+}
+
+void TestLRUCacheStats()
+{
+    Log("Start TestLRUCacheStats()");
+
+    const std::string name = "TestLRUCacheStats";
+    const long nb = 1000 * sizeof(double);  // The size of the value for key=0.
+    galsim::LRUCache<int, SizedValue> cache(10, name);
+    for (int key=0; key<5; ++key) cache.get(key);
+    for (int key=0; key<5; ++key) cache.get(key);
+    galsim::LRUCacheStats stats = galsim::GetLRUCacheStats(name);
+    AssertEqual(stats.nhit, 5);
+    AssertEqual(stats.nmiss, 5);
+    AssertEqual(stats.nevict, 0);
+    AssertTrue(stats.build_time >= 0.);
+    AssertEqual(stats.nentries, 5);
+    AssertEqual(stats.nbytes, 15 * nb);
+    AssertEqual(stats.max_entries, 10);
+    AssertEqual(stats.max_bytes, 0);
+
+    // Room for keys 4, 3, 2, which are the most recently used.
+    galsim::SetLRUCacheSize(name, 10, 12 * nb);
+    stats = galsim::GetLRUCacheStats(name);
+    AssertEqual(stats.nevict, 2);
+    AssertEqual(stats.nentries, 3);
+    AssertEqual(stats.nbytes, 12 * nb);
+    AssertEqual(stats.max_bytes, 12 * nb);
+
+    // Adding key 0 back in pushes out key 2.
+    cache.get(0);
+    stats = galsim::GetLRUCacheStats(name);
+    AssertEqual(stats.nmiss, 6);
+    AssertEqual(stats.nevict, 3);
+    AssertEqual(stats.nentries, 3);
+    AssertEqual(stats.nbytes, 10 * nb);
+
+    // A value that is bigger than the limit on its own is still kept.
+    cache.get(20);
+    stats = galsim::GetLRUCacheStats(name);
+    AssertEqual(stats.nevict, 6);
+    AssertEqual(stats.nentries, 1);
+    AssertEqual(stats.nbytes, 21 * nb);
+
+    // Limit the number of entries instead.
+    galsim::SetLRUCacheSize(name, 2, 0);
+    for (int key=0; key<4; ++key) cache.get(key);
+    stats = galsim::GetLRUCacheStats(name);
+    AssertEqual(stats.nentries, 2);
+    AssertEqual(stats.nbytes, 7 * nb);
+    AssertEqual(stats.max_entries, 2);
+    AssertEqual(stats.max_bytes, 0);
+
+    galsim::ResetLRUCacheStats(name);
+    stats = galsim::GetLRUCacheStats(name);
+    AssertEqual(stats.nhit, 0);
+    AssertEqual(stats.nmiss, 0);
+    AssertEqual(stats.nevict, 0);
+    AssertEqual(stats.build_time, 0.);
+    AssertEqual(stats.nentries, 2);
+
+    galsim::ClearLRUCache(name);
+    AssertEqual(cache.size(), size_t(0));
+    AssertEqual(galsim::GetLRUCacheStats(name).nbytes, 0);
+
+    // The profile caches are all registered.
+    std::vector<std::string> names = galsim::GetLRUCacheNames();
+    AssertTrue(std::find(names.begin(), names.end(), "Sersic") != names.end());
+    AssertTrue(std::find(names.begin(), names.end(), name) != names.end());
+
+    bool threw = false;
+    try {
+        galsim::GetLRUCacheStats("NotACache");
+    } catch (std::invalid_argument&) {
+        threw = true;
+    }
+    AssertTrue(threw);
+}
+
+void TestInterpolantThreads()
+{
+    Log("Start TestInterpolantThreads()");
+
+    // Use a kvalue_accuracy that isn't used anywhere else, so the tables really are built
+    // in the threads.
+    galsim::GSParams gsp(128, 8192, 5.e-3, 5., 1.e-3, 3.7e-5, 1.e-5, 1., 1.e-4, 1.e-6,
+                         1.e-6, 1.e-8, 1.e-5, false, true, false);
+    std::vector<double> u(20);
+    for (int i=0; i<int(u.size()); ++i) u[i] = 0.07 * i;
+
+    std::vector<double> cubic(test_nthreads * u.size());
+    std::vector<double> quintic(test_nthreads * u.size());
+    std::vector<double> lanczos(test_nthreads * u.size());
+    std::vector<double> lanczos_x(test_nthreads * u.size());
+    RunThreads([&](int ithread) {
+        galsim::Cubic c(gsp);
+        galsim::Quintic q(gsp);
+        galsim::Lanczos l(5, true, gsp);
+        for (size_t i=0; i<u.size(); ++i) {
+            cubic[ithread*u.size()+i] = c.uval(u[i]);
+            quintic[ithread*u.size()+i] = q.uval(u[i]);
+            lanczos[ithread*u.size()+i] = l.uval(u[i]);
+            lanczos_x[ithread*u.size()+i] = l.xval(10.*u[i]);
+        }
+    });
+
+    // Every thread should see the same tables as a fresh construction now that they are cached.
+    galsim::Cubic c(gsp);
+    galsim::Quintic q(gsp);
+    galsim::Lanczos l(5, true, gsp);
+    for (int i=0; i<test_nthreads; ++i) {
+        for (size_t j=0; j<u.size(); ++j) {
+            AssertEqual(cubic[i*u.size()+j], c.uval(u[j]));
+            AssertEqual(quintic[i*u.size()+j], q.uval(u[j]));
+            AssertEqual(lanczos[i*u.size()+j], l.uval(u[j]));
+            AssertEqual(lanczos_x[i*u.size()+j], l.xval(10.*u[j]));
+        }
+    }
+}
+
+void TestProfileCacheThreads()
+{
+    Log("Start TestProfileCacheThreads()");
+
+    // Several threads making the same profiles share the Info objects through the LRUCaches.
+    // Each of them lazily builds more tables on first use, which also needs to be safe.
+    galsim::GSParams gsp;
+    std::vector<double> k(10);
+    for (int i=0; i<int(k.size()); ++i) k[i] = 0.3 * i;
+
+    std::vector<double> sersic(test_nthreads * k.size());
+    std::vector<double> spergel(test_nthreads * k.size());
+    std::vector<double> airy(test_nthreads * k.size());
+    std::vector<double> flux(3 * test_nthreads);
+    RunThreads([&](int ithread) {
+        galsim::SBSersic s(2.7, 1.3, 1., 0., gsp);
+        galsim::SBSpergel sp(-0.35, 1.1, 1., gsp);
+        galsim::SBAiry a(0.8, 0.23, 1., gsp);
+        for (size_t i=0; i<k.size(); ++i) {
+            galsim::Position<double> kpos(k[i], 0.5*k[i]);
+            sersic[ithread*k.size()+i] = s.kValue(kpos).real();
+            spergel[ithread*k.size()+i] = sp.kValue(kpos).real();
+            airy[ithread*k.size()+i] = a.kValue(kpos).real();
+        }
+        galsim::BaseDeviate rng(1234 + ithread);
+        galsim::PhotonArray photons(100);
+        s.shoot(photons, rng);
+        flux[3*ithread] = photons.getTotalFlux();
+        sp.shoot(photons, rng);
+        flux[3*ithread+1] = photons.getTotalFlux();
+        a.shoot(photons, rng);
+        flux[3*ithread+2] = photons.getTotalFlux();
+    });
+
+    galsim::SBSersic s(2.7, 1.3, 1., 0., gsp);
+    galsim::SBSpergel sp(-0.35, 1.1, 1., gsp);
+    galsim::SBAiry a(0.8, 0.23, 1., gsp);
+    for (int i=0; i<test_nthreads; ++i) {
+        for (size_t j=0; j<k.size(); ++j) {
+            galsim::Position<double> kpos(k[j], 0.5*k[j]);
+            AssertEqual(sersic[i*k.size()+j], s.kValue(kpos).real());
+            AssertEqual(spergel[i*k.size()+j], sp.kValue(kpos).real());
+            AssertEqual(airy[i*k.size()+j], a.kValue(kpos).real());
+        }
+        AssertClose(flux[3*i], 1., 1.e-8);
+        AssertClose(flux[3*i+1], 1., 1.e-8);
+        AssertClose(flux[3*i+2], 1., 1.e-8);
+    }
+}
+
+void TestShootThreads()
+{
+    Log("Start TestShootThreads()");
+
+    // An Interpolant and an SBInterpolatedImage build their photon-shooting structures the
+    // first time they are used, so have many threads shoot the same objects at once.
+    // Each thread uses its own seed, so we can check the results against a serial run.
+    const int nphot = 100;
+    galsim::GSParams gsp;
+    galsim::Quintic quintic(gsp);
+    galsim::ImageAlloc<double> im(8, 8, 0.);
+    for (int y=1; y<=8; ++y)
+        for (int x=1; x<=8; ++x)
+            im(x,y) = std::exp(-0.1*((x-4.5)*(x-4.5) + (y-4.5)*(y-4.5)));
+    galsim::Quintic image_quintic(gsp);
+    galsim::SBInterpolatedImage sbii(im, im.getBounds(), im.getBounds(),
+                                     image_quintic, image_quintic, 0., 0., gsp);
+
+    std::vector<double> xinterp(test_nthreads * nphot);
+    std::vector<double> ximage(test_nthreads * nphot);
+    RunThreads([&](int ithread) {
+        galsim::UniformDeviate ud(4321 + ithread);
+        galsim::PhotonArray photons(nphot);
+        quintic.shoot(photons, ud);
+        for (int i=0; i<nphot; ++i) xinterp[ithread*nphot+i] = photons.getX(i);
+        galsim::BaseDeviate rng(1234 + ithread);
+        sbii.shoot(photons, rng);
+        for (int i=0; i<nphot; ++i) ximage[ithread*nphot+i] = photons.getX(i);
+    });
+
+    for (int i=0; i<test_nthreads; ++i) {
+        galsim::UniformDeviate ud(4321 + i);
+        galsim::PhotonArray photons(nphot);
+        quintic.shoot(photons, ud);
+        for (int j=0; j<nphot; ++j) AssertEqual(xinterp[i*nphot+j], photons.getX(j));
+        galsim::BaseDeviate rng(1234 + i);
+        sbii.shoot(photons, rng);
+        for (int j=0; j<nphot; ++j) AssertEqual(ximage[i*nphot+j], photons.getX(j));
+    }
+}
+
+void TestCache()
+{
+    TestLRUCacheThreads();
+    TestLRUCacheStats();
+    TestInterpolantThreads();
+    TestProfileCacheThreads();
+    TestShootThreads();
+}
@@ -40,6 +40,31 @@ private :
     double _sig;
 };
 
+// The same Gaussian, but also able to evaluate many points at once
+class GaussMany : public Gauss
+{
+public :
+    GaussMany(double sig) : Gauss(sig), _nmany(0) {}
+
+    void evalMany(const double* x, double* f, int n) const
+    {
+        for (int i=0; i<n; ++i) f[i] = (*this)(x[i]);
+        ++_nmany;
+    }
+
+    int getNMany() const { return _nmany; }
+
+private :
+    mutable int _nmany;
+};
+
+// A functional class that only inherits its evalMany method
+class GaussManyDerived : public GaussMany
+{
+public :
+    GaussManyDerived(double sig) : GaussMany(sig) {}
+};
+
 // A simple power law
 class Power : public std::unary_function<double,double>
 {
@@ -87,6 +112,37 @@ void TestGaussian()
     AssertClose(test6, 17.54639792241700421699, test_rel_err, test_abs_err);
 }
 
+void TestEvalMany()
+{
+    Log("Start TestEvalMany()");
+    Gauss gauss(test_sigma);
+    GaussMany gauss_many(test_sigma);
+
+    // The values should be identical to using operator() for each point.
+    double test1 = galsim::integ::int1d(gauss_many, -1., 1., test_rel_err, test_abs_err);
+    AssertEqual(test1, galsim::integ::int1d(gauss, -1., 1., test_rel_err, test_abs_err));
+    AssertTrue(gauss_many.getNMany() > 0);
+
+    // Including through the transformations for infinite ranges.
+    double test2 = galsim::integ::int1d(gauss_many, 0., test_mock_inf,
+                                        test_rel_err, test_abs_err);
+    AssertEqual(test2, galsim::integ::int1d(gauss, 0., test_mock_inf,
+                                            test_rel_err, test_abs_err));
+    AssertClose(test2, 8.77319896120850210849, test_rel_err, test_abs_err);
+
+    double test3 = galsim::integ::int1d(gauss_many, -test_mock_inf, test_mock_inf,
+                                        test_rel_err, test_abs_err);
+    AssertEqual(test3, galsim::integ::int1d(gauss, -test_mock_inf, test_mock_inf,
+                                            test_rel_err, test_abs_err));
+    AssertClose(test3, 17.54639792241700421699, test_rel_err, test_abs_err);
+
+    // An inherited evalMany is used too.
+    GaussManyDerived gauss_derived(test_sigma);
+    double test4 = galsim::integ::int1d(gauss_derived, -1., 1., test_rel_err, test_abs_err);
+    AssertEqual(test4, test1);
+    AssertTrue(gauss_derived.getNMany() > 0);
+}
+
 void TestOscillatory()
 {
     Log("Start TestOscillatory()");
@@ -157,6 +213,7 @@ void TestInteg()
 {
     Log("Start tests of galsim::integ");
     TestGaussian();
+    TestEvalMany();
     TestOscillatory();
     TestPole();
     Test2d();
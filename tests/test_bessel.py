@@ -422,6 +422,54 @@ def test_j0_root():
     np.testing.assert_allclose(
         vals1, vals2, rtol=1.e-10, err_msg="bessel.j0_root disagrees with reference values")
 
+@timer
+def test_many():
+    """Test the array versions j0_many, j1_many and kv_many against the scalar versions"""
+    import time
+    rng = np.random.RandomState(1234)
+    x = np.concatenate([rng.uniform(-10, 10, 3000), rng.uniform(-1.e4, 1.e4, 1000),
+                        [0., 4., -4., 8., -8., 1.e6, -1.e6, 1.e7, 1.e-300, -3.e8]])
+
+    t0 = time.time()
+    vals1 = galsim.bessel.j0_many(x)
+    t1 = time.time()
+    vals2 = np.array([galsim.bessel.j0(xx) for xx in x])
+    t2 = time.time()
+    print('j0_many time = %f, scalar time = %f'%(t1-t0, t2-t1))
+    np.testing.assert_allclose(vals1, vals2, rtol=0, atol=2.e-15,
+                               err_msg="bessel.j0_many disagrees with bessel.j0")
+
+    t0 = time.time()
+    vals1 = galsim.bessel.j1_many(x)
+    t1 = time.time()
+    vals2 = np.array([galsim.bessel.j1(xx) for xx in x])
+    t2 = time.time()
+    print('j1_many time = %f, scalar time = %f'%(t1-t0, t2-t1))
+    np.testing.assert_allclose(vals1, vals2, rtol=0, atol=2.e-15,
+                               err_msg="bessel.j1_many disagrees with bessel.j1")
+
+    # The shape is preserved, and lists work too.
+    x2 = x[:4000].reshape(40,100)
+    np.testing.assert_array_equal(galsim.bessel.j0_many(x2),
+                                  galsim.bessel.j0_many(x[:4000]).reshape(40,100))
+    np.testing.assert_array_equal(galsim.bessel.j1_many(list(x[:10])), vals1[:10])
+
+    x = 10**rng.uniform(-6, 3, 2000)
+    for nu in [0, 1, -1, 2, 3, 12, 2.7, 0.5]:
+        t0 = time.time()
+        vals1 = galsim.bessel.kv_many(nu, x)
+        t1 = time.time()
+        vals2 = np.array([galsim.bessel.kv(nu, xx) for xx in x])
+        t2 = time.time()
+        print('kv_many(%s) time = %f, scalar time = %f'%(nu, t1-t0, t2-t1))
+        np.testing.assert_allclose(vals1, vals2, rtol=1.e-13,
+                                   err_msg="bessel.kv_many disagrees with bessel.kv")
+
+    with assert_raises(RuntimeError):
+        galsim.bessel.kv_many(0, [1., 0., 2.])
+    with assert_raises(RuntimeError):
+        galsim.bessel.kv_many(2.7, [1., -1.])
+
 
 if __name__ == "__main__":
     test_j0()
@@ -435,3 +483,4 @@ if __name__ == "__main__":
     test_kn()
     test_kv()
     test_j0_root()
+    test_many()
@@ -1622,6 +1622,264 @@ def test_direct_scale():
     assert_raises(ValueError, obj.drawPhot, im2, n_photons=-20)
     assert_raises(TypeError, obj.drawPhot, im2, sensor=5)
 
+@timer
+def test_fft_plans():
+    """Test the FFTW plan cache and wisdom functions.
+    """
+    xar = galsim.Gaussian(sigma=1.3).drawImage(nx=48, ny=32, scale=0.3).array
+    kar1 = galsim.fft.fft2(xar)
+
+    # Repeated transforms of the same size should reuse the cached plans.
+    galsim.fft.clear_plan_cache()
+    assert galsim._galsim.GetFFTWPlanCacheSize() == 0
+    kar2 = galsim.fft.rfft2(xar)
+    n = galsim._galsim.GetFFTWPlanCacheSize()
+    assert n >= 1
+    for i in range(5):
+        kar3 = galsim.fft.rfft2(xar)
+        np.testing.assert_array_equal(kar3, kar2)
+    assert galsim._galsim.GetFFTWPlanCacheSize() == n
+
+    # Measured plans give the same answers (to numerical precision).
+    assert galsim.fft.get_plan_mode() == 'estimate'
+    for mode in ['measure', 'patient', 'estimate']:
+        galsim.fft.set_plan_mode(mode)
+        assert galsim.fft.get_plan_mode() == mode
+        np.testing.assert_almost_equal(galsim.fft.fft2(xar), kar1, 12)
+        np.testing.assert_almost_equal(galsim.fft.irfft2(galsim.fft.rfft2(xar)), xar, 12)
+    assert_raises(ValueError, galsim.fft.set_plan_mode, 'fast')
+
+    # A plan made in measure mode is kept for later transforms of that size in estimate mode,
+    # rather than making a new plan.
+    galsim.fft.clear_plan_cache()
+    galsim.fft.set_plan_mode('measure')
+    galsim.fft.rfft2(xar)
+    n = galsim._galsim.GetFFTWPlanCacheSize()
+    galsim.fft.set_plan_mode('estimate')
+    np.testing.assert_almost_equal(galsim.fft.rfft2(xar), kar2, 12)
+    assert galsim._galsim.GetFFTWPlanCacheSize() == n
+
+    # The plan cache is an LRUCache with a limited size.
+    assert 'FFTWPlan' in galsim.utilities.cache_names()
+    stats = galsim.utilities.get_cache_stats('FFTWPlan')
+    assert stats.max_entries == 200
+    assert 0 < stats.nentries <= 200
+
+    # Wisdom round trips through a file.
+    wisdom_file = os.path.join('output', 'fftw_wisdom.txt')
+    galsim.fft.export_wisdom(wisdom_file)
+    assert os.path.isfile(wisdom_file)
+    galsim.fft.import_wisdom(wisdom_file)
+    assert_raises(OSError, galsim.fft.import_wisdom, 'input/this_file_does_not_exist')
+    galsim.fft.clear_plan_cache()
+    assert galsim._galsim.GetFFTWPlanCacheSize() == 0
+
+    # Multi-threaded transforms give the same answers.  Use a small min_size, so this
+    # small array actually gets the threaded plans.
+    assert galsim.fft.get_num_threads() == 1
+    min_size = galsim._galsim.GetFFTWThreadsMinSize()
+    if galsim._galsim.FFTWHasThreads():
+        galsim.fft.set_num_threads(4, min_size=16)
+        assert galsim.fft.get_num_threads() == 4
+    else:
+        with assert_warns(galsim.GalSimWarning):
+            galsim.fft.set_num_threads(4, min_size=16)
+        assert galsim.fft.get_num_threads() == 1
+    assert galsim._galsim.GetFFTWThreadsMinSize() == 16
+    np.testing.assert_almost_equal(galsim.fft.fft2(xar), kar1, 12)
+    np.testing.assert_almost_equal(galsim.fft.irfft2(galsim.fft.rfft2(xar)), xar, 12)
+    assert_raises(ValueError, galsim.fft.set_num_threads, 4, min_size=0)
+    galsim.fft.set_num_threads(1, min_size=min_size)
+    assert galsim.fft.get_num_threads() == 1
+    assert galsim._galsim.GetFFTWThreadsMinSize() == min_size
+    galsim.fft.clear_plan_cache()
+
+
+@timer
+def test_scratch_arena():
+    """Test that the temporary buffers used while drawing are reused from one stamp to the next.
+    """
+    obj = galsim.Gaussian(sigma=1.7) + galsim.Exponential(half_light_radius=2.3)
+    im = galsim.ImageD(32, 32, scale=0.3)
+
+    # The first draw may need to get memory from the system.
+    obj.drawImage(im, method='no_pixel')
+    im1 = im.copy()
+
+    # After that, all the temporaries should come from the arena.
+    galsim._galsim.ResetScratchArenaStats()
+    for i in range(10):
+        obj.drawImage(im, method='no_pixel')
+    stats = galsim._galsim.GetScratchArenaStats()
+    print('nalloc = ',stats.nalloc,'  nbytes = ',stats.nbytes)
+    print('nsys_alloc = ',stats.nsys_alloc,'  nsys_bytes = ',stats.nsys_bytes)
+    assert stats.nalloc >= 10
+    assert stats.nsys_alloc == 0
+    assert stats.allocs_avoided == stats.nalloc
+    assert stats.bytes_avoided == stats.nbytes
+    np.testing.assert_array_equal(im.array, im1.array)
+
+    # Also check that the arena is used by the k-space drawing.
+    galsim._galsim.ResetScratchArenaStats()
+    obj.drawKImage(nx=32, ny=32, scale=0.2)
+    stats = galsim._galsim.GetScratchArenaStats()
+    assert stats.nalloc >= 1
+
+
+@timer
+def test_draw_many():
+    """Test drawing many stamps with batched FFTs.
+    """
+    psf = galsim.Moffat(beta=3, fwhm=0.8)
+    objects = []
+    images = []
+    for i in range(12):
+        gal = galsim.Sersic(n=1.+0.3*(i%4), half_light_radius=0.5+0.1*i, flux=100.+i)
+        gal = gal.shear(g1=0.02*i, g2=-0.01*i).shift(0.1*(i%3), -0.05*(i%5))
+        objects.append(galsim.Convolve(gal, psf))
+        # A mix of sizes and types, including an int type, which is drawn one at a time.
+        size = [24, 32, 48, 64][i%4]
+        dtype = [np.float64, np.float32, np.float64, np.int32][i%4]
+        images.append(galsim.Image(size, size+2*(i%2), scale=0.2, dtype=dtype))
+        images[-1].setCenter(0,0)
+
+    ref_images = [ im.copy() for im in images ]
+    ref_flux = [ obj.drawFFT(im) for obj, im in zip(objects, ref_images) ]
+    flux = galsim.fft.draw_many(objects, images)
+    # drawFFT uses single precision k-space images for float32 targets, so only ~1.e-6 here.
+    np.testing.assert_allclose(flux, ref_flux, rtol=1.e-6)
+    for im, ref_im in zip(images, ref_images):
+        if im.dtype == np.float32:
+            np.testing.assert_allclose(im.array, ref_im.array, rtol=1.e-5, atol=1.e-5)
+        else:
+            np.testing.assert_allclose(im.array, ref_im.array, rtol=1.e-10, atol=1.e-10)
+
+    # With add_to_image, the values should double.
+    flux2 = galsim.fft.draw_many(objects, images, add_to_image=True)
+    np.testing.assert_allclose(flux2, ref_flux, rtol=1.e-6)
+    for im, ref_im in zip(images, ref_images):
+        if im.dtype != np.int32:
+            np.testing.assert_allclose(im.array, 2*ref_im.array, rtol=1.e-5, atol=1.e-5)
+
+    # Profiles with single_precision_fft are drawn with drawFFT onto float32 images.
+    gsp = galsim.GSParams(single_precision_fft=True)
+    sp_objects = [ obj.withGSParams(gsp) for obj in objects ]
+    images = [ galsim.Image(im.bounds, scale=0.2, dtype=im.dtype) for im in ref_images ]
+    ref_images = [ im.copy() for im in images ]
+    ref_flux = [ obj.drawFFT(im) for obj, im in zip(sp_objects, ref_images) ]
+    flux = galsim.fft.draw_many(sp_objects, images)
+    for i, (im, ref_im) in enumerate(zip(images, ref_images)):
+        if im.dtype == np.float32:
+            assert flux[i] == ref_flux[i]
+            np.testing.assert_array_equal(im.array, ref_im.array)
+        else:
+            np.testing.assert_allclose(im.array, ref_im.array, rtol=1.e-10, atol=1.e-10)
+
+    # Images with the default 1-based bounds also work, as long as they fit in the FFT box.
+    images = [ galsim.ImageD(16,16, scale=0.2), galsim.ImageF(16,20, scale=0.2) ]
+    big_objects = [ obj.dilate(3) for obj in objects[:2] ]
+    ref_images = [ im.copy() for im in images ]
+    ref_flux = [ obj.drawFFT(im) for obj, im in zip(big_objects, ref_images) ]
+    flux = galsim.fft.draw_many(big_objects, images)
+    np.testing.assert_allclose(flux, ref_flux, rtol=1.e-6)
+    for im, ref_im in zip(images, ref_images):
+        np.testing.assert_allclose(im.array, ref_im.array, rtol=1.e-5, atol=1.e-5)
+
+    # When they don't fit, this raises the same error as drawFFT, rather than aborting.
+    images = [ galsim.ImageD(32,32, scale=0.2), galsim.ImageD(32,32, scale=0.2) ]
+    images[1].setCenter(0,0)
+    assert_raises(galsim.GalSimBoundsError, objects[0].drawFFT, images[0])
+    assert_raises(galsim.GalSimBoundsError, galsim.fft.draw_many, objects[:2], images)
+
+    # Errors
+    assert_raises(ValueError, galsim.fft.draw_many, objects, images[:-1])
+    assert_raises(ValueError, galsim.fft.draw_many, objects[:1], [galsim.ImageD(32,32)])
+
+
+@timer
+def test_single_precision_fft():
+    """Test drawing float32 images with single-precision FFTs.
+    """
+    gsp = galsim.GSParams(single_precision_fft=True)
+    assert gsp.single_precision_fft
+    assert not galsim.GSParams().single_precision_fft
+    assert gsp != galsim.GSParams()
+    assert galsim.GSParams.combine([gsp, galsim.GSParams(folding_threshold=1.e-3)]) != gsp
+    assert galsim.GSParams.combine([gsp, gsp]).single_precision_fft
+    do_pickle(gsp)
+
+    obj = galsim.Sersic(n=2.3, half_light_radius=1.2, flux=1.e4).shear(g1=0.2, g2=-0.1)
+    obj = galsim.Convolve(obj, galsim.Moffat(beta=2.5, fwhm=0.9))
+    obj_sp = obj.withGSParams(gsp)
+    assert obj_sp.gsparams.single_precision_fft
+
+    for nx in [32, 200]:
+        im1 = obj.drawImage(nx=nx, ny=nx, scale=0.2, method='no_pixel', dtype=np.float32)
+        im2 = obj_sp.drawImage(nx=nx, ny=nx, scale=0.2, method='no_pixel', dtype=np.float32)
+        assert im2.dtype == np.float32
+        np.testing.assert_allclose(im2.array, im1.array, rtol=1.e-4, atol=1.e-5 * im1.array.max())
+        np.testing.assert_allclose(im2.array.sum(dtype=float), im1.array.sum(dtype=float),
+                                   rtol=1.e-5)
+
+        # Double precision images ignore the option.
+        im3 = obj.drawImage(nx=nx, ny=nx, scale=0.2, method='no_pixel')
+        im4 = obj_sp.drawImage(nx=nx, ny=nx, scale=0.2, method='no_pixel')
+        np.testing.assert_array_equal(im4.array, im3.array)
+
+
+@timer
+def test_threads():
+    """Test that drawing from multiple Python threads at once gives the same answers.
+    """
+    from concurrent.futures import ThreadPoolExecutor
+
+    psf = galsim.Moffat(beta=3, fwhm=0.8)
+    objects = []
+    for i in range(8):
+        gal = galsim.Sersic(n=1.+0.4*(i%4), half_light_radius=0.5+0.1*i, flux=100.+i)
+        gal = gal.shear(g1=0.02*i, g2=-0.01*i)
+        objects.append(galsim.Convolve(gal, psf))
+
+    def draw(obj, method):
+        if method == 'phot':
+            return obj.drawImage(nx=64, ny=64, scale=0.2, method=method, n_photons=1000,
+                                 rng=galsim.BaseDeviate(1234))
+        else:
+            return obj.drawImage(nx=64, ny=64, scale=0.2, method=method)
+
+    for method in ['fft', 'real_space', 'phot']:
+        if method == 'real_space':
+            # Real-space convolution only works with two profiles, so just use the galaxies,
+            # which get convolved by the pixel.
+            objs = [ obj.obj_list[0] for obj in objects ]
+        else:
+            objs = objects
+        ref_images = [ draw(obj, method) for obj in objs ]
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            images = list(executor.map(lambda obj: draw(obj, method), objs))
+        for im, ref_im in zip(images, ref_images):
+            np.testing.assert_array_equal(im.array, ref_im.array)
+
+    # The above draws everything serially first, which sets up any lazily calculated values
+    # before the threads start.  So also draw the same freshly built profiles from all the
+    # threads at once: a real-space Convolution (drawn with no_pixel, since real_space would
+    # revert to fft) and a sheared galaxy, which real_space convolves with the pixel.
+    def make_objects():
+        gal = galsim.Exponential(half_light_radius=0.6, flux=100.).shear(g1=0.2, g2=-0.1)
+        conv = galsim.Convolve(gal, galsim.Gaussian(fwhm=0.8), real_space=True)
+        return [(conv, 'no_pixel'), (gal.shift(0.1, -0.2), 'real_space')]
+    def draw_real(obj, method):
+        return obj.drawImage(nx=24, ny=24, scale=0.2, method=method)
+
+    ref_images = [ draw_real(obj, method) for obj, method in make_objects() ]
+    for (obj, method), ref_im in zip(make_objects(), ref_images):
+        obj._sbp  # Make sure all the threads use the same C++ profile.
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            images = list(executor.map(lambda i: draw_real(obj, method), range(8)))
+        for im in images:
+            np.testing.assert_array_equal(im.array, ref_im.array)
+
+
 if __name__ == "__main__":
     test_drawImage()
     test_draw_methods()
@@ -1635,3 +1893,8 @@ if __name__ == "__main__":
     test_shoot()
     test_types()
     test_direct_scale()
+    test_fft_plans()
+    test_scratch_arena()
+    test_draw_many()
+    test_single_precision_fft()
+    test_threads()
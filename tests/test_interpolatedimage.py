@@ -376,6 +376,53 @@ def test_interpolant():
         q.kval(x2d)
 
 
+@timer
+def test_tabulated_xval():
+    """Test the lookup-table version of xval for Cubic, Quintic and Lanczos.
+    """
+    x = np.linspace(-8, 8, 1601)
+    x = np.concatenate([x, x + 1.e-3, [2.9999999, 3.0000001, 4.9999999, 5.0000001]])
+    nodes = np.arange(-8., 9.)
+
+    for tol in [1.e-5, 1.e-7]:
+        gsp = galsim.GSParams(xvalue_accuracy=tol, tabulate_xval=True)
+        assert gsp.tabulate_xval
+        assert not galsim.GSParams().tabulate_xval
+        assert galsim.GSParams.combine([gsp, gsp]).tabulate_xval
+        assert not galsim.GSParams.combine([gsp, galsim.GSParams()]).tabulate_xval
+        for interp in [galsim.Cubic(), galsim.Quintic(), galsim.Lanczos(3),
+                       galsim.Lanczos(5, conserve_dc=False), galsim.Lanczos(7)]:
+            print(interp, tol)
+            tab = interp.withGSParams(gsp)
+            assert tab._i.isXvalTabulated()
+            assert not interp._i.isXvalTabulated()
+            do_pickle(tab)
+
+            # The array version and the scalar version should match, and both should be within
+            # xvalue_accuracy of the direct calculation.
+            tab_xval = tab.xval(x)
+            np.testing.assert_allclose(tab_xval, interp.xval(x), rtol=0, atol=tol)
+            np.testing.assert_array_equal([tab.xval(xx) for xx in x[::37]], tab_xval[::37])
+
+            # Still exact at the nodes.
+            np.testing.assert_array_equal(tab.xval(nodes), interp.xval(nodes))
+
+        # The Cubic kernel is piecewise cubic, so the table is exact up to rounding.
+        cubic = galsim.Cubic(gsparams=gsp)
+        np.testing.assert_allclose(cubic.xval(x), galsim.Cubic().xval(x), rtol=0, atol=1.e-13)
+
+    # Drawing an InterpolatedImage in real space should be accurate to about xvalue_accuracy
+    # times the sum of the absolute values of the kernel weights.
+    im = galsim.Gaussian(sigma=2.3).shear(g1=0.1, g2=0.3).drawImage(scale=1., nx=32, ny=32)
+    gsp = galsim.GSParams(tabulate_xval=True)
+    for interp in ['quintic', 'lanczos5']:
+        ii1 = galsim.InterpolatedImage(im, x_interpolant=interp)
+        ii2 = galsim.InterpolatedImage(im, x_interpolant=interp, gsparams=gsp)
+        im1 = ii1.drawImage(nx=41, ny=41, scale=0.73, method='no_pixel')
+        im2 = ii2.drawImage(nx=41, ny=41, scale=0.73, method='no_pixel')
+        np.testing.assert_allclose(im2.array, im1.array, rtol=0, atol=1.e-4 * im1.array.max())
+
+
 @timer
 def test_fluxnorm():
     """Test that InterpolatedImage class responds properly to instructions about flux normalization.
@@ -1077,6 +1124,69 @@ def test_realspace_conv():
         do_pickle(c3)
 
 
+@timer
+def test_resample_grid():
+    """Test that drawing an InterpolatedImage in real space matches xValue at each pixel.
+    """
+    # The no_pixel drawing uses the separable two-pass resampling in the C++ layer, while
+    # xValue interpolates one point at a time.  They should agree to numerical precision.
+    gal = galsim.Sersic(n=2.3, half_light_radius=1.3).shear(g1=0.2, g2=-0.13)
+    gal_im = gal.drawImage(scale=0.2, nx=48, ny=40, method='no_pixel')
+
+    if __name__ == "__main__":
+        interp_list = ['nearest', 'linear', 'cubic', 'quintic', 'lanczos3', 'lanczos5']
+    else:
+        interp_list = ['linear', 'quintic', 'lanczos5']
+    for interp in interp_list:
+        print('interp = ',interp)
+        ii = galsim.InterpolatedImage(gal_im, x_interpolant=interp)
+
+        # Non-commensurate scale and an offset, so the kernel weights vary across the image.
+        # Also make the image extend past the edge of the original to test the zero region.
+        for dtype in [np.float64, np.float32]:
+            im = galsim.Image(27, 31, scale=0.37, dtype=dtype)
+            ii.drawImage(im, method='no_pixel', offset=(0.31,-0.17))
+            x = (np.arange(27) - 13 - 0.31) * 0.37
+            y = (np.arange(31) - 15 + 0.17) * 0.37
+            ref = np.array([[ii.xValue(xx,yy) for xx in x] for yy in y])
+            np.testing.assert_allclose(im.array, ref * 0.37**2, rtol=1.e-5, atol=1.e-7,
+                                       err_msg="Grid resampling doesn't match xValue for "+interp)
+
+        # On the original grid, exact interpolants should reproduce the input image.
+        im = ii.drawImage(nx=48, ny=40, scale=0.2, method='no_pixel')
+        np.testing.assert_allclose(im.array, gal_im.array, rtol=1.e-10, atol=1.e-12)
+
+
+@timer
+def test_kimage_grid():
+    """Test that drawKImage of an InterpolatedImage matches kValue at each pixel.
+    """
+    # drawKImage does the k-space interpolation for the whole grid at once with precomputed
+    # weights, while kValue interpolates one point at a time.
+    gal = galsim.Sersic(n=1.7, half_light_radius=0.9).shear(g1=-0.1, g2=0.23)
+    gal_im = gal.drawImage(scale=0.2, nx=40, ny=40, method='no_pixel')
+
+    for k_interp in ['linear', 'cubic', 'quintic', 'lanczos3']:
+        print('k_interpolant = ',k_interp)
+        ii = galsim.InterpolatedImage(gal_im, k_interpolant=k_interp)
+
+        # Regular grid, which uses the separable path.
+        kim = ii.drawKImage(nx=33, ny=29, scale=0.37)
+        kx = (np.arange(33) - 16) * 0.37
+        ky = (np.arange(29) - 14) * 0.37
+        ref = np.array([[ii.kValue(kkx,kky) for kkx in kx] for kky in ky])
+        np.testing.assert_allclose(kim.array, ref, rtol=1.e-10, atol=1.e-12,
+                                   err_msg="drawKImage doesn't match kValue for "+k_interp)
+
+        # A sheared profile uses the non-separable grid in k-space.
+        sheared = ii.shear(g1=0.15, g2=-0.2).rotate(17 * galsim.degrees)
+        kim = sheared.drawKImage(nx=33, ny=29, scale=0.37)
+        ref = np.array([[sheared.kValue(kkx,kky) for kkx in kx] for kky in ky])
+        np.testing.assert_allclose(kim.array, ref, rtol=1.e-8, atol=1.e-10,
+                                   err_msg="Sheared drawKImage doesn't match kValue for "+
+                                   k_interp)
+
+
 @timer
 def test_Cubic_ref():
     """Test use of Cubic interpolant against some reference values
@@ -1535,6 +1645,56 @@ def test_ii_shoot():
         assert np.isclose(im.array.sum(), obj.flux, rtol=rtol)
 
 
+@timer
+def test_table_cache():
+    """Test that InterpolatedImages made from the same image values share their tables."""
+    assert 'InterpolatedImage' in galsim.utilities.cache_names()
+    orig = galsim.utilities.get_cache_stats('InterpolatedImage')
+    galsim.utilities.clear_cache('InterpolatedImage')
+    galsim.utilities.reset_cache_stats('InterpolatedImage')
+
+    im = galsim.Gaussian(sigma=1.3).shear(g1=0.1, g2=0.2).drawImage(nx=32, ny=32, scale=0.2)
+    ii1 = galsim.InterpolatedImage(im)
+    ii1.shear(g1=0.05).drawImage(nx=40, ny=40, scale=0.15, method='no_pixel')
+    stats1 = galsim.utilities.get_cache_stats('InterpolatedImage')
+    assert stats1.nmiss >= 1
+    assert stats1.nentries >= 1
+    assert stats1.nbytes > 0
+    assert stats1.max_entries == 0
+    assert stats1.max_bytes == orig.max_bytes > 0
+
+    # A new profile from a copy of the same image reuses the tables.
+    ii2 = galsim.InterpolatedImage(im.copy())
+    im2 = ii2.shift(0.1, -0.2).drawImage(nx=40, ny=40, scale=0.15, method='no_pixel')
+    stats2 = galsim.utilities.get_cache_stats('InterpolatedImage')
+    assert stats2.nhit > stats1.nhit
+    assert stats2.nmiss == stats1.nmiss
+    assert stats2.nentries == stats1.nentries
+
+    # Different values need new tables.
+    ii3 = galsim.InterpolatedImage(im * 2.)
+    ii3.drawImage(nx=40, ny=40, scale=0.15, method='no_pixel')
+    stats3 = galsim.utilities.get_cache_stats('InterpolatedImage')
+    assert stats3.nmiss > stats2.nmiss
+    assert stats3.nentries > stats2.nentries
+
+    # With room for only one entry, the results are the same, but the older tables are dropped.
+    galsim.utilities.set_cache_size('InterpolatedImage', 1, 0)
+    stats4 = galsim.utilities.get_cache_stats('InterpolatedImage')
+    assert stats4.nentries == 1
+    assert stats4.nevict > stats3.nevict
+    ii4 = galsim.InterpolatedImage(im.copy())
+    im4 = ii4.shift(0.1, -0.2).drawImage(nx=40, ny=40, scale=0.15, method='no_pixel')
+    np.testing.assert_array_equal(im4.array, im2.array)
+    stats5 = galsim.utilities.get_cache_stats('InterpolatedImage')
+    assert stats5.nmiss > stats4.nmiss
+    assert stats5.nentries == 1
+
+    galsim.utilities.set_cache_size('InterpolatedImage', orig.max_entries, orig.max_bytes)
+    galsim.utilities.clear_cache('InterpolatedImage')
+    assert galsim.utilities.get_cache_stats('InterpolatedImage').nentries == 0
+
+
 @timer
 def test_ne():
     """ Check that inequality works as expected for corner cases where the reprs of two
@@ -1637,6 +1797,7 @@ if __name__ == "__main__":
     setup()
     test_roundtrip()
     test_interpolant()
+    test_tabulated_xval()
     test_fluxnorm()
     test_exceptions()
     test_operations_simple()
@@ -1645,6 +1806,8 @@ if __name__ == "__main__":
     test_pad_image()
     test_corr_padding()
     test_realspace_conv()
+    test_resample_grid()
+    test_kimage_grid()
     test_Cubic_ref()
     test_Quintic_ref()
     test_Lanczos5_ref()
@@ -1654,5 +1817,6 @@ if __name__ == "__main__":
     test_kroundtrip()
     test_multihdu_readin()
     test_ii_shoot()
+    test_table_cache()
     test_ne()
     test_quintic_glagn()
@@ -458,6 +458,49 @@ def test_moffat_shoot():
     assert np.isclose(im.array.sum(), obj.flux)
 
 
+@timer
+def test_moffat_kvalue_table():
+    """Test the tabulated kValue used for Moffats with general beta and the cache of MoffatInfos.
+    """
+    import math
+    gsp = galsim.GSParams(kvalue_accuracy=1.e-6)
+    kvals = np.linspace(0., 30., 301)
+    for beta in [1.2, 1.7, 2.3, 3.7, 5.2]:
+        moffat = galsim.Moffat(beta=beta, scale_radius=1.3, flux=1.7, gsparams=gsp)
+        nu = beta - 1.
+        # The k=0 value is just the flux.
+        expected = [1.] + [4.*galsim.bessel.kv(nu,x)*(x/2.)**beta/math.gamma(nu)
+                           for x in kvals[1:]*1.3]
+        expected = 1.7 * np.array(expected)
+        kv = np.array([moffat.kValue(k,0.).real for k in kvals])
+        print('beta = ',beta,' max diff = ',np.max(np.abs(kv-expected)))
+        np.testing.assert_allclose(kv, expected, rtol=0, atol=1.7*gsp.kvalue_accuracy,
+                                   err_msg="Moffat kValue disagrees with the analytic formula "
+                                           "for beta = %f"%beta)
+
+    # The tables are shared among Moffats with the same beta, trunc, and gsparams.
+    assert 'Moffat' in galsim.utilities.cache_names()
+    galsim.utilities.clear_cache('Moffat')
+    galsim.utilities.reset_cache_stats('Moffat')
+    betas = [1.7, 2.3, 3.7]
+    for beta in betas:
+        galsim.Moffat(beta=beta, half_light_radius=1.2, trunc=4.).drawImage(nx=32, ny=32, scale=0.3)
+    stats1 = galsim.utilities.get_cache_stats('Moffat')
+    print('stats1 = ',stats1.nhit,stats1.nmiss,stats1.nevict,stats1.nentries,stats1.nbytes)
+    assert stats1.nmiss == len(betas)
+    assert stats1.nentries == len(betas)
+    assert stats1.nbytes > 0
+
+    for beta in betas:
+        galsim.Moffat(beta=beta, half_light_radius=1.2, trunc=4., flux=2.3).drawImage(
+                nx=32, ny=32, scale=0.3)
+    stats2 = galsim.utilities.get_cache_stats('Moffat')
+    print('stats2 = ',stats2.nhit,stats2.nmiss,stats2.nevict,stats2.nentries,stats2.nbytes)
+    assert stats2.nhit >= stats1.nhit + len(betas)
+    assert stats2.nmiss == stats1.nmiss
+    assert stats2.nentries == len(betas)
+
+
 @timer
 def test_ne():
     """Test base.py GSObjects for not-equals."""
@@ -483,4 +526,5 @@ if __name__ == "__main__":
     test_moffat_radii()
     test_moffat_flux_scaling()
     test_moffat_shoot()
+    test_moffat_kvalue_table()
     test_ne()
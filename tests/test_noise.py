@@ -842,6 +842,65 @@ def test_addnoisesnr():
             err_msg='addNoiseSNR with preserve_flux = True and False give inconsistent results')
 
 
+@timer
+def test_tiled_noise():
+    """Test the parallel tiled noise used with the philox engine.
+    """
+    seed = 1234
+    noises = [ lambda rng: galsim.GaussianNoise(rng, sigma=4.),
+               lambda rng: galsim.PoissonNoise(rng, sky_level=50.),
+               lambda rng: galsim.CCDNoise(rng, sky_level=50., gain=2., read_noise=3.) ]
+    variances = [ 16., 150., 77.25 ]
+
+    for make_noise, var in zip(noises, variances):
+        # Large enough to have several tiles.  And not a multiple of the tile size.
+        im = galsim.ImageD(700, 600, init_value=100.)
+        rng = galsim.BaseDeviate(seed, engine='philox')
+        noise = make_noise(rng)
+        im.addNoise(noise)
+        print(noise, np.mean(im.array), np.var(im.array))
+        np.testing.assert_allclose(np.mean(im.array), 100., atol=5*np.sqrt(var/im.array.size))
+        np.testing.assert_allclose(np.var(im.array), var, rtol=0.01)
+
+        # Only the two values for the 64-bit key are drawn from the rng.
+        rng2 = galsim.BaseDeviate(seed, engine='philox')
+        rng2.discard(2)
+        assert rng == rng2
+
+        # The same for any number of threads.
+        for num_threads in [1, 3, 4]:
+            galsim.set_omp_threads(num_threads)
+            im2 = galsim.ImageD(700, 600, init_value=100.)
+            im2.addNoise(make_noise(galsim.BaseDeviate(seed, engine='philox')))
+            np.testing.assert_array_equal(im2.array, im.array)
+        galsim.set_omp_threads(None)
+
+        # Other types work too.
+        for dtype in [np.float32, np.int32, np.uint16]:
+            im3 = galsim.Image(300, 200, dtype=dtype, init_value=100)
+            im3.addNoise(make_noise(galsim.BaseDeviate(seed, engine='philox')))
+            np.testing.assert_allclose(np.mean(im3.array), 100., atol=1.)
+            # Truncating to integers reduces the variance of the Gaussian noise somewhat.
+            np.testing.assert_allclose(np.var(im3.array), var, rtol=0.25)
+
+        # A view of part of an image only changes those pixels.
+        im4 = galsim.ImageD(100, 100, init_value=100.)
+        im4[galsim.BoundsI(11,60,21,80)].addNoise(make_noise(rng))
+        assert np.all(im4.array[:20,:] == 100.)
+        assert np.all(im4.array[:,:10] == 100.)
+        assert np.all(im4.array[80:,:] == 100.)
+        assert np.all(im4.array[:,60:] == 100.)
+        assert np.mean(im4.array[20:80,10:60] != 100.) > 0.9
+
+    # Negative values in unsigned images wrap around, as they would for integer arithmetic.
+    imd = galsim.ImageD(300, 200)
+    imd.addNoise(galsim.GaussianNoise(galsim.BaseDeviate(seed, engine='philox'), sigma=4.))
+    for dtype in [np.int16, np.uint16, np.uint32]:
+        im5 = galsim.Image(300, 200, dtype=dtype)
+        im5.addNoise(galsim.GaussianNoise(galsim.BaseDeviate(seed, engine='philox'), sigma=4.))
+        np.testing.assert_array_equal(im5.array, np.trunc(imd.array).astype(np.int64).astype(dtype))
+
+
 if __name__ == "__main__":
     test_deviate_noise()
     test_gaussian_noise()
@@ -849,3 +908,4 @@ if __name__ == "__main__":
     test_poisson_noise()
     test_ccdnoise()
     test_addnoisesnr()
+    test_tiled_noise()
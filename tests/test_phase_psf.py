@@ -358,6 +358,78 @@ def test_frozen_flow():
     np.testing.assert_array_almost_equal(wf0, wf2, 5, "Flow is not frozen")
 
 
+@timer
+def test_phase_screen_engine():
+    """Test that the C++ phase screen calculations match the original numpy calculations."""
+    # Random screen synthesis and boiling.  Use alpha < 1 so the screen keeps _psi around.
+    screen = galsim.AtmosphericScreen(6.4, screen_scale=0.1, alpha=0.99, time_step=0.01,
+                                      rng=galsim.BaseDeviate(5))
+    screen.instantiate()
+    psi = screen._psi
+    screen0 = screen._screen.copy()
+    rng = galsim.BaseDeviate(5)
+    def random_screen():
+        noise = galsim.utilities.rand_arr(psi.shape, galsim.GaussianDeviate(rng))
+        return galsim.fft.ifft2(galsim.fft.fft2(noise)*psi).real
+    np.testing.assert_allclose(screen0, random_screen(), rtol=0, atol=1.e-12*np.max(screen0))
+
+    screen._seek(0.035)
+    boiled = screen0
+    for _ in range(3):
+        boiled *= screen.alpha
+        boiled += np.sqrt(1.-screen.alpha**2) * random_screen()
+    np.testing.assert_allclose(screen._screen, boiled, rtol=0, atol=1.e-12*np.max(boiled))
+
+    # Multi-layer time integration, including a time-independent optical screen.
+    rng = galsim.BaseDeviate(1234)
+    layers = [galsim.AtmosphericScreen(10.0, altitude=alt, vx=vx, vy=vy, rng=rng)
+              for alt, vx, vy in [(0., 3., 1.), (5., -4., 2.), (10., 1., -6.)]]
+    layers.insert(1, galsim.OpticalScreen(diam=1.0, defocus=0.3, coma1=-0.1))
+    kwargs = dict(lam=700.0, diam=1.0, exptime=0.05, time_step=0.01,
+                  theta=(0.2*galsim.arcmin, -0.1*galsim.arcmin))
+
+    psl1 = galsim.PhaseScreenList(layers)
+    assert psl1._use_engine
+    psf1 = psl1.makePSF(**kwargs)
+    psf1._prepareDraw()
+
+    # Force the original python path, which seeks to each time step in turn.
+    psl2 = galsim.PhaseScreenList(layers)
+    psl2._use_engine = False
+    psf2 = psl2.makePSF(**kwargs)
+    psf2._prepareDraw()
+
+    np.testing.assert_allclose(psf1._img.array, psf2._img.array, rtol=0,
+                               atol=1.e-10*np.max(psf2._img.array))
+
+    # Drawing from the same list more than once, including a PSF starting at a later time,
+    # still matches the python path.
+    psl1 = galsim.PhaseScreenList(layers)
+    psl2 = galsim.PhaseScreenList(layers)
+    psl2._use_engine = False
+    for t0 in [0., 0.02, 0.]:
+        im1 = psl1.makePSF(t0=t0, **kwargs).drawImage(nx=32, ny=32, scale=0.05)
+        im2 = psl2.makePSF(t0=t0, **kwargs).drawImage(nx=32, ny=32, scale=0.05)
+        np.testing.assert_allclose(im1.array, im2.array, rtol=0, atol=1.e-9*np.max(im2.array))
+    assert psl1._update_time_heap == []
+
+    # The time integration gives exactly the same image for any number of threads.
+    kwargs['exptime'] = 0.23
+    images = []
+    for num_threads in [1, 3, 4]:
+        galsim.set_omp_threads(num_threads)
+        psf3 = galsim.PhaseScreenList(layers).makePSF(**kwargs)
+        psf3._prepareDraw()
+        images.append(psf3._img.array)
+    galsim.set_omp_threads(None)
+    np.testing.assert_array_equal(images[1], images[0])
+    np.testing.assert_array_equal(images[2], images[0])
+
+    # Boiling screens can't use the engine.
+    boil = galsim.PhaseScreenList(galsim.AtmosphericScreen(10.0, alpha=0.99, time_step=0.01))
+    assert not boil._use_engine
+
+
 @timer
 def test_phase_psf_reset():
     """Test that phase screen reset() method correctly resets the screen to t=0."""
@@ -1371,6 +1443,7 @@ if __name__ == "__main__":
     test_structure_function()
     test_phase_screen_list()
     test_frozen_flow()
+    test_phase_screen_engine()
     test_phase_psf_reset()
     test_phase_psf_batch()
     test_opt_indiv_aberrations()
@@ -1717,6 +1717,131 @@ def test_int64():
         assert rng2 == rng1
 
 
+@timer
+def test_poisson_batch():
+    """Test the batch sampler for PoissonDeviate.generate_from_expectation
+    """
+    if __name__ == '__main__':
+        n = 1000000
+    else:
+        n = 100000
+    means = [0.3, 4.1, 9.99, 10., 25.3, 400., 5000.]
+    for engine in ['mt19937', 'philox']:
+        p = galsim.PoissonDeviate(galsim.BaseDeviate(testseed, engine=engine))
+        # Interleave the different means, so each chunk uses all the methods.
+        array = np.tile(means, n)
+        array[::17] = 0.
+        p.generate_from_expectation(array, normal_threshold=1000.)
+        vals = array.reshape(n, len(means))
+        np.testing.assert_array_equal(vals, np.floor(vals))
+        for i, mean in enumerate(means):
+            zero = (np.arange(n) * len(means) + i) % 17 == 0
+            v = vals[:,i][~zero]
+            np.testing.assert_allclose(np.mean(v), mean, atol=5*np.sqrt(mean/len(v)))
+            np.testing.assert_allclose(np.var(v), mean, rtol=0.03)
+            # Values <= 0 are left alone.
+            np.testing.assert_array_equal(vals[:,i][zero], 0.)
+
+    # With philox, the default is to use the batch sampler with a threshold of 2**30.
+    p = galsim.PoissonDeviate(galsim.BaseDeviate(testseed, engine='philox'))
+    p2 = p.duplicate()
+    array = np.tile(means + [2.**31], 100)
+    array2 = array.copy()
+    p.generate_from_expectation(array)
+    p2.generate_from_expectation(array2, normal_threshold=2**30)
+    np.testing.assert_array_equal(array, array2)
+
+    # With mt19937, the default is the same as drawing each value in turn.
+    p = galsim.PoissonDeviate(testseed)
+    rng2 = galsim.BaseDeviate(testseed)
+    array = np.array(means)
+    p.generate_from_expectation(array)
+    vals2 = [galsim.PoissonDeviate(rng2, mean=mean)() for mean in means]
+    np.testing.assert_array_equal(array, vals2)
+
+
+@timer
+def test_philox():
+    """Test the philox engine.
+    """
+    # Known answers from the Random123 distribution, kat_vectors.  The serialization string
+    # is the key, the counter, and the index of the next value in the current block.
+    kat = [ ((0, 0), (0, 0, 0, 0),
+             (0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8)),
+            ((0xffffffff, 0xffffffff), (0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff),
+             (0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd)),
+            ((0xa4093822, 0x299f31d0), (0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344),
+             (0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1)) ]
+    for key, ctr, result in kat:
+        rng = galsim.BaseDeviate('philox4x32 %d %d %d %d %d %d 0'%(key + ctr))
+        assert rng.engine == 'philox'
+        np.testing.assert_equal([rng.raw() for i in range(4)], result)
+
+    rng = galsim.BaseDeviate(testseed, engine='philox')
+    assert rng.engine == 'philox'
+    assert rng != galsim.BaseDeviate(testseed)
+    assert galsim.BaseDeviate(testseed).engine == 'mt19937'
+
+    # Deviates seeded with it use it too.
+    u = galsim.UniformDeviate(rng)
+    assert u.engine == 'philox'
+    u2 = u.duplicate()
+    assert u2.engine == 'philox'
+    assert u2 == u
+    do_pickle(u)
+    do_pickle(rng)
+
+    # generate fills the array in blocks, but gives the same values as single draws.
+    for n in [1, 3, 4, 17, 10001]:
+        u.discard(1)
+        u2 = u.duplicate()
+        v = np.empty(n)
+        u.generate(v)
+        np.testing.assert_equal(v, [u2() for i in range(n)])
+        assert u() == u2()
+
+    # For Gaussian, this is true after clearing the cache for even n.
+    g = galsim.GaussianDeviate(rng, mean=gMean, sigma=gSigma)
+    for n in [2, 4, 18, 10000]:
+        g2 = g.duplicate()
+        v = np.empty(n)
+        g.generate(v)
+        g2.clearCache()
+        np.testing.assert_allclose(v, [g2() for i in range(n)], rtol=1.e-15)
+    v = np.empty(nvals)
+    g.generate(v)
+    np.testing.assert_allclose(np.mean(v), gMean, atol=3*gSigma/np.sqrt(nvals))
+    np.testing.assert_allclose(np.std(v), gSigma, rtol=0.01)
+
+    g2 = g.duplicate()
+    var = np.linspace(0.1, 10., 1000)
+    v = var.copy()
+    g.generate_from_variance(v)
+    g2 = galsim.GaussianDeviate(g2, mean=0, sigma=1)
+    v2 = np.empty(len(var))
+    g2.generate(v2)
+    np.testing.assert_allclose(v, v2 * np.sqrt(var), rtol=1.e-15)
+
+    # discard doesn't need to generate the values it skips.
+    u2 = u.duplicate()
+    u.discard(10**9 + 3)
+    s = u.serialize().split()
+    s2 = u2.serialize().split()
+    pos = int(s[3]) * 4 + int(s[7])
+    pos2 = int(s2[3]) * 4 + int(s2[7])
+    assert pos - pos2 == 10**9 + 3
+
+    # reset and seed keep the engine.
+    u.reset(testseed)
+    assert u.engine == 'philox'
+    u.seed(testseed)
+    assert u.engine == 'philox'
+    u.reset(galsim.BaseDeviate(testseed))
+    assert u.engine == 'mt19937'
+
+    assert_raises(ValueError, galsim.BaseDeviate, testseed, engine='invalid')
+
+
 if __name__ == "__main__":
     test_uniform()
     test_gaussian()
@@ -1733,3 +1858,5 @@ if __name__ == "__main__":
     test_permute()
     test_ne()
     test_int64()
+    test_poisson_batch()
+    test_philox()
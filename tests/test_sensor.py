@@ -988,6 +988,44 @@ def test_flat():
     np.testing.assert_allclose(cov20 / counts_total, 0., atol=2*toler)
     np.testing.assert_allclose(cov02 / counts_total, 0., atol=2*toler)
 
+@timer
+def test_silicon_threads():
+    """Test that the Silicon accumulate loop gives the same answer with any number of threads.
+
+    With wavelengths, each photon looks up its absorption length in a table shared by all
+    the OpenMP threads, so this is a stress test of concurrent Table lookups.
+    """
+    nphotons = 200000
+    ud = galsim.UniformDeviate(1234)
+    photons = galsim.PhotonArray(nphotons)
+    ud.generate(photons.x)
+    ud.generate(photons.y)
+    photons.x = 20. * photons.x - 10.
+    photons.y = 20. * photons.y - 10.
+    photons.flux = 1.
+    # Random order, so the lookups jump all over the table.
+    wave = np.empty(nphotons)
+    ud.generate(wave)
+    photons.wavelength = 400. + 700. * wave
+    # Large angles, so the conversion depth makes a big difference to where the electrons land.
+    dxdz = np.empty(nphotons)
+    dydz = np.empty(nphotons)
+    ud.generate(dxdz)
+    ud.generate(dydz)
+    photons.dxdz = 2. * dxdz - 1.
+    photons.dydz = 2. * dydz - 1.
+
+    images = []
+    for num_threads in [1, 4]:
+        galsim.set_omp_threads(num_threads)
+        silicon = galsim.SiliconSensor(rng=galsim.BaseDeviate(5678), nrecalc=nphotons)
+        im = galsim.ImageD(24, 24, xmin=-11, ymin=-11, scale=0.3)
+        silicon.accumulate(photons, im)
+        images.append(im)
+    galsim.set_omp_threads(None)
+    np.testing.assert_array_equal(images[1].array, images[0].array)
+
+
 def test_omp():
     """Test setting the number of omp threads.
     """
@@ -1080,3 +1118,4 @@ if __name__ == "__main__":
     test_resume()
     test_flat()
     test_omp()
+    test_silicon_threads()
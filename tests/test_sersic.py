@@ -568,6 +568,141 @@ def test_near_05():
     np.testing.assert_allclose(im3.array, im1.array, atol=1.e-12)
 
 
+@timer
+def test_sersic_grid():
+    """Test the interpolate_sersic_n option, which interpolates the Sersic tables in n.
+    """
+    gsp = galsim.GSParams(interpolate_sersic_n=True)
+    assert gsp.interpolate_sersic_n
+    assert not galsim.GSParams().interpolate_sersic_n
+    assert galsim.GSParams.combine([gsp, gsp]).interpolate_sersic_n
+    assert not galsim.GSParams.combine([gsp, galsim.GSParams()]).interpolate_sersic_n
+    assert gsp != galsim.GSParams()
+
+    # The interpolated Fourier transform should be accurate to about kvalue_accuracy.  Compare
+    # to direct calculations with more accurate integrals.  At n < 4, they also use a finer table,
+    # whose low-k end is well below the first k value of the image.  (At larger n, the high-k
+    # integrals fail with the finer table, but the low-k end is below the first k anyway.)
+    flux = 1.7
+    for n in [0.35, 0.77, 1.61, 2.9, 3.8, 4.5, 5.3, 6.2]:
+        ref_gsp = galsim.GSParams(kvalue_accuracy=1.e-7 if n < 4 else 1.e-5,
+                                  integration_relerr=1.e-7, integration_abserr=1.e-9)
+        exact = galsim.Sersic(n=n, half_light_radius=1.3, flux=flux, gsparams=ref_gsp)
+        direct = galsim.Sersic(n=n, half_light_radius=1.3, flux=flux)
+        interp = galsim.Sersic(n=n, half_light_radius=1.3, flux=flux, gsparams=gsp)
+        np.testing.assert_allclose(interp.stepk, direct.stepk, rtol=1.e-5)
+        # maxk is the first k in the table past the last value above maxk_threshold, so it
+        # matches the direct calculation with the same table spacing to much better than the
+        # spacing of about 3%.
+        np.testing.assert_allclose(interp.maxk, direct.maxk, rtol=3.e-3)
+        assert abs(interp.kValue(interp.maxk, 0.)) <= gsp.maxk_threshold * flux
+
+        kim1 = exact.drawKImage(nx=64, ny=64, scale=0.15)
+        kim2 = interp.drawKImage(nx=64, ny=64, scale=0.15)
+        print('n = ',n,' max diff = ',np.max(np.abs(kim2.array-kim1.array))/flux)
+        np.testing.assert_allclose(kim2.array, kim1.array, rtol=0,
+                                   atol=gsp.kvalue_accuracy * flux)
+
+        im1 = direct.drawImage(nx=32, ny=32, scale=0.3, method='fft')
+        im2 = interp.drawImage(nx=32, ny=32, scale=0.3, method='fft')
+        np.testing.assert_allclose(im2.array, im1.array, rtol=0, atol=1.e-5 * im1.array.max())
+
+    # Truncated profiles don't use the grid.
+    trunc1 = galsim.Sersic(n=2.3, half_light_radius=1.3, trunc=5.)
+    trunc2 = galsim.Sersic(n=2.3, half_light_radius=1.3, trunc=5., gsparams=gsp)
+    np.testing.assert_array_equal(trunc2.drawKImage(nx=32, ny=32, scale=0.2).array,
+                                  trunc1.drawKImage(nx=32, ny=32, scale=0.2).array)
+
+    # Write the grid to a file and read it back in.
+    file_name = os.path.join('output', 'sersic_grid.dat')
+    galsim.sersic.write_sersic_grid(file_name, gsp)
+    assert galsim.sersic.load_sersic_grid(file_name, gsp)
+    # interpolate_sersic_n doesn't need to be set for these.
+    assert galsim.sersic.load_sersic_grid(file_name)
+    interp = galsim.Sersic(n=6.2, half_light_radius=1.3, flux=flux, gsparams=gsp)
+    np.testing.assert_array_equal(interp.drawKImage(nx=64, ny=64, scale=0.15).array, kim2.array)
+    # The grid for the default gsparams is shipped in the share directory.
+    shipped_file = os.path.join(galsim.meta_data.share_dir, 'sersic_grid.dat')
+    assert os.path.isfile(shipped_file)
+    assert galsim.sersic.load_sersic_grid(shipped_file, gsp)
+    assert not galsim.sersic.load_sersic_grid(shipped_file, galsim.GSParams(kvalue_accuracy=1.e-4))
+    # A grid for different gsparams is rejected.
+    assert not galsim.sersic.load_sersic_grid(file_name, galsim.GSParams(kvalue_accuracy=1.e-4))
+    # So is a file that isn't a grid at all.
+    assert not galsim.sersic.load_sersic_grid(os.path.join('..', 'share', 'sip_7_6_8.txt'))
+    with assert_raises(galsim.GalSimError):
+        galsim.sersic.load_sersic_grid(os.path.join('output', 'nonexistent_sersic_grid.dat'))
+
+
+
+@timer
+def test_sersic_cache_stats():
+    """Test the statistics and size limits of the cache of SersicInfo objects."""
+    assert 'Sersic' in galsim.utilities.cache_names()
+    assert 'Kolmogorov' in galsim.utilities.cache_names()
+    orig = galsim.utilities.get_cache_stats('Sersic')
+    galsim.utilities.clear_cache('Sersic')
+    galsim.utilities.reset_cache_stats('Sersic')
+
+    gsp = galsim.GSParams(kvalue_accuracy=2.3e-5)
+    ns = [1.3, 1.7, 2.2, 2.9, 3.6]
+    for n in ns:
+        galsim.Sersic(n=n, half_light_radius=1.2, gsparams=gsp).drawImage(nx=32, ny=32, scale=0.3)
+    stats1 = galsim.utilities.get_cache_stats('Sersic')
+    print('stats1 = ',stats1.nhit,stats1.nmiss,stats1.nevict,stats1.nentries,stats1.nbytes)
+    assert stats1.nmiss == len(ns)
+    assert stats1.nevict == 0
+    assert stats1.nentries == len(ns)
+    assert stats1.nbytes > 0
+    assert stats1.build_time >= 0.
+    assert stats1.max_entries == orig.max_entries
+    assert stats1.max_bytes == orig.max_bytes
+
+    # Remaking the same profiles uses the cached SersicInfos.
+    for n in ns:
+        galsim.Sersic(n=n, half_light_radius=1.2, gsparams=gsp).drawImage(nx=32, ny=32, scale=0.3)
+    stats2 = galsim.utilities.get_cache_stats('Sersic')
+    print('stats2 = ',stats2.nhit,stats2.nmiss,stats2.nevict,stats2.nentries,stats2.nbytes)
+    assert stats2.nhit >= stats1.nhit + len(ns)
+    assert stats2.nmiss == stats1.nmiss
+    assert stats2.nentries == len(ns)
+    # Sizes are measured again on each use, so now they include the Fourier tables.
+    assert stats2.nbytes >= stats1.nbytes
+
+    # A byte limit removes the least recently used entries.
+    galsim.utilities.set_cache_size('Sersic', 0, stats2.nbytes // 2)
+    stats3 = galsim.utilities.get_cache_stats('Sersic')
+    print('stats3 = ',stats3.nhit,stats3.nmiss,stats3.nevict,stats3.nentries,stats3.nbytes)
+    assert stats3.max_entries == 0
+    assert stats3.max_bytes == stats2.nbytes // 2
+    assert stats3.nbytes <= stats3.max_bytes
+    assert stats3.nentries < len(ns)
+    assert stats3.nevict == len(ns) - stats3.nentries
+
+    # So does a limit on the number of entries.
+    galsim.utilities.set_cache_size('Sersic', 1, 0)
+    stats4 = galsim.utilities.get_cache_stats('Sersic')
+    assert stats4.nentries == 1
+    assert stats4.nevict == len(ns) - 1
+
+    # The results are the same regardless of the cache.
+    im1 = galsim.Sersic(n=ns[0], half_light_radius=1.2, gsparams=gsp).drawImage(nx=32, ny=32,
+                                                                              scale=0.3)
+    galsim.utilities.clear_cache('Sersic')
+    assert galsim.utilities.get_cache_stats('Sersic').nentries == 0
+    assert galsim.utilities.get_cache_stats('Sersic').nbytes == 0
+    im2 = galsim.Sersic(n=ns[0], half_light_radius=1.2, gsparams=gsp).drawImage(nx=32, ny=32,
+                                                                              scale=0.3)
+    np.testing.assert_array_equal(im1.array, im2.array)
+
+    with assert_raises(ValueError):
+        galsim.utilities.get_cache_stats('invalid')
+    with assert_raises(ValueError):
+        galsim.utilities.set_cache_size('invalid', 10, 0)
+
+    galsim.utilities.set_cache_size('Sersic', orig.max_entries, orig.max_bytes)
+
+
 if __name__ == "__main__":
     test_sersic()
     test_sersic_radii()
@@ -577,3 +712,5 @@ if __name__ == "__main__":
     test_sersic_shoot()
     test_ne()
     test_near_05()
+    test_sersic_grid()
+    test_sersic_cache_stats()
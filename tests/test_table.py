@@ -359,6 +359,29 @@ def test_table_GSInterp():
         )
 
 
+@timer
+def test_interp_many():
+    """Test LookupTable on large arrays in various orders, which are split across threads.
+    """
+    rng = np.random.RandomState(1234)
+    x = np.cumsum(rng.uniform(0.01, 1., size=2000))
+    f = np.sin(0.1*x) + 0.01*x
+    xeq = np.linspace(x[0], x[-1], 2000)
+    for args in [x, xeq]:
+        for interp in ['linear', 'spline', 'floor', 'ceil', 'nearest']:
+            tab = galsim.LookupTable(args, f, interpolant=interp)
+            a = rng.uniform(args[0], args[-1], size=300000)
+            ref = np.array([tab(aa) for aa in a[:2000]])
+            np.testing.assert_array_equal(tab(a)[:2000], ref)
+            # Sorted input (either way) should give the same answers as unsorted.
+            fa = tab(a)
+            index = np.argsort(a)
+            np.testing.assert_array_equal(tab(a[index]), fa[index])
+            np.testing.assert_array_equal(tab(a[index[::-1]]), fa[index[::-1]])
+            # Also check exactly at the nodes.
+            np.testing.assert_array_equal(tab(args), np.array([tab(aa) for aa in args]))
+
+
 @timer
 def test_table2d():
     """Check LookupTable2D functionality.
@@ -742,6 +765,51 @@ def test_table2d_gradient():
     np.testing.assert_array_equal(0.0, test_dfdy[:,:,1])
 
 
+@timer
+def test_table2d_value_gradient():
+    """Test the fused value_and_gradient method of LookupTable2D.
+    """
+    rng = np.random.RandomState(5678)
+    x = np.cumsum(rng.uniform(0.1, 1., size=80))
+    y = np.cumsum(rng.uniform(0.1, 1., size=60))
+    xx, yy = np.meshgrid(x, y, indexing='ij')
+    z = np.sin(0.3*xx) * np.cos(0.2*yy)
+
+    # Enough points to be split across threads.
+    newx = rng.uniform(x[0], x[-1], size=30000)
+    newy = rng.uniform(y[0], y[-1], size=30000)
+    gridx = np.sort(rng.uniform(x[0], x[-1], size=200))
+    gridy = np.sort(rng.uniform(y[0], y[-1], size=150))
+
+    for interpolant in ['linear', 'spline']:
+        tab2d = galsim.LookupTable2D(x, y, z, interpolant=interpolant)
+        f, dfdx, dfdy = tab2d.value_and_gradient(newx, newy)
+        np.testing.assert_array_equal(f, tab2d(newx, newy))
+        np.testing.assert_array_equal((dfdx, dfdy), tab2d.gradient(newx, newy))
+
+        f, dfdx, dfdy = tab2d.value_and_gradient(gridx, gridy, grid=True)
+        np.testing.assert_array_equal(f, tab2d(gridx, gridy, grid=True))
+        np.testing.assert_array_equal((dfdx, dfdy), tab2d.gradient(gridx, gridy, grid=True))
+        # The grid and non-grid versions should match too.
+        np.testing.assert_array_equal(f, tab2d(*np.meshgrid(gridx, gridy, indexing='ij')))
+
+        f1, dfdx1, dfdy1 = tab2d.value_and_gradient(newx[17], newy[17])
+        assert f1 == tab2d(newx[17], newy[17])
+        assert (dfdx1, dfdy1) == tab2d.gradient(newx[17], newy[17])
+
+        # Outside the bounds
+        assert_raises(ValueError, tab2d.value_and_gradient, x[-1]+1, y[0])
+        tab2dc = galsim.LookupTable2D(x, y, z, interpolant=interpolant, edge_mode='constant',
+                                      constant=7)
+        f, dfdx, dfdy = tab2dc.value_and_gradient(newx+10, newy)
+        np.testing.assert_array_equal(f, tab2dc(newx+10, newy))
+        np.testing.assert_array_equal((dfdx, dfdy), tab2dc.gradient(newx+10, newy))
+
+    # Gradients aren't implemented for the other interpolants.
+    tab2d = galsim.LookupTable2D(x, y, z, interpolant='floor')
+    assert_raises(RuntimeError, tab2d.value_and_gradient, newx, newy)
+
+
 @timer
 def test_table2d_cubic():
     # A few functions that should be exactly interpolatable with bicubic
@@ -984,8 +1052,10 @@ if __name__ == "__main__":
     test_from_func()
     test_roundoff()
     test_table_GSInterp()
+    test_interp_many()
     test_table2d()
     test_table2d_gradient()
+    test_table2d_value_gradient()
     test_table2d_cubic()
     test_table2d_GSInterp()
     test_ne()
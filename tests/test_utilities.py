@@ -1259,6 +1259,110 @@ def test_horner2d():
         galsim.utilities.horner2d(x, y[:10], coef)
 
 
+@timer
+def test_info_cache():
+    """Test the on-disk cache of profile calculations.
+    """
+    import subprocess
+    import shutil
+
+    cache_dir = os.path.join('output', 'info_cache')
+    if os.path.isdir(cache_dir):
+        shutil.rmtree(cache_dir)
+
+    save_dir = galsim.utilities.get_info_cache_dir()
+    galsim.utilities.set_info_cache_dir(cache_dir)
+    assert galsim.utilities.get_info_cache_dir() == cache_dir
+    assert os.path.isdir(cache_dir)
+    galsim.utilities.set_info_cache_dir(None)
+    assert galsim.utilities.get_info_cache_dir() is None
+    galsim.utilities.set_info_cache_dir(save_dir)
+    shutil.rmtree(cache_dir)
+
+    # The in-memory caches would hide the on-disk one, so each use is a separate process.
+    script = """
+import sys
+import numpy as np
+import galsim
+galsim.utilities.set_info_cache_dir(sys.argv[1])
+gsp = galsim.GSParams(folding_threshold=4.e-3)
+objs = [ galsim.Sersic(n=2.3, half_light_radius=1.1, trunc=5., gsparams=gsp),
+         galsim.Spergel(nu=-0.3, half_light_radius=1.1, gsparams=gsp),
+         galsim.Kolmogorov(fwhm=0.9, gsparams=gsp),
+         galsim.VonKarman(lam=700, r0=0.2, L0=20., gsparams=gsp),
+         galsim.SecondKick(lam=700, r0=0.2, diam=4., obscuration=0.3, gsparams=gsp),
+         galsim.Airy(lam_over_diam=0.3, obscuration=0.2, gsparams=gsp),
+         galsim.Exponential(half_light_radius=1.1, gsparams=gsp) ]
+images = []
+for obj in objs:
+    images.append(obj.drawImage(nx=32, ny=32, scale=0.2).array)
+    images.append(obj.drawImage(nx=32, ny=32, scale=0.2, method='phot', n_photons=1000,
+                                rng=galsim.BaseDeviate(1234)).array)
+np.save(sys.argv[2], np.array(images))
+"""
+    env = dict(os.environ)
+    galsim_dir = os.path.dirname(os.path.dirname(os.path.abspath(galsim.__file__)))
+    env['PYTHONPATH'] = os.pathsep.join([galsim_dir, env.get('PYTHONPATH', '')])
+    def run(dir, out_file):
+        subprocess.check_call([sys.executable, '-c', script, dir, out_file], env=env)
+        return np.load(out_file)
+
+    # First without the cache.
+    im0 = run('', os.path.join('output', 'info_cache_0.npy'))
+    assert not os.path.isdir(cache_dir)
+
+    # Then with an empty cache, which writes all the entries.
+    im1 = run(cache_dir, os.path.join('output', 'info_cache_1.npy'))
+    np.testing.assert_array_equal(im1, im0)
+    files = sorted(os.listdir(cache_dir))
+    for name in ['SersicInfo', 'SersicSampler', 'SpergelInfo', 'SpergelSampler',
+                 'KolmogorovInfo', 'KolmogorovSampler', 'VonKarmanInfo', 'VonKarmanSampler',
+                 'SKInfo', 'SKSampler', 'AirySampler', 'ExponentialSampler']:
+        assert any(f.startswith(name + '_') and f.endswith('.dat') for f in files)
+    assert not any('.tmp.' in f for f in files)
+    sizes = dict((f, os.path.getsize(os.path.join(cache_dir, f))) for f in files)
+
+    # Again, now reading everything from the cache.  Photon shooting uses exactly the same
+    # sampler, so the results are identical, and nothing is rewritten.
+    mtimes = dict((f, os.path.getmtime(os.path.join(cache_dir, f))) for f in files)
+    im2 = run(cache_dir, os.path.join('output', 'info_cache_2.npy'))
+    np.testing.assert_array_equal(im2, im0)
+    assert sorted(os.listdir(cache_dir)) == files
+    for f in files:
+        assert os.path.getmtime(os.path.join(cache_dir, f)) == mtimes[f]
+
+    # A damaged entry is ignored and replaced.
+    kolm_file = [f for f in files if f.startswith('KolmogorovInfo_')][0]
+    kolm_file = os.path.join(cache_dir, kolm_file)
+    with open(kolm_file, 'r+b') as fout:
+        fout.truncate(sizes[os.path.basename(kolm_file)] // 2)
+    im3 = run(cache_dir, os.path.join('output', 'info_cache_3.npy'))
+    np.testing.assert_array_equal(im3, im0)
+    assert os.path.getsize(kolm_file) == sizes[os.path.basename(kolm_file)]
+
+    # The Sersic and Moffat Fourier transforms are only calculated (and saved) if they are used.
+    shutil.rmtree(cache_dir)
+    script = """
+import sys
+import galsim
+galsim.utilities.set_info_cache_dir(sys.argv[1])
+sersic = galsim.Sersic(n=2.7, half_light_radius=1.1, trunc=5.)
+moffat = galsim.Moffat(beta=2.9, half_light_radius=1.1, trunc=5.)
+# Making the C++ profiles doesn't need the Fourier transforms.
+sbp = [ sersic._sbp, moffat._sbp ]
+if sys.argv[2] == 'draw':
+    sersic.drawImage(nx=32, ny=32, scale=0.2)
+    moffat.drawImage(nx=32, ny=32, scale=0.2)
+"""
+    subprocess.check_call([sys.executable, '-c', script, cache_dir, 'nodraw'], env=env)
+    files = os.listdir(cache_dir)
+    assert not any(f.startswith('SersicInfo_') or f.startswith('MoffatInfo_') for f in files)
+    subprocess.check_call([sys.executable, '-c', script, cache_dir, 'draw'], env=env)
+    files = os.listdir(cache_dir)
+    assert any(f.startswith('SersicInfo_') for f in files)
+    assert any(f.startswith('MoffatInfo_') for f in files)
+
+
 if __name__ == "__main__":
     test_pos()
     test_bounds()
@@ -1278,3 +1382,4 @@ if __name__ == "__main__":
     test_nCr()
     test_horner()
     test_horner2d()
+    test_info_cache()